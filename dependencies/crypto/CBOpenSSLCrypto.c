@@ -17,6 +17,7 @@
 #include "CBDependencies.h" // cbitcoin dependencies to implement
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <openssl/sha.h>
 #include <openssl/ripemd.h>
 #include <openssl/ssl.h>
@@ -24,6 +25,261 @@
 
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations" // For OSX Lion
 
+// Multi-buffer SHA-256
+
+#define CB_SHA256_LANES 8 // The number of messages hashed together. Each step is done for all lanes in a loop, which the compiler can vectorise.
+#define CBRotr32(x, n) ((x) >> (n) | (x) << (32 - (n)))
+
+static const uint32_t CBSha256K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+static const uint32_t CBSha256Initial[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ @brief Hashes CB_SHA256_LANES messages of the same length together.
+ @param data Pointers to the messages.
+ @param length The length of each message.
+ @param outputs Pointers for each 32-byte hash.
+ */
+static void CBSha256Lanes(unsigned char ** data, int length, unsigned char ** outputs);
+
+static void CBSha256Lanes(unsigned char ** data, int length, unsigned char ** outputs) {
+	
+	uint32_t state[8][CB_SHA256_LANES], w[64][CB_SHA256_LANES], v[8][CB_SHA256_LANES];
+	for (int x = 0; x < 8; x++)
+		for (int l = 0; l < CB_SHA256_LANES; l++)
+			state[x][l] = CBSha256Initial[x];
+	// The padding adds a one bit and the 64-bit length in bits.
+	int blocks = (length + 9 + 63) / 64;
+	uint64_t bits = (uint64_t)length * 8;
+	for (int b = 0; b < blocks; b++) {
+		int offset = b * 64;
+		for (int l = 0; l < CB_SHA256_LANES; l++) {
+			unsigned char padded[64];
+			unsigned char * block = data[l] + offset;
+			if (offset + 64 > length) {
+				// Copy the remainder of the message into a padded block.
+				int remaining = length > offset ? length - offset : 0;
+				memcpy(padded, block, remaining);
+				memset(padded + remaining, 0, 64 - remaining);
+				if (length >= offset)
+					padded[remaining] = 0x80;
+				if (b == blocks - 1)
+					for (int x = 0; x < 8; x++)
+						padded[63 - x] = (unsigned char)(bits >> (x * 8));
+				block = padded;
+			}
+			for (int x = 0; x < 16; x++)
+				w[x][l] = (uint32_t)block[x * 4] << 24 | (uint32_t)block[x * 4 + 1] << 16 | (uint32_t)block[x * 4 + 2] << 8 | block[x * 4 + 3];
+		}
+		for (int x = 16; x < 64; x++)
+			for (int l = 0; l < CB_SHA256_LANES; l++) {
+				uint32_t s0 = CBRotr32(w[x - 15][l], 7) ^ CBRotr32(w[x - 15][l], 18) ^ (w[x - 15][l] >> 3);
+				uint32_t s1 = CBRotr32(w[x - 2][l], 17) ^ CBRotr32(w[x - 2][l], 19) ^ (w[x - 2][l] >> 10);
+				w[x][l] = w[x - 16][l] + s0 + w[x - 7][l] + s1;
+			}
+		memcpy(v, state, sizeof(v));
+		for (int x = 0; x < 64; x++)
+			for (int l = 0; l < CB_SHA256_LANES; l++) {
+				uint32_t s1 = CBRotr32(v[4][l], 6) ^ CBRotr32(v[4][l], 11) ^ CBRotr32(v[4][l], 25);
+				uint32_t ch = (v[4][l] & v[5][l]) ^ (~v[4][l] & v[6][l]);
+				uint32_t t1 = v[7][l] + s1 + ch + CBSha256K[x] + w[x][l];
+				uint32_t s0 = CBRotr32(v[0][l], 2) ^ CBRotr32(v[0][l], 13) ^ CBRotr32(v[0][l], 22);
+				uint32_t maj = (v[0][l] & v[1][l]) ^ (v[0][l] & v[2][l]) ^ (v[1][l] & v[2][l]);
+				v[7][l] = v[6][l];
+				v[6][l] = v[5][l];
+				v[5][l] = v[4][l];
+				v[4][l] = v[3][l] + t1;
+				v[3][l] = v[2][l];
+				v[2][l] = v[1][l];
+				v[1][l] = v[0][l];
+				v[0][l] = t1 + s0 + maj;
+			}
+		for (int x = 0; x < 8; x++)
+			for (int l = 0; l < CB_SHA256_LANES; l++)
+				state[x][l] += v[x][l];
+	}
+	for (int l = 0; l < CB_SHA256_LANES; l++)
+		for (int x = 0; x < 8; x++) {
+			outputs[l][x * 4] = (unsigned char)(state[x][l] >> 24);
+			outputs[l][x * 4 + 1] = (unsigned char)(state[x][l] >> 16);
+			outputs[l][x * 4 + 2] = (unsigned char)(state[x][l] >> 8);
+			outputs[l][x * 4 + 3] = (unsigned char)state[x][l];
+		}
+	
+}
+
+// Multi-buffer RIPEMD-160
+
+#define CB_RIPEMD160_LANES CB_SHA256_LANES // The same number of lanes as SHA-256, so that hash160 passes the SHA-256 lanes straight on.
+#define CBRotl32(x, n) ((x) << (n) | (x) >> (32 - (n)))
+
+static const uint32_t CBRipemd160Initial[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+static const uint32_t CBRipemd160KLeft[5] = {0x00000000, 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xA953FD4E};
+static const uint32_t CBRipemd160KRight[5] = {0x50A28BE6, 0x5C4DD124, 0x6D703EF3, 0x7A6D76E9, 0x00000000};
+static const unsigned char CBRipemd160RLeft[80] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+	3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+	1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+	4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+static const unsigned char CBRipemd160RRight[80] = {
+	5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+	6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+	15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+	8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+	12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+static const unsigned char CBRipemd160SLeft[80] = {
+	11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+	7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+	11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+	11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+	9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+static const unsigned char CBRipemd160SRight[80] = {
+	8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+	9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+	9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+	15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+	8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+
+/**
+ @brief The boolean function of a round of RIPEMD-160.
+ @param round The round from 0 to 4.
+ @param x The first word.
+ @param y The second word.
+ @param z The third word.
+ @returns The result of the function.
+ */
+static inline uint32_t CBRipemd160F(int round, uint32_t x, uint32_t y, uint32_t z);
+/**
+ @brief Does the sixteen steps of a round of RIPEMD-160 on both lines for every lane.
+ @param round The round from 0 to 4.
+ @param wLeft The message words of the block in the order of the steps of the left line.
+ @param wRight The message words of the block in the order of the steps of the right line.
+ @param left The state of the left line.
+ @param right The state of the right line.
+ */
+static inline void CBRipemd160Round(int round, uint32_t wLeft[80][CB_RIPEMD160_LANES], uint32_t wRight[80][CB_RIPEMD160_LANES], uint32_t left[5][CB_RIPEMD160_LANES], uint32_t right[5][CB_RIPEMD160_LANES]) __attribute__((always_inline));
+/**
+ @brief Hashes CB_RIPEMD160_LANES messages of the same length together.
+ @param data Pointers to the messages.
+ @param length The length of each message.
+ @param outputs Pointers for each 20-byte hash.
+ */
+static void CBRipemd160Lanes(unsigned char ** data, int length, unsigned char ** outputs);
+
+static inline uint32_t CBRipemd160F(int round, uint32_t x, uint32_t y, uint32_t z) {
+	
+	switch (round) {
+		case 0: return x ^ y ^ z;
+		case 1: return (x & y) | (~x & z);
+		case 2: return (x | ~y) ^ z;
+		case 3: return (x & z) | (y & ~z);
+		default: return x ^ (y | ~z);
+	}
+	
+}
+
+static inline void CBRipemd160Round(int round, uint32_t wLeft[80][CB_RIPEMD160_LANES], uint32_t wRight[80][CB_RIPEMD160_LANES], uint32_t left[5][CB_RIPEMD160_LANES], uint32_t right[5][CB_RIPEMD160_LANES]) {
+	
+	// Unroll the steps so that the rotations are by constants, as vectors cannot be rotated by variables.
+	#pragma GCC unroll 16
+	for (int x = round * 16; x < round * 16 + 16; x++) {
+		uint32_t sLeft = CBRipemd160SLeft[x], sRight = CBRipemd160SRight[x];
+		for (int l = 0; l < CB_RIPEMD160_LANES; l++) {
+			uint32_t t = left[0][l] + CBRipemd160F(round, left[1][l], left[2][l], left[3][l]) + wLeft[x][l] + CBRipemd160KLeft[round];
+			t = CBRotl32(t, sLeft) + left[4][l];
+			left[0][l] = left[4][l];
+			left[4][l] = left[3][l];
+			left[3][l] = CBRotl32(left[2][l], 10);
+			left[2][l] = left[1][l];
+			left[1][l] = t;
+			t = right[0][l] + CBRipemd160F(4 - round, right[1][l], right[2][l], right[3][l]) + wRight[x][l] + CBRipemd160KRight[round];
+			t = CBRotl32(t, sRight) + right[4][l];
+			right[0][l] = right[4][l];
+			right[4][l] = right[3][l];
+			right[3][l] = CBRotl32(right[2][l], 10);
+			right[2][l] = right[1][l];
+			right[1][l] = t;
+		}
+	}
+	
+}
+
+static void CBRipemd160Lanes(unsigned char ** data, int length, unsigned char ** outputs) {
+	
+	uint32_t state[5][CB_RIPEMD160_LANES], w[16][CB_RIPEMD160_LANES], wLeft[80][CB_RIPEMD160_LANES], wRight[80][CB_RIPEMD160_LANES];
+	uint32_t left[5][CB_RIPEMD160_LANES], right[5][CB_RIPEMD160_LANES];
+	for (int x = 0; x < 5; x++)
+		for (int l = 0; l < CB_RIPEMD160_LANES; l++)
+			state[x][l] = CBRipemd160Initial[x];
+	// The padding is as for SHA-256 but with the words and the length in little-endian.
+	int blocks = (length + 9 + 63) / 64;
+	uint64_t bits = (uint64_t)length * 8;
+	for (int b = 0; b < blocks; b++) {
+		int offset = b * 64;
+		for (int l = 0; l < CB_RIPEMD160_LANES; l++) {
+			unsigned char padded[64];
+			unsigned char * block = data[l] + offset;
+			if (offset + 64 > length) {
+				int remaining = length > offset ? length - offset : 0;
+				memcpy(padded, block, remaining);
+				memset(padded + remaining, 0, 64 - remaining);
+				if (length >= offset)
+					padded[remaining] = 0x80;
+				if (b == blocks - 1)
+					for (int x = 0; x < 8; x++)
+						padded[56 + x] = (unsigned char)(bits >> (x * 8));
+				block = padded;
+			}
+			for (int x = 0; x < 16; x++)
+				w[x][l] = block[x * 4] | (uint32_t)block[x * 4 + 1] << 8 | (uint32_t)block[x * 4 + 2] << 16 | (uint32_t)block[x * 4 + 3] << 24;
+		}
+		memcpy(left, state, sizeof(left));
+		memcpy(right, state, sizeof(right));
+		// Put the words in the order of the steps, so that the words of each step are read as vectors.
+		for (int x = 0; x < 80; x++) {
+			memcpy(wLeft[x], w[CBRipemd160RLeft[x]], sizeof(*w));
+			memcpy(wRight[x], w[CBRipemd160RRight[x]], sizeof(*w));
+		}
+		// Each round is called with a constant so that the functions are fixed and the lane loops are vectorised.
+		CBRipemd160Round(0, wLeft, wRight, left, right);
+		CBRipemd160Round(1, wLeft, wRight, left, right);
+		CBRipemd160Round(2, wLeft, wRight, left, right);
+		CBRipemd160Round(3, wLeft, wRight, left, right);
+		CBRipemd160Round(4, wLeft, wRight, left, right);
+		for (int l = 0; l < CB_RIPEMD160_LANES; l++) {
+			uint32_t t = state[1][l] + left[2][l] + right[3][l];
+			state[1][l] = state[2][l] + left[3][l] + right[4][l];
+			state[2][l] = state[3][l] + left[4][l] + right[0][l];
+			state[3][l] = state[4][l] + left[0][l] + right[1][l];
+			state[4][l] = state[0][l] + left[1][l] + right[2][l];
+			state[0][l] = t;
+		}
+	}
+	for (int l = 0; l < CB_RIPEMD160_LANES; l++)
+		for (int x = 0; x < 5; x++) {
+			outputs[l][x * 4] = (unsigned char)state[x][l];
+			outputs[l][x * 4 + 1] = (unsigned char)(state[x][l] >> 8);
+			outputs[l][x * 4 + 2] = (unsigned char)(state[x][l] >> 16);
+			outputs[l][x * 4 + 3] = (unsigned char)(state[x][l] >> 24);
+		}
+	
+}
+
 // Implementation
 
 void CBAddPoints(unsigned char * point1, unsigned char * point2) {
@@ -75,55 +331,137 @@ void CBKeyIncrementPubkey(unsigned char * pubKey) {
 
 }
 
-void CBKeyGetPublicKey(unsigned char * privKey, unsigned char * pubKey) {
+void CBSha160(unsigned char * data, int len, unsigned char * output) {
 	
-	BIGNUM * privBn = BN_bin2bn(privKey, CB_PRIVKEY_SIZE, NULL);
-	EC_GROUP * group = EC_GROUP_new_by_curve_name(NID_secp256k1);
-	EC_POINT * point = EC_POINT_new(group);
-	BN_CTX * ctx = BN_CTX_new();
+    SHA1(data, len, output);
 	
-	EC_POINT_mul(group, point, privBn, NULL, NULL, ctx);
-	EC_POINT_point2oct(group, point, POINT_CONVERSION_COMPRESSED, pubKey, CB_PUBKEY_SIZE, ctx);
+}
+
+void CBSha256(unsigned char * data, int len, unsigned char * output) {
 	
-	BN_CTX_free(ctx);
-	EC_POINT_free(point);
-	EC_GROUP_free(group);
-	BN_free(privBn);
+	SHA256(data, len, output);
 	
 }
 
-int CBKeySign(unsigned char * privKey, unsigned char * hash, unsigned char * signature) {
+void CBSha256Batch(unsigned char ** data, int length, int num, unsigned char * output) {
+	
+	for (int x = 0; x < num; x += CB_SHA256_LANES) {
+		if (num - x == 1) {
+			// A single message is faster alone.
+			SHA256(data[x], length, output + x * 32);
+			break;
+		}
+		// Fill unused lanes with the first message of this group and discard their hashes.
+		unsigned char * laneData[CB_SHA256_LANES], * laneOutputs[CB_SHA256_LANES];
+		unsigned char spare[CB_SHA256_LANES][32];
+		for (int l = 0; l < CB_SHA256_LANES; l++) {
+			bool used = x + l < num;
+			laneData[l] = data[used ? x + l : x];
+			laneOutputs[l] = used ? output + (x + l) * 32 : spare[l];
+		}
+		CBSha256Lanes(laneData, length, laneOutputs);
+	}
 	
-	unsigned int sigSize;
-	EC_KEY * key = EC_KEY_new_by_curve_name(NID_secp256k1);
-	BIGNUM * bn = BN_bin2bn(privKey, CB_PRIVKEY_SIZE, NULL);
+}
+
+void CBSha256Midstates(unsigned char * data, int blocks, unsigned char * midstates) {
 	
-	EC_KEY_set_private_key(key, bn);
-	ECDSA_sign(0, hash, CB_PRIVKEY_SIZE, signature, &sigSize, key);
+	SHA256_CTX ctx;
+	SHA256_Init(&ctx);
+	for (int x = 0; x < blocks; x++) {
+		SHA256_Update(&ctx, data + x * SHA256_CBLOCK, SHA256_CBLOCK);
+		memcpy(midstates + x * 32, ctx.h, 32);
+	}
 	
-	// Free key and BIGNUM
-	EC_KEY_free(key);
-	BN_free(bn);
+}
+
+void CBSha256FromMidstate(unsigned char * midstate, int blocks, unsigned char * data, int length, unsigned char * output) {
 	
-	return sigSize;
+	SHA256_CTX ctx;
+	SHA256_Init(&ctx);
+	if (blocks) {
+		// Continue from the state with the length of the blocks in bits.
+		uint64_t bits = (uint64_t)blocks * SHA256_CBLOCK * 8;
+		memcpy(ctx.h, midstate, 32);
+		ctx.Nl = (SHA_LONG)bits;
+		ctx.Nh = (SHA_LONG)(bits >> 32);
+	}
+	SHA256_Update(&ctx, data, length);
+	SHA256_Final(output, &ctx);
 	
 }
 
-void CBSha160(unsigned char * data, int len, unsigned char * output) {
+void CBSha512(unsigned char * data, int len, unsigned char * output) {
 	
-    SHA1(data, len, output);
+	SHA512(data, len, output);
 	
 }
 
-void CBSha256(unsigned char * data, int len, unsigned char * output) {
+void CBHmacSha512Midstate(unsigned char * key, int keyLen, unsigned char * midstate) {
 	
-	SHA256(data, len, output);
+	// Keys longer than the block are hashed first.
+	unsigned char block[SHA512_CBLOCK], pad[SHA512_CBLOCK];
+	memset(block, 0, SHA512_CBLOCK);
+	if (keyLen > SHA512_CBLOCK)
+		SHA512(key, keyLen, block);
+	else
+		memcpy(block, key, keyLen);
+	// Hash the inner and outer padded keys, keeping the states.
+	SHA512_CTX ctx;
+	for (int x = 0; x < 2; x++) {
+		for (int y = 0; y < SHA512_CBLOCK; y++)
+			pad[y] = block[y] ^ (x ? 0x5c : 0x36);
+		SHA512_Init(&ctx);
+		SHA512_Update(&ctx, pad, SHA512_CBLOCK);
+		memcpy(midstate + x * 64, ctx.h, 64);
+	}
 	
 }
 
-void CBSha512(unsigned char * data, int len, unsigned char * output) {
+void CBHmacSha512FromMidstate(unsigned char * midstate, unsigned char * data, int length, unsigned char * output) {
 	
-	SHA512(data, len, output);
+	SHA512_CTX ctx;
+	unsigned char inner[64];
+	// Continue from the inner state after one block of 1024 bits.
+	SHA512_Init(&ctx);
+	memcpy(ctx.h, midstate, 64);
+	ctx.Nl = SHA512_CBLOCK * 8;
+	SHA512_Update(&ctx, data, length);
+	SHA512_Final(inner, &ctx);
+	// Continue from the outer state.
+	SHA512_Init(&ctx);
+	memcpy(ctx.h, midstate + 64, 64);
+	ctx.Nl = SHA512_CBLOCK * 8;
+	SHA512_Update(&ctx, inner, 64);
+	SHA512_Final(output, &ctx);
+	
+}
+
+void CBHash160Batch(unsigned char ** data, int length, int num, unsigned char * output) {
+	
+	for (int x = 0; x < num; x += CB_SHA256_LANES) {
+		if (num - x == 1) {
+			// A single message is faster alone.
+			unsigned char hash[32];
+			SHA256(data[x], length, hash);
+			RIPEMD160(hash, 32, output + x * 20);
+			break;
+		}
+		// Fill unused lanes with the first message of this group and discard their hashes.
+		unsigned char * laneData[CB_SHA256_LANES], * laneOutputs[CB_SHA256_LANES];
+		unsigned char hashes[CB_SHA256_LANES][32], spare[CB_SHA256_LANES][20];
+		for (int l = 0; l < CB_SHA256_LANES; l++) {
+			laneData[l] = data[x + l < num ? x + l : x];
+			laneOutputs[l] = hashes[l];
+		}
+		CBSha256Lanes(laneData, length, laneOutputs);
+		// The SHA-256 hashes go straight into the RIPEMD-160 lanes.
+		for (int l = 0; l < CB_RIPEMD160_LANES; l++) {
+			laneData[l] = hashes[l];
+			laneOutputs[l] = x + l < num ? output + (x + l) * 20 : spare[l];
+		}
+		CBRipemd160Lanes(laneData, 32, laneOutputs);
+	}
 	
 }
 
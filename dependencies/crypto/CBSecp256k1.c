@@ -0,0 +1,1044 @@
+//
+//  CBSecp256k1.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+// Arithmetic on the secp256k1 curve for the batch key functions. Field elements are eight 32-bit limbs, least significant first, always reduced below p, so that every product fits into 64 bits. Points are added in Jacobian coordinates and many points are converted to affine coordinates together with one field inversion (Montgomery's trick).
+// Multiplication of the generator uses a fixed-base table with a row of 16 points for each 4-bit window of the scalar. Each entry has an offset added so that no entry is the point at infinity, with the offsets of all rows summing to zero. Every window then adds a point selected by scanning the whole row, so that the operations do not depend on the scalar.
+// Signing uses the same table for the nonce point, with nonces from RFC 6979 so that signatures are deterministic. Scalars modulo the order n are also eight 32-bit limbs, and a batch of signatures shares one field inversion for the nonce points and one scalar inversion for the nonces.
+
+// Includes
+
+#include "CBDependencies.h" // cbitcoin dependencies to implement
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Constants and Macros
+
+#define CB_SECP256K1_WINDOWS 64 // The number of 4-bit windows in a scalar.
+#define CB_FIELD_C_LOW 0x3D1 // p = 2^256 - 2^32 - 0x3D1, so 2^256 is 2^32 + 0x3D1 modulo p.
+#define CB_SECP256K1_MULTIPLES 1024 // The number of consecutive multiples of the generator kept for stepping public keys.
+#define CB_SECP256K1_SIGN_BATCH 256 // The number of signatures made together by CBKeySignBatch.
+
+// Structures
+
+typedef struct{
+	uint32_t n[8];
+} CBFieldElement;
+
+typedef struct{
+	uint32_t n[8];
+} CBScalar;
+
+typedef struct{
+	unsigned char k[32];
+	unsigned char v[32];
+} CBRFC6979State;
+
+typedef struct{
+	CBFieldElement x;
+	CBFieldElement y;
+	bool infinity;
+} CBAffinePoint;
+
+typedef struct{
+	CBFieldElement x;
+	CBFieldElement y;
+	CBFieldElement z;
+	bool infinity;
+} CBJacobianPoint;
+
+static const CBAffinePoint CBSecp256k1G = {
+	{{0x16F81798, 0x59F2815B, 0x2DCE28D9, 0x029BFCDB, 0xCE870B07, 0x55A06295, 0xF9DCBBAC, 0x79BE667E}},
+	{{0xFB10D4B8, 0x9C47D08F, 0xA6855419, 0xFD17B448, 0x0E1108A8, 0x5DA4FBFC, 0x26A3C465, 0x483ADA77}},
+	false
+};
+
+static const CBScalar CBSecp256k1N = {{0xD0364141, 0xBFD25E8C, 0xAF48A03B, 0xBAAEDCE6, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}};
+static const CBScalar CBSecp256k1HalfN = {{0x681B20A0, 0xDFE92F46, 0x57A4501D, 0x5D576E73, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF}};
+// 2^256 - n, which is 129 bits.
+static const uint32_t CBSecp256k1NC[5] = {0x2FC9BEBF, 0x402DA173, 0x50B75FC4, 0x45512319, 0x1};
+
+static CBAffinePoint CBSecp256k1Table[CB_SECP256K1_WINDOWS][16];
+static pthread_once_t CBSecp256k1TableOnce = PTHREAD_ONCE_INIT;
+static CBAffinePoint CBSecp256k1Multiples[CB_SECP256K1_MULTIPLES];
+static pthread_once_t CBSecp256k1MultiplesOnce = PTHREAD_ONCE_INIT;
+
+// Field functions
+
+/**
+ @brief Adds two field elements.
+ */
+static void CBFieldAdd(CBFieldElement * r, const CBFieldElement * a, const CBFieldElement * b);
+/**
+ @brief Adds a small value to the limbs, returning the carry out of the most significant limb.
+ */
+static uint32_t CBFieldAddSmall(CBFieldElement * r, uint64_t low, uint64_t high);
+/**
+ @brief Determines if two field elements are equal.
+ */
+static bool CBFieldEqual(const CBFieldElement * a, const CBFieldElement * b);
+/**
+ @brief Reads a field element from 32 big-endian bytes.
+ @returns false if the number is not below p.
+ */
+static bool CBFieldFromBytes(CBFieldElement * r, const unsigned char * bytes);
+/**
+ @brief Inverts a field element by raising it to p - 2.
+ */
+static void CBFieldInverse(CBFieldElement * r, const CBFieldElement * a);
+/**
+ @brief Determines if a field element is zero.
+ */
+static bool CBFieldIsZero(const CBFieldElement * a);
+/**
+ @brief Multiplies two field elements.
+ */
+static void CBFieldMul(CBFieldElement * r, const CBFieldElement * a, const CBFieldElement * b);
+/**
+ @brief Negates a field element.
+ */
+static void CBFieldNegate(CBFieldElement * r, const CBFieldElement * a);
+/**
+ @brief Subtracts p from a number which is below 2^256 if it is not below p.
+ */
+static void CBFieldNormalise(CBFieldElement * r);
+/**
+ @brief Squares a field element a number of times.
+ */
+static void CBFieldSqrN(CBFieldElement * r, const CBFieldElement * a, int times);
+/**
+ @brief Finds a square root of a field element by raising it to (p + 1)/4.
+ @returns false if the element has no square root.
+ */
+static bool CBFieldSqrt(CBFieldElement * r, const CBFieldElement * a);
+/**
+ @brief Subtracts a field element from another.
+ */
+static void CBFieldSub(CBFieldElement * r, const CBFieldElement * a, const CBFieldElement * b);
+/**
+ @brief Writes a field element as 32 big-endian bytes.
+ */
+static void CBFieldToBytes(const CBFieldElement * a, unsigned char * bytes);
+
+// Point functions
+
+/**
+ @brief Adds an affine point to a Jacobian point.
+ */
+static void CBSecp256k1AddAffine(CBJacobianPoint * r, const CBJacobianPoint * a, const CBAffinePoint * b);
+/**
+ @brief Adds two Jacobian points.
+ */
+static void CBSecp256k1AddJacobian(CBJacobianPoint * r, const CBJacobianPoint * a, const CBJacobianPoint * b);
+/**
+ @brief Adds the multiples G to num G of the generator to an affine point, with affine additions sharing one field inversion.
+ @param a The point.
+ @param num The number of multiples, up to CB_SECP256K1_MULTIPLES.
+ @param r The sums are written here.
+ */
+static void CBSecp256k1AddMultiples(const CBAffinePoint * a, int num, CBAffinePoint * r);
+/**
+ @brief Builds the table of the multiples G to CB_SECP256K1_MULTIPLES G of the generator.
+ */
+static void CBSecp256k1BuildMultiples(void);
+/**
+ @brief Builds the fixed-base table for the generator.
+ */
+static void CBSecp256k1BuildTable(void);
+/**
+ @brief Doubles a Jacobian point.
+ */
+static void CBSecp256k1Double(CBJacobianPoint * r, const CBJacobianPoint * a);
+/**
+ @brief Multiplies the generator by a scalar.
+ @param r The product.
+ @param scalar The 32-byte big-endian scalar.
+ */
+static void CBSecp256k1MultiplyG(CBJacobianPoint * r, const unsigned char * scalar);
+/**
+ @brief Reads a 33-byte compressed public key.
+ @returns false if the public key is not a point on the curve.
+ */
+static bool CBSecp256k1ParsePublicKey(CBAffinePoint * r, const unsigned char * pubKey);
+/**
+ @brief Writes a point as a 33-byte compressed public key, or zero bytes for the point at infinity.
+ */
+static void CBSecp256k1SerialisePublicKey(const CBAffinePoint * a, unsigned char * pubKey);
+/**
+ @brief Converts Jacobian points to affine points with a single field inversion.
+ @param points The Jacobian points.
+ @param affine The affine points are written here.
+ @param num The number of points.
+ */
+static void CBSecp256k1ToAffine(const CBJacobianPoint * points, CBAffinePoint * affine, int num);
+
+// Scalar functions
+
+/**
+ @brief Adds two scalars modulo n.
+ */
+static void CBScalarAdd(CBScalar * r, const CBScalar * a, const CBScalar * b);
+/**
+ @brief Replaces the high limbs of a number with their product with 2^256 - n, giving a smaller number equal modulo n.
+ @param t The limbs of the number, least significant first.
+ @param num The number of limbs in t.
+ @param r The result is written here.
+ @param rNum The number of limbs for r, enough for the result.
+ */
+static void CBScalarFold(const uint32_t * t, int num, uint32_t * r, int rNum);
+/**
+ @brief Reads a scalar from 32 big-endian bytes, reducing it modulo n.
+ @returns true if the number was below n, false if it was reduced.
+ */
+static bool CBScalarFromBytes(CBScalar * r, const unsigned char * bytes);
+/**
+ @brief Inverts a non-zero scalar by raising it to n - 2.
+ */
+static void CBScalarInverse(CBScalar * r, const CBScalar * a);
+/**
+ @brief Determines if a scalar is zero.
+ */
+static bool CBScalarIsZero(const CBScalar * a);
+/**
+ @brief Multiplies two scalars modulo n.
+ */
+static void CBScalarMul(CBScalar * r, const CBScalar * a, const CBScalar * b);
+/**
+ @brief Subtracts n from a number which is below 2^256 if it is not below n, or from n - 1 the number if it is above n/2 and low is true.
+ @param r The number.
+ @param low If true replace numbers above n/2 with their negation.
+ @returns true if the number was reduced or negated.
+ */
+static bool CBScalarNormalise(CBScalar * r, bool low);
+/**
+ @brief Writes a scalar as 32 big-endian bytes.
+ */
+static void CBScalarToBytes(const CBScalar * a, unsigned char * bytes);
+
+// Signing functions
+
+/**
+ @brief Writes a DER signature from r and s.
+ @param r The r value.
+ @param s The s value.
+ @param signature The signature is written here, up to 72 bytes.
+ @returns The length of the signature.
+ */
+static int CBSecp256k1EncodeSignature(const CBScalar * r, const CBScalar * s, unsigned char * signature);
+/**
+ @brief Makes a HMAC-SHA256 of up to 97 bytes of data.
+ @param key The 32-byte key.
+ @param data The data.
+ @param length The length of the data.
+ @param output The 32-byte HMAC is written here.
+ */
+static void CBSecp256k1HmacSha256(const unsigned char * key, const unsigned char * data, int length, unsigned char * output);
+/**
+ @brief Starts the RFC 6979 generation of nonces for a private key and hash.
+ @param state The state to start.
+ @param privKey The 32-byte private key, below n.
+ @param hash The 32-byte hash, reduced modulo n.
+ */
+static void CBSecp256k1NonceInit(CBRFC6979State * state, const unsigned char * privKey, const unsigned char * hash);
+/**
+ @brief Gets the next RFC 6979 nonce.
+ @param state The state.
+ @param first true for the first nonce, when the state does not need updating after a rejected nonce.
+ @param nonce The nonce, which is not zero and below n.
+ */
+static void CBSecp256k1NonceNext(CBRFC6979State * state, bool first, CBScalar * nonce);
+/**
+ @brief Signs a hash, trying the nonces in turn as for each nonce in a batch failing.
+ @param privKey The private key, not zero and below n.
+ @param z The hash as a scalar.
+ @param state The nonce state after the first nonce.
+ @param signature The signature is written here.
+ @returns The length of the signature.
+ */
+static int CBSecp256k1SignRetry(const CBScalar * privKey, const CBScalar * z, CBRFC6979State * state, unsigned char * signature);
+
+static void CBFieldAdd(CBFieldElement * r, const CBFieldElement * a, const CBFieldElement * b){
+	uint64_t acc = 0;
+	for (int x = 0; x < 8; x++) {
+		acc += (uint64_t)a->n[x] + b->n[x];
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	// Past 2^256, so subtract p by adding 2^256 - p, using a mask so that there is no branch. The result is then below p and is not changed by CBFieldNormalise.
+	uint32_t mask = -(uint32_t)acc;
+	CBFieldAddSmall(r, CB_FIELD_C_LOW & mask, 1 & mask);
+	CBFieldNormalise(r);
+}
+static uint32_t CBFieldAddSmall(CBFieldElement * r, uint64_t low, uint64_t high){
+	uint64_t acc = (uint64_t)r->n[0] + low;
+	r->n[0] = (uint32_t)acc;
+	acc = (acc >> 32) + r->n[1] + high;
+	r->n[1] = (uint32_t)acc;
+	acc >>= 32;
+	for (int x = 2; x < 8; x++) {
+		acc += r->n[x];
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	return (uint32_t)acc;
+}
+static bool CBFieldEqual(const CBFieldElement * a, const CBFieldElement * b){
+	uint32_t diff = 0;
+	for (int x = 0; x < 8; x++)
+		diff |= a->n[x] ^ b->n[x];
+	return ! diff;
+}
+static bool CBFieldFromBytes(CBFieldElement * r, const unsigned char * bytes){
+	for (int x = 0; x < 8; x++)
+		r->n[x] = (uint32_t)bytes[31 - x * 4] | (uint32_t)bytes[30 - x * 4] << 8 | (uint32_t)bytes[29 - x * 4] << 16 | (uint32_t)bytes[28 - x * 4] << 24;
+	CBFieldElement copy = *r;
+	CBFieldNormalise(r);
+	return CBFieldEqual(r, &copy);
+}
+static void CBFieldInverse(CBFieldElement * r, const CBFieldElement * a){
+	// The binary form of p - 2 has runs of ones of lengths 223, 22, 2 and 1, which are built from x2 = a^(2^2 - 1) and so on.
+	CBFieldElement x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t;
+	CBFieldSqrN(&x2, a, 1);
+	CBFieldMul(&x2, &x2, a);
+	CBFieldSqrN(&x3, &x2, 1);
+	CBFieldMul(&x3, &x3, a);
+	CBFieldSqrN(&x6, &x3, 3);
+	CBFieldMul(&x6, &x6, &x3);
+	CBFieldSqrN(&x9, &x6, 3);
+	CBFieldMul(&x9, &x9, &x3);
+	CBFieldSqrN(&x11, &x9, 2);
+	CBFieldMul(&x11, &x11, &x2);
+	CBFieldSqrN(&x22, &x11, 11);
+	CBFieldMul(&x22, &x22, &x11);
+	CBFieldSqrN(&x44, &x22, 22);
+	CBFieldMul(&x44, &x44, &x22);
+	CBFieldSqrN(&x88, &x44, 44);
+	CBFieldMul(&x88, &x88, &x44);
+	CBFieldSqrN(&x176, &x88, 88);
+	CBFieldMul(&x176, &x176, &x88);
+	CBFieldSqrN(&x220, &x176, 44);
+	CBFieldMul(&x220, &x220, &x44);
+	CBFieldSqrN(&x223, &x220, 3);
+	CBFieldMul(&x223, &x223, &x3);
+	CBFieldSqrN(&t, &x223, 23);
+	CBFieldMul(&t, &t, &x22);
+	CBFieldSqrN(&t, &t, 5);
+	CBFieldMul(&t, &t, a);
+	CBFieldSqrN(&t, &t, 3);
+	CBFieldMul(&t, &t, &x2);
+	CBFieldSqrN(&t, &t, 2);
+	CBFieldMul(r, &t, a);
+}
+static bool CBFieldIsZero(const CBFieldElement * a){
+	uint32_t bits = 0;
+	for (int x = 0; x < 8; x++)
+		bits |= a->n[x];
+	return ! bits;
+}
+static void CBFieldMul(CBFieldElement * r, const CBFieldElement * a, const CBFieldElement * b){
+	uint32_t t[16];
+	memset(t, 0, sizeof(t));
+	for (int x = 0; x < 8; x++) {
+		uint64_t carry = 0;
+		for (int y = 0; y < 8; y++) {
+			uint64_t v = (uint64_t)a->n[x] * b->n[y] + t[x + y] + carry;
+			t[x + y] = (uint32_t)v;
+			carry = v >> 32;
+		}
+		t[x + 8] = (uint32_t)carry;
+	}
+	// Reduce the high half by multiplying it by 2^32 + 0x3D1 and adding it to the low half.
+	uint64_t acc = 0;
+	for (int x = 0; x < 8; x++) {
+		acc += (uint64_t)t[x] + (uint64_t)t[x + 8] * CB_FIELD_C_LOW + (x ? t[x + 7] : 0);
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	acc += t[15];
+	// Fold the remaining carry, which is under 2^34, and then any carry from that, using a mask so that there is no branch.
+	uint32_t mask = -CBFieldAddSmall(r, acc * CB_FIELD_C_LOW, acc);
+	CBFieldAddSmall(r, CB_FIELD_C_LOW & mask, 1 & mask);
+	CBFieldNormalise(r);
+}
+static void CBFieldNegate(CBFieldElement * r, const CBFieldElement * a){
+	CBFieldElement zero;
+	memset(&zero, 0, sizeof(zero));
+	CBFieldSub(r, &zero, a);
+}
+static void CBFieldNormalise(CBFieldElement * r){
+	// r is at least p when adding 2^256 - p carries out.
+	CBFieldElement t = *r;
+	uint32_t mask = -CBFieldAddSmall(&t, CB_FIELD_C_LOW, 1);
+	for (int x = 0; x < 8; x++)
+		r->n[x] = (t.n[x] & mask) | (r->n[x] & ~mask);
+}
+static void CBFieldSqrN(CBFieldElement * r, const CBFieldElement * a, int times){
+	CBFieldMul(r, a, a);
+	for (int x = 1; x < times; x++)
+		CBFieldMul(r, r, r);
+}
+static bool CBFieldSqrt(CBFieldElement * r, const CBFieldElement * a){
+	// (p + 1)/4 has runs of ones of lengths 223 and 22 followed by 0b1100.
+	CBFieldElement x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t, check;
+	CBFieldSqrN(&x2, a, 1);
+	CBFieldMul(&x2, &x2, a);
+	CBFieldSqrN(&x3, &x2, 1);
+	CBFieldMul(&x3, &x3, a);
+	CBFieldSqrN(&x6, &x3, 3);
+	CBFieldMul(&x6, &x6, &x3);
+	CBFieldSqrN(&x9, &x6, 3);
+	CBFieldMul(&x9, &x9, &x3);
+	CBFieldSqrN(&x11, &x9, 2);
+	CBFieldMul(&x11, &x11, &x2);
+	CBFieldSqrN(&x22, &x11, 11);
+	CBFieldMul(&x22, &x22, &x11);
+	CBFieldSqrN(&x44, &x22, 22);
+	CBFieldMul(&x44, &x44, &x22);
+	CBFieldSqrN(&x88, &x44, 44);
+	CBFieldMul(&x88, &x88, &x44);
+	CBFieldSqrN(&x176, &x88, 88);
+	CBFieldMul(&x176, &x176, &x88);
+	CBFieldSqrN(&x220, &x176, 44);
+	CBFieldMul(&x220, &x220, &x44);
+	CBFieldSqrN(&x223, &x220, 3);
+	CBFieldMul(&x223, &x223, &x3);
+	CBFieldSqrN(&t, &x223, 23);
+	CBFieldMul(&t, &t, &x22);
+	CBFieldSqrN(&t, &t, 6);
+	CBFieldMul(&t, &t, &x2);
+	CBFieldSqrN(r, &t, 2);
+	CBFieldSqrN(&check, r, 1);
+	return CBFieldEqual(&check, a);
+}
+static void CBFieldSub(CBFieldElement * r, const CBFieldElement * a, const CBFieldElement * b){
+	int64_t acc = 0;
+	for (int x = 0; x < 8; x++) {
+		acc += (int64_t)a->n[x] - b->n[x];
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	// Below zero when the borrow is -1, so add p by subtracting 2^256 - p, using a mask so that there is no branch.
+	uint32_t mask = (uint32_t)acc;
+	acc = (int64_t)r->n[0] - (CB_FIELD_C_LOW & mask);
+	r->n[0] = (uint32_t)acc;
+	acc = (acc >> 32) + r->n[1] - (1 & mask);
+	r->n[1] = (uint32_t)acc;
+	acc >>= 32;
+	for (int x = 2; x < 8; x++) {
+		acc += r->n[x];
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+}
+static void CBFieldToBytes(const CBFieldElement * a, unsigned char * bytes){
+	for (int x = 0; x < 8; x++) {
+		bytes[31 - x * 4] = (unsigned char)a->n[x];
+		bytes[30 - x * 4] = (unsigned char)(a->n[x] >> 8);
+		bytes[29 - x * 4] = (unsigned char)(a->n[x] >> 16);
+		bytes[28 - x * 4] = (unsigned char)(a->n[x] >> 24);
+	}
+}
+
+static void CBSecp256k1AddAffine(CBJacobianPoint * r, const CBJacobianPoint * a, const CBAffinePoint * b){
+	if (b->infinity) {
+		*r = *a;
+		return;
+	}
+	if (a->infinity) {
+		r->x = b->x;
+		r->y = b->y;
+		memset(&r->z, 0, sizeof(r->z));
+		r->z.n[0] = 1;
+		r->infinity = false;
+		return;
+	}
+	CBFieldElement z1z1, u2, s2, h, rr, hh, hhh, v, t;
+	CBFieldMul(&z1z1, &a->z, &a->z);
+	CBFieldMul(&u2, &b->x, &z1z1);
+	CBFieldMul(&s2, &b->y, &a->z);
+	CBFieldMul(&s2, &s2, &z1z1);
+	CBFieldSub(&h, &u2, &a->x);
+	CBFieldSub(&rr, &s2, &a->y);
+	if (CBFieldIsZero(&h)) {
+		if (CBFieldIsZero(&rr))
+			CBSecp256k1Double(r, a);
+		else
+			r->infinity = true;
+		return;
+	}
+	CBFieldMul(&hh, &h, &h);
+	CBFieldMul(&hhh, &h, &hh);
+	CBFieldMul(&v, &a->x, &hh);
+	CBJacobianPoint res;
+	// x3 = r^2 - h^3 - 2v
+	CBFieldMul(&res.x, &rr, &rr);
+	CBFieldSub(&res.x, &res.x, &hhh);
+	CBFieldSub(&res.x, &res.x, &v);
+	CBFieldSub(&res.x, &res.x, &v);
+	// y3 = r(v - x3) - y1 h^3
+	CBFieldSub(&t, &v, &res.x);
+	CBFieldMul(&res.y, &rr, &t);
+	CBFieldMul(&t, &a->y, &hhh);
+	CBFieldSub(&res.y, &res.y, &t);
+	// z3 = z1 h
+	CBFieldMul(&res.z, &a->z, &h);
+	res.infinity = false;
+	*r = res;
+}
+static void CBSecp256k1AddJacobian(CBJacobianPoint * r, const CBJacobianPoint * a, const CBJacobianPoint * b){
+	if (a->infinity) {
+		*r = *b;
+		return;
+	}
+	if (b->infinity) {
+		*r = *a;
+		return;
+	}
+	CBFieldElement z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t;
+	CBFieldMul(&z1z1, &a->z, &a->z);
+	CBFieldMul(&z2z2, &b->z, &b->z);
+	CBFieldMul(&u1, &a->x, &z2z2);
+	CBFieldMul(&u2, &b->x, &z1z1);
+	CBFieldMul(&s1, &a->y, &b->z);
+	CBFieldMul(&s1, &s1, &z2z2);
+	CBFieldMul(&s2, &b->y, &a->z);
+	CBFieldMul(&s2, &s2, &z1z1);
+	CBFieldSub(&h, &u2, &u1);
+	CBFieldSub(&rr, &s2, &s1);
+	if (CBFieldIsZero(&h)) {
+		if (CBFieldIsZero(&rr))
+			CBSecp256k1Double(r, a);
+		else
+			r->infinity = true;
+		return;
+	}
+	CBFieldMul(&hh, &h, &h);
+	CBFieldMul(&hhh, &h, &hh);
+	CBFieldMul(&v, &u1, &hh);
+	CBJacobianPoint res;
+	CBFieldMul(&res.x, &rr, &rr);
+	CBFieldSub(&res.x, &res.x, &hhh);
+	CBFieldSub(&res.x, &res.x, &v);
+	CBFieldSub(&res.x, &res.x, &v);
+	CBFieldSub(&t, &v, &res.x);
+	CBFieldMul(&res.y, &rr, &t);
+	CBFieldMul(&t, &s1, &hhh);
+	CBFieldSub(&res.y, &res.y, &t);
+	CBFieldMul(&res.z, &a->z, &b->z);
+	CBFieldMul(&res.z, &res.z, &h);
+	res.infinity = false;
+	*r = res;
+}
+static void CBSecp256k1AddMultiples(const CBAffinePoint * a, int num, CBAffinePoint * r){
+	pthread_once(&CBSecp256k1MultiplesOnce, CBSecp256k1BuildMultiples);
+	if (a->infinity) {
+		memcpy(r, CBSecp256k1Multiples, sizeof(*r) * num);
+		return;
+	}
+	// Keep the products of the x differences before each sum, invert the product of all of them, and work backwards.
+	CBFieldElement * products = malloc(sizeof(*products) * num);
+	CBFieldElement acc, inverse, d, dInv, lambda, t;
+	memset(&acc, 0, sizeof(acc));
+	acc.n[0] = 1;
+	for (int x = 0; x < num; x++) {
+		products[x] = acc;
+		CBFieldSub(&d, &CBSecp256k1Multiples[x].x, &a->x);
+		if (! CBFieldIsZero(&d))
+			CBFieldMul(&acc, &acc, &d);
+	}
+	CBFieldInverse(&inverse, &acc);
+	for (int x = num; x--;) {
+		const CBAffinePoint * b = CBSecp256k1Multiples + x;
+		CBFieldSub(&d, &b->x, &a->x);
+		if (CBFieldIsZero(&d)) {
+			// The point is the multiple or its negation, so the affine formula does not apply.
+			CBJacobianPoint j = {a->x, a->y, {{1}}, false};
+			CBSecp256k1AddAffine(&j, &j, b);
+			CBSecp256k1ToAffine(&j, r + x, 1);
+			continue;
+		}
+		CBFieldMul(&dInv, &inverse, &products[x]);
+		CBFieldMul(&inverse, &inverse, &d);
+		// lambda = (y2 - y1) / (x2 - x1), x3 = lambda^2 - x1 - x2, y3 = lambda (x1 - x3) - y1
+		CBFieldSub(&lambda, &b->y, &a->y);
+		CBFieldMul(&lambda, &lambda, &dInv);
+		CBFieldMul(&r[x].x, &lambda, &lambda);
+		CBFieldSub(&r[x].x, &r[x].x, &a->x);
+		CBFieldSub(&r[x].x, &r[x].x, &b->x);
+		CBFieldSub(&t, &a->x, &r[x].x);
+		CBFieldMul(&r[x].y, &lambda, &t);
+		CBFieldSub(&r[x].y, &r[x].y, &a->y);
+		r[x].infinity = false;
+	}
+	free(products);
+}
+static void CBSecp256k1BuildMultiples(void){
+	CBJacobianPoint * points = malloc(sizeof(*points) * CB_SECP256K1_MULTIPLES);
+	CBJacobianPoint g = {CBSecp256k1G.x, CBSecp256k1G.y, {{1}}, false};
+	points[0] = g;
+	for (int x = 1; x < CB_SECP256K1_MULTIPLES; x++)
+		CBSecp256k1AddAffine(&points[x], &points[x - 1], &CBSecp256k1G);
+	CBSecp256k1ToAffine(points, CBSecp256k1Multiples, CB_SECP256K1_MULTIPLES);
+	free(points);
+}
+static void CBSecp256k1BuildTable(void){
+	// Find an offset point with an unknown discrete logarithm from a hash.
+	unsigned char seed[32];
+	CBSha256((unsigned char *)"cbitcoin secp256k1 table offset", 31, seed);
+	CBAffinePoint offsetAffine;
+	CBFieldElement seven, rhs;
+	memset(&seven, 0, sizeof(seven));
+	seven.n[0] = 7;
+	for (;;) {
+		if (CBFieldFromBytes(&offsetAffine.x, seed)) {
+			CBFieldMul(&rhs, &offsetAffine.x, &offsetAffine.x);
+			CBFieldMul(&rhs, &rhs, &offsetAffine.x);
+			CBFieldAdd(&rhs, &rhs, &seven);
+			if (CBFieldSqrt(&offsetAffine.y, &rhs))
+				break;
+		}
+		for (int x = 32; x-- && ! ++seed[x];);
+	}
+	offsetAffine.infinity = false;
+	CBJacobianPoint base, offset, offsetSum, start;
+	base.infinity = offset.infinity = offsetSum.infinity = start.infinity = true;
+	CBSecp256k1AddAffine(&base, &base, &CBSecp256k1G);
+	CBSecp256k1AddAffine(&offset, &offset, &offsetAffine);
+	CBJacobianPoint * points = malloc(sizeof(*points) * CB_SECP256K1_WINDOWS * 16);
+	for (int x = 0; x < CB_SECP256K1_WINDOWS; x++) {
+		// Row x has j * 16^x * G plus 2^x times the offset point, and the last row cancels the offsets of the others.
+		if (x == CB_SECP256K1_WINDOWS - 1) {
+			start = offsetSum;
+			CBFieldNegate(&start.y, &start.y);
+		}else{
+			start = offset;
+			CBSecp256k1AddJacobian(&offsetSum, &offsetSum, &offset);
+			CBSecp256k1Double(&offset, &offset);
+		}
+		points[x * 16] = start;
+		for (int y = 1; y < 16; y++)
+			CBSecp256k1AddJacobian(&points[x * 16 + y], &points[x * 16 + y - 1], &base);
+		for (int y = 0; y < 4; y++)
+			CBSecp256k1Double(&base, &base);
+	}
+	CBSecp256k1ToAffine(points, &CBSecp256k1Table[0][0], CB_SECP256K1_WINDOWS * 16);
+	free(points);
+}
+static void CBSecp256k1Double(CBJacobianPoint * r, const CBJacobianPoint * a){
+	if (a->infinity || CBFieldIsZero(&a->y)) {
+		r->infinity = true;
+		return;
+	}
+	CBFieldElement yy, s, m, t, yyyy;
+	CBJacobianPoint res;
+	// s = 4xy^2, m = 3x^2
+	CBFieldMul(&yy, &a->y, &a->y);
+	CBFieldMul(&s, &a->x, &yy);
+	CBFieldAdd(&s, &s, &s);
+	CBFieldAdd(&s, &s, &s);
+	CBFieldMul(&t, &a->x, &a->x);
+	CBFieldAdd(&m, &t, &t);
+	CBFieldAdd(&m, &m, &t);
+	// x3 = m^2 - 2s
+	CBFieldMul(&res.x, &m, &m);
+	CBFieldSub(&res.x, &res.x, &s);
+	CBFieldSub(&res.x, &res.x, &s);
+	// y3 = m(s - x3) - 8y^4
+	CBFieldMul(&yyyy, &yy, &yy);
+	CBFieldAdd(&yyyy, &yyyy, &yyyy);
+	CBFieldAdd(&yyyy, &yyyy, &yyyy);
+	CBFieldAdd(&yyyy, &yyyy, &yyyy);
+	CBFieldSub(&t, &s, &res.x);
+	CBFieldMul(&res.y, &m, &t);
+	CBFieldSub(&res.y, &res.y, &yyyy);
+	// z3 = 2yz
+	CBFieldMul(&res.z, &a->y, &a->z);
+	CBFieldAdd(&res.z, &res.z, &res.z);
+	res.infinity = false;
+	*r = res;
+}
+static void CBSecp256k1MultiplyG(CBJacobianPoint * r, const unsigned char * scalar){
+	pthread_once(&CBSecp256k1TableOnce, CBSecp256k1BuildTable);
+	r->infinity = true;
+	for (int x = 0; x < CB_SECP256K1_WINDOWS; x++) {
+		uint32_t digit = scalar[31 - x / 2] >> (x % 2 * 4) & 0xF;
+		CBAffinePoint entry;
+		memset(&entry, 0, sizeof(entry));
+		for (uint32_t y = 0; y < 16; y++) {
+			uint32_t mask = -(uint32_t)(y == digit);
+			for (int z = 0; z < 8; z++) {
+				entry.x.n[z] |= CBSecp256k1Table[x][y].x.n[z] & mask;
+				entry.y.n[z] |= CBSecp256k1Table[x][y].y.n[z] & mask;
+			}
+		}
+		CBSecp256k1AddAffine(r, r, &entry);
+	}
+}
+static bool CBSecp256k1ParsePublicKey(CBAffinePoint * r, const unsigned char * pubKey){
+	if ((pubKey[0] != 2 && pubKey[0] != 3) || ! CBFieldFromBytes(&r->x, pubKey + 1))
+		return false;
+	CBFieldElement rhs, seven;
+	memset(&seven, 0, sizeof(seven));
+	seven.n[0] = 7;
+	CBFieldMul(&rhs, &r->x, &r->x);
+	CBFieldMul(&rhs, &rhs, &r->x);
+	CBFieldAdd(&rhs, &rhs, &seven);
+	if (! CBFieldSqrt(&r->y, &rhs))
+		return false;
+	if ((r->y.n[0] & 1) != (pubKey[0] & 1))
+		CBFieldNegate(&r->y, &r->y);
+	r->infinity = false;
+	return true;
+}
+static void CBSecp256k1SerialisePublicKey(const CBAffinePoint * a, unsigned char * pubKey){
+	if (a->infinity) {
+		memset(pubKey, 0, CB_PUBKEY_SIZE);
+		return;
+	}
+	pubKey[0] = 2 | (a->y.n[0] & 1);
+	CBFieldToBytes(&a->x, pubKey + 1);
+}
+static void CBSecp256k1ToAffine(const CBJacobianPoint * points, CBAffinePoint * affine, int num){
+	// Keep the products of the z coordinates before each point, invert the product of all of them, and work backwards.
+	CBFieldElement * products = malloc(sizeof(*products) * num);
+	CBFieldElement acc, inverse, zInv, zInv2;
+	memset(&acc, 0, sizeof(acc));
+	acc.n[0] = 1;
+	for (int x = 0; x < num; x++) {
+		products[x] = acc;
+		if (! points[x].infinity)
+			CBFieldMul(&acc, &acc, &points[x].z);
+	}
+	CBFieldInverse(&inverse, &acc);
+	for (int x = num; x--;) {
+		affine[x].infinity = points[x].infinity;
+		if (points[x].infinity)
+			continue;
+		CBFieldMul(&zInv, &inverse, &products[x]);
+		CBFieldMul(&inverse, &inverse, &points[x].z);
+		CBFieldMul(&zInv2, &zInv, &zInv);
+		CBFieldMul(&affine[x].x, &points[x].x, &zInv2);
+		CBFieldMul(&zInv2, &zInv2, &zInv);
+		CBFieldMul(&affine[x].y, &points[x].y, &zInv2);
+	}
+	free(products);
+}
+
+static void CBScalarAdd(CBScalar * r, const CBScalar * a, const CBScalar * b){
+	uint64_t acc = 0;
+	for (int x = 0; x < 8; x++) {
+		acc += (uint64_t)a->n[x] + b->n[x];
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	// Past 2^256, so subtract n by adding 2^256 - n, which cannot carry again.
+	uint32_t mask = -(uint32_t)acc;
+	acc = 0;
+	for (int x = 0; x < 8; x++) {
+		acc += (uint64_t)r->n[x] + (x < 5 ? CBSecp256k1NC[x] & mask : 0);
+		r->n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	CBScalarNormalise(r, false);
+}
+static void CBScalarFold(const uint32_t * t, int num, uint32_t * r, int rNum){
+	memset(r, 0, rNum * sizeof(*r));
+	memcpy(r, t, 8 * sizeof(*r));
+	for (int x = 8; x < num; x++) {
+		uint64_t carry = 0;
+		for (int y = 0; y < 5; y++) {
+			uint64_t v = (uint64_t)t[x] * CBSecp256k1NC[y] + r[x - 8 + y] + carry;
+			r[x - 8 + y] = (uint32_t)v;
+			carry = v >> 32;
+		}
+		for (int y = x - 3; y < rNum; y++) {
+			uint64_t v = (uint64_t)r[y] + carry;
+			r[y] = (uint32_t)v;
+			carry = v >> 32;
+		}
+	}
+}
+static bool CBScalarFromBytes(CBScalar * r, const unsigned char * bytes){
+	for (int x = 0; x < 8; x++)
+		r->n[x] = (uint32_t)bytes[31 - x * 4] | (uint32_t)bytes[30 - x * 4] << 8 | (uint32_t)bytes[29 - x * 4] << 16 | (uint32_t)bytes[28 - x * 4] << 24;
+	return ! CBScalarNormalise(r, false);
+}
+static void CBScalarInverse(CBScalar * r, const CBScalar * a){
+	// Use 4-bit windows of n - 2, which is public, with a table of the powers a^0 to a^15.
+	CBScalar powers[16], exponent = CBSecp256k1N;
+	exponent.n[0] -= 2;
+	memset(&powers[0], 0, sizeof(powers[0]));
+	powers[0].n[0] = 1;
+	for (int x = 1; x < 16; x++)
+		CBScalarMul(&powers[x], &powers[x - 1], a);
+	*r = powers[0];
+	for (int x = 64; x--;) {
+		for (int y = 0; y < 4; y++)
+			CBScalarMul(r, r, r);
+		CBScalarMul(r, r, &powers[exponent.n[x / 8] >> (x % 8 * 4) & 0xF]);
+	}
+}
+static bool CBScalarIsZero(const CBScalar * a){
+	uint32_t bits = 0;
+	for (int x = 0; x < 8; x++)
+		bits |= a->n[x];
+	return ! bits;
+}
+static void CBScalarMul(CBScalar * r, const CBScalar * a, const CBScalar * b){
+	uint32_t t[16], t2[13], t3[9], t4[9];
+	memset(t, 0, sizeof(t));
+	for (int x = 0; x < 8; x++) {
+		uint64_t carry = 0;
+		for (int y = 0; y < 8; y++) {
+			uint64_t v = (uint64_t)a->n[x] * b->n[y] + t[x + y] + carry;
+			t[x + y] = (uint32_t)v;
+			carry = v >> 32;
+		}
+		t[x + 8] = (uint32_t)carry;
+	}
+	// Fold the product below 2^386, then 2^260, then 2^256 plus a little, then below 2^256.
+	CBScalarFold(t, 16, t2, 13);
+	CBScalarFold(t2, 13, t3, 9);
+	CBScalarFold(t3, 9, t4, 9);
+	CBScalarFold(t4, 9, t3, 9);
+	memcpy(r->n, t3, sizeof(r->n));
+	CBScalarNormalise(r, false);
+}
+static bool CBScalarNormalise(CBScalar * r, bool low){
+	// Subtract the number from the limit, which borrows if the number is above the limit.
+	const CBScalar * limit = low ? &CBSecp256k1HalfN : &CBSecp256k1N;
+	CBScalar t;
+	int64_t acc = 0;
+	for (int x = 0; x < 8; x++) {
+		acc += (int64_t)limit->n[x] - r->n[x] - (x == 0 && ! low);
+		acc >>= 32;
+	}
+	uint32_t mask = -(uint32_t)(acc != 0);
+	acc = 0;
+	for (int x = 0; x < 8; x++) {
+		// r - n for the reduction or n - r for the negation.
+		acc += low ? (int64_t)CBSecp256k1N.n[x] - r->n[x] : (int64_t)r->n[x] - CBSecp256k1N.n[x];
+		t.n[x] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	for (int x = 0; x < 8; x++)
+		r->n[x] = (t.n[x] & mask) | (r->n[x] & ~mask);
+	return mask;
+}
+static void CBScalarToBytes(const CBScalar * a, unsigned char * bytes){
+	for (int x = 0; x < 8; x++) {
+		bytes[31 - x * 4] = (unsigned char)a->n[x];
+		bytes[30 - x * 4] = (unsigned char)(a->n[x] >> 8);
+		bytes[29 - x * 4] = (unsigned char)(a->n[x] >> 16);
+		bytes[28 - x * 4] = (unsigned char)(a->n[x] >> 24);
+	}
+}
+
+static int CBSecp256k1EncodeSignature(const CBScalar * r, const CBScalar * s, unsigned char * signature){
+	const CBScalar * values[2] = {r, s};
+	int length = 2;
+	for (int x = 0; x < 2; x++) {
+		unsigned char bytes[33];
+		bytes[0] = 0;
+		CBScalarToBytes(values[x], bytes + 1);
+		// Remove leading zeros but keep one when the next byte has the sign bit.
+		int start = 0;
+		while (start < 32 && ! bytes[start] && ! (bytes[start + 1] & 0x80))
+			start++;
+		signature[length] = 2;
+		signature[length + 1] = 33 - start;
+		memcpy(signature + length + 2, bytes + start, 33 - start);
+		length += 35 - start;
+	}
+	signature[0] = 0x30;
+	signature[1] = length - 2;
+	return length;
+}
+static void CBSecp256k1HmacSha256(const unsigned char * key, const unsigned char * data, int length, unsigned char * output){
+	unsigned char block[64 + 97];
+	memset(block, 0x36, 64);
+	for (int x = 0; x < 32; x++)
+		block[x] ^= key[x];
+	memcpy(block + 64, data, length);
+	CBSha256(block, 64 + length, block + 64);
+	memset(block, 0x5c, 64);
+	for (int x = 0; x < 32; x++)
+		block[x] ^= key[x];
+	CBSha256(block, 96, output);
+	memset(block, 0, sizeof(block));
+}
+static void CBSecp256k1NonceInit(CBRFC6979State * state, const unsigned char * privKey, const unsigned char * hash){
+	unsigned char data[97];
+	memset(state->v, 1, 32);
+	memset(state->k, 0, 32);
+	memcpy(data + 33, privKey, 32);
+	memcpy(data + 65, hash, 32);
+	for (unsigned char x = 0; x < 2; x++) {
+		// K = HMAC_K(V || x || privKey || hash), V = HMAC_K(V)
+		memcpy(data, state->v, 32);
+		data[32] = x;
+		CBSecp256k1HmacSha256(state->k, data, 97, state->k);
+		CBSecp256k1HmacSha256(state->k, state->v, 32, state->v);
+	}
+	memset(data, 0, sizeof(data));
+}
+static void CBSecp256k1NonceNext(CBRFC6979State * state, bool first, CBScalar * nonce){
+	for (;;) {
+		if (! first) {
+			unsigned char data[33];
+			memcpy(data, state->v, 32);
+			data[32] = 0;
+			CBSecp256k1HmacSha256(state->k, data, 33, state->k);
+			CBSecp256k1HmacSha256(state->k, state->v, 32, state->v);
+		}
+		first = false;
+		CBSecp256k1HmacSha256(state->k, state->v, 32, state->v);
+		if (CBScalarFromBytes(nonce, state->v) && ! CBScalarIsZero(nonce))
+			return;
+	}
+}
+static int CBSecp256k1SignRetry(const CBScalar * privKey, const CBScalar * z, CBRFC6979State * state, unsigned char * signature){
+	for (;;) {
+		CBScalar nonce, r, s;
+		unsigned char bytes[32];
+		CBSecp256k1NonceNext(state, false, &nonce);
+		CBScalarToBytes(&nonce, bytes);
+		CBJacobianPoint point;
+		CBAffinePoint affine;
+		CBSecp256k1MultiplyG(&point, bytes);
+		CBSecp256k1ToAffine(&point, &affine, 1);
+		CBFieldToBytes(&affine.x, bytes);
+		CBScalarFromBytes(&r, bytes);
+		// s = (z + r privKey) / nonce
+		CBScalarMul(&s, &r, privKey);
+		CBScalarAdd(&s, &s, z);
+		CBScalarInverse(&nonce, &nonce);
+		CBScalarMul(&s, &s, &nonce);
+		if (CBScalarIsZero(&r) || CBScalarIsZero(&s))
+			continue;
+		CBScalarNormalise(&s, true);
+		return CBSecp256k1EncodeSignature(&r, &s, signature);
+	}
+}
+
+// Implementation
+
+void CBKeyGetPublicKey(unsigned char * privKey, unsigned char * pubKey){
+	CBKeyGetPublicKeys(privKey, 1, pubKey);
+}
+void CBKeyGetPublicKeys(unsigned char * privKeys, int num, unsigned char * pubKeys){
+	CBJacobianPoint * points = malloc(sizeof(*points) * num);
+	CBAffinePoint * affine = malloc(sizeof(*affine) * num);
+	for (int x = 0; x < num; x++)
+		CBSecp256k1MultiplyG(&points[x], privKeys + x * CB_PRIVKEY_SIZE);
+	CBSecp256k1ToAffine(points, affine, num);
+	for (int x = 0; x < num; x++)
+		CBSecp256k1SerialisePublicKey(&affine[x], pubKeys + x * CB_PUBKEY_SIZE);
+	free(points);
+	free(affine);
+}
+bool CBKeyGetNextPublicKeys(unsigned char * pubKey, int num, unsigned char * pubKeys){
+	CBAffinePoint base;
+	if (! CBSecp256k1ParsePublicKey(&base, pubKey))
+		return false;
+	CBAffinePoint * affine = malloc(sizeof(*affine) * (num < CB_SECP256K1_MULTIPLES ? num : CB_SECP256K1_MULTIPLES));
+	for (int x = 0; x < num; x += CB_SECP256K1_MULTIPLES) {
+		int batchNum = num - x < CB_SECP256K1_MULTIPLES ? num - x : CB_SECP256K1_MULTIPLES;
+		CBSecp256k1AddMultiples(&base, batchNum, affine);
+		for (int y = 0; y < batchNum; y++)
+			CBSecp256k1SerialisePublicKey(&affine[y], pubKeys + (x + y) * CB_PUBKEY_SIZE);
+		base = affine[batchNum - 1];
+	}
+	free(affine);
+	return true;
+}
+bool CBKeyTweakPublicKeys(unsigned char * pubKey, unsigned char * tweaks, int num, unsigned char * pubKeys){
+	CBAffinePoint parent;
+	if (! CBSecp256k1ParsePublicKey(&parent, pubKey))
+		return false;
+	CBJacobianPoint * points = malloc(sizeof(*points) * num);
+	CBAffinePoint * affine = malloc(sizeof(*affine) * num);
+	for (int x = 0; x < num; x++) {
+		CBSecp256k1MultiplyG(&points[x], tweaks + x * CB_PRIVKEY_SIZE);
+		CBSecp256k1AddAffine(&points[x], &points[x], &parent);
+	}
+	CBSecp256k1ToAffine(points, affine, num);
+	for (int x = 0; x < num; x++)
+		CBSecp256k1SerialisePublicKey(&affine[x], pubKeys + x * CB_PUBKEY_SIZE);
+	free(points);
+	free(affine);
+	return true;
+}
+int CBKeySign(unsigned char * privKey, unsigned char * hash, unsigned char * signature){
+	int length;
+	CBKeySignBatch(&privKey, &hash, 1, &signature, &length);
+	return length;
+}
+void CBKeySignBatch(unsigned char ** privKeys, unsigned char ** hashes, int num, unsigned char ** signatures, int * sigLens){
+	int batchSize = num < CB_SECP256K1_SIGN_BATCH ? num : CB_SECP256K1_SIGN_BATCH;
+	CBScalar * keys = malloc(sizeof(*keys) * batchSize * 4), * zs = keys + batchSize, * nonces = zs + batchSize, * products = nonces + batchSize;
+	CBRFC6979State * states = malloc(sizeof(*states) * batchSize);
+	CBJacobianPoint * points = malloc(sizeof(*points) * batchSize);
+	CBAffinePoint * affine = malloc(sizeof(*affine) * batchSize);
+	for (int x = 0; x < num; x += batchSize) {
+		int batchNum = num - x < batchSize ? num - x : batchSize;
+		// Get the nonces and the nonce points, and the product of the nonces before each.
+		CBScalar acc, inverse;
+		memset(&acc, 0, sizeof(acc));
+		acc.n[0] = 1;
+		for (int y = 0; y < batchNum; y++) {
+			unsigned char bytes[32];
+			// Invalid keys are kept in the batch but their signatures are not written.
+			bool valid = CBScalarFromBytes(&keys[y], privKeys[x + y]) && ! CBScalarIsZero(&keys[y]);
+			CBScalarFromBytes(&zs[y], hashes[x + y]);
+			CBScalarToBytes(&zs[y], bytes);
+			CBSecp256k1NonceInit(&states[y], privKeys[x + y], bytes);
+			CBSecp256k1NonceNext(&states[y], true, &nonces[y]);
+			CBScalarToBytes(&nonces[y], bytes);
+			CBSecp256k1MultiplyG(&points[y], bytes);
+			products[y] = acc;
+			CBScalarMul(&acc, &acc, &nonces[y]);
+			sigLens[x + y] = valid;
+		}
+		CBSecp256k1ToAffine(points, affine, batchNum);
+		CBScalarInverse(&inverse, &acc);
+		for (int y = batchNum; y--;) {
+			CBScalar nonceInv, r, s;
+			unsigned char bytes[32];
+			CBScalarMul(&nonceInv, &inverse, &products[y]);
+			CBScalarMul(&inverse, &inverse, &nonces[y]);
+			if (! sigLens[x + y])
+				continue;
+			CBFieldToBytes(&affine[y].x, bytes);
+			CBScalarFromBytes(&r, bytes);
+			// s = (z + r privKey) / nonce
+			CBScalarMul(&s, &r, &keys[y]);
+			CBScalarAdd(&s, &s, &zs[y]);
+			CBScalarMul(&s, &s, &nonceInv);
+			if (CBScalarIsZero(&r) || CBScalarIsZero(&s))
+				sigLens[x + y] = CBSecp256k1SignRetry(&keys[y], &zs[y], &states[y], signatures[x + y]);
+			else{
+				CBScalarNormalise(&s, true);
+				sigLens[x + y] = CBSecp256k1EncodeSignature(&r, &s, signatures[x + y]);
+			}
+		}
+	}
+	// Remove the private keys and nonces from memory.
+	memset(keys, 0, sizeof(*keys) * batchSize * 4);
+	memset(states, 0, sizeof(*states) * batchSize);
+	free(keys);
+	free(states);
+	free(points);
+	free(affine);
+}
@@ -18,32 +18,248 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef CB_MACOSX
+#include <sys/random.h>
+#else
+#include <sys/syscall.h>
+#endif
+
+// ChaCha20 generator
+
+#define CB_RANDOM_BLOCKS 8 // The number of ChaCha20 blocks made together. Each step is done for all blocks in a loop, which the compiler can vectorise.
+#define CB_RANDOM_BUFFER_SIZE (CB_RANDOM_BLOCKS * 64 - 32) // The output of each refill. The first 32 bytes of the blocks replace the key, so that earlier output cannot be recovered from the state.
+#define CB_RANDOM_RESEED_BYTES 1048576 // The number of bytes given by a secure generator before it is seeded again from the system.
+#define CBRotl32(x, n) ((x) << (n) | (x) >> (32 - (n)))
+#define CBChaCha20QuarterRound(a, b, c, d) \
+	_Pragma("GCC unroll 1") /* Unrolling would stop the loop being vectorised. */ \
+	for (int l = 0; l < CB_RANDOM_BLOCKS; l++) { \
+		x[a][l] += x[b][l]; x[d][l] ^= x[a][l]; x[d][l] = CBRotl32(x[d][l], 16); \
+		x[c][l] += x[d][l]; x[b][l] ^= x[c][l]; x[b][l] = CBRotl32(x[b][l], 12); \
+		x[a][l] += x[b][l]; x[d][l] ^= x[a][l]; x[d][l] = CBRotl32(x[d][l], 8); \
+		x[c][l] += x[d][l]; x[b][l] ^= x[c][l]; x[b][l] = CBRotl32(x[b][l], 7); \
+	}
+
+/**
+ @brief The state of a random number generator.
+ */
+typedef struct{
+	uint32_t key[8]; /**< The ChaCha20 key. */
+	uint64_t counter; /**< The block counter for the key. */
+	unsigned char buffer[CB_RANDOM_BUFFER_SIZE]; /**< Output which has not been given yet is at the end. */
+	int available; /**< The number of bytes at the end of the buffer which have not been given. */
+	bool seeded; /**< true when the generator has been seeded. */
+	bool secure; /**< true if seeded from the system, so that the generator is seeded again after CB_RANDOM_RESEED_BYTES and in forked processes. */
+	uint64_t sinceSeed; /**< The number of bytes given since the generator was seeded from the system. */
+	unsigned int forks; /**< The number of forks in the ancestry of the process when the generator was seeded. */
+} CBRandomGenerator;
+
+static const uint32_t CBChaCha20Constants[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+
+static pthread_once_t CBRandomForkOnce = PTHREAD_ONCE_INIT;
+static volatile unsigned int CBRandomForks = 0;
+static __thread CBRandomGenerator CBRandomThreadGenerator;
+
+/**
+ @brief Makes CB_RANDOM_BLOCKS blocks of ChaCha20 output and replaces the key with the start of the output.
+ @param gen The generator.
+ */
+static void CBRandomGeneratorRefill(CBRandomGenerator * gen);
+/**
+ @brief Copies random bytes from a generator, refilling the buffer as needed.
+ @param gen The generator.
+ @param bytes The bytes to fill.
+ @param length The number of bytes.
+ @returns true on success, false if a secure generator needed seeding from the system and this failed.
+ */
+static bool CBRandomGeneratorGetBytes(CBRandomGenerator * gen, unsigned char * bytes, int length);
+/**
+ @brief Seeds a generator from the system, mixing the new seed into the key if already seeded.
+ @param gen The generator.
+ @returns true on success, false if the system could not give random bytes.
+ */
+static bool CBRandomGeneratorSeed(CBRandomGenerator * gen);
+/**
+ @brief Counts a fork in the child process, so that secure generators are seeded again and the child does not repeat the output of the parent.
+ */
+static void CBRandomOnFork(void);
+/**
+ @brief Registers CBRandomOnFork.
+ */
+static void CBRandomRegisterFork(void);
+/**
+ @brief Reads random bytes from the system, without a file descriptor, waiting only until the system has been seeded after booting.
+ @param bytes The bytes to fill.
+ @param length The number of bytes, up to 256.
+ @returns true on success, false on failure.
+ */
+static bool CBRandomSystemBytes(unsigned char * bytes, int length);
+
+static void CBRandomGeneratorRefill(CBRandomGenerator * gen) {
+
+	uint32_t x[16][CB_RANDOM_BLOCKS], input[16][CB_RANDOM_BLOCKS];
+	for (int l = 0; l < CB_RANDOM_BLOCKS; l++) {
+		for (int y = 0; y < 4; y++)
+			input[y][l] = CBChaCha20Constants[y];
+		for (int y = 0; y < 8; y++)
+			input[y + 4][l] = gen->key[y];
+		uint64_t counter = gen->counter + l;
+		input[12][l] = (uint32_t)counter;
+		input[13][l] = (uint32_t)(counter >> 32);
+		input[14][l] = 0;
+		input[15][l] = 0;
+	}
+	gen->counter += CB_RANDOM_BLOCKS;
+	memcpy(x, input, sizeof(x));
+	for (int y = 0; y < 10; y++) {
+		CBChaCha20QuarterRound(0, 4, 8, 12)
+		CBChaCha20QuarterRound(1, 5, 9, 13)
+		CBChaCha20QuarterRound(2, 6, 10, 14)
+		CBChaCha20QuarterRound(3, 7, 11, 15)
+		CBChaCha20QuarterRound(0, 5, 10, 15)
+		CBChaCha20QuarterRound(1, 6, 11, 12)
+		CBChaCha20QuarterRound(2, 7, 8, 13)
+		CBChaCha20QuarterRound(3, 4, 9, 14)
+	}
+	unsigned char blocks[CB_RANDOM_BLOCKS * 64];
+	for (int l = 0; l < CB_RANDOM_BLOCKS; l++)
+		for (int y = 0; y < 16; y++) {
+			uint32_t word = x[y][l] + input[y][l];
+			unsigned char * out = blocks + l * 64 + y * 4;
+			out[0] = (unsigned char)word;
+			out[1] = (unsigned char)(word >> 8);
+			out[2] = (unsigned char)(word >> 16);
+			out[3] = (unsigned char)(word >> 24);
+		}
+	// Fast key erasure: the new key is never given as output, and the old key is gone.
+	for (int y = 0; y < 8; y++)
+		gen->key[y] = blocks[y * 4] | (uint32_t)blocks[y * 4 + 1] << 8 | (uint32_t)blocks[y * 4 + 2] << 16 | (uint32_t)blocks[y * 4 + 3] << 24;
+	gen->counter = 0;
+	memcpy(gen->buffer, blocks + 32, CB_RANDOM_BUFFER_SIZE);
+	gen->available = CB_RANDOM_BUFFER_SIZE;
+	memset(blocks, 0, sizeof(blocks));
+	memset(x, 0, sizeof(x));
+	memset(input, 0, sizeof(input));
+
+}
+
+static bool CBRandomGeneratorGetBytes(CBRandomGenerator * gen, unsigned char * bytes, int length) {
+
+	if (gen->secure && (gen->forks != CBRandomForks || gen->sinceSeed >= CB_RANDOM_RESEED_BYTES)
+		&& ! CBRandomGeneratorSeed(gen))
+		return false;
+	gen->sinceSeed += length;
+	while (length) {
+		if (! gen->available)
+			CBRandomGeneratorRefill(gen);
+		int num = length < gen->available ? length : gen->available;
+		unsigned char * out = gen->buffer + CB_RANDOM_BUFFER_SIZE - gen->available;
+		memcpy(bytes, out, num);
+		// Erase output once given.
+		memset(out, 0, num);
+		gen->available -= num;
+		bytes += num;
+		length -= num;
+	}
+	return true;
+
+}
+
+static bool CBRandomGeneratorSeed(CBRandomGenerator * gen) {
+
+	pthread_once(&CBRandomForkOnce, CBRandomRegisterFork);
+	unsigned char seed[32];
+	if (! CBRandomSystemBytes(seed, 32))
+		return false;
+	if (! gen->seeded) {
+		memset(gen->key, 0, sizeof(gen->key));
+		gen->counter = 0;
+	}
+	for (int y = 0; y < 8; y++)
+		gen->key[y] ^= seed[y * 4] | (uint32_t)seed[y * 4 + 1] << 8 | (uint32_t)seed[y * 4 + 2] << 16 | (uint32_t)seed[y * 4 + 3] << 24;
+	memset(seed, 0, 32);
+	// Discard output made with the old key.
+	memset(gen->buffer, 0, CB_RANDOM_BUFFER_SIZE);
+	gen->available = 0;
+	gen->seeded = true;
+	gen->secure = true;
+	gen->sinceSeed = 0;
+	gen->forks = CBRandomForks;
+	return true;
+
+}
+
+static void CBRandomOnFork(void) {
+
+	CBRandomForks++;
+
+}
+
+static void CBRandomRegisterFork(void) {
+
+	pthread_atfork(NULL, NULL, CBRandomOnFork);
+
+}
+
+static bool CBRandomSystemBytes(unsigned char * bytes, int length) {
+
+#ifdef CB_MACOSX
+	return getentropy(bytes, length) == 0;
+#else
+	while (length) {
+		long num = syscall(SYS_getrandom, bytes, length, 0);
+		if (num < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		bytes += num;
+		length -= (int)num;
+	}
+	return true;
+#endif
+
+}
 
 // Implementation
 
 bool CBNewSecureRandomGenerator(CBDepObject * gen){
-	gen->ptr = malloc(32);
-	return true;
+	gen->ptr = calloc(1, sizeof(CBRandomGenerator));
+	return gen->ptr != NULL;
 }
 bool CBSecureRandomSeed(CBDepObject gen){
-	return CBGet32RandomBytes(gen.ptr);
+	return CBRandomGeneratorSeed(gen.ptr);
 }
 void CBRandomSeed(CBDepObject gen, long long int seed){
-	memcpy(gen.ptr, &seed, 8);
-	memset((unsigned char *)gen.ptr + 8, 0, 24); // Blank out the rest of the data
+	// The generator gives the same output for the same seed.
+	CBRandomGenerator * self = gen.ptr;
+	memset(self, 0, sizeof(*self));
+	self->key[0] = (uint32_t)seed;
+	self->key[1] = (uint32_t)((unsigned long long int)seed >> 32);
+	self->seeded = true;
 }
 unsigned long long int CBSecureRandomInteger(CBDepObject gen){
-	CBSha256(gen.ptr, 32, gen.ptr);
-	unsigned long long int i;
-	memcpy(&i, gen.ptr, 8);
+	unsigned char bytes[8];
+	unsigned long long int i = 0;
+	if (CBRandomGeneratorGetBytes(gen.ptr, bytes, 8))
+		memcpy(&i, bytes, 8);
 	return i;
 }
+bool CBSecureRandomBytes(CBDepObject gen, unsigned char * bytes, int length){
+	return CBRandomGeneratorGetBytes(gen.ptr, bytes, length);
+}
 void CBFreeSecureRandomGenerator(CBDepObject gen){
+	memset(gen.ptr, 0, sizeof(CBRandomGenerator));
 	free(gen.ptr);
 }
+bool CBGetRandomBytes(unsigned char * bytes, int length){
+	CBRandomGenerator * gen = &CBRandomThreadGenerator;
+	if (! gen->seeded && ! CBRandomGeneratorSeed(gen))
+		return false;
+	return CBRandomGeneratorGetBytes(gen, bytes, length);
+}
 bool CBGet32RandomBytes(unsigned char * bytes){
-	FILE * f = fopen("/dev/random", "r");
-	bool result = fread(bytes, 1, 32, f) == 32;
-	fclose(f);
-	return result;
+	return CBGetRandomBytes(bytes, 32);
 }
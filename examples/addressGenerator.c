@@ -37,58 +37,55 @@ int main(){
 	puts("Waiting for entropy... Move the cursor around...");
 	CBKeyPair * key = CBNewKeyPair(true);
 	CBKeyPairGenerate(key);
-	BN_CTX * ctx = BN_CTX_new();
-	EC_GROUP * group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+	CBKeyPair * keys = malloc(sizeof(*keys) * CB_KEY_PAIR_STEP_BATCH);
+	unsigned char * hashes = malloc(CB_KEY_PAIR_STEP_BATCH * 20);
+	char * strings = malloc(CB_KEY_PAIR_STEP_BATCH * CB_ADDRESS_STRING_SIZE);
+	size_t matchSize = strlen(stringMatch);
 	printf("Making %lu addresses for \"%s\"\n\n", i, stringMatch);
 	for (unsigned int x = 0; x < i;) {
-		CBAddress * address = CBNewAddressFromRIPEMD160Hash(CBKeyPairGetHash(key), CB_PREFIX_PRODUCTION_ADDRESS, false);
-		CBByteArray * string = CBChecksumBytesGetString(CBGetChecksumBytes(address));
-		CBReleaseObject(address);
-		bool match = true;
-		int offset = 1;
-		size_t matchSize = strlen(stringMatch);
-		for (size_t y = 0; y < matchSize;) {
-			char other = islower(stringMatch[y]) ? toupper(stringMatch[y]) : (isupper(stringMatch[y])? tolower(stringMatch[y]) : '\0');
-			if (CBByteArrayGetByte(string, y+offset) != stringMatch[y] && CBByteArrayGetByte(string, y+offset) != other) {
-				offset++;
-				y = 0;
-				if (string->length < (int)matchSize + offset) {
-					match = false;
-					break;
-				}
-			}else y++;
+		// Get the next keys and their addresses together
+		CBKeyPairGetNextKeys(key, CB_KEY_PAIR_STEP_BATCH, keys);
+		for (int z = 0; z < CB_KEY_PAIR_STEP_BATCH; z++)
+			memcpy(hashes + z * 20, keys[z].pubkey.hash, 20);
+		CBAddressEncodeBatch(hashes, CB_PREFIX_PRODUCTION_ADDRESS, CB_KEY_PAIR_STEP_BATCH, strings);
+		for (int z = 0; z < CB_KEY_PAIR_STEP_BATCH && x < i; z++) {
+			char * string = strings + z * CB_ADDRESS_STRING_SIZE;
+			size_t length = strlen(string);
+			bool match = true;
+			size_t offset = 1;
+			for (size_t y = 0; y < matchSize;) {
+				char other = islower(stringMatch[y]) ? toupper(stringMatch[y]) : (isupper(stringMatch[y])? tolower(stringMatch[y]) : '\0');
+				if (string[y+offset] != stringMatch[y] && string[y+offset] != other) {
+					offset++;
+					y = 0;
+					if (length < matchSize + offset) {
+						match = false;
+						break;
+					}
+				}else y++;
+			}
+			if (match) {
+				// Print key data to stdout
+				printf("Private key (WIF): ");
+				CBWIF * wif = CBNewWIFFromPrivateKey(keys[z].privkey, true, CB_NETWORK_PRODUCTION, false);
+				CBByteArray * str = CBChecksumBytesGetString(wif);
+				CBReleaseObject(wif);
+				puts((char *)CBByteArrayGetData(str));
+				CBReleaseObject(str);
+				// Print public key
+				printf("Public key (hex): ");
+				for (int y = 0; y < CB_PUBKEY_SIZE; y++)
+					printf(" %.2X", keys[z].pubkey.key[y]);
+				printf("\nAddress (base-58): %s\n\n", string);
+				x++; // Move to next
+			}
 		}
-		if (match) {
-			// Print key data to stdout
-			printf("Private key (WIF): ");
-			CBWIF * wif = CBNewWIFFromPrivateKey(key->privkey, true, CB_NETWORK_PRODUCTION, false);
-			CBByteArray * str = CBChecksumBytesGetString(wif);
-			CBReleaseObject(wif);
-			puts((char *)CBByteArrayGetData(str));
-			CBReleaseObject(str);
-			// Print public key
-			printf("Public key (hex): ");
-			for (int y = 0; y < CB_PUBKEY_SIZE; y++)
-				printf(" %.2X", key->pubkey.key[y]);
-			printf("\nAddress (base-58): %s\n\n", CBByteArrayGetData(string));
-			x++; // Move to next
-		}
-		CBReleaseObject(string);
-		// Get next key
-		for (int x = CB_PRIVKEY_SIZE - 1; ++key->privkey[x--] == 0;);
-		// Get new public key, by adding the base point.
-		EC_POINT * pub = EC_POINT_new(group);
-		EC_POINT * new = EC_POINT_new(group);
-		EC_POINT_oct2point(group, pub, key->pubkey.key, CB_PUBKEY_SIZE, ctx);
-		EC_POINT_add(group, new, (EC_POINT *)EC_GROUP_get0_generator(group), pub, ctx);
-		EC_POINT_point2oct(group, new, POINT_CONVERSION_COMPRESSED, key->pubkey.key, CB_PUBKEY_SIZE, ctx);
-		EC_POINT_free(pub);
-		EC_POINT_free(new);
-		// Invalidate hash
-		key->pubkey.hashSet = false;
+		// Continue from the last key
+		*key = keys[CB_KEY_PAIR_STEP_BATCH - 1];
 	}
-	EC_GROUP_free(group);
-	BN_CTX_free(ctx);
+	free(keys);
+	free(hashes);
+	free(strings);
 	free(key);
 	return 0;
 }
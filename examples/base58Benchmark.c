@@ -0,0 +1,128 @@
+//
+//  base58Benchmark.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+// Measures the throughput of CBBase58Encode and CBBase58Decode for address and extended key sizes, against the previous digit at a time conversion with CBBigInt.
+// Usage: base58Benchmark [iterations]
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+#include "CBBase58.h"
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+	va_start(argptr, format);
+	vfprintf(stderr, format, argptr);
+	va_end(argptr);
+	fprintf(stderr, "\n");
+}
+
+double getSeconds(void);
+double getSeconds(void){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// The previous conversion, dividing by 58 for each digit and adding a power of 58 for each digit.
+void referenceEncode(unsigned char * bytes, int length, char * str);
+void referenceEncode(unsigned char * bytes, int length, char * str){
+	CBBigInt bi;
+	CBBigIntAlloc(&bi, length);
+	memcpy(bi.data, bytes, length);
+	bi.length = length;
+	unsigned char * temp = malloc(length);
+	int x = 0;
+	for (; CBBigIntCompareTo58(&bi) >= 0; x++) {
+		int mod = CBBigIntModuloWith58(&bi);
+		str[x] = base58Characters[mod];
+		CBBigIntEqualsSubtractionByUInt8(&bi, mod);
+		memset(temp, 0, bi.length);
+		CBBigIntEqualsDivisionBy58(&bi, temp);
+	}
+	str[x++] = base58Characters[bi.data[bi.length - 1]];
+	for (int y = 0; y < x / 2; y++) {
+		char c = str[y];
+		str[y] = str[x - y - 1];
+		str[x - y - 1] = c;
+	}
+	str[x] = '\0';
+	free(temp);
+	free(bi.data);
+}
+void referenceDecode(char * str, CBBigInt * bi);
+void referenceDecode(char * str, CBBigInt * bi){
+	CBBigInt power;
+	CBBigIntAlloc(&power, 1);
+	bi->data[0] = 0;
+	bi->length = 1;
+	int length = (int)strlen(str);
+	for (int x = length; x--;) {
+		int value = 0;
+		while (base58Characters[value] != str[x])
+			value++;
+		if (value) {
+			CBBigIntFromPowUInt8(&power, 58, length - 1 - x);
+			CBBigIntEqualsMultiplicationByUInt8(&power, value);
+			CBBigIntEqualsAdditionByBigInt(bi, &power);
+		}
+	}
+	free(power.data);
+}
+
+void benchmark(int length, int iterations);
+void benchmark(int length, int iterations){
+	unsigned char bytes[82], decoded[82];
+	char str[CBBase58MaxLength(82) + 1];
+	for (int x = 0; x < length; x++)
+		bytes[x] = rand();
+	bytes[length - 1] |= 1;
+	CBBase58Encode(bytes, length, str);
+	CBBigInt bi;
+	CBBigIntAlloc(&bi, length + 1);
+	double start = getSeconds();
+	for (int x = 0; x < iterations; x++)
+		CBBase58Encode(bytes, length, str);
+	double encodeTime = getSeconds() - start;
+	start = getSeconds();
+	for (int x = 0; x < iterations; x++)
+		CBBase58Decode(str, decoded, length);
+	double decodeTime = getSeconds() - start;
+	start = getSeconds();
+	for (int x = 0; x < iterations; x++)
+		referenceEncode(bytes, length, str);
+	double refEncodeTime = getSeconds() - start;
+	start = getSeconds();
+	for (int x = 0; x < iterations; x++)
+		referenceDecode(str, &bi);
+	double refDecodeTime = getSeconds() - start;
+	if (CBBase58Decode(str, decoded, length) != length || memcmp(bytes, decoded, length)
+		|| memcmp(bytes, bi.data, length))
+		printf("%i bytes: conversions do not match\n", length);
+	free(bi.data);
+	printf("%i bytes: encode %.0f/s (previously %.0f/s, %.1fx), decode %.0f/s (previously %.0f/s, %.1fx)\n",
+		length,
+		iterations / encodeTime, iterations / refEncodeTime, refEncodeTime / encodeTime,
+		iterations / decodeTime, iterations / refDecodeTime, refDecodeTime / decodeTime);
+}
+
+int main(int argc, char * argv[]){
+	int iterations = argc > 1 ? atoi(argv[1]) : 100000;
+	srand((unsigned int)time(NULL));
+	// Addresses are 25 bytes with the checksum and extended keys are 82 bytes.
+	benchmark(25, iterations);
+	benchmark(82, iterations);
+	return 0;
+}
@@ -0,0 +1,109 @@
+//
+//  blockValidationBenchmark.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+// Validates recorded blocks from the genesis block onwards with CBValidateBlock and reports the throughput.
+// Usage: blockValidationBenchmark <threads> <blk00000.dat> [blk00001.dat ...]
+// The files use the bitcoind block file format of the network magic, the block length and the block. Blocks must be stored in chain order.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+#include "CBBlockValidator.h"
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+	va_start(argptr, format);
+	vfprintf(stderr, format, argptr);
+	va_end(argptr);
+	fprintf(stderr, "\n");
+}
+
+double getSeconds(void);
+double getSeconds(void){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char * argv[]){
+	if (argc < 3) {
+		printf("Usage: %s <threads> <block file> [block file ...]\n", argv[0]);
+		return 1;
+	}
+	CBBlockValidator * validator = CBNewBlockValidator(atoi(argv[1]));
+	CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+	unsigned char prevHash[32] = {0};
+	unsigned int height = 0;
+	unsigned long long int txNum = 0, inputNum = 0, bytes = 0;
+	double validateTime = 0;
+	for (int x = 2; x < argc; x++) {
+		FILE * file = fopen(argv[x], "rb");
+		if (! file) {
+			printf("Could not open %s\n", argv[x]);
+			return 1;
+		}
+		unsigned char header[8];
+		while (fread(header, 1, 8, file) == 8) {
+			unsigned int magic = header[0] | header[1] << 8 | header[2] << 16 | (unsigned int)header[3] << 24;
+			unsigned int length = header[4] | header[5] << 8 | header[6] << 16 | (unsigned int)header[7] << 24;
+			// Pre-allocated space at the end of a file is zero.
+			if (magic != CB_PRODUCTION_NETWORK_BYTES || length > CB_BLOCK_MAX_SIZE)
+				break;
+			CBByteArray * data = CBNewByteArrayOfSize(length);
+			if (fread(CBByteArrayGetData(data), 1, length, file) != length) {
+				CBReleaseObject(data);
+				break;
+			}
+			CBBlock * block = CBNewBlockFromData(data);
+			CBReleaseObject(data);
+			if (CBBlockDeserialise(block, true) == CB_DESERIALISE_ERROR) {
+				printf("Could not deserialise block %u\n", height);
+				return 1;
+			}
+			if (memcmp(CBByteArrayGetData(block->prevBlockHash), prevHash, 32)) {
+				printf("Block %u is not stored in chain order. Stopping.\n", height);
+				CBReleaseObject(block);
+				fclose(file);
+				goto finish;
+			}
+			CBBlockUndo * undo = CBNewBlockUndo();
+			double start = getSeconds();
+			CBBlockValidationResult res = CBValidateBlock(validator, block, set, height, block->time, undo);
+			validateTime += getSeconds() - start;
+			if (res != CB_BLOCK_VALIDATION_OK) {
+				printf("Block %u failed validation with reason %i at transaction %i\n", height, res, validator->failedTransaction);
+				return 1;
+			}
+			memcpy(prevHash, CBBlockGetHash(block), 32);
+			txNum += block->transactionNum;
+			inputNum += validator->inputNum;
+			bytes += length;
+			height++;
+			CBReleaseObject(undo);
+			CBReleaseObject(block);
+			if (height % 10000 == 0)
+				printf("%u blocks, %llu transactions, %.2f seconds\n", height, txNum, validateTime);
+		}
+		fclose(file);
+	}
+finish:
+	printf("Validated %u blocks with %llu transactions and %llu script inputs (%llu bytes) in %.3f seconds\n", height, txNum, inputNum, bytes, validateTime);
+	if (validateTime > 0)
+		printf("%.1f blocks/s, %.1f transactions/s, %.1f inputs/s, %.2f MB/s\n", height / validateTime, txNum / validateTime, inputNum / validateTime, bytes / validateTime / 1e6);
+	printf("%i unspent outputs\n", set->outputNum);
+	CBReleaseObject(set);
+	CBReleaseObject(validator);
+	return 0;
+}
@@ -0,0 +1,111 @@
+//
+//  compactBlockBenchmark.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+// Encodes recorded blocks with CBBlockCompactSerialise, checks that CBBlockCompactDeserialise gives the same blocks and reports the bytes saved and the throughput.
+// Usage: compactBlockBenchmark <blk00000.dat> [blk00001.dat ...]
+// The files use the bitcoind block file format of the network magic, the block length and the block. Blocks can be in any order.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+#include "CBBlock.h"
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+	va_start(argptr, format);
+	vfprintf(stderr, format, argptr);
+	va_end(argptr);
+	fprintf(stderr, "\n");
+}
+
+double getSeconds(void);
+double getSeconds(void){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char * argv[]){
+	if (argc < 2) {
+		printf("Usage: %s <block file> [block file ...]\n", argv[0]);
+		return 1;
+	}
+	unsigned int blockNum = 0;
+	unsigned long long int txNum = 0, bytes = 0, compactBytes = 0;
+	double wireDecodeTime = 0, encodeTime = 0, decodeTime = 0;
+	for (int x = 1; x < argc; x++) {
+		FILE * file = fopen(argv[x], "rb");
+		if (! file) {
+			printf("Could not open %s\n", argv[x]);
+			return 1;
+		}
+		unsigned char header[8];
+		while (fread(header, 1, 8, file) == 8) {
+			unsigned int magic = header[0] | header[1] << 8 | header[2] << 16 | (unsigned int)header[3] << 24;
+			unsigned int length = header[4] | header[5] << 8 | header[6] << 16 | (unsigned int)header[7] << 24;
+			// Pre-allocated space at the end of a file is zero.
+			if (magic != CB_PRODUCTION_NETWORK_BYTES || length > CB_BLOCK_MAX_SIZE)
+				break;
+			CBByteArray * data = CBNewByteArrayOfSize(length);
+			if (fread(CBByteArrayGetData(data), 1, length, file) != length) {
+				CBReleaseObject(data);
+				break;
+			}
+			CBBlock * block = CBNewBlockFromData(data);
+			double start = getSeconds();
+			if (CBBlockDeserialise(block, true) == CB_DESERIALISE_ERROR) {
+				printf("Could not deserialise block %u\n", blockNum);
+				return 1;
+			}
+			wireDecodeTime += getSeconds() - start;
+			start = getSeconds();
+			CBByteArray * compact = CBNewByteArrayOfSize(CBBlockCalculateCompactLength(block));
+			int compactLength = CBBlockCompactSerialise(block, compact, 0);
+			encodeTime += getSeconds() - start;
+			CBBlock * compactBlock = CBNewBlock();
+			start = getSeconds();
+			if (CBBlockCompactDeserialise(compactBlock, compact, 0) != compactLength) {
+				printf("Could not deserialise compact block %u\n", blockNum);
+				return 1;
+			}
+			decodeTime += getSeconds() - start;
+			// The compact block must serialise to the original data.
+			CBGetMessage(compactBlock)->bytes = CBNewByteArrayOfSize(CBBlockCalculateLength(compactBlock, true));
+			if (CBBlockSerialise(compactBlock, true, false) != (int)length
+				|| memcmp(CBByteArrayGetData(CBGetMessage(compactBlock)->bytes), CBByteArrayGetData(data), length)) {
+				printf("Compact block %u does not give the original block\n", blockNum);
+				return 1;
+			}
+			txNum += block->transactionNum;
+			bytes += length;
+			compactBytes += compactLength;
+			blockNum++;
+			CBReleaseObject(compactBlock);
+			CBReleaseObject(compact);
+			CBReleaseObject(block);
+			CBReleaseObject(data);
+			if (blockNum % 10000 == 0)
+				printf("%u blocks, %llu bytes, %llu compact bytes\n", blockNum, bytes, compactBytes);
+		}
+		fclose(file);
+	}
+	printf("Encoded %u blocks with %llu transactions from %llu bytes to %llu bytes", blockNum, txNum, bytes, compactBytes);
+	if (bytes)
+		printf(" (%.1f%% saved)", 100.0 * (bytes - compactBytes) / bytes);
+	printf("\n");
+	if (wireDecodeTime > 0 && encodeTime > 0 && decodeTime > 0)
+		printf("Network format decoding %.2f MB/s, compact encoding %.2f MB/s, compact decoding %.2f MB/s (%.1f transactions/s)\n", bytes / wireDecodeTime / 1e6, bytes / encodeTime / 1e6, bytes / decodeTime / 1e6, txNum / decodeTime);
+	return 0;
+}
@@ -33,66 +33,76 @@ CBDepObject outputMutex;
 
 void CBAddressGenThread(void * vkey) {
 
-	CBAddress address;
 	CBKeyPair * key = vkey;
+	CBKeyPair * keys = malloc(sizeof(*keys) * CB_KEY_PAIR_STEP_BATCH);
+	unsigned char * hashes = malloc(CB_KEY_PAIR_STEP_BATCH * 20);
+	char * strings = malloc(CB_KEY_PAIR_STEP_BATCH * CB_ADDRESS_STRING_SIZE);
 
 	for (;;) {
 
-		CBInitAddressFromRIPEMD160Hash(&address, CBKeyPairGetHash(key), prefix, false);
-		CBByteArray * string = CBChecksumBytesGetString(CBGetChecksumBytes(&address));
-		CBDestroyAddress(&address);
+		// Get the next keys and their addresses together
+		CBKeyPairGetNextKeys(key, CB_KEY_PAIR_STEP_BATCH, keys);
+		for (int x = 0; x < CB_KEY_PAIR_STEP_BATCH; x++)
+			memcpy(hashes + x * 20, keys[x].pubkey.hash, 20);
+		CBAddressEncodeBatch(hashes, prefix, CB_KEY_PAIR_STEP_BATCH, strings);
 
-		bool match = true;
-		int amount = 0;
+		for (int x = 0; x < CB_KEY_PAIR_STEP_BATCH; x++) {
 
-		for (int y = 0; y < string->length - 1; y++) {
-			if (islower(CBByteArrayGetByte(string, y))) {
-				if (y <= highest)
-					match = false;
-				amount = y;
-				break;
+			char * string = strings + x * CB_ADDRESS_STRING_SIZE;
+			int length = (int)strlen(string);
+
+			bool match = true;
+			int amount = 0;
+
+			for (int y = 0; y < length; y++) {
+				if (islower(string[y])) {
+					if (y <= highest)
+						match = false;
+					amount = y;
+					break;
+				}
 			}
-		}
 
-		if (amount == 0)
-			amount = string->length - 1;
+			if (amount == 0)
+				amount = length;
 
-		if (match) {
+			if (match) {
 
-			CBWIF wif;
-			CBInitWIFFromPrivateKey(&wif, key->privkey, true, CB_PREFIX_PRODUCTION_PRIVATE_KEY, false);
-			CBByteArray * str = CBChecksumBytesGetString(&wif);
-			CBDestroyWIF(&wif);
+				CBWIF wif;
+				CBInitWIFFromPrivateKey(&wif, keys[x].privkey, true, CB_PREFIX_PRODUCTION_PRIVATE_KEY, false);
+				CBByteArray * str = CBChecksumBytesGetString(&wif);
+				CBDestroyWIF(&wif);
 
-			char publicKeyStr[CB_PUBKEY_SIZE*2 + 1];
-			CBBytesToString(key->pubkey.key, 0, CB_PUBKEY_SIZE, publicKeyStr, false);
+				char publicKeyStr[CB_PUBKEY_SIZE*2 + 1];
+				CBBytesToString(keys[x].pubkey.key, 0, CB_PUBKEY_SIZE, publicKeyStr, false);
 
-			// Print key data to stdout
+				// Print key data to stdout
 
-			CBMutexLock(outputMutex);
+				CBMutexLock(outputMutex);
 
-			printf("No lower for %u\n", amount);
-			printf("Private key (WIF): ");
-			puts((char *)CBByteArrayGetData(str));
-			printf("Public key (hex): %s\n", publicKeyStr);
-			printf("Address (base-58): %s\n\n", CBByteArrayGetData(string));
-			
-			// Set new highest
-			highest = amount; 
+				printf("No lower for %u\n", amount);
+				printf("Private key (WIF): ");
+				puts((char *)CBByteArrayGetData(str));
+				printf("Public key (hex): %s\n", publicKeyStr);
+				printf("Address (base-58): %s\n\n", string);
 
-			CBMutexUnlock(outputMutex);
+				// Set new highest
+				highest = amount;
 
-			CBReleaseObject(str);
+				CBMutexUnlock(outputMutex);
 
-		}
+				CBReleaseObject(str);
 
-		CBReleaseObject(string);
+			}
+
+			if (amount == length)
+				// Got the complete address
+				exit(0);
 
-		if (amount == string->length - 1)
-			// Got the complete address
-			exit(0);
+		}
 
-		CBKeyPairGetNext(key);
+		// Continue from the last key
+		*key = keys[CB_KEY_PAIR_STEP_BATCH - 1];
 
 	}
 
@@ -0,0 +1,97 @@
+//
+//  vanitySearchBenchmark.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+// Measures how fast CBVanitySearch filters hashes against encoding every address and comparing the pattern, then searches for a key pair with the pattern on every core, reporting the progress each second.
+// Usage: vanitySearchBenchmark [pattern] [ignore case (0 or 1)] [hashes to filter]
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <strings.h>
+#include <time.h>
+#include "CBVanitySearch.h"
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+	va_start(argptr, format);
+	vfprintf(stderr, format, argptr);
+	va_end(argptr);
+	fprintf(stderr, "\n");
+}
+
+double getSeconds(void);
+double getSeconds(void){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+bool onProgress(void * vsearch, uint64_t tried, double rate);
+bool onProgress(void * vsearch, uint64_t tried, double rate){
+	CBVanitySearch * search = vsearch;
+	printf("Tried %llu key pairs at %.0f/s, %.1f%% of the expected number, %.0f seconds expected in total\n",
+		(unsigned long long)tried, rate, tried * 100.0 / search->difficulty, search->difficulty / rate);
+	return true;
+}
+
+int main(int argc, char * argv[]){
+	char * pattern = argc > 1 ? argv[1] : "1Kid";
+	bool caseInsensitive = argc > 2 && atoi(argv[2]);
+	int num = argc > 3 ? atoi(argv[3]) : 1000000;
+	srand((unsigned int)time(NULL));
+	CBVanitySearch * search = CBNewVanitySearch(pattern, CB_PREFIX_PRODUCTION_ADDRESS, caseInsensitive);
+	if (! search)
+		return 1;
+	printf("Pattern \"%s\"%s: %i hash ranges, one in %.0f addresses match\n", pattern, caseInsensitive ? " ignoring case" : "", search->rangeNum, search->difficulty);
+	unsigned char * hashes = malloc(num * 20);
+	for (int x = 0; x < num * 20; x++)
+		hashes[x] = rand();
+	// Filter the hashes with the ranges
+	int matches = 0;
+	double start = getSeconds();
+	for (int x = 0; x < num; x++)
+		matches += CBVanitySearchCheckHash(search, hashes + x * 20, NULL);
+	double filterTime = getSeconds() - start;
+	// Encode every address and compare the pattern, in batches as the address generators did.
+	int encodeMatches = 0;
+	size_t length = strlen(pattern);
+	char strings[CB_ADDRESS_BATCH_SIZE * CB_ADDRESS_STRING_SIZE];
+	start = getSeconds();
+	for (int x = 0; x < num; x += CB_ADDRESS_BATCH_SIZE) {
+		int batch = num - x < CB_ADDRESS_BATCH_SIZE ? num - x : CB_ADDRESS_BATCH_SIZE;
+		CBAddressEncodeBatch(hashes + x * 20, CB_PREFIX_PRODUCTION_ADDRESS, batch, strings);
+		for (int y = 0; y < batch; y++) {
+			char * string = strings + y * CB_ADDRESS_STRING_SIZE;
+			encodeMatches += caseInsensitive ? ! strncasecmp(string, pattern, length) : ! strncmp(string, pattern, length);
+		}
+	}
+	double encodeTime = getSeconds() - start;
+	free(hashes);
+	if (matches != encodeMatches)
+		printf("The number of matches differ: %i with the ranges, %i encoding\n", matches, encodeMatches);
+	printf("Filtering %i hashes: %.0f/s with the ranges, %.0f/s encoding each address (%.1fx)\n",
+		num, num / filterTime, num / encodeTime, encodeTime / filterTime);
+	// Search for a key pair
+	int threads = CBGetNumberOfCores();
+	printf("Searching with %i threads\n", threads);
+	CBKeyPair key;
+	char address[CB_ADDRESS_STRING_SIZE];
+	start = getSeconds();
+	if (! CBVanitySearchFind(search, threads, onProgress, search, 1000, &key, address))
+		return 1;
+	double searchTime = getSeconds() - start;
+	printf("Found %s after %llu key pairs in %.1f seconds (%.0f/s)\n", address, (unsigned long long)search->tried, searchTime, search->tried / searchTime);
+	CBReleaseObject(search);
+	return 0;
+}
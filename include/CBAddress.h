@@ -26,6 +26,11 @@
 
 #define CBGetAddress(x) ((CBAddress *)x)
 
+// Constants
+
+#define CB_ADDRESS_BATCH_SIZE 64 // The number of addresses hashed together by the batch functions, which bounds the stack space used.
+#define CB_ADDRESS_STRING_SIZE 36 // The space for each string in the batch functions, including the terminator.
+
 //  Includes
 
 #include "CBChecksumBytes.h"
@@ -85,4 +90,23 @@ void CBFreeAddress(void * self);
  
 //  Functions
 
+/**
+ @brief Decodes base-58 address strings into RIPEMD-160 hashes without creating objects. The checksums are checked with CBSha256Batch.
+ @param strings The null terminated strings, each at an offset of CB_ADDRESS_STRING_SIZE bytes.
+ @param num The number of strings.
+ @param hashes The 20-byte hashes are written here one after another. The hash for an invalid string is undefined.
+ @param prefixes If not NULL, the prefix of each address is written here.
+ @param valid Set to true for each string which is a valid address and false otherwise.
+ @returns The number of valid addresses.
+ */
+int CBAddressDecodeBatch(char * strings, int num, unsigned char * hashes, CBBase58Prefix * prefixes, bool * valid);
+/**
+ @brief Encodes RIPEMD-160 hashes as base-58 address strings without creating objects. The checksums are calculated with CBSha256Batch.
+ @param hashes The 20-byte hashes one after another.
+ @param prefix The prefix for the addresses. @see CBBase58Prefix
+ @param num The number of hashes.
+ @param strings The null terminated strings are written here, each at an offset of CB_ADDRESS_STRING_SIZE bytes.
+ */
+void CBAddressEncodeBatch(unsigned char * hashes, CBBase58Prefix prefix, int num, char * strings);
+
 #endif
@@ -15,6 +15,7 @@
 /**
  @file
  @brief Functions for encoding and decoding in base 58. Avoids "0", "o", "l", "I", which may look alike. This is due to readability concerns.
+ @details CBBase58Encode and CBBase58Decode convert between bytes and strings in caller buffers. They work on five base 58 digits at a time as numbers below 58^5, against 32-bit words of the bytes, so that every product fits into 64 bits. Inputs with up to CB_BASE58_STACK_LIMBS limbs, which covers addresses, WIF keys and extended keys, are converted without heap allocations. As with CBBigInt, the bytes are little-endian so the last byte is the most significant, and each zero byte at the end is a leading "1".
  */
 
 #ifndef CBBASE58H
@@ -24,11 +25,30 @@
 #include "CBBigInt.h"
 #include "CBDependencies.h"
 
+#define CB_BASE58_STACK_LIMBS 64 // The number of 32-bit limbs held on the stack during a conversion, enough for 256 bytes.
+#define CBBase58MaxLength(length) ((length) * 138 / 100 + 1) // The maximum length of the base 58 string for a number of bytes, without the terminator.
+
 static const char base58Characters[58] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
 
+/**
+ @brief Decodes a base 58 string into a buffer.
+ @param str Base 58 string to decode.
+ @param bytes The bytes are written here in little-endian order.
+ @param size The size of the buffer. The length of the string is always enough.
+ @returns The number of bytes, or -1 if the string has an invalid character or the buffer is too small.
+ */
+int CBBase58Decode(char * str, unsigned char * bytes, int size);
+/**
+ @brief Encodes bytes into a base 58 string in a buffer.
+ @param bytes The bytes in little-endian order.
+ @param length The number of bytes.
+ @param str The string is written here with a null terminator. It should have CBBase58MaxLength(length) + 1 bytes.
+ @returns The length of the string, not including the terminator.
+ */
+int CBBase58Encode(unsigned char * bytes, int length, char * str);
 /**
  @brief Decodes base 58 string into byte data as a CBBigInt.
- @param bi The CBBigInt which should be preallocated with at least one byte.
+ @param bi The CBBigInt which should be preallocated with at least one byte. It is set to a single zero byte if the string has an invalid character.
  @param str Base 58 string to decode.
  */
 void CBDecodeBase58(CBBigInt * bi, char * str);
@@ -43,7 +63,7 @@ bool CBDecodeBase58Checked(CBBigInt * bi, char * str);
 
 /**
  @brief Encodes byte data into base 58.
- @param bytes Pointer to a normalised CBBigInt containing the byte data to encode. Will almost certainly be modified. Copy data beforehand if needed.
+ @param bytes Pointer to a normalised CBBigInt containing the byte data to encode.
  @returns Newly allocated string with encoded data or NULL on error.
  */
 char * CBEncodeBase58(CBBigInt * bi);
@@ -142,6 +142,31 @@ int CBBlockCalculateLength(CBBlock * self, bool transactions);
  */
 unsigned char * CBBlockCalculateMerkleRoot(CBBlock * self);
 
+/**
+ @brief Calculates the most bytes needed for the compact encoding of a block, which is exact when no previous output hashes are repeated.
+ @param self The CBBlock object with all transactions.
+ @returns The length.
+ */
+int CBBlockCalculateCompactLength(CBBlock * self);
+
+/**
+ @brief Deserialises a block from the compact encoding made by CBBlockCompactSerialise. The block hash is calculated from the header.
+ @param self The CBBlock object with no header or transactions, such as from CBNewBlock.
+ @param bytes The compact data.
+ @param offset The offset to the block in the data.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBBlockCompactDeserialise(CBBlock * self, CBByteArray * bytes, int offset);
+
+/**
+ @brief Serialises a block with the compact encoding for storage. The 80 byte header is written as it is for the network, followed by a variable size integer for the number of transactions and the transactions from CBTransactionCompactSerialise, sharing a table of previous output hashes so that hashes repeated in the block are only written once.
+ @param self The CBBlock object with all transactions.
+ @param bytes The data to write to, with CBBlockCalculateCompactLength bytes available at the offset.
+ @param offset The offset to write to.
+ @returns The length written.
+ */
+int CBBlockCompactSerialise(CBBlock * self, CBByteArray * bytes, int offset);
+
 /**
  @brief Deserialises a CBBlock so that it can be used as an object.
  @param self The CBBlock object
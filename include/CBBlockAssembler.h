@@ -0,0 +1,123 @@
+//
+//  CBBlockAssembler.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Assembles candidate blocks for mining from the transactions in a CBMempool. Inherits CBObject
+ @details A new template is made for every new chain tip with CBBlockAssemblerNewTemplate, which selects transactions by ancestor fee rate so that each transaction is added together with its ancestors which are not yet in the template. The template stays under CB_BLOCK_MAX_SIZE and CB_MAX_SIG_OPS. Transactions arriving in the pool afterwards can be added to the template with CBBlockAssemblerAddTransaction without rebuilding it.
+ The coinbase transaction pays the block reward and the fees to the output script, and has the height in the input script as in BIP34. The merkle tree is a CBMerkleTree, so adding a transaction or changing the coinbase only rehashes the path to the root.
+*/
+
+#ifndef CBBLOCKASSEMBLERH
+#define CBBLOCKASSEMBLERH
+
+//  Includes
+
+#include "CBMempool.h"
+#include "CBMerkleTree.h"
+
+// Constants and Macros
+
+#define CB_BLOCK_ASSEMBLER_VERSION 2 // The version of assembled blocks, which have the height in the coinbase.
+#define CB_BLOCK_ASSEMBLER_MAX_FAILURES 1000 // Selection stops after this many packages in a row do not fit into a nearly full block.
+#define CB_BLOCK_ASSEMBLER_NEARLY_FULL 4000 // The remaining bytes for which a block is nearly full.
+#define CBGetBlockAssembler(x) ((CBBlockAssembler *)x)
+
+/**
+ @brief Structure for CBBlockAssembler objects. @see CBBlockAssembler.h
+*/
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	CBMempool * mempool; /**< The pool to select transactions from. */
+	CBScript * outputScript; /**< The output script for the coinbase. */
+	unsigned char prevBlockHash[32]; /**< The hash of the chain tip the template builds on. */
+	unsigned int height; /**< The height of the template. */
+	unsigned int time; /**< The timestamp of the template. */
+	int target; /**< The compact target of the template. */
+	unsigned int extraNonce; /**< The extra nonce in the coinbase input script. */
+	CBTransaction ** transactions; /**< The transactions of the template, starting with the coinbase. */
+	int transactionNum; /**< The number of transactions. */
+	int transactionAlloc; /**< The number of transactions allocated for. */
+	CBAssociativeArray included; /**< The hashes of the transactions in the template. */
+	int size; /**< The serialised size of the template. */
+	int sigOps; /**< The signature operations of the template. */
+	unsigned long long int fees; /**< The fees of the transactions in the template. */
+	CBMerkleTree merkleTree; /**< The merkle tree of the transaction hashes. */
+} CBBlockAssembler;
+
+/**
+ @brief Creates a new CBBlockAssembler object.
+ @param mempool The pool to select transactions from.
+ @param outputScript The output script for the coinbase.
+ @returns A new CBBlockAssembler object.
+ */
+CBBlockAssembler * CBNewBlockAssembler(CBMempool * mempool, CBScript * outputScript);
+
+/**
+ @brief Initialises a CBBlockAssembler object.
+ @param self The CBBlockAssembler object to initialise.
+ @param mempool The pool to select transactions from.
+ @param outputScript The output script for the coinbase.
+ */
+void CBInitBlockAssembler(CBBlockAssembler * self, CBMempool * mempool, CBScript * outputScript);
+
+/**
+ @brief Releases and frees the objects stored by the CBBlockAssembler.
+ @param self The CBBlockAssembler object to destroy.
+ */
+void CBDestroyBlockAssembler(void * self);
+/**
+ @brief Frees a CBBlockAssembler object and also calls CBDestroyBlockAssembler.
+ @param self The CBBlockAssembler object to free.
+ */
+void CBFreeBlockAssembler(void * self);
+
+//  Functions
+
+/**
+ @brief Adds a transaction from the pool to the template, together with its ancestors which are not in the template, if they fit.
+ @param self The CBBlockAssembler object.
+ @param tx The transaction in the pool.
+ @returns true if the transaction is now in the template, false if it does not fit or there is no template yet from CBBlockAssemblerNewTemplate.
+ */
+bool CBBlockAssemblerAddTransaction(CBBlockAssembler * self, CBMempoolTransaction * tx);
+/**
+ @brief Creates a block from the template. The block and transactions are serialised.
+ @param self The CBBlockAssembler object.
+ @returns A new CBBlock with the nonce set to zero.
+ */
+CBBlock * CBBlockAssemblerGetBlock(CBBlockAssembler * self);
+/**
+ @brief Gets the merkle root of the template.
+ @param self The CBBlockAssembler object.
+ @returns The merkle root.
+ */
+unsigned char * CBBlockAssemblerGetMerkleRoot(CBBlockAssembler * self);
+/**
+ @brief Starts a new template on a chain tip and fills it with transactions from the pool by ancestor fee rate. The pool should have had the transactions of the tip removed.
+ @param self The CBBlockAssembler object.
+ @param prevBlockHash The hash of the chain tip.
+ @param height The height of the new block.
+ @param time The timestamp for the new block.
+ @param target The compact target for the new block.
+ */
+void CBBlockAssemblerNewTemplate(CBBlockAssembler * self, unsigned char * prevBlockHash, unsigned int height, unsigned int time, int target);
+/**
+ @brief Changes the extra nonce in the coinbase and updates the merkle root.
+ @param self The CBBlockAssembler object.
+ @param extraNonce The new extra nonce.
+ */
+void CBBlockAssemblerSetExtraNonce(CBBlockAssembler * self, unsigned int extraNonce);
+
+#endif
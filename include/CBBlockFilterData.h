@@ -0,0 +1,114 @@
+//
+//  CBBlockFilterData.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief The data elements of a block which are matched against BIP37 bloom filters, for making filtered blocks. Inherits CBObject
+ @details The scripts of a block are parsed once when the object is made, giving a list of the data pushed by the output and input scripts and the outpoints spent by the inputs. The elements point into the transaction data, so the block is retained. A block served to many lightweight clients is then matched against each of their filters without parsing the scripts again.
+ A transaction matches a filter as in BIP37 when the filter contains the transaction hash, data pushed by an output script, an outpoint spent by an input or data pushed by an input script. When data in an output matches, the outpoint of the output is inserted into the filter according to the update flag so that transactions spending the output match as well.
+ */
+
+#ifndef CBBLOCKFILTERDATAH
+#define CBBLOCKFILTERDATAH
+
+//  Includes
+
+#include "CBMerkleBlock.h"
+#include "CBBloomFilter.h"
+
+// Constants and Macros
+
+#define CBGetBlockFilterData(x) ((CBBlockFilterData *)x)
+
+/**
+ @brief A data element pushed by a script.
+ */
+typedef struct{
+	unsigned char * data; /**< The pushed data, in the transaction data. */
+	int length; /**< The length of the data. */
+	int outputIndex; /**< The index of the output with the script, or -1 for an input script. */
+	bool isPubKey; /**< For outputs, true if the output is pay-to-pubkey or multisig. */
+} CBBlockFilterElement;
+
+/**
+ @brief The elements of a transaction in the element and outpoint lists.
+ */
+typedef struct{
+	int outputStart; /**< The index of the first element of the output scripts. */
+	int inputStart; /**< The index of the first element of the input scripts. */
+	int end; /**< The index after the last element of the transaction. */
+	int outPointStart; /**< The index of the first outpoint. */
+	int outPointEnd; /**< The index after the last outpoint. */
+} CBBlockFilterTransaction;
+
+/**
+ @brief Structure for CBBlockFilterData objects. @see CBBlockFilterData.h
+ */
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	CBBlock * block; /**< The block. */
+	unsigned char * hashes; /**< The transaction hashes, 32 bytes each. */
+	CBBlockFilterTransaction * transactions; /**< The elements of each transaction. */
+	CBBlockFilterElement * elements; /**< The pushed data elements of all transactions. */
+	int elementNum; /**< The number of elements. */
+	unsigned char * outPoints; /**< The outpoints of all inputs, 36 bytes each. */
+	int outPointNum; /**< The number of outpoints. */
+} CBBlockFilterData;
+
+/**
+ @brief Creates a new CBBlockFilterData object.
+ @param block The block, deserialised with transactions.
+ @returns A new CBBlockFilterData object.
+ */
+CBBlockFilterData * CBNewBlockFilterData(CBBlock * block);
+
+/**
+ @brief Initialises a CBBlockFilterData object.
+ @param self The CBBlockFilterData object to initialise.
+ @param block The block, deserialised with transactions.
+ */
+void CBInitBlockFilterData(CBBlockFilterData * self, CBBlock * block);
+
+/**
+ @brief Releases and frees the objects stored by the CBBlockFilterData object.
+ @param self The CBBlockFilterData object to destroy.
+ */
+void CBDestroyBlockFilterData(void * self);
+/**
+ @brief Frees a CBBlockFilterData object and also calls CBDestroyBlockFilterData.
+ @param self The CBBlockFilterData object to free.
+ */
+void CBFreeBlockFilterData(void * self);
+
+//  Functions
+
+/**
+ @brief Matches the transactions of the block against a filter and makes a merkleblock for the matches. The filter is updated for matched outputs.
+ @param self The CBBlockFilterData object.
+ @param filter The filter of the peer.
+ @param matches The matched transactions are written here, to be sent after the merkleblock. Needs room for every transaction in the block. The transactions are not retained.
+ @param matchNum The number of matched transactions is written here.
+ @returns A new CBMerkleBlock.
+ */
+CBMerkleBlock * CBBlockFilterDataGetMerkleBlock(CBBlockFilterData * self, CBBloomFilter * filter, CBTransaction ** matches, int * matchNum);
+/**
+ @brief Determines if a transaction of the block matches a filter. The filter is updated for matched outputs.
+ @param self The CBBlockFilterData object.
+ @param filter The filter.
+ @param index The index of the transaction in the block.
+ @returns true if the transaction matches, false otherwise.
+ */
+bool CBBlockFilterDataMatchTransaction(CBBlockFilterData * self, CBBloomFilter * filter, int index);
+
+#endif
@@ -15,6 +15,7 @@
 /**
  @file
  @brief A message used to send and receive block headers. Inherits CBMessage
+ @details The headers can be CBBlock objects or a flat representation, where the headers are kept as serialised with CB_BLOCK_HEADERS_ENTRY_SIZE bytes for each. Flat headers are deserialised without copying or any allocations and can be hashed and checked in a loop. A CBBlockHeaders object should only use one of the representations. Received "headers" messages are only given flat to onMessageReceived when the CBNetworkCommunicator has the CB_NETWORK_COMMUNICATOR_FLAT_HEADERS flag, otherwise the blockHeaders array is filled as before.
 */
 
 #ifndef CBBLOCKHEADERSH
@@ -26,7 +27,15 @@
 
 // Cosntants
 
+#define CB_BLOCK_HEADERS_MAX_NUM 2000
+#define CB_BLOCK_HEADERS_ENTRY_SIZE 82 // The 80 byte header, the transaction number as a one byte var int and the null byte.
 #define CBGetBlockHeaders(x) ((CBBlockHeaders *)x)
+#define CBBlockHeaderGetVersion(header) CBArrayToInt32(header, 0)
+#define CBBlockHeaderGetPrevBlockHash(header) ((header) + 4)
+#define CBBlockHeaderGetMerkleRoot(header) ((header) + 36)
+#define CBBlockHeaderGetTime(header) CBArrayToInt32(header, 68)
+#define CBBlockHeaderGetTarget(header) CBArrayToInt32(header, 72)
+#define CBBlockHeaderGetNonce(header) CBArrayToInt32(header, 76)
 
 /**
  @brief Structure for CBBlockHeaders objects. @see CBBlockHeaders.h
@@ -34,7 +43,9 @@
 typedef struct{
 	CBMessage base; /**< CBMessage base structure */
 	int headerNum; /**< The number of headers. */
-	CBBlock * blockHeaders[2000]; /**< The block headers as CBBlock objects with no transactions. The number of transactions is given however. */
+	CBBlock * blockHeaders[CB_BLOCK_HEADERS_MAX_NUM]; /**< The block headers as CBBlock objects with no transactions. The number of transactions is given however. Not used for flat headers. */
+	unsigned char * headers; /**< The flat headers, or NULL if the headers are CBBlock objects. @see CBBlockHeadersGetHeader */
+	bool ownHeaders; /**< True if the flat headers were allocated, false if they reference the message bytes. */
 } CBBlockHeaders;
 
 /**
@@ -78,18 +89,41 @@ void CBFreeBlockHeaders(void * self);
 //  Functions
 
 /**
- @brief Adds a CBBlock into the block header list.
+ @brief Adds a CBBlock into the block header list. Not for flat headers.
  @param self The CBBlockHeaders object
  @param address The CBBlock to add.
  */
 void CBBlockHeadersAddBlockHeader(CBBlockHeaders * self, CBBlock * header);
 
+/**
+ @brief Adds a serialised header to the flat headers.
+ @param self The CBBlockHeaders object, which has no CBBlock objects.
+ @param header The 80 byte header.
+ @param transactionNum The number of transactions given for the header, below 0xFD.
+ @returns true on success, false if there are already CB_BLOCK_HEADERS_MAX_NUM headers.
+ */
+bool CBBlockHeadersAddHeader(CBBlockHeaders * self, unsigned char * header, int transactionNum);
+/**
+ @brief Calculates the hash of a flat header.
+ @param self The CBBlockHeaders object.
+ @param index The index of the header.
+ @param hash The 32 byte hash is written here.
+ */
+void CBBlockHeadersCalculateHash(CBBlockHeaders * self, int index, unsigned char * hash);
 /**
  @brief Calculates the length needed to serialise the object.
  @param self The CBBlockHeaders object.
  @returns The length
  */
 int CBBlockHeadersCalculateLength(CBBlockHeaders * self);
+/**
+ @brief Checks that the flat headers link to each other and have valid proof of work.
+ @param self The CBBlockHeaders object.
+ @param prevHash If not NULL, the hash the first header should link to.
+ @param hashes If not NULL, the hashes of the valid headers are written here, needing 32 bytes for each header.
+ @returns The number of valid headers before the first invalid header, or headerNum if all headers are valid.
+ */
+int CBBlockHeadersCheckChain(CBBlockHeaders * self, unsigned char * prevHash, unsigned char * hashes);
 
 /**
  @brief Deserialises a CBBlockHeaders so that it can be used as an object.
@@ -97,6 +131,33 @@ int CBBlockHeadersCalculateLength(CBBlockHeaders * self);
  @returns The length read on success, 0 on failure.
 */
 int CBBlockHeadersDeserialise(CBBlockHeaders * self);
+/**
+ @brief Deserialises a CBBlockHeaders into the flat representation, referencing the message bytes.
+ @param self The CBBlockHeaders object
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure, including when a header has a transaction number over one byte.
+*/
+int CBBlockHeadersDeserialiseFlat(CBBlockHeaders * self);
+/**
+ @brief Gets a flat header as a new CBBlock object with no transactions.
+ @param self The CBBlockHeaders object.
+ @param index The index of the header.
+ @returns A new CBBlock object.
+ */
+CBBlock * CBBlockHeadersGetBlock(CBBlockHeaders * self, int index);
+/**
+ @brief Gets a flat header.
+ @param self The CBBlockHeaders object.
+ @param index The index of the header.
+ @returns The 80 byte header, which can be read with the CBBlockHeaderGet macros.
+ */
+unsigned char * CBBlockHeadersGetHeader(CBBlockHeaders * self, int index);
+/**
+ @brief Gets the number of transactions given for a flat header.
+ @param self The CBBlockHeaders object.
+ @param index The index of the header.
+ @returns The number of transactions.
+ */
+int CBBlockHeadersGetTransactionNum(CBBlockHeaders * self, int index);
 
 void CBBlockHeadersPrepareBytes(CBBlockHeaders * self);
 
@@ -109,7 +170,7 @@ void CBBlockHeadersPrepareBytes(CBBlockHeaders * self);
 int CBBlockHeadersSerialise(CBBlockHeaders * self, bool force);
 
 /**
- @brief Takes a CBBlock for the block header list. This does not retain the CBBlock so you can pass an CBBlock into this while releasing control from the calling function.
+ @brief Takes a CBBlock for the block header list. Not for flat headers. This does not retain the CBBlock so you can pass an CBBlock into this while releasing control from the calling function.
  @param self The CBBlockHeaders object
  @param address The CBBlock to take.
  */
@@ -0,0 +1,156 @@
+//
+//  CBBlockScanner.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Finds the outputs paying watched hashes and the inputs spending them in blocks, for wallets following the chain and rescanning it. Inherits CBObject
+ @details Blocks are read from their serialised bytes, so blocks from storage do not need to be deserialised and no transaction objects are made. The hash of each output script is taken from the pay-to-pubkey-hash and P2SH templates, or by hashing the key of pay-to-pubkey outputs, and is looked up in a CBHash160Map. The transaction hash is only calculated for transactions with a match. Found outputs are watched by their outpoints so that the inputs spending them are found.
+ Blocks given together are scanned concurrently on the thread pool. As an output and the input spending it can be in different blocks of the same call, the outpoints found are added in order of height after the blocks have been scanned, and only the inputs of the blocks after the first new output are read again for them. The matches are given to the callback in order of height, transaction and input or output on the calling thread.
+ */
+
+#ifndef CBBLOCKSCANNERH
+#define CBBLOCKSCANNERH
+
+//  Includes
+
+#include "CBAssociativeArray.h"
+#include "CBBlock.h"
+#include "CBHash160Map.h"
+#include "CBThreadPoolQueue.h"
+
+// Constants and Macros
+
+#define CBGetBlockScanner(x) ((CBBlockScanner *)x)
+
+/**
+ @brief The kind of a CBBlockScannerMatch.
+ */
+typedef enum{
+	CB_BLOCK_SCANNER_SPEND, /**< An input spending a watched outpoint. */
+	CB_BLOCK_SCANNER_OUTPUT, /**< An output paying a watched hash. */
+} CBBlockScannerMatchType;
+
+/**
+ @brief An input or output found by a CBBlockScanner.
+ */
+typedef struct{
+	CBBlockScannerMatchType type; /**< Whether an output or an input was found. */
+	unsigned int height; /**< The height of the block. */
+	int txIndex; /**< The index of the transaction in the block. */
+	unsigned char txHash[32]; /**< The hash of the transaction. */
+	int index; /**< The index of the output or input in the transaction. */
+	uint64_t value; /**< The value of an output, or zero for an input. */
+	void * watched; /**< The pointer given when watching the hash paid by an output or the outpoint spent by an input. The outpoint of a found output is watched with the pointer of its hash. */
+} CBBlockScannerMatch;
+
+/**
+ @brief A watched outpoint of a CBBlockScanner. The outpoint is placed first so that it can be used as the key in a CBAssociativeArray.
+ */
+typedef struct{
+	unsigned char outPoint[36]; /**< The transaction hash followed by the 32-bit little-endian output index. */
+	void * watched; /**< The pointer given for matches spending the outpoint. */
+	bool added; /**< true while the outpoint is being added after a scan, so that only inputs spending it are found when the following blocks are read again. */
+} CBBlockScannerOutPoint;
+
+/**
+ @brief The matches of a block being scanned.
+ */
+typedef struct{
+	CBByteArray * bytes; /**< The serialised block. */
+	unsigned int height; /**< The height of the block. */
+	CBBlockScannerMatch * matches; /**< The matches found. */
+	int matchNum; /**< The number of matches. */
+	int matchAlloc; /**< The number of matches allocated for. */
+	bool ok; /**< false if the block could not be read. */
+} CBBlockScannerBlock;
+
+/**
+ @brief Structure for CBBlockScanner objects. @see CBBlockScanner.h
+ */
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	int numThreads; /**< The number of threads in the thread pool. Zero if blocks are scanned on the calling thread only. */
+	CBThreadPoolQueue pool; /**< The thread pool for scanning blocks concurrently. */
+	CBHash160Map hashes; /**< The watched hashes of public keys and scripts. */
+	CBAssociativeArray outPoints; /**< The watched outpoints as CBBlockScannerOutPoint. */
+	void (*onMatch)(void *, CBBlockScannerMatch *); /**< Called for each match. */
+	void * callbackObject; /**< Passed to onMatch. */
+} CBBlockScanner;
+
+/**
+ @brief A block given to the thread pool of a CBBlockScanner.
+ */
+typedef struct{
+	CBQueueItem base; /**< The queue item. */
+	CBBlockScanner * scanner; /**< The CBBlockScanner object. */
+	CBBlockScannerBlock * block; /**< The block to scan. */
+} CBBlockScannerJob;
+
+/**
+ @brief Creates a new CBBlockScanner object.
+ @param numThreads The number of threads to scan blocks with. Use zero to scan on the calling thread only.
+ @param onMatch Called for each match with the callback object, on the thread which called the scan function.
+ @param callbackObject Passed to onMatch.
+ @returns A new CBBlockScanner object.
+ */
+CBBlockScanner * CBNewBlockScanner(int numThreads, void (*onMatch)(void *, CBBlockScannerMatch *), void * callbackObject);
+
+/**
+ @brief Initialises a CBBlockScanner object.
+ @param self The CBBlockScanner object to initialise.
+ @param numThreads The number of threads to scan blocks with.
+ @param onMatch Called for each match.
+ @param callbackObject Passed to onMatch.
+ */
+void CBInitBlockScanner(CBBlockScanner * self, int numThreads, void (*onMatch)(void *, CBBlockScannerMatch *), void * callbackObject);
+
+/**
+ @brief Stops the threads and frees the watched hashes and outpoints of a CBBlockScanner object.
+ @param self The CBBlockScanner object to destroy.
+ */
+void CBDestroyBlockScanner(void * self);
+/**
+ @brief Frees a CBBlockScanner object and also calls CBDestroyBlockScanner.
+ @param self The CBBlockScanner object to free.
+ */
+void CBFreeBlockScanner(void * self);
+
+//  Functions
+
+/**
+ @brief Scans blocks, concurrently when the scanner has threads, and gives the matches to the callback.
+ @param self The CBBlockScanner object.
+ @param blocks The blocks in order of height. Only the serialised bytes are read.
+ @param num The number of blocks.
+ @param firstHeight The height of the first block.
+ @returns true if every block could be read. Matches are given for the blocks before the first block which could not be read.
+ */
+bool CBBlockScannerScanBlocks(CBBlockScanner * self, CBBlock ** blocks, int num, unsigned int firstHeight);
+/**
+ @brief Watches the outputs paying a hash.
+ @param self The CBBlockScanner object.
+ @param hash The 20 byte hash of a public key, for pay-to-pubkey-hash and pay-to-pubkey outputs, or of a script, for P2SH outputs.
+ @param watched A pointer given with the matches, which cannot be NULL.
+ */
+void CBBlockScannerWatchHash(CBBlockScanner * self, unsigned char * hash, void * watched);
+/**
+ @brief Watches the inputs spending an output.
+ @param self The CBBlockScanner object.
+ @param txHash The 32 byte hash of the transaction with the output.
+ @param index The index of the output.
+ @param watched A pointer given with the matches.
+ */
+void CBBlockScannerWatchOutPoint(CBBlockScanner * self, unsigned char * txHash, unsigned int index, void * watched);
+
+#endif
@@ -0,0 +1,107 @@
+//
+//  CBBlockTxn.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A "blocktxn" message as in BIP152, which has the transactions of a block requested by a "getblocktxn" message, in the order they were requested. Inherits CBMessage
+ */
+
+#ifndef CBBLOCKTXNH
+#define CBBLOCKTXNH
+
+//  Includes
+
+#include "CBTransaction.h"
+#include "CBGetBlockTxn.h"
+
+// Constants and Macros
+
+#define CBGetBlockTxn(x) ((CBBlockTxn *)x)
+
+/**
+ @brief Structure for CBBlockTxn objects. @see CBBlockTxn.h
+ */
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	CBByteArray * blockHash; /**< The hash of the block. */
+	int transactionNum; /**< The number of transactions. */
+	CBTransaction ** transactions; /**< The requested transactions, which must be serialised. */
+} CBBlockTxn;
+
+/**
+ @brief Creates a new CBBlockTxn object with the transactions of a block requested by a "getblocktxn" message.
+ @param request The "getblocktxn" message. The indexes should be checked to be in the block beforehand.
+ @param transactions The transactions of the block, which must be serialised. The requested transactions are retained.
+ @returns A new CBBlockTxn object.
+ */
+CBBlockTxn * CBNewBlockTxn(CBGetBlockTxn * request, CBTransaction ** transactions);
+/**
+ @brief Creates a new CBBlockTxn object from serialised data.
+ @param data Serialised CBBlockTxn data.
+ @returns A new CBBlockTxn object.
+ */
+CBBlockTxn * CBNewBlockTxnFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBBlockTxn object with the transactions of a block requested by a "getblocktxn" message.
+ @param self The CBBlockTxn object to initialise.
+ @param request The "getblocktxn" message. The indexes should be checked to be in the block beforehand.
+ @param transactions The transactions of the block, which must be serialised. The requested transactions are retained.
+ */
+void CBInitBlockTxn(CBBlockTxn * self, CBGetBlockTxn * request, CBTransaction ** transactions);
+/**
+ @brief Initialises a CBBlockTxn object from serialised data.
+ @param self The CBBlockTxn object to initialise.
+ @param data The serialised data.
+ */
+void CBInitBlockTxnFromData(CBBlockTxn * self, CBByteArray * data);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBBlockTxn object.
+ @param self The CBBlockTxn object to destroy.
+ */
+void CBDestroyBlockTxn(void * self);
+/**
+ @brief Frees a CBBlockTxn object and also calls CBDestroyBlockTxn.
+ @param self The CBBlockTxn object to free.
+ */
+void CBFreeBlockTxn(void * self);
+
+//  Functions
+
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBBlockTxn object.
+ @returns The length.
+ */
+int CBBlockTxnCalculateLength(CBBlockTxn * self);
+/**
+ @brief Deserialises a CBBlockTxn so that it can be used as an object.
+ @param self The CBBlockTxn object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBBlockTxnDeserialise(CBBlockTxn * self);
+/**
+ @brief Prepares the bytes for serialising the object.
+ @param self The CBBlockTxn object.
+ */
+void CBBlockTxnPrepareBytes(CBBlockTxn * self);
+/**
+ @brief Serialises a CBBlockTxn to the byte data.
+ @param self The CBBlockTxn object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBBlockTxnSerialise(CBBlockTxn * self);
+
+#endif
@@ -0,0 +1,124 @@
+//
+//  CBBlockUndo.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Undo data for a block, produced when the block is connected to a CBUnspentOutputSet and used to disconnect the block when the main chain switches. The undo data contains the outputs spent by every non-coinbase input of the block in order and should be stored alongside the block. Inherits CBMessage
+ @details The serialised format starts with the 32 byte block hash followed by a variable size integer for the number of spent outputs. Each spent output is then encoded as a variable size integer of the height shifted left once with the lowest bit set for coinbase outputs, a variable size integer of the value compressed with CBCompressAmount, a variable size integer for the script length and the script. The outpoints are not stored since they are given by the inputs of the block.
+*/
+
+#ifndef CBBLOCKUNDOH
+#define CBBLOCKUNDOH
+
+//  Includes
+
+#include "CBBlock.h"
+#include "CBUnspentOutputSet.h"
+
+// Constants and Macros
+
+#define CBGetBlockUndo(x) ((CBBlockUndo *)x)
+
+/**
+ @brief Structure for CBBlockUndo objects. @see CBBlockUndo.h
+*/
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	unsigned char blockHash[32]; /**< The hash of the block this undo data is for. */
+	int spentNum; /**< The number of spent outputs. */
+	int spentAlloc; /**< The number of spent outputs allocated for. */
+	CBUnspentOutput ** spent; /**< The outputs spent by the block, in the order of the inputs spending them. */
+} CBBlockUndo;
+
+/**
+ @brief Creates a new CBBlockUndo object.
+ @returns A new CBBlockUndo object.
+ */
+CBBlockUndo * CBNewBlockUndo(void);
+/**
+ @brief Creates a new CBBlockUndo object from serialised data.
+ @param data Serialised CBBlockUndo data.
+ @returns A new CBBlockUndo object.
+ */
+CBBlockUndo * CBNewBlockUndoFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBBlockUndo object.
+ @param self The CBBlockUndo object to initialise.
+ */
+void CBInitBlockUndo(CBBlockUndo * self);
+/**
+ @brief Initialises a CBBlockUndo object from serialised data.
+ @param self The CBBlockUndo object to initialise.
+ @param data The serialised data.
+ */
+void CBInitBlockUndoFromData(CBBlockUndo * self, CBByteArray * data);
+
+/**
+ @brief Frees the spent outputs held by the CBBlockUndo object.
+ @param self The CBBlockUndo object to destroy.
+ */
+void CBDestroyBlockUndo(void * self);
+/**
+ @brief Frees a CBBlockUndo object and also calls CBDestroyBlockUndo.
+ @param self The CBBlockUndo object to free.
+ */
+void CBFreeBlockUndo(void * self);
+
+//  Functions
+
+/**
+ @brief Connects a block to an unspent output set. Each transaction in turn has the outputs it spends removed from the set and its own outputs added. If an input spends an output which does not exist in the set, the changes are reverted and false is returned.
+ @param block The block with transactions. The transactions should be serialised so that the hashes can be obtained.
+ @param set The unspent output set.
+ @param height The height of the block.
+ @param undo An empty CBBlockUndo object to receive the spent outputs.
+ @returns true on success or false if an output could not be found.
+ */
+bool CBBlockConnect(CBBlock * block, CBUnspentOutputSet * set, unsigned int height, CBBlockUndo * undo);
+/**
+ @brief Disconnects a block from an unspent output set by applying the undo data in reverse. The outputs of the block are removed and the spent outputs are moved back into the set, leaving the undo data empty.
+ @param block The block with transactions.
+ @param set The unspent output set.
+ @param undo The undo data produced by CBBlockConnect or deserialised for the block.
+ @returns true on success or false if the undo data does not match the block or the set was inconsistent with the block. On an inconsistency the block is still disconnected as far as possible.
+ */
+bool CBBlockDisconnect(CBBlock * block, CBUnspentOutputSet * set, CBBlockUndo * undo);
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBBlockUndo object.
+ @returns The length.
+ */
+int CBBlockUndoCalculateLength(CBBlockUndo * self);
+/**
+ @brief Deserialises a CBBlockUndo so that it can be used as an object.
+ @param self The CBBlockUndo object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBBlockUndoDeserialise(CBBlockUndo * self);
+void CBBlockUndoPrepareBytes(CBBlockUndo * self);
+/**
+ @brief Serialises a CBBlockUndo to the byte data.
+ @param self The CBBlockUndo object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBBlockUndoSerialise(CBBlockUndo * self);
+/**
+ @brief Takes a spent output onto the end of the undo data.
+ @param self The CBBlockUndo object.
+ @param spent The spent output which becomes owned by the undo data.
+ */
+void CBBlockUndoTakeSpentOutput(CBBlockUndo * self, CBUnspentOutput * spent);
+
+#endif
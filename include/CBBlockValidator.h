@@ -0,0 +1,183 @@
+//
+//  CBBlockValidator.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Validates full blocks in stages and connects them to a CBUnspentOutputSet. Inherits CBObject
+ @details Validation is done in four stages:
+ 1. Context-free checks: size, proof of work against the block's own target, timestamp, coinbase placement, CBTransactionValidateBasic, signature operation limits and double spends between transactions. The transaction hashes are calculated here.
+ 2. The merkle root and duplicate transaction checks.
+ 3. Unspent output lookups by connecting the block, transaction finality, coinbase maturity and value and fee checks.
+ 4. Script verification for every non-coinbase input.
+ When the validator has threads, stage 2 runs on the thread pool whilst stage 3 runs on the calling thread, and the inputs for stage 4 are split across the thread pool. Checks requiring the block chain, such as the previous block and the expected target, are left to the caller.
+ For initial synchronisation, CBBlockValidatorSetAssumeValid configures a trusted block hash. Stage 4 is skipped for the trusted block and its ancestors and every other stage is still done. A block only skips stage 4 if its hash is the hash of the trusted chain at its height, so blocks on any other chain are always fully verified.
+*/
+
+#ifndef CBBLOCKVALIDATORH
+#define CBBLOCKVALIDATORH
+
+//  Includes
+
+#include "CBBlockUndo.h"
+#include "CBThreadPoolQueue.h"
+
+// Constants and Macros
+
+#define CB_VALIDATION_INPUTS_PER_JOB 16 // The minimum number of inputs to verify in one thread pool item.
+#define CBGetBlockValidator(x) ((CBBlockValidator *)x)
+
+/**
+ @brief The reason a block failed validation.
+ */
+typedef enum{
+	CB_BLOCK_VALIDATION_OK, /**< The block is valid. */
+	CB_BLOCK_VALIDATION_NO_TRANSACTIONS, /**< The block has no transactions. */
+	CB_BLOCK_VALIDATION_BAD_SIZE, /**< The block is over CB_BLOCK_MAX_SIZE. */
+	CB_BLOCK_VALIDATION_BAD_POW, /**< The block hash is above the target or the target is invalid. */
+	CB_BLOCK_VALIDATION_BAD_TIME, /**< The timestamp is too far in the future. */
+	CB_BLOCK_VALIDATION_BAD_COINBASE, /**< The first transaction is not a coinbase or another transaction is. */
+	CB_BLOCK_VALIDATION_BAD_TRANSACTION, /**< A transaction failed CBTransactionValidateBasic. */
+	CB_BLOCK_VALIDATION_TOO_MANY_SIGOPS, /**< The block is over CB_MAX_SIG_OPS. */
+	CB_BLOCK_VALIDATION_DOUBLE_SPEND, /**< Two inputs in the block spend the same output. */
+	CB_BLOCK_VALIDATION_BAD_MERKLE_ROOT, /**< The merkle root does not match the transactions. */
+	CB_BLOCK_VALIDATION_DUPLICATE_TRANSACTION, /**< Two transactions have the same hash. */
+	CB_BLOCK_VALIDATION_NOT_FINAL, /**< A transaction is not final. */
+	CB_BLOCK_VALIDATION_BAD_SPEND, /**< An input spends a missing or spent output, or an output would replace an unspent output. */
+	CB_BLOCK_VALIDATION_IMMATURE_COINBASE, /**< An input spends a coinbase output before CB_COINBASE_MATURITY blocks. */
+	CB_BLOCK_VALIDATION_BAD_VALUE, /**< A transaction spends more than its inputs or the input values overflow. */
+	CB_BLOCK_VALIDATION_BAD_COINBASE_VALUE, /**< The coinbase claims more than the block reward and fees. */
+	CB_BLOCK_VALIDATION_BAD_SCRIPT, /**< An input script failed verification. */
+} CBBlockValidationResult;
+
+/**
+ @brief An input for script verification.
+ */
+typedef struct{
+	CBTransaction * tx; /**< The transaction with the input. */
+	int txIndex; /**< The index of the transaction in the block. */
+	int index; /**< The index of the input. */
+	CBUnspentOutput * spent; /**< The output spent by the input. */
+} CBValidationInput;
+
+/**
+ @brief Structure for CBBlockValidator objects. @see CBBlockValidator.h
+*/
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	int numThreads; /**< The number of threads in the thread pool. Zero if all validation is done on the calling thread. */
+	CBThreadPoolQueue pool; /**< The thread pool for concurrent stages. */
+	CBDepObject resultMutex; /**< Protects the results written by the thread pool. */
+	CBBlock * block; /**< The block being validated. */
+	bool p2sh; /**< True if P2SH scripts are being verified for the block. */
+	CBValidationInput * inputs; /**< The inputs to verify for the block. */
+	int inputNum; /**< The number of inputs to verify. */
+	int inputAlloc; /**< The number of inputs allocated for. */
+	CBBlockValidationResult merkleResult; /**< The result of the merkle root stage. */
+	CBBlockValidationResult scriptResult; /**< The result of the script stage. */
+	int failedTransaction; /**< The index of the transaction which caused the last validation failure, or -1 if it was not caused by a single transaction. */
+	unsigned char * assumeValidHashes; /**< The block hashes of the trusted chain by height, ending with the trusted block, or NULL if assume-valid is not used. */
+	int assumeValidNum; /**< The number of hashes in assumeValidHashes. */
+	unsigned int assumeValidFirstHeight; /**< The height of the first hash in assumeValidHashes. */
+	bool assumedValid; /**< True if the scripts of the last block were not verified because it is on the trusted chain. */
+} CBBlockValidator;
+
+/**
+ @brief Creates a new CBBlockValidator object.
+ @param numThreads The number of threads to use for concurrent validation. Use zero to validate on the calling thread only.
+ @returns A new CBBlockValidator object.
+ */
+CBBlockValidator * CBNewBlockValidator(int numThreads);
+
+/**
+ @brief Initialises a CBBlockValidator object.
+ @param self The CBBlockValidator object to initialise.
+ @param numThreads The number of threads to use for concurrent validation.
+ */
+void CBInitBlockValidator(CBBlockValidator * self, int numThreads);
+
+/**
+ @brief Stops the threads of a CBBlockValidator object.
+ @param self The CBBlockValidator object to destroy.
+ */
+void CBDestroyBlockValidator(void * self);
+/**
+ @brief Frees a CBBlockValidator object and also calls CBDestroyBlockValidator.
+ @param self The CBBlockValidator object to free.
+ */
+void CBFreeBlockValidator(void * self);
+
+//  Functions
+
+/**
+ @brief Determines if a block is the trusted block for assume-valid or one of its ancestors.
+ @param self The CBBlockValidator object.
+ @param hash The block hash.
+ @param height The height of the block.
+ @returns true if the hash is the hash of the trusted chain at the height, false otherwise.
+ */
+bool CBBlockValidatorIsAssumedValid(CBBlockValidator * self, unsigned char * hash, unsigned int height);
+/**
+ @brief Sets the trusted block for assume-valid, replacing any previous trusted block. The headers of the trusted chain are checked to link to each other with valid proof of work and to end with the trusted block, so that no hash is trusted unless the trusted hash commits to it.
+ @param self The CBBlockValidator object.
+ @param trustedHash The hash of the trusted block, or NULL to disable assume-valid.
+ @param headers The block headers up to and including the trusted block, in order of height.
+ @param headerNum The number of headers.
+ @param firstHeight The height of the first header.
+ @returns true if assume-valid was set, false if the headers are not a valid chain to the trusted block, in which case assume-valid is disabled.
+ */
+bool CBBlockValidatorSetAssumeValid(CBBlockValidator * self, unsigned char * trustedHash, CBBlock ** headers, int headerNum, unsigned int firstHeight);
+/**
+ @brief Fully validates a block and connects it to an unspent output set, skipping script verification if the block is assumed valid. On failure the set is left unchanged.
+ @param self The CBBlockValidator object.
+ @param block The block with transactions. The block and transactions should be serialised.
+ @param set The unspent output set for the previous block.
+ @param height The height of the block.
+ @param networkTime The network time to check the timestamp against.
+ @param undo An empty CBBlockUndo object which receives the undo data for the block on success.
+ @returns CB_BLOCK_VALIDATION_OK if the block is valid and was connected, otherwise the reason for the failure.
+ */
+CBBlockValidationResult CBValidateBlock(CBBlockValidator * self, CBBlock * block, CBUnspentOutputSet * set, unsigned int height, unsigned int networkTime, CBBlockUndo * undo);
+/**
+ @brief Does the context-free checks of stage 1 and calculates the transaction hashes.
+ @param block The block with transactions.
+ @param networkTime The network time to check the timestamp against.
+ @param failedTransaction Set to the index of the failing transaction, or -1.
+ @returns CB_BLOCK_VALIDATION_OK or the reason for the failure.
+ */
+CBBlockValidationResult CBValidateBlockContextFree(CBBlock * block, unsigned int networkTime, int * failedTransaction);
+/**
+ @brief Does the checks of stage 2, verifying the merkle root and that no two transactions share a hash. The transaction hashes should already be calculated.
+ @param block The block with transactions.
+ @returns CB_BLOCK_VALIDATION_OK or the reason for the failure.
+ */
+CBBlockValidationResult CBValidateBlockMerkleRoot(CBBlock * block);
+/**
+ @brief Does the checks of stage 3 by connecting the block to the unspent output set and checking finality, coinbase maturity, input and output values and the coinbase value. The inputs are collected for script verification. On failure the block is disconnected.
+ @param self The CBBlockValidator object.
+ @param block The block with transactions.
+ @param set The unspent output set for the previous block.
+ @param height The height of the block.
+ @param undo An empty CBBlockUndo object which receives the undo data.
+ @returns CB_BLOCK_VALIDATION_OK or the reason for the failure.
+ */
+CBBlockValidationResult CBValidateBlockSpends(CBBlockValidator * self, CBBlock * block, CBUnspentOutputSet * set, unsigned int height, CBBlockUndo * undo);
+/**
+ @brief Verifies the scripts for an input.
+ @param input The input with the output it spends.
+ @param p2sh True if P2SH scripts should be verified.
+ @returns true if the scripts are valid, false otherwise.
+ */
+bool CBValidateInputScripts(CBValidationInput * input, bool p2sh);
+
+#endif
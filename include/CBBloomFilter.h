@@ -0,0 +1,150 @@
+//
+//  CBBloomFilter.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A bloom filter as in BIP37, used in "filterload" messages. Inherits CBMessage
+ @details Lightweight clients load a filter into a peer so that the peer only sends them the transactions which match the filter. Each element is hashed with MurmurHash3 once for each hash function, with the seeds made from the hash function number and the tweak, and the bits for the hashes are set. The filter can be updated with the outpoints of matched outputs so that transactions spending them match as well. @see CBBlockFilterData.h
+ */
+
+#ifndef CBBLOOMFILTERH
+#define CBBLOOMFILTERH
+
+//  Includes
+
+#include "CBMessage.h"
+
+// Constants and Macros
+
+#define CB_BLOOM_FILTER_MAX_SIZE 36000 // The maximum number of bytes in a filter.
+#define CB_BLOOM_FILTER_MAX_HASH_FUNCS 50 // The maximum number of hash functions.
+#define CB_BLOOM_FILTER_MIN_FALSE_POSITIVE_RATE 1e-9 // Lower false positive rates are raised to this.
+#define CB_BLOOM_FILTER_SEED_MULTIPLIER 0xFBA4C795 // Multiplied by the hash function number for the seed.
+#define CBGetBloomFilter(x) ((CBBloomFilter *)x)
+
+/**
+ @brief How a filter is updated when an output matches.
+ */
+typedef enum{
+	CB_BLOOM_FILTER_UPDATE_NONE = 0, /**< The filter is not updated. */
+	CB_BLOOM_FILTER_UPDATE_ALL = 1, /**< The outpoint of any matched output is added. */
+	CB_BLOOM_FILTER_UPDATE_P2PUBKEY_ONLY = 2, /**< The outpoint is only added for matched pay-to-pubkey and multisig outputs. */
+} CBBloomFilterUpdate;
+
+/**
+ @brief Structure for CBBloomFilter objects. @see CBBloomFilter.h
+ */
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	CBByteArray * filter; /**< The filter bits. */
+	unsigned int hashFuncNum; /**< The number of hash functions. */
+	unsigned int tweak; /**< Added to the seeds of the hash functions. */
+	CBBloomFilterUpdate update; /**< How the filter is updated when an output matches. */
+	bool full; /**< True when all bits are set, so everything matches. */
+	bool empty; /**< True when no bits are set, so nothing matches. */
+} CBBloomFilter;
+
+/**
+ @brief Creates a new CBBloomFilter object for a number of elements and a false positive rate, within the maximum size and number of hash functions.
+ @param elementNum The number of elements the filter is for.
+ @param falsePositiveRate The rate of false positives when the filter has that number of elements, between CB_BLOOM_FILTER_MIN_FALSE_POSITIVE_RATE and 1.
+ @param tweak Added to the seeds of the hash functions.
+ @param update How the filter is updated when an output matches.
+ @returns A new CBBloomFilter object.
+ */
+CBBloomFilter * CBNewBloomFilter(int elementNum, double falsePositiveRate, unsigned int tweak, CBBloomFilterUpdate update);
+/**
+ @brief Creates a new CBBloomFilter object from serialised data.
+ @param data Serialised CBBloomFilter data.
+ @returns A new CBBloomFilter object.
+ */
+CBBloomFilter * CBNewBloomFilterFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBBloomFilter object.
+ @param self The CBBloomFilter object to initialise.
+ @param elementNum The number of elements the filter is for.
+ @param falsePositiveRate The rate of false positives when the filter has that number of elements, between CB_BLOOM_FILTER_MIN_FALSE_POSITIVE_RATE and 1.
+ @param tweak Added to the seeds of the hash functions.
+ @param update How the filter is updated when an output matches.
+ */
+void CBInitBloomFilter(CBBloomFilter * self, int elementNum, double falsePositiveRate, unsigned int tweak, CBBloomFilterUpdate update);
+/**
+ @brief Initialises a CBBloomFilter object from serialised data.
+ @param self The CBBloomFilter object to initialise.
+ @param data The serialised data.
+ */
+void CBInitBloomFilterFromData(CBBloomFilter * self, CBByteArray * data);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBBloomFilter object.
+ @param self The CBBloomFilter object to destroy.
+ */
+void CBDestroyBloomFilter(void * self);
+/**
+ @brief Frees a CBBloomFilter object and also calls CBDestroyBloomFilter.
+ @param self The CBBloomFilter object to free.
+ */
+void CBFreeBloomFilter(void * self);
+
+//  Functions
+
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBBloomFilter object.
+ @returns The length.
+ */
+int CBBloomFilterCalculateLength(CBBloomFilter * self);
+/**
+ @brief Determines if data may have been inserted into the filter.
+ @param self The CBBloomFilter object.
+ @param data The data.
+ @param length The length of the data.
+ @returns true if the data matches the filter, false if it was certainly not inserted.
+ */
+bool CBBloomFilterContains(CBBloomFilter * self, unsigned char * data, int length);
+/**
+ @brief Deserialises a CBBloomFilter so that it can be used as an object.
+ @param self The CBBloomFilter object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBBloomFilterDeserialise(CBBloomFilter * self);
+/**
+ @brief Inserts data into the filter.
+ @param self The CBBloomFilter object.
+ @param data The data.
+ @param length The length of the data.
+ */
+void CBBloomFilterInsert(CBBloomFilter * self, unsigned char * data, int length);
+/**
+ @brief Prepares the bytes for serialising the object.
+ @param self The CBBloomFilter object.
+ */
+void CBBloomFilterPrepareBytes(CBBloomFilter * self);
+/**
+ @brief Serialises a CBBloomFilter to the byte data.
+ @param self The CBBloomFilter object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBBloomFilterSerialise(CBBloomFilter * self);
+/**
+ @brief Calculates the 32-bit MurmurHash3 hash of data.
+ @param seed The seed for the hash.
+ @param data The data to hash.
+ @param length The length of the data.
+ @returns The hash.
+ */
+uint32_t CBMurmurHash3(uint32_t seed, unsigned char * data, int length);
+
+#endif
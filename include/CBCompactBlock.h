@@ -0,0 +1,140 @@
+//
+//  CBCompactBlock.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A "cmpctblock" message as in BIP152, which has a block header, the 6 byte short IDs of the transactions and the prefilled transactions which the receiver is unlikely to have, such as the coinbase. Inherits CBMessage
+ @details The short IDs are SipHash-2-4 hashes of the transaction hashes, keyed with the SHA-256 hash of the header and a nonce chosen by the sender so that collisions cannot be made for every peer at once. A peer which has most of the transactions in its mempool can rebuild the block with a fraction of the bytes of a "block" message. @see CBPartialBlock.h
+ */
+
+#ifndef CBCOMPACTBLOCKH
+#define CBCOMPACTBLOCKH
+
+//  Includes
+
+#include "CBBlock.h"
+
+// Constants and Macros
+
+#define CB_COMPACT_BLOCK_SHORT_ID_SIZE 6
+#define CBGetCompactBlock(x) ((CBCompactBlock *)x)
+
+/**
+ @brief Structure for CBCompactBlock objects. @see CBCompactBlock.h
+ */
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	int version; /**< The block version. */
+	CBByteArray * prevBlockHash; /**< The hash of the previous block. */
+	CBByteArray * merkleRoot; /**< The merkle root of the block. */
+	unsigned int time; /**< The block timestamp. */
+	unsigned int target; /**< The compact target of the block. */
+	unsigned int nonce; /**< The nonce of the block. */
+	uint64_t shortIDNonce; /**< The nonce used for the short ID keys. */
+	uint64_t keys[2]; /**< The SipHash keys for the short IDs. */
+	int shortIDNum; /**< The number of short IDs. */
+	uint64_t * shortIDs; /**< The short IDs of the transactions which are not prefilled, in block order. */
+	int prefilledNum; /**< The number of prefilled transactions. */
+	int * prefilledIndexes; /**< The indexes in the block of the prefilled transactions, in increasing order. */
+	CBTransaction ** prefilled; /**< The prefilled transactions, which must be serialised. */
+} CBCompactBlock;
+
+/**
+ @brief Creates a new CBCompactBlock object for a block with the coinbase transaction prefilled.
+ @param block The block, serialised with transactions.
+ @param shortIDNonce The nonce for the short ID keys, which should be random.
+ @returns A new CBCompactBlock object.
+ */
+CBCompactBlock * CBNewCompactBlock(CBBlock * block, uint64_t shortIDNonce);
+/**
+ @brief Creates a new CBCompactBlock object from serialised data.
+ @param data Serialised CBCompactBlock data.
+ @returns A new CBCompactBlock object.
+ */
+CBCompactBlock * CBNewCompactBlockFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBCompactBlock object for a block with the coinbase transaction prefilled.
+ @param self The CBCompactBlock object to initialise.
+ @param block The block, serialised with transactions.
+ @param shortIDNonce The nonce for the short ID keys, which should be random.
+ */
+void CBInitCompactBlock(CBCompactBlock * self, CBBlock * block, uint64_t shortIDNonce);
+/**
+ @brief Initialises a CBCompactBlock object from serialised data.
+ @param self The CBCompactBlock object to initialise.
+ @param data The serialised data.
+ */
+void CBInitCompactBlockFromData(CBCompactBlock * self, CBByteArray * data);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBCompactBlock object.
+ @param self The CBCompactBlock object to destroy.
+ */
+void CBDestroyCompactBlock(void * self);
+/**
+ @brief Frees a CBCompactBlock object and also calls CBDestroyCompactBlock.
+ @param self The CBCompactBlock object to free.
+ */
+void CBFreeCompactBlock(void * self);
+
+//  Functions
+
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBCompactBlock object.
+ @returns The length.
+ */
+int CBCompactBlockCalculateLength(CBCompactBlock * self);
+/**
+ @brief Calculates the hash of the block from the serialised header.
+ @param self The serialised CBCompactBlock object.
+ @param hash The 32 byte hash is written here.
+ */
+void CBCompactBlockCalculateHash(CBCompactBlock * self, unsigned char * hash);
+/**
+ @brief Deserialises a CBCompactBlock so that it can be used as an object.
+ @param self The CBCompactBlock object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBCompactBlockDeserialise(CBCompactBlock * self);
+/**
+ @brief Calculates the short ID for a transaction.
+ @param self The CBCompactBlock object.
+ @param txHash The 32 byte hash of the transaction.
+ @returns The short ID.
+ */
+uint64_t CBCompactBlockGetShortID(CBCompactBlock * self, unsigned char * txHash);
+/**
+ @brief Prepares the bytes for serialising the object.
+ @param self The CBCompactBlock object.
+ */
+void CBCompactBlockPrepareBytes(CBCompactBlock * self);
+/**
+ @brief Serialises a CBCompactBlock to the byte data.
+ @param self The CBCompactBlock object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBCompactBlockSerialise(CBCompactBlock * self);
+/**
+ @brief Calculates the SipHash-2-4 hash of data.
+ @param k0 The first 64 bits of the key.
+ @param k1 The second 64 bits of the key.
+ @param data The data to hash.
+ @param length The length of the data.
+ @returns The hash.
+ */
+uint64_t CBSipHash(uint64_t k0, uint64_t k1, unsigned char * data, int length);
+
+#endif
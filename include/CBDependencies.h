@@ -39,6 +39,7 @@ typedef union{
 
 #define CB_PUBKEY_SIZE 33
 #define CB_PRIVKEY_SIZE 32
+#define CB_HMAC_SHA512_MIDSTATE_SIZE 128
 
 // Functions
 
@@ -48,12 +49,65 @@ void CBAddPoints(unsigned char * point1, unsigned char * point2);
 void CBKeyIncrementPubkey(unsigned char * pubKey);
 #pragma weak CBKeyIncrementPubkey
 
+/**
+ @brief Gets the public key for a private key, multiplying the generator with a precomputed table.
+ @param privKey The 32-byte private key.
+ @param pubKey The 33-byte compressed public key is written here.
+ */
 void CBKeyGetPublicKey(unsigned char * privKey, unsigned char * pubKey);
 #pragma weak CBKeyGetPublicKey
 
+/**
+ @brief Gets the public keys for many private keys. The points are converted to affine coordinates together with a single field inversion.
+ @param privKeys The 32-byte private keys one after another.
+ @param num The number of keys.
+ @param pubKeys The 33-byte compressed public keys are written here one after another.
+ */
+void CBKeyGetPublicKeys(unsigned char * privKeys, int num, unsigned char * pubKeys);
+#pragma weak CBKeyGetPublicKeys
+
+/**
+ @brief Gets the public keys following a public key, as when the private key is incremented once for each key. Precomputed multiples of the generator are added with affine additions which share one field inversion.
+ @param pubKey The 33-byte compressed public key.
+ @param num The number of keys.
+ @param pubKeys The 33-byte compressed public keys for the private key plus one to plus num are written here one after another. The point at infinity is written as zero bytes.
+ @returns false if pubKey is not a valid public key, true otherwise.
+ */
+bool CBKeyGetNextPublicKeys(unsigned char * pubKey, int num, unsigned char * pubKeys);
+#pragma weak CBKeyGetNextPublicKeys
+
+/**
+ @brief Adds the public key of each tweak to a public key, as for BIP32 public derivation. The points are converted to affine coordinates together with a single field inversion.
+ @param pubKey The 33-byte compressed public key.
+ @param tweaks The 32-byte tweaks one after another.
+ @param num The number of tweaks.
+ @param pubKeys The 33-byte compressed public keys are written here one after another. A sum which is the point at infinity is written as zero bytes.
+ @returns false if pubKey is not a valid public key, true otherwise.
+ */
+bool CBKeyTweakPublicKeys(unsigned char * pubKey, unsigned char * tweaks, int num, unsigned char * pubKeys);
+#pragma weak CBKeyTweakPublicKeys
+
+/**
+ @brief Signs a hash with a deterministic nonce from RFC 6979, giving a DER signature with the lower of the two s values.
+ @param privKey The 32-byte private key.
+ @param hash The 32-byte hash.
+ @param signature The signature is written here, up to 72 bytes.
+ @returns The length of the signature, or zero if the private key is zero or not below the order of the curve.
+ */
 int CBKeySign(unsigned char * privKey, unsigned char * hash, unsigned char * signature);
 #pragma weak CBKeySign
 
+/**
+ @brief Signs many hashes as CBKeySign does. The nonce points are converted to affine coordinates with one field inversion and the nonces are inverted with one scalar inversion.
+ @param privKeys The 32-byte private keys for each hash.
+ @param hashes The 32-byte hashes.
+ @param num The number of hashes.
+ @param signatures The signatures are written here, up to 72 bytes each.
+ @param sigLens The lengths of the signatures are written here, or zero for invalid private keys.
+ */
+void CBKeySignBatch(unsigned char ** privKeys, unsigned char ** hashes, int num, unsigned char ** signatures, int * sigLens);
+#pragma weak CBKeySignBatch
+
 /**
  @brief SHA-256 cryptographic hash function.
  @param data A pointer to the byte data to hash.
@@ -63,6 +117,36 @@ int CBKeySign(unsigned char * privKey, unsigned char * hash, unsigned char * sig
 void CBSha256(unsigned char * data, int length, unsigned char * output);
 #pragma weak CBSha256
 
+/**
+ @brief SHA-256 of many messages of the same length. As the messages have the same number of blocks, they can be hashed together in parallel lanes.
+ @param data Pointers to the messages.
+ @param length The length of each message.
+ @param num The number of messages.
+ @param output A pointer to hold the 32-byte hashes one after another.
+ */
+void CBSha256Batch(unsigned char ** data, int length, int num, unsigned char * output);
+#pragma weak CBSha256Batch
+
+/**
+ @brief Gets the SHA-256 states after each 64-byte block of some data, so that hashes of data beginning with some of the blocks can continue from a state with CBSha256FromMidstate.
+ @param data The data.
+ @param blocks The number of blocks.
+ @param midstates The 32-byte states are written here one after another, from the state after the first block.
+ */
+void CBSha256Midstates(unsigned char * data, int blocks, unsigned char * midstates);
+#pragma weak CBSha256Midstates
+
+/**
+ @brief SHA-256 continuing from a state given by CBSha256Midstates.
+ @param midstate The state after the blocks, or NULL when there are no blocks.
+ @param blocks The number of blocks hashed for the state.
+ @param data The data after the blocks.
+ @param length The length of the data.
+ @param output A pointer to hold the 32-byte hash.
+ */
+void CBSha256FromMidstate(unsigned char * midstate, int blocks, unsigned char * data, int length, unsigned char * output);
+#pragma weak CBSha256FromMidstate
+
 /**
  @brief SHA-512 cryptographic hash function.
  @param data A pointer to the byte data to hash.
@@ -72,6 +156,35 @@ void CBSha256(unsigned char * data, int length, unsigned char * output);
 void CBSha512(unsigned char * data, int len, unsigned char * output);
 #pragma weak CBSha512
 
+/**
+ @brief Prepares HMAC-SHA512 with a key, so that many messages can be authenticated with the key without hashing the padded key blocks each time.
+ @param key The key.
+ @param keyLen The length of the key.
+ @param midstate The SHA-512 states after the inner and outer padded key blocks are written here, as CB_HMAC_SHA512_MIDSTATE_SIZE bytes.
+ */
+void CBHmacSha512Midstate(unsigned char * key, int keyLen, unsigned char * midstate);
+#pragma weak CBHmacSha512Midstate
+
+/**
+ @brief HMAC-SHA512 using a midstate from CBHmacSha512Midstate.
+ @param midstate The midstate for the key.
+ @param data The message.
+ @param length The length of the message.
+ @param output A pointer to hold the 64-byte result.
+ */
+void CBHmacSha512FromMidstate(unsigned char * midstate, unsigned char * data, int length, unsigned char * output);
+#pragma weak CBHmacSha512FromMidstate
+
+/**
+ @brief RIPEMD-160 of SHA-256 (hash160) of many messages of the same length, such as public keys, hashed together in parallel lanes with both hash functions.
+ @param data Pointers to the messages.
+ @param length The length of each message.
+ @param num The number of messages.
+ @param output A pointer to hold the 20-byte hashes one after another.
+ */
+void CBHash160Batch(unsigned char ** data, int length, int num, unsigned char * output);
+#pragma weak CBHash160Batch
+
 /**
  @brief RIPEMD-160 cryptographic hash function.
  @param data A pointer to the byte data to hash.
@@ -360,6 +473,30 @@ unsigned long long int CBSecureRandomInteger(CBDepObject gen);
 void CBFreeSecureRandomGenerator(CBDepObject gen);
 #pragma weak CBFreeSecureRandomGenerator
 
+/**
+ @brief Fills bytes from a secure random number generator.
+ @param gen The generator.
+ @param bytes The bytes to fill.
+ @param length The number of bytes.
+ @returns true on success, false if the generator could not be seeded again.
+ */
+bool CBSecureRandomBytes(CBDepObject gen, unsigned char * bytes, int length);
+#pragma weak CBSecureRandomBytes
+
+/**
+ @brief Fills bytes from a secure random number generator for the calling thread, which is seeded from the system when first used, after a number of bytes and in forked processes.
+ @param bytes The bytes to fill.
+ @param length The number of bytes.
+ @returns true on success, false if the system could not give random bytes.
+ */
+bool CBGetRandomBytes(unsigned char * bytes, int length);
+#pragma weak CBGetRandomBytes
+
+/**
+ @brief Fills 32 bytes with CBGetRandomBytes.
+ @param bytes The bytes to fill.
+ @returns true on success, false on failure.
+ */
 bool CBGet32RandomBytes(unsigned char * bytes);
 #pragma weak CBGet32RandomBytes
 
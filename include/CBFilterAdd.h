@@ -0,0 +1,103 @@
+//
+//  CBFilterAdd.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A "filteradd" message as in BIP37, which adds a data element to the bloom filter loaded into a peer. Inherits CBMessage
+ */
+
+#ifndef CBFILTERADDH
+#define CBFILTERADDH
+
+//  Includes
+
+#include "CBMessage.h"
+
+// Constants and Macros
+
+#define CB_FILTER_ADD_MAX_SIZE 520 // The maximum size of the data element, being the maximum size of script push data.
+#define CBGetFilterAdd(x) ((CBFilterAdd *)x)
+
+/**
+ @brief Structure for CBFilterAdd objects. @see CBFilterAdd.h
+ */
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	CBByteArray * data; /**< The data element to add to the filter. */
+} CBFilterAdd;
+
+/**
+ @brief Creates a new CBFilterAdd object.
+ @param data The data element to add to the filter.
+ @returns A new CBFilterAdd object.
+ */
+CBFilterAdd * CBNewFilterAdd(CBByteArray * data);
+/**
+ @brief Creates a new CBFilterAdd object from serialised data.
+ @param data Serialised CBFilterAdd data.
+ @returns A new CBFilterAdd object.
+ */
+CBFilterAdd * CBNewFilterAddFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBFilterAdd object.
+ @param self The CBFilterAdd object to initialise.
+ @param data The data element to add to the filter.
+ */
+void CBInitFilterAdd(CBFilterAdd * self, CBByteArray * data);
+/**
+ @brief Initialises a CBFilterAdd object from serialised data.
+ @param self The CBFilterAdd object to initialise.
+ @param data The serialised data.
+ */
+void CBInitFilterAddFromData(CBFilterAdd * self, CBByteArray * data);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBFilterAdd object.
+ @param self The CBFilterAdd object to destroy.
+ */
+void CBDestroyFilterAdd(void * self);
+/**
+ @brief Frees a CBFilterAdd object and also calls CBDestroyFilterAdd.
+ @param self The CBFilterAdd object to free.
+ */
+void CBFreeFilterAdd(void * self);
+
+//  Functions
+
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBFilterAdd object.
+ @returns The length.
+ */
+int CBFilterAddCalculateLength(CBFilterAdd * self);
+/**
+ @brief Deserialises a CBFilterAdd so that it can be used as an object.
+ @param self The CBFilterAdd object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBFilterAddDeserialise(CBFilterAdd * self);
+/**
+ @brief Prepares the bytes for serialising the object.
+ @param self The CBFilterAdd object.
+ */
+void CBFilterAddPrepareBytes(CBFilterAdd * self);
+/**
+ @brief Serialises a CBFilterAdd to the byte data.
+ @param self The CBFilterAdd object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBFilterAddSerialise(CBFilterAdd * self);
+
+#endif
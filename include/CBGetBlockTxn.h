@@ -0,0 +1,108 @@
+//
+//  CBGetBlockTxn.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A "getblocktxn" message as in BIP152, which requests the transactions of a compact block which could not be found in the mempool. The indexes are serialised as the differences from the previous index plus one. Inherits CBMessage
+ */
+
+#ifndef CBGETBLOCKTXNH
+#define CBGETBLOCKTXNH
+
+//  Includes
+
+#include "CBMessage.h"
+
+// Constants and Macros
+
+#define CBGetGetBlockTxn(x) ((CBGetBlockTxn *)x)
+
+/**
+ @brief Structure for CBGetBlockTxn objects. @see CBGetBlockTxn.h
+ */
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	CBByteArray * blockHash; /**< The hash of the block. */
+	int indexNum; /**< The number of requested transactions. */
+	int * indexes; /**< The indexes in the block of the requested transactions, in increasing order. */
+} CBGetBlockTxn;
+
+/**
+ @brief Creates a new CBGetBlockTxn object.
+ @param blockHash The hash of the block.
+ @param indexes The indexes in the block of the requested transactions, in increasing order. This is copied.
+ @param indexNum The number of indexes.
+ @returns A new CBGetBlockTxn object.
+ */
+CBGetBlockTxn * CBNewGetBlockTxn(unsigned char * blockHash, int * indexes, int indexNum);
+/**
+ @brief Creates a new CBGetBlockTxn object from serialised data.
+ @param data Serialised CBGetBlockTxn data.
+ @returns A new CBGetBlockTxn object.
+ */
+CBGetBlockTxn * CBNewGetBlockTxnFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBGetBlockTxn object.
+ @param self The CBGetBlockTxn object to initialise.
+ @param blockHash The hash of the block.
+ @param indexes The indexes in the block of the requested transactions, in increasing order. This is copied.
+ @param indexNum The number of indexes.
+ */
+void CBInitGetBlockTxn(CBGetBlockTxn * self, unsigned char * blockHash, int * indexes, int indexNum);
+/**
+ @brief Initialises a CBGetBlockTxn object from serialised data.
+ @param self The CBGetBlockTxn object to initialise.
+ @param data The serialised data.
+ */
+void CBInitGetBlockTxnFromData(CBGetBlockTxn * self, CBByteArray * data);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBGetBlockTxn object.
+ @param self The CBGetBlockTxn object to destroy.
+ */
+void CBDestroyGetBlockTxn(void * self);
+/**
+ @brief Frees a CBGetBlockTxn object and also calls CBDestroyGetBlockTxn.
+ @param self The CBGetBlockTxn object to free.
+ */
+void CBFreeGetBlockTxn(void * self);
+
+//  Functions
+
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBGetBlockTxn object.
+ @returns The length.
+ */
+int CBGetBlockTxnCalculateLength(CBGetBlockTxn * self);
+/**
+ @brief Deserialises a CBGetBlockTxn so that it can be used as an object.
+ @param self The CBGetBlockTxn object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBGetBlockTxnDeserialise(CBGetBlockTxn * self);
+/**
+ @brief Prepares the bytes for serialising the object.
+ @param self The CBGetBlockTxn object.
+ */
+void CBGetBlockTxnPrepareBytes(CBGetBlockTxn * self);
+/**
+ @brief Serialises a CBGetBlockTxn to the byte data.
+ @param self The CBGetBlockTxn object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBGetBlockTxnSerialise(CBGetBlockTxn * self);
+
+#endif
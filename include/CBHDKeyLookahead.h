@@ -0,0 +1,148 @@
+//
+//  CBHDKeyLookahead.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Keeps the hash160 of the next children of HD key chains, so that the outputs paying any key of a wallet up to the gap limit can be recognised. Inherits CBObject
+ @details Each chain is a CBHDKey, such as the external or internal chain of an account, with an identifier chosen by the caller. The children after the last used child, up to the gap limit, are derived with CBHDKeyDeriveChildren and their hashes are put into a CBHash160Map which gives the chain and child number of a hash with one probe. When a child is marked as used, the window is extended so that there are again gap limit children after it, either on a thread of the object while lookups continue, or on the calling thread.
+ Entries are stored in chunks of CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE so that they never move and can be kept by the caller.
+ */
+
+#ifndef CBHDKEYLOOKAHEADH
+#define CBHDKEYLOOKAHEADH
+
+//  Includes
+
+#include "CBHDKeys.h"
+#include "CBHash160Map.h"
+#include "CBScript.h"
+#include "CBThreadPoolQueue.h"
+
+// Constants and Macros
+
+#define CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE 1024 // The number of entries in each allocation.
+#define CBGetHDKeyLookahead(x) ((CBHDKeyLookahead *)x)
+
+/**
+ @brief A chain of a CBHDKeyLookahead.
+ */
+typedef struct{
+	CBHDKey * key; /**< The public key of the chain, which the children are derived from. */
+	unsigned int chainID; /**< The identifier given for the chain. */
+	unsigned int derived; /**< The number of children which have been derived. */
+	unsigned int used; /**< One more than the child number of the last used child, or zero if no child was used. */
+	bool queued; /**< true if an extension of the chain is waiting to be processed. */
+} CBHDKeyLookaheadChain;
+
+/**
+ @brief The derivation path of a hash in a CBHDKeyLookahead.
+ */
+typedef struct{
+	unsigned char hash[20]; /**< The hash160 of the compressed public key of the child. */
+	CBHDKeyLookaheadChain * chain; /**< The chain of the child. */
+	unsigned int childNumber; /**< The child number in the chain. */
+} CBHDKeyLookaheadEntry;
+
+/**
+ @brief Structure for CBHDKeyLookahead objects. @see CBHDKeyLookahead.h
+ */
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	unsigned int gapLimit; /**< The number of children kept after the last used child of each chain. */
+	CBHDKeyLookaheadChain ** chains; /**< The chains. */
+	int chainNum; /**< The number of chains. */
+	CBHDKeyLookaheadEntry ** chunks; /**< The entries of every chain in order of derivation. */
+	int chunkNum; /**< The number of allocated chunks. */
+	unsigned int entryNum; /**< The number of entries. */
+	CBHash160Map hashes; /**< The entries by hash. */
+	bool background; /**< true if chains are extended on a thread of the object. */
+	CBThreadPoolQueue pool; /**< The thread extending chains, when background is true. */
+	CBDepObject mutex; /**< Guards the chains, entries and hashes when background is true. */
+} CBHDKeyLookahead;
+
+/**
+ @brief A request to extend a chain on the thread of a CBHDKeyLookahead.
+ */
+typedef struct{
+	CBQueueItem base; /**< The queue item. */
+	CBHDKeyLookahead * lookahead; /**< The CBHDKeyLookahead object. */
+	CBHDKeyLookaheadChain * chain; /**< The chain to extend. */
+} CBHDKeyLookaheadJob;
+
+/**
+ @brief Creates a new CBHDKeyLookahead object.
+ @param gapLimit The number of children to keep after the last used child of each chain.
+ @param background If true, chains are extended on a thread of the object and the functions can be used from any thread. Otherwise chains are extended by CBHDKeyLookaheadMarkUsed on the calling thread and the object should only be used by one thread at a time.
+ @returns A new CBHDKeyLookahead object.
+ */
+CBHDKeyLookahead * CBNewHDKeyLookahead(unsigned int gapLimit, bool background);
+
+/**
+ @brief Initialises a CBHDKeyLookahead object.
+ @param self The CBHDKeyLookahead object to initialise.
+ @param gapLimit The number of children to keep after the last used child of each chain.
+ @param background If true, chains are extended on a thread of the object.
+ */
+void CBInitHDKeyLookahead(CBHDKeyLookahead * self, unsigned int gapLimit, bool background);
+
+/**
+ @brief Stops the thread and frees the chains and entries of a CBHDKeyLookahead object.
+ @param self The CBHDKeyLookahead object to destroy.
+ */
+void CBDestroyHDKeyLookahead(void * self);
+/**
+ @brief Frees a CBHDKeyLookahead object and also calls CBDestroyHDKeyLookahead.
+ @param self The CBHDKeyLookahead object to free.
+ */
+void CBFreeHDKeyLookahead(void * self);
+
+//  Functions
+
+/**
+ @brief Adds a chain and derives its first gap limit children on the calling thread.
+ @param self The CBHDKeyLookahead object.
+ @param key The key of the chain, which may be private or public. Only the public key is kept.
+ @param chainID An identifier for the chain, such as the account number and whether the chain is for change, which is given by the entries.
+ @param used The number of children of the chain which are already known to be used.
+ @returns The chain, or NULL if a child would be an invalid key.
+ */
+CBHDKeyLookaheadChain * CBHDKeyLookaheadAddChain(CBHDKeyLookahead * self, CBHDKey * key, unsigned int chainID, unsigned int used);
+/**
+ @brief Finds the derivation path of a hash160.
+ @param self The CBHDKeyLookahead object.
+ @param hash The 20 byte hash of a public key.
+ @returns The entry or NULL if the hash is not of a child in the lookahead.
+ */
+CBHDKeyLookaheadEntry * CBHDKeyLookaheadFind(CBHDKeyLookahead * self, unsigned char * hash);
+/**
+ @brief Finds the child paid by an output script, for pay-to-pubkey-hash scripts and pay-to-pubkey scripts with compressed keys.
+ @param self The CBHDKeyLookahead object.
+ @param script The output script.
+ @returns The entry or NULL if the script does not pay a child in the lookahead.
+ */
+CBHDKeyLookaheadEntry * CBHDKeyLookaheadFindScript(CBHDKeyLookahead * self, CBScript * script);
+/**
+ @brief Marks the child of an entry as used, which extends the chain so that there are gap limit children after it.
+ @param self The CBHDKeyLookahead object.
+ @param entry The entry of the used child.
+ @returns false if the chain was extended on the calling thread and a child would be an invalid key, otherwise true.
+ */
+bool CBHDKeyLookaheadMarkUsed(CBHDKeyLookahead * self, CBHDKeyLookaheadEntry * entry);
+/**
+ @brief Waits until the chains which are being extended on the thread of the object have been extended.
+ @param self The CBHDKeyLookahead object.
+ */
+void CBHDKeyLookaheadWaitUntilExtended(CBHDKeyLookahead * self);
+
+#endif
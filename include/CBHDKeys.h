@@ -29,6 +29,8 @@
 // Macros
 
 #define CB_HD_KEY_STR_SIZE 82
+#define CB_HD_KEY_DERIVE_BATCH 256 // The number of children which share a field inversion in CBHDKeyDeriveChildren.
+#define CB_KEY_PAIR_STEP_BATCH 1024 // A number of key pairs to get together with CBKeyPairGetNextKeys, matching the precomputed multiples of the generator.
 
 // Enums
 
@@ -87,6 +89,16 @@ void CBInitKeyPair(CBKeyPair * key);
 //  Functions
 
 bool CBHDKeyDeriveChild(CBHDKey * parentKey, CBHDKeyChildID childID, CBHDKey * childKey);
+/**
+ @brief Derives consecutive children of a key. The HMAC-SHA512 midstate for the chain code is computed once, and the public keys of each batch of CB_HD_KEY_DERIVE_BATCH children are converted to affine coordinates with a single field inversion.
+ @param parentKey The parent key.
+ @param firstChildID The ID of the first child. The other children follow with the same derivation type.
+ @param count The number of children to derive.
+ @param children The keys for the children, which should be made by CBNewHDKey with private space when the parent is private.
+ @param numThreads The number of threads to divide the children between. Zero or one derives on the calling thread.
+ @returns true on success, false if the derivation type is not possible for the parent or a child would be an invalid key.
+ */
+bool CBHDKeyDeriveChildren(CBHDKey * parentKey, CBHDKeyChildID firstChildID, int count, CBHDKey ** children, int numThreads);
 bool CBHDKeyGenerateMaster(CBHDKey * key, bool production);
 int CBHDKeyGetChildNumber(CBHDKeyChildID childID);
 unsigned char * CBHDKeyGetHash(CBHDKey * key);
@@ -100,6 +112,13 @@ void CBHDKeySerialise(CBHDKey * key, unsigned char * data);
 bool CBKeyPairGenerate(CBKeyPair * keyPair);
 unsigned char * CBKeyPairGetHash(CBKeyPair * key);
 void CBKeyPairGetNext(CBKeyPair * key);
+/**
+ @brief Gets the key pairs following a key pair, as with repeated calls to CBKeyPairGetNext. The public keys are made together with CBKeyGetNextPublicKeys and hashed together, so the hashes are set.
+ @param key The key pair to start from, which is not changed.
+ @param num The number of key pairs.
+ @param keys The key pairs for the private key plus one to plus num. Use the last key pair to continue.
+ */
+void CBKeyPairGetNextKeys(CBKeyPair * key, int num, CBKeyPair * keys);
 
 #endif
 
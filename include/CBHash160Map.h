@@ -0,0 +1,89 @@
+//
+//  CBHash160Map.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Maps 20 byte hashes, such as the hash160 of public keys and scripts, to pointers with one expected probe for each lookup.
+ @details Unlike CBAssociativeArray, the elements are not ordered. The keys are the outputs of a hash function so the first four bytes are used directly as the slot, with linear probing in a table which is kept at most half full. Only keys in the map form clusters, so looking up keys which are not in the map, such as the hashes in the outputs of every transaction of a block, cannot be slowed down by others choosing the hashes.
+ */
+
+#ifndef CBHASH160MAPH
+#define CBHASH160MAPH
+
+//  Includes
+
+#include "CBConstants.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Constants
+
+#define CB_HASH160_MAP_MIN_CAPACITY 16 // The smallest number of slots, which must be a power of two.
+
+/**
+ @brief A slot of a CBHash160Map.
+ */
+typedef struct{
+	unsigned char hash[20]; /**< The key. */
+	void * value; /**< The value, or NULL if the slot is empty. */
+} CBHash160MapEntry;
+
+/**
+ @brief Structure for a CBHash160Map.
+ */
+typedef struct{
+	CBHash160MapEntry * entries; /**< The slots. */
+	unsigned int capacity; /**< The number of slots, which is a power of two. */
+	unsigned int num; /**< The number of keys in the map. */
+} CBHash160Map;
+
+/**
+ @brief Initialises a CBHash160Map.
+ @param self The CBHash160Map to initialise.
+ @param num The number of keys to make space for.
+ */
+void CBInitHash160Map(CBHash160Map * self, unsigned int num);
+/**
+ @brief Frees the slots of a CBHash160Map. The values are not freed.
+ @param self The CBHash160Map.
+ */
+void CBFreeHash160Map(CBHash160Map * self);
+
+//  Functions
+
+/**
+ @brief Gets the value for a key.
+ @param self The CBHash160Map.
+ @param hash The 20 byte key.
+ @returns The value or NULL if the key is not in the map.
+ */
+void * CBHash160MapGet(CBHash160Map * self, unsigned char * hash);
+/**
+ @brief Inserts a key, replacing the value if the key is already in the map.
+ @param self The CBHash160Map.
+ @param hash The 20 byte key.
+ @param value The value, which cannot be NULL.
+ @returns true if the key was added, false if the key was already in the map.
+ */
+bool CBHash160MapInsert(CBHash160Map * self, unsigned char * hash, void * value);
+/**
+ @brief Removes a key.
+ @param self The CBHash160Map.
+ @param hash The 20 byte key.
+ @returns The value of the key that was removed, or NULL if the key was not in the map.
+ */
+void * CBHash160MapRemove(CBHash160Map * self, unsigned char * hash);
+
+#endif
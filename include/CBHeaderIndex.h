@@ -0,0 +1,167 @@
+//
+//  CBHeaderIndex.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Holds the headers of the main block chain by height and by hash, for building block locators and answering "getblocks" and "getheaders" requests. Inherits CBObject
+ @details The headers are stored flat in chunks of CB_HEADER_INDEX_CHUNK_SIZE entries, so that entries never move and can be referenced by a CBAssociativeArray keyed by the block hash. Locators are built by stepping back exponentially from a height, giving O(log n) hashes. Responses are written from the stored headers without creating CBBlock or CBInventoryItem objects: the "inv" response is serialised directly and the "headers" response uses the flat representation of CBBlockHeaders.
+ Each entry has the total work of the chain up to it as a CBUInt256, so that chains can be compared by the work of their tips.
+ Headers are only added to the tip. To follow another chain, truncate the index to the fork point and add the headers of the new chain.
+*/
+
+#ifndef CBHEADERINDEXH
+#define CBHEADERINDEXH
+
+//  Includes
+
+#include "CBAssociativeArray.h"
+#include "CBBlockHeaders.h"
+#include "CBGetBlocks.h"
+#include "CBInventory.h"
+
+// Constants and Macros
+
+#define CB_HEADER_INDEX_CHUNK_SIZE 2048 // The number of headers in each allocation.
+#define CB_HEADER_INDEX_MAX_INV 500 // The maximum number of block hashes in a "getblocks" response.
+#define CB_HEADER_INDEX_LOCATOR_DENSE 10 // The number of latest hashes in a locator before the step doubles.
+#define CBGetHeaderIndex(x) ((CBHeaderIndex *)x)
+
+/**
+ @brief A header in a CBHeaderIndex. The hash is placed first so that it can be used as the key in a CBAssociativeArray.
+ */
+typedef struct{
+	unsigned char hash[32]; /**< The block hash. */
+	unsigned int height; /**< The height of the block. */
+	CBUInt256 chainWork; /**< The total work of the headers from the first header of the index up to and including this header, for choosing between chains. */
+	unsigned char header[80]; /**< The serialised header. */
+} CBHeaderIndexEntry;
+
+/**
+ @brief Structure for CBHeaderIndex objects. @see CBHeaderIndex.h
+ */
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	CBHeaderIndexEntry ** chunks; /**< The entries in order of height. */
+	int chunkNum; /**< The number of allocated chunks. */
+	unsigned int firstHeight; /**< The height of the first header. */
+	unsigned int headerNum; /**< The number of headers. */
+	CBAssociativeArray hashes; /**< The entries by hash. */
+} CBHeaderIndex;
+
+/**
+ @brief Creates a new CBHeaderIndex object.
+ @param firstHeader The 80 byte header to start the index with, which is trusted, such as the genesis header.
+ @param firstHeight The height of the first header.
+ @returns A new CBHeaderIndex object.
+ */
+CBHeaderIndex * CBNewHeaderIndex(unsigned char * firstHeader, unsigned int firstHeight);
+
+/**
+ @brief Initialises a CBHeaderIndex object.
+ @param self The CBHeaderIndex object to initialise.
+ @param firstHeader The 80 byte header to start the index with.
+ @param firstHeight The height of the first header.
+ */
+void CBInitHeaderIndex(CBHeaderIndex * self, unsigned char * firstHeader, unsigned int firstHeight);
+
+/**
+ @brief Frees the headers of a CBHeaderIndex object.
+ @param self The CBHeaderIndex object to destroy.
+ */
+void CBDestroyHeaderIndex(void * self);
+/**
+ @brief Frees a CBHeaderIndex object and also calls CBDestroyHeaderIndex.
+ @param self The CBHeaderIndex object to free.
+ */
+void CBFreeHeaderIndex(void * self);
+
+//  Functions
+
+/**
+ @brief Adds a header onto the tip of the index.
+ @param self The CBHeaderIndex object.
+ @param header The 80 byte header.
+ @returns true if the header was added, false if it does not link to the tip or has invalid proof of work.
+ */
+bool CBHeaderIndexAddHeader(CBHeaderIndex * self, unsigned char * header);
+/**
+ @brief Adds the headers of a "headers" message onto the tip of the index, after skipping any headers which are already in the index.
+ @param self The CBHeaderIndex object.
+ @param headers The CBBlockHeaders object with flat headers.
+ @returns The number of headers added. Headers after the first which does not link or has invalid proof of work are not added.
+ */
+int CBHeaderIndexAddHeaders(CBHeaderIndex * self, CBBlockHeaders * headers);
+/**
+ @brief Finds a header by hash.
+ @param self The CBHeaderIndex object.
+ @param hash The 32 byte block hash.
+ @returns The entry or NULL if the hash is not in the index.
+ */
+CBHeaderIndexEntry * CBHeaderIndexFind(CBHeaderIndex * self, unsigned char * hash);
+/**
+ @brief Finds the latest header in the index given by a locator.
+ @param self The CBHeaderIndex object.
+ @param locator The locator with the newest hashes first.
+ @returns The entry for the first hash in the locator which is in the index, or the first header of the index if there is none.
+ */
+CBHeaderIndexEntry * CBHeaderIndexFindFork(CBHeaderIndex * self, CBChainDescriptor * locator);
+/**
+ @brief Makes the response to a "getblocks" request with the hashes of up to CB_HEADER_INDEX_MAX_INV blocks following the fork point, stopping after the stop hash.
+ @param self The CBHeaderIndex object.
+ @param request The request.
+ @returns A serialised "inv" message, or NULL if there are no blocks to send.
+ */
+CBInventory * CBHeaderIndexGetBlocksInventory(CBHeaderIndex * self, CBGetBlocks * request);
+/**
+ @brief Gets a header by height.
+ @param self The CBHeaderIndex object.
+ @param height The height.
+ @returns The entry, or NULL if the height is not in the index.
+ */
+CBHeaderIndexEntry * CBHeaderIndexGetEntry(CBHeaderIndex * self, unsigned int height);
+/**
+ @brief Makes the response to a "getheaders" request with up to CB_BLOCK_HEADERS_MAX_NUM headers following the fork point, stopping after the stop hash. When the locator is empty, only the header of the stop hash is given.
+ @param self The CBHeaderIndex object.
+ @param request The request.
+ @returns A "headers" message with flat headers, which may be empty.
+ */
+CBBlockHeaders * CBHeaderIndexGetHeaders(CBHeaderIndex * self, CBGetBlocks * request);
+/**
+ @brief Makes a locator from a height, with the CB_HEADER_INDEX_LOCATOR_DENSE latest hashes and then a step doubling for each hash, ending with the first header of the index.
+ @param self The CBHeaderIndex object.
+ @param height The height to start from.
+ @returns A new CBChainDescriptor with the newest hashes first, or NULL if the height is not in the index.
+ */
+CBChainDescriptor * CBHeaderIndexGetLocator(CBHeaderIndex * self, unsigned int height);
+/**
+ @brief Gets the header at the tip of the index.
+ @param self The CBHeaderIndex object.
+ @returns The entry.
+ */
+CBHeaderIndexEntry * CBHeaderIndexGetTip(CBHeaderIndex * self);
+/**
+ @brief Adds a header onto the tip of the index without checking it, for headers which were checked before, such as headers loaded from storage.
+ @param self The CBHeaderIndex object.
+ @param header The 80 byte header.
+ */
+void CBHeaderIndexLoadHeader(CBHeaderIndex * self, unsigned char * header);
+/**
+ @brief Removes the headers above a height.
+ @param self The CBHeaderIndex object.
+ @param height The height of the new tip.
+ @returns true on success, false if the height is not in the index.
+ */
+bool CBHeaderIndexTruncate(CBHeaderIndex * self, unsigned int height);
+
+#endif
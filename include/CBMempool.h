@@ -0,0 +1,189 @@
+//
+//  CBMempool.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Holds validated unconfirmed transactions for relay and mining. Inherits CBObject
+ @details Transactions are held in compact form. Each entry is one allocation holding the serialised transaction, the outputs it spends and its parents, and the entries are indexed by:
+ - Transaction hash.
+ - Spent outpoint, giving the spending transaction for conflict detection.
+ - Ancestor fee rate, being the fee rate of the transaction together with its unconfirmed ancestors, for selecting transactions to mine.
+ - Descendant fee rate, being the fee rate of the transaction together with its unconfirmed descendants, for eviction.
+ Each entry links to its parents and children in the pool, and keeps the totals for its ancestors and descendants, which are limited to CB_MEMPOOL_MAX_ANCESTORS and CB_MEMPOOL_MAX_DESCENDANTS. When the serialised size of the pool goes over the maximum, the transactions with the lowest descendant fee rate are evicted together with their descendants.
+ The pool is not thread-safe. Callers should use one thread or a mutex.
+*/
+
+#ifndef CBMEMPOOLH
+#define CBMEMPOOLH
+
+//  Includes
+
+#include "CBBlockValidator.h"
+
+// Constants and Macros
+
+#define CB_MEMPOOL_MAX_ANCESTORS 25 // The maximum number of transactions in the pool a transaction can depend on, including itself.
+#define CB_MEMPOOL_MAX_DESCENDANTS 25 // The maximum number of transactions in the pool that can depend on a transaction, including itself.
+#define CB_MEMPOOL_DEFAULT_MAX_SIZE 300000000 // The default maximum serialised size of all transactions in the pool.
+#define CB_MEMPOOL_DEFAULT_MIN_FEE_RATE 1000 // The default minimum fee in satoshis per 1000 bytes.
+#define CB_MEMPOOL_MAX_TX_SIG_OPS (CB_MAX_SIG_OPS/5) // The maximum number of signature operations for a transaction in the pool.
+#define CBGetMempool(x) ((CBMempool *)x)
+
+/**
+ @brief The result of adding a transaction to a CBMempool.
+ */
+typedef enum{
+	CB_MEMPOOL_OK, /**< The transaction was added. */
+	CB_MEMPOOL_ALREADY_HAVE, /**< The transaction is already in the pool. */
+	CB_MEMPOOL_INVALID, /**< The transaction failed CBTransactionValidateBasic or is a coinbase transaction. */
+	CB_MEMPOOL_NOT_FINAL, /**< The transaction could not be included in the next block as it is not final. */
+	CB_MEMPOOL_TOO_MANY_SIGOPS, /**< The transaction is over CB_MEMPOOL_MAX_TX_SIG_OPS. */
+	CB_MEMPOOL_CONFLICT, /**< An output spent by the transaction is spent by a transaction in the pool. */
+	CB_MEMPOOL_MISSING_INPUTS, /**< An output spent by the transaction is not in the unspent output set or the pool. */
+	CB_MEMPOOL_IMMATURE_COINBASE, /**< The transaction spends an immature coinbase output. */
+	CB_MEMPOOL_BAD_VALUE, /**< The transaction spends more than its inputs. */
+	CB_MEMPOOL_LOW_FEE, /**< The fee rate is below the minimum. */
+	CB_MEMPOOL_TOO_LONG_CHAIN, /**< The transaction would go over the ancestor or descendant limits. */
+	CB_MEMPOOL_BAD_SCRIPT, /**< An input script failed verification. */
+	CB_MEMPOOL_FULL, /**< The pool is full and the transaction was evicted for having the lowest fee rate. */
+} CBMempoolResult;
+
+typedef struct CBMempoolTransaction CBMempoolTransaction;
+
+/**
+ @brief An output spent by a transaction in the pool. The outpoint is placed first so that it can be used as the key in a CBAssociativeArray.
+ */
+typedef struct{
+	unsigned char outPoint[CB_OUTPOINT_KEY_SIZE]; /**< The spent outpoint. @see CBMakeOutPointKey */
+	CBMempoolTransaction * spender; /**< The transaction spending the output. */
+} CBMempoolSpend;
+
+/**
+ @brief A transaction in the pool. The hash is placed first so that it can be used as the key in a CBAssociativeArray.
+ */
+struct CBMempoolTransaction{
+	unsigned char hash[32]; /**< The transaction hash. */
+	unsigned long long int fee; /**< The fee of the transaction. */
+	int size; /**< The serialised size of the transaction. */
+	int sigOps; /**< The signature operations of the transaction. @see CBTransactionGetSigOps */
+	int ancestorNum; /**< The number of ancestors in the pool, including this transaction. */
+	int ancestorSize; /**< The total size of the ancestors, including this transaction. */
+	unsigned long long int ancestorFee; /**< The total fee of the ancestors, including this transaction. */
+	int ancestorSigOps; /**< The total signature operations of the ancestors, including this transaction. */
+	unsigned long long int ancestorScore; /**< The fee rate of the ancestors, in satoshis per 1000 bytes. */
+	int descendantNum; /**< The number of descendants in the pool, including this transaction. */
+	int descendantSize; /**< The total size of the descendants, including this transaction. */
+	unsigned long long int descendantFee; /**< The total fee of the descendants, including this transaction. */
+	unsigned long long int descendantScore; /**< The fee rate of the descendants, in satoshis per 1000 bytes. */
+	CBMempoolTransaction ** parents; /**< The transactions in the pool which this transaction spends outputs of. */
+	int parentNum; /**< The number of parents. */
+	CBMempoolTransaction ** children; /**< The transactions in the pool which spend outputs of this transaction. */
+	int childNum; /**< The number of children. */
+	int childAlloc; /**< The number of children allocated for. */
+	unsigned int mark; /**< Used to mark transactions which have been visited when searching ancestors and descendants. */
+	int inputNum; /**< The number of inputs. */
+	CBMempoolSpend * spends; /**< The outputs spent by each input. */
+	unsigned char * data; /**< The serialised transaction. */
+};
+
+/**
+ @brief Structure for CBMempool objects. @see CBMempool.h
+*/
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	CBAssociativeArray transactions; /**< The CBMempoolTransaction structures ordered by hash. */
+	CBAssociativeArray spends; /**< The CBMempoolSpend structures ordered by outpoint. */
+	CBAssociativeArray ancestorScores; /**< The CBMempoolTransaction structures ordered by ancestor fee rate, lowest first. */
+	CBAssociativeArray descendantScores; /**< The CBMempoolTransaction structures ordered by descendant fee rate, lowest first. */
+	int transactionNum; /**< The number of transactions in the pool. */
+	unsigned long long int size; /**< The total serialised size of the transactions in the pool. */
+	unsigned long long int maxSize; /**< The maximum serialised size before transactions are evicted. */
+	unsigned long long int minFeeRate; /**< The minimum fee rate in satoshis per 1000 bytes to accept transactions. */
+	unsigned int mark; /**< The last mark used for searching ancestors and descendants. */
+} CBMempool;
+
+/**
+ @brief Creates a new CBMempool object.
+ @param maxSize The maximum serialised size of the transactions in the pool. @see CB_MEMPOOL_DEFAULT_MAX_SIZE
+ @param minFeeRate The minimum fee rate in satoshis per 1000 bytes. @see CB_MEMPOOL_DEFAULT_MIN_FEE_RATE
+ @returns A new CBMempool object.
+ */
+CBMempool * CBNewMempool(unsigned long long int maxSize, unsigned long long int minFeeRate);
+
+/**
+ @brief Initialises a CBMempool object.
+ @param self The CBMempool object to initialise.
+ @param maxSize The maximum serialised size of the transactions in the pool.
+ @param minFeeRate The minimum fee rate in satoshis per 1000 bytes.
+ */
+void CBInitMempool(CBMempool * self, unsigned long long int maxSize, unsigned long long int minFeeRate);
+
+/**
+ @brief Frees the transactions of a CBMempool object.
+ @param self The CBMempool object to destroy.
+ */
+void CBDestroyMempool(void * self);
+/**
+ @brief Frees a CBMempool object and also calls CBDestroyMempool.
+ @param self The CBMempool object to free.
+ */
+void CBFreeMempool(void * self);
+
+//  Functions
+
+/**
+ @brief Validates a transaction against the unspent output set and the pool and adds it to the pool. Inputs are verified with CBValidateInputScripts with P2SH.
+ @param self The CBMempool object.
+ @param tx The transaction, which should be serialised.
+ @param set The unspent output set of the chain tip.
+ @param height The height of the chain tip.
+ @param time The time to check the transaction is final against.
+ @returns CB_MEMPOOL_OK if the transaction was added, otherwise the reason it was not.
+ */
+CBMempoolResult CBMempoolAddTransaction(CBMempool * self, CBTransaction * tx, CBUnspentOutputSet * set, unsigned int height, unsigned int time);
+/**
+ @brief Gets a transaction in the pool.
+ @param self The CBMempool object.
+ @param hash The transaction hash.
+ @returns The transaction entry or NULL if it is not in the pool.
+ */
+CBMempoolTransaction * CBMempoolGetTransaction(CBMempool * self, unsigned char * hash);
+/**
+ @brief Gets the transaction in the pool which spends an output.
+ @param self The CBMempool object.
+ @param txHash The hash of the transaction with the output.
+ @param index The index of the output.
+ @returns The spending transaction or NULL if no transaction in the pool spends the output.
+ */
+CBMempoolTransaction * CBMempoolGetSpender(CBMempool * self, unsigned char * txHash, unsigned int index);
+/**
+ @brief Removes the transactions in a block from the pool, and removes transactions which conflict with the block together with their descendants.
+ @param self The CBMempool object.
+ @param block The connected block with transactions.
+ */
+void CBMempoolRemoveBlockTransactions(CBMempool * self, CBBlock * block);
+/**
+ @brief Removes a transaction from the pool together with its descendants.
+ @param self The CBMempool object.
+ @param tx The transaction in the pool.
+ */
+void CBMempoolRemoveTransaction(CBMempool * self, CBMempoolTransaction * tx);
+/**
+ @brief Creates a deserialised CBTransaction from a transaction in the pool.
+ @param tx The transaction in the pool.
+ @returns A new CBTransaction.
+ */
+CBTransaction * CBMempoolTransactionGetTransaction(CBMempoolTransaction * tx);
+
+#endif
@@ -0,0 +1,129 @@
+//
+//  CBMerkleBlock.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A "merkleblock" message as in BIP37, which has a block header and a partial merkle tree proving the transactions in the block which matched a bloom filter. The matched transactions are sent as "tx" messages afterwards. Inherits CBMessage
+ */
+
+#ifndef CBMERKLEBLOCKH
+#define CBMERKLEBLOCKH
+
+//  Includes
+
+#include "CBPartialMerkleTree.h"
+
+// Constants and Macros
+
+#define CBGetMerkleBlock(x) ((CBMerkleBlock *)x)
+
+/**
+ @brief Structure for CBMerkleBlock objects. @see CBMerkleBlock.h
+ */
+typedef struct{
+	CBMessage base; /**< CBMessage base structure */
+	int version; /**< The block version. */
+	CBByteArray * prevBlockHash; /**< The hash of the previous block. */
+	CBByteArray * merkleRoot; /**< The merkle root of the block. */
+	unsigned int time; /**< The block timestamp. */
+	unsigned int target; /**< The compact target of the block. */
+	unsigned int nonce; /**< The nonce of the block. */
+	CBPartialMerkleTree tree; /**< The partial merkle tree. */
+} CBMerkleBlock;
+
+/**
+ @brief Creates a new CBMerkleBlock object for the matched transactions of a block.
+ @param block The block, with the header deserialised.
+ @param hashes The transaction hashes of the block, 32 bytes each.
+ @param hashNum The number of transaction hashes.
+ @param matches For each transaction, true if it is matched.
+ @returns A new CBMerkleBlock object.
+ */
+CBMerkleBlock * CBNewMerkleBlock(CBBlock * block, unsigned char * hashes, int hashNum, bool * matches);
+/**
+ @brief Creates a new CBMerkleBlock object from serialised data.
+ @param data Serialised CBMerkleBlock data.
+ @returns A new CBMerkleBlock object.
+ */
+CBMerkleBlock * CBNewMerkleBlockFromData(CBByteArray * data);
+
+/**
+ @brief Initialises a CBMerkleBlock object for the matched transactions of a block.
+ @param self The CBMerkleBlock object to initialise.
+ @param block The block, with the header deserialised.
+ @param hashes The transaction hashes of the block, 32 bytes each.
+ @param hashNum The number of transaction hashes.
+ @param matches For each transaction, true if it is matched.
+ */
+void CBInitMerkleBlock(CBMerkleBlock * self, CBBlock * block, unsigned char * hashes, int hashNum, bool * matches);
+/**
+ @brief Initialises a CBMerkleBlock object from serialised data.
+ @param self The CBMerkleBlock object to initialise.
+ @param data The serialised data.
+ */
+void CBInitMerkleBlockFromData(CBMerkleBlock * self, CBByteArray * data);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBMerkleBlock object.
+ @param self The CBMerkleBlock object to destroy.
+ */
+void CBDestroyMerkleBlock(void * self);
+/**
+ @brief Frees a CBMerkleBlock object and also calls CBDestroyMerkleBlock.
+ @param self The CBMerkleBlock object to free.
+ */
+void CBFreeMerkleBlock(void * self);
+
+//  Functions
+
+/**
+ @brief Calculates the length needed to serialise the object.
+ @param self The CBMerkleBlock object.
+ @returns The length.
+ */
+int CBMerkleBlockCalculateLength(CBMerkleBlock * self);
+/**
+ @brief Deserialises a CBMerkleBlock so that it can be used as an object.
+ @param self The CBMerkleBlock object.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBMerkleBlockDeserialise(CBMerkleBlock * self);
+/**
+ @brief Calculates the hash of the block from the serialised header.
+ @param self The serialised CBMerkleBlock object.
+ @param hash The 32 byte hash is written here.
+ */
+void CBMerkleBlockCalculateHash(CBMerkleBlock * self, unsigned char * hash);
+/**
+ @brief Prepares the bytes for serialising the object.
+ @param self The CBMerkleBlock object.
+ */
+void CBMerkleBlockPrepareBytes(CBMerkleBlock * self);
+/**
+ @brief Serialises a CBMerkleBlock to the byte data.
+ @param self The CBMerkleBlock object.
+ @returns The length written on success, 0 on failure.
+ */
+int CBMerkleBlockSerialise(CBMerkleBlock * self);
+/**
+ @brief Verifies the partial merkle tree against the merkle root in the header and gets the matched transactions.
+ @param self The CBMerkleBlock object.
+ @param matches The hashes of the matched transactions are written here, which needs room for 32 bytes for every hash in the tree.
+ @param indexes If not NULL, the indexes of the matched transactions in the block are written here.
+ @param matchNum The number of matched transactions is written here.
+ @returns true if the tree is valid, false otherwise.
+ */
+bool CBMerkleBlockVerify(CBMerkleBlock * self, unsigned char * matches, int * indexes, int * matchNum);
+
+#endif
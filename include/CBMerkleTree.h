@@ -0,0 +1,150 @@
+//
+//  CBMerkleTree.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief An incremental merkle tree which keeps every level of hashes, so that changing or appending a hash only rehashes the path to the root.
+ @details The levels are stored one after another in a single block of memory, starting with the leaf hashes, each level having room for half of the level below rounded up. When a level has an odd number of hashes the last hash is paired with itself, as in bitcoin blocks. The root is always up to date after a change so getting it costs nothing. When the leaf capacity runs out the block is reallocated with double the capacity and the levels are moved into place. Use CBBuildMerkleTree in CBMerkleNode.h for a linked tree built in one go.
+ Merkle branches prove that a hash is in a tree with one hash for each level below the root. They can be taken from a CBMerkleTree or calculated from a list of hashes, such as the transaction hashes of a stored block, without building a tree.
+ */
+
+#ifndef CBMERKLETREEH
+#define CBMERKLETREEH
+
+//  Includes
+
+#include "CBDependencies.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Constants
+
+#define CB_MERKLE_TREE_MAX_LEVELS 33 // Enough for the number of leaves to be any positive int.
+
+/**
+ @brief An incremental merkle tree. @see CBMerkleTree.h
+ */
+typedef struct{
+	unsigned char * hashes; /**< The hashes of all the levels, starting with the leaves. */
+	int levelOffsets[CB_MERKLE_TREE_MAX_LEVELS]; /**< The index of the first hash of each level in "hashes". */
+	int levelNum; /**< The number of levels including the root. Zero when there are no leaves. */
+	int hashNum; /**< The number of leaf hashes. */
+	int hashAlloc; /**< The number of leaf hashes there is room for. */
+} CBMerkleTree;
+
+/**
+ @brief Initialises an empty merkle tree.
+ @param self The merkle tree.
+ */
+void CBInitMerkleTree(CBMerkleTree * self);
+/**
+ @brief Frees the memory used by a merkle tree, but not the tree structure itself.
+ @param self The merkle tree.
+ */
+void CBDestroyMerkleTree(CBMerkleTree * self);
+
+/**
+ @brief Appends a leaf hash and rehashes the path to the root.
+ @param self The merkle tree.
+ @param hash The 32 byte hash to append.
+ */
+void CBMerkleTreeAppend(CBMerkleTree * self, unsigned char * hash);
+/**
+ @brief Removes all leaves, keeping the memory for reuse.
+ @param self The merkle tree.
+ */
+void CBMerkleTreeClear(CBMerkleTree * self);
+/**
+ @brief Gets a hash on a level of the tree.
+ @param self The merkle tree.
+ @param level The level, with zero for the leaves.
+ @param index The index of the hash on the level.
+ @returns The 32 byte hash.
+ */
+unsigned char * CBMerkleTreeGetHash(CBMerkleTree * self, int level, int index);
+/**
+ @brief Gets the number of hashes on a level of the tree.
+ @param self The merkle tree.
+ @param level The level, with zero for the leaves.
+ @returns The number of hashes.
+ */
+int CBMerkleTreeGetLevelHashNum(CBMerkleTree * self, int level);
+/**
+ @brief Gets the merkle root, which is kept up to date.
+ @param self The merkle tree.
+ @returns The 32 byte root or NULL if there are no leaves.
+ */
+unsigned char * CBMerkleTreeGetRoot(CBMerkleTree * self);
+/**
+ @brief Replaces all of the leaves and builds the levels, hashing each node once.
+ @param self The merkle tree.
+ @param hashes The leaf hashes, 32 bytes each.
+ @param hashNum The number of leaf hashes.
+ */
+void CBMerkleTreeSetHashes(CBMerkleTree * self, unsigned char * hashes, int hashNum);
+/**
+ @brief Changes a leaf hash and rehashes the path to the root.
+ @param self The merkle tree.
+ @param index The index of the leaf.
+ @param hash The new 32 byte hash.
+ */
+void CBMerkleTreeUpdate(CBMerkleTree * self, int index, unsigned char * hash);
+
+//  Functions for hash lists and branches
+
+/**
+ @brief Calculates a merkle branch from a list of hashes. Only the hashes of the sibling of each node on the path are calculated.
+ @param hashes The leaf hashes, 32 bytes each.
+ @param hashNum The number of leaf hashes.
+ @param index The index of the leaf to make the branch for.
+ @param branch The branch is written here, which needs room for 32 bytes for each level below the root.
+ @returns The number of hashes in the branch.
+ */
+int CBCalculateMerkleBranch(unsigned char * hashes, int hashNum, int index, unsigned char * branch);
+/**
+ @brief Calculates the hash of a node in a merkle tree from a list of hashes, by hashing the subtree below it.
+ @param hashes The leaf hashes, 32 bytes each.
+ @param hashNum The number of leaf hashes.
+ @param height The height of the node, with zero for the leaves.
+ @param index The index of the node on its level.
+ @param hash The 32 byte hash of the node is written here.
+ */
+void CBCalculateMerkleNode(unsigned char * hashes, int hashNum, int height, int index, unsigned char * hash);
+/**
+ @brief Calculates the merkle root from a leaf hash and its branch. The proof is valid if the result equals the known merkle root.
+ @param hash The leaf hash.
+ @param branch The branch hashes from the bottom up.
+ @param branchNum The number of hashes in the branch.
+ @param index The index of the leaf.
+ @param root The 32 byte root is written here.
+ */
+void CBMerkleBranchCalculateRoot(unsigned char * hash, unsigned char * branch, int branchNum, int index, unsigned char * root);
+/**
+ @brief Gets the merkle branch for a leaf from the levels of the tree.
+ @param self The merkle tree.
+ @param index The index of the leaf.
+ @param branch The branch is written here, which needs room for 32 bytes for each level below the root.
+ @returns The number of hashes in the branch.
+ */
+int CBMerkleTreeGetBranch(CBMerkleTree * self, int index, unsigned char * branch);
+/**
+ @brief Gets the number of hashes on a level of a merkle tree.
+ @param hashNum The number of leaf hashes.
+ @param height The height of the level, with zero for the leaves.
+ @returns The number of hashes on the level.
+ */
+int CBMerkleTreeWidth(int hashNum, int height);
+
+#endif
@@ -30,7 +30,7 @@
 
 // Constants and Macros
 
-#define CB_MESSAGE_TYPE_STR_SIZE 11
+#define CB_MESSAGE_TYPE_STR_SIZE 13
 #define CB_DESERIALISE_ERROR -1
 #define CBGetMessage(x) ((CBMessage *)x)
 
@@ -52,6 +52,13 @@ typedef enum{
 	CB_MESSAGE_TYPE_PING, /**< @see CBPingPong.h */
 	CB_MESSAGE_TYPE_PONG, /**< @see CBPingPong.h */
 	CB_MESSAGE_TYPE_ALERT, /**< @see CBAlert.h */
+	CB_MESSAGE_TYPE_FILTERLOAD, /**< @see CBBloomFilter.h */
+	CB_MESSAGE_TYPE_FILTERADD, /**< @see CBFilterAdd.h */
+	CB_MESSAGE_TYPE_FILTERCLEAR, /**< Removes the bloom filter loaded into a peer. */
+	CB_MESSAGE_TYPE_MERKLEBLOCK, /**< @see CBMerkleBlock.h */
+	CB_MESSAGE_TYPE_CMPCTBLOCK, /**< @see CBCompactBlock.h */
+	CB_MESSAGE_TYPE_GETBLOCKTXN, /**< @see CBGetBlockTxn.h */
+	CB_MESSAGE_TYPE_BLOCKTXN, /**< @see CBBlockTxn.h */
 	CB_MESSAGE_TYPE_ALT, /**< The message was defined by "alternativeMessages" in a CBNetworkCommunicator */
 	CB_MESSAGE_TYPE_NUM, /**< Number of messages */
 	CB_MESSAGE_TYPE_NONE = UINT8_MAX,
@@ -32,6 +32,8 @@
 #include "CBBlockHeaders.h"
 #include "CBPingPong.h"
 #include "CBAlert.h"
+#include "CBBlockFilterData.h"
+#include "CBPartialBlock.h"
 #include <assert.h>
 #include <stdio.h>
 
@@ -59,6 +61,8 @@ typedef enum{
 	CB_NETWORK_COMMUNICATOR_DETERMINE_IP6 = 16, /**< Determine IPv6 by looking for the receiving IPv6 in version messages. */
 	CB_NETWORK_COMMUNICATOR_BOOTSTRAP = 32, /**< Discover nodes through DNS or use fallback nodes if necessary. Only relevant if  CB_NETWORK_COMMUNICATOR_INCOMING_ONLY is not set. */
 	CB_NETWORK_COMMUNICATOR_INCOMING_ONLY = 64, /**< Only accept incoming connections. Do not initiate any connections. */
+	CB_NETWORK_COMMUNICATOR_BLOOM_FILTERS = 128, /**< Keep the bloom filters loaded by peers with "filterload", "filteradd" and "filterclear" messages as in BIP37. The filters are found in the bloomFilter field of the CBPeer objects and can be used with CBBlockFilterData to serve filtered blocks. */
+	CB_NETWORK_COMMUNICATOR_FLAT_HEADERS = 256, /**< Deserialise received "headers" messages into the flat representation with CBBlockHeadersDeserialiseFlat, so that the headers are found with CBBlockHeadersGetHeader and the blockHeaders array is not filled. Headers with a transaction number over one byte are rejected. */
 }CBNetworkCommunicatorFlags;
 
 /*
@@ -0,0 +1,110 @@
+//
+//  CBPartialBlock.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A block being rebuilt from a "cmpctblock" message as in BIP152. Inherits CBObject
+ @details The transactions are found by matching the short IDs against the short IDs of the transactions in the mempool. Mempool transactions with the same short ID are not used, and the transactions which are not found are requested with a "getblocktxn" message. If the "cmpctblock" message has the same short ID more than once, or the rebuilt block does not have the merkle root of the header because a short ID matched the wrong transaction, the full block should be requested with "getdata" instead.
+ */
+
+#ifndef CBPARTIALBLOCKH
+#define CBPARTIALBLOCKH
+
+//  Includes
+
+#include "CBCompactBlock.h"
+#include "CBBlockTxn.h"
+#include "CBMempool.h"
+
+// Constants and Macros
+
+#define CBGetPartialBlock(x) ((CBPartialBlock *)x)
+
+/**
+ @brief The status of a CBPartialBlock after it is filled with transactions.
+ */
+typedef enum{
+	CB_PARTIAL_BLOCK_COMPLETE, /**< All of the transactions were found. @see CBPartialBlockGetBlock */
+	CB_PARTIAL_BLOCK_MISSING, /**< Transactions are missing and should be requested. @see CBPartialBlockGetRequest */
+	CB_PARTIAL_BLOCK_FULL_BLOCK, /**< The short IDs cannot be used, so the full block should be requested. */
+	CB_PARTIAL_BLOCK_INVALID, /**< The "blocktxn" message does not match the request. */
+} CBPartialBlockStatus;
+
+/**
+ @brief Structure for CBPartialBlock objects. @see CBPartialBlock.h
+ */
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	CBCompactBlock * compactBlock; /**< The "cmpctblock" message. */
+	unsigned char hash[32]; /**< The hash of the block. */
+	int transactionNum; /**< The number of transactions in the block. */
+	CBTransaction ** transactions; /**< The transactions of the block, NULL where they are missing. */
+	int missingNum; /**< The number of missing transactions. */
+} CBPartialBlock;
+
+/**
+ @brief Creates a new CBPartialBlock object with the prefilled transactions.
+ @param compactBlock The "cmpctblock" message, deserialised.
+ @returns A new CBPartialBlock object.
+ */
+CBPartialBlock * CBNewPartialBlock(CBCompactBlock * compactBlock);
+
+/**
+ @brief Initialises a CBPartialBlock object with the prefilled transactions.
+ @param self The CBPartialBlock object to initialise.
+ @param compactBlock The "cmpctblock" message, deserialised.
+ */
+void CBInitPartialBlock(CBPartialBlock * self, CBCompactBlock * compactBlock);
+
+/**
+ @brief Releases and frees all of the objects stored by the CBPartialBlock object.
+ @param self The CBPartialBlock object to destroy.
+ */
+void CBDestroyPartialBlock(void * self);
+/**
+ @brief Frees a CBPartialBlock object and also calls CBDestroyPartialBlock.
+ @param self The CBPartialBlock object to free.
+ */
+void CBFreePartialBlock(void * self);
+
+//  Functions
+
+/**
+ @brief Fills the block with the transactions from a "blocktxn" message sent for the request from CBPartialBlockGetRequest.
+ @param self The CBPartialBlock object.
+ @param blockTxn The "blocktxn" message.
+ @returns CB_PARTIAL_BLOCK_COMPLETE or CB_PARTIAL_BLOCK_INVALID if the message does not have the missing transactions of this block.
+ */
+CBPartialBlockStatus CBPartialBlockFillFromBlockTxn(CBPartialBlock * self, CBBlockTxn * blockTxn);
+/**
+ @brief Fills the block with the transactions in a mempool.
+ @param self The CBPartialBlock object.
+ @param mempool The mempool.
+ @returns CB_PARTIAL_BLOCK_COMPLETE, CB_PARTIAL_BLOCK_MISSING or CB_PARTIAL_BLOCK_FULL_BLOCK.
+ */
+CBPartialBlockStatus CBPartialBlockFillFromMempool(CBPartialBlock * self, CBMempool * mempool);
+/**
+ @brief Gets the block when all of the transactions have been found.
+ @param self The CBPartialBlock object.
+ @returns A new serialised CBBlock. NULL if transactions are still missing. Also NULL if the transactions do not match the merkle root, in which case the full block should be requested.
+ */
+CBBlock * CBPartialBlockGetBlock(CBPartialBlock * self);
+/**
+ @brief Gets a "getblocktxn" message for the missing transactions.
+ @param self The CBPartialBlock object.
+ @returns A new CBGetBlockTxn object.
+ */
+CBGetBlockTxn * CBPartialBlockGetRequest(CBPartialBlock * self);
+
+#endif
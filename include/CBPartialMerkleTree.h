@@ -0,0 +1,92 @@
+//
+//  CBPartialMerkleTree.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief A partial merkle tree as in BIP37, which proves that some transactions are in a block with the hashes of the subtrees without matches.
+ @details The tree is traversed depth first. A flag bit for each node visited says if the node has a matched transaction below it. The hashes of the nodes without matches below them and of the matched transactions are given in order, and the other nodes are hashed from their children.
+ The tree is built directly from the list of transaction hashes of a block, hashing only the subtrees without matches, and serialises into the part of a merkleblock message after the block header.
+ */
+
+#ifndef CBPARTIALMERKLETREEH
+#define CBPARTIALMERKLETREEH
+
+//  Includes
+
+#include "CBMerkleTree.h"
+#include "CBBlock.h"
+
+// Constants
+
+#define CB_PARTIAL_MERKLE_TREE_MAX_TRANSACTIONS (CB_BLOCK_MAX_SIZE / 60) // No more transactions than this can fit into a block.
+
+/**
+ @brief A partial merkle tree. @see CBPartialMerkleTree.h
+ */
+typedef struct{
+	int transactionNum; /**< The number of transactions in the block. */
+	unsigned char * hashes; /**< The hashes in depth first order, 32 bytes each. */
+	int hashNum; /**< The number of hashes. */
+	unsigned char * flags; /**< The flag bits, with the first bit in the least significant bit of the first byte. */
+	int flagNum; /**< The number of flag bits. */
+} CBPartialMerkleTree;
+
+/**
+ @brief Builds a partial merkle tree for the matched transactions of a block.
+ @param self The partial merkle tree to initialise.
+ @param hashes The transaction hashes of the block, 32 bytes each.
+ @param hashNum The number of transaction hashes.
+ @param matches For each transaction, true if it is matched.
+ */
+void CBInitPartialMerkleTree(CBPartialMerkleTree * self, unsigned char * hashes, int hashNum, bool * matches);
+/**
+ @brief Frees the memory used by a partial merkle tree, but not the tree structure itself.
+ @param self The partial merkle tree.
+ */
+void CBDestroyPartialMerkleTree(CBPartialMerkleTree * self);
+
+/**
+ @brief Gets the serialised length of a partial merkle tree.
+ @param self The partial merkle tree.
+ @returns The length in bytes.
+ */
+int CBPartialMerkleTreeCalculateLength(CBPartialMerkleTree * self);
+/**
+ @brief Deserialises a partial merkle tree. The tree should be destroyed afterwards even on failure.
+ @param self The partial merkle tree, which does not need to be initialised.
+ @param bytes The bytes to deserialise from.
+ @param offset The offset of the tree in the bytes.
+ @returns The length read, or zero on failure.
+ */
+int CBPartialMerkleTreeDeserialise(CBPartialMerkleTree * self, CBByteArray * bytes, int offset);
+/**
+ @brief Serialises a partial merkle tree.
+ @param self The partial merkle tree.
+ @param bytes The bytes to serialise into, with room for CBPartialMerkleTreeCalculateLength bytes from the offset.
+ @param offset The offset to serialise to.
+ @returns The length written.
+ */
+int CBPartialMerkleTreeSerialise(CBPartialMerkleTree * self, CBByteArray * bytes, int offset);
+/**
+ @brief Verifies a partial merkle tree against a merkle root and gets the matched transactions.
+ @param self The partial merkle tree.
+ @param merkleRoot The merkle root from the block header.
+ @param matches The hashes of the matched transactions are written here, which needs room for 32 bytes for every hash in the tree.
+ @param indexes If not NULL, the indexes of the matched transactions in the block are written here.
+ @param matchNum The number of matched transactions is written here.
+ @returns true if the tree is valid and has the merkle root, false otherwise.
+ */
+bool CBPartialMerkleTreeVerify(CBPartialMerkleTree * self, unsigned char * merkleRoot, unsigned char * matches, int * indexes, int * matchNum);
+
+#endif
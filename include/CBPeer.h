@@ -26,6 +26,8 @@
 #include "CBVersion.h"
 #include "CBInventory.h"
 #include "CBAssociativeArray.h"
+#include "CBBloomFilter.h"
+#include "CBFilterAdd.h"
 
 // Constants and Macros
 
@@ -78,6 +80,7 @@ typedef struct{
 	bool connectionWorking; /**< True when the connection has been successful and the peer has ben added to the CBNetworkAddressManager. */
 	bool disconnected; /**< Set when we have disconnected so we don't do it more than once. */
 	CBMessageType typeExpected; /**< Type we expect in response. */
+	CBBloomFilter * bloomFilter; /**< The bloom filter loaded by the peer with a "filterload" message, or NULL if the peer has not loaded a filter. */
 	bool incomming; /**< Node from an incomming connection if true */
 	bool connecting;
 	long long int downloadTime; /**< Download time for this peer (in millisconds), not taking the latency into account. Use for determining effeciency. */
@@ -103,4 +106,13 @@ void CBInitPeer(CBPeer * self, CBNetworkAddress * addr);
 void CBDestroyPeer(CBPeer * peer);
 void CBFreePeer(void * peer);
 
+//  Functions
+
+/**
+ @brief Updates the bloom filter of the peer for a received "filterload", "filteradd" or "filterclear" message. Other messages are ignored.
+ @param self The CBPeer object with the received message.
+ @returns false if the peer sent a "filteradd" message without loading a filter, true otherwise.
+ */
+bool CBPeerProcessFilterMessage(CBPeer * self);
+
 #endif
@@ -61,6 +61,19 @@ typedef enum{
 	CB_TX_OUTPUT_TYPE_MULTISIG, /**< <number of signatures required> <public keys> <number of public keys supplied> OP_CHECKMULTISIG */
 } CBScriptOutputType;
 
+/**
+ @brief The templates of the compact script encoding, given by a variable size integer at the start.
+ */
+typedef enum{
+	CB_SCRIPT_COMPACT_KEYHASH, /**< Followed by the 20 byte hash of a pay-to-pubkey-hash output. */
+	CB_SCRIPT_COMPACT_P2SH, /**< Followed by the 20 byte hash of a P2SH output. */
+	CB_SCRIPT_COMPACT_PUBKEY_EVEN, /**< Followed by the 32 byte x coordinate of a pay-to-pubkey output with a compressed public key starting with 0x02. */
+	CB_SCRIPT_COMPACT_PUBKEY_ODD, /**< Followed by the 32 byte x coordinate of a pay-to-pubkey output with a compressed public key starting with 0x03. */
+	CB_SCRIPT_COMPACT_PUBKEY_UNCOMPRESSED, /**< Followed by the 64 bytes after the 0x04 of a pay-to-pubkey output with an uncompressed public key. */
+	CB_SCRIPT_COMPACT_MULTISIG, /**< Followed by a byte with the number of signatures minus one in the high four bits and the number of public keys minus one in the low four bits, a bit for each public key set when it has 65 bytes rather than 33, and the public keys. */
+	CB_SCRIPT_COMPACT_RAW, /**< Added to the length of any other script, which follows in full. */
+} CBScriptCompactTemplate;
+
 typedef enum{
 	CB_SCRIPT_OP_0 = 0x00,
     CB_SCRIPT_OP_FALSE = CB_SCRIPT_OP_0,
@@ -293,6 +306,28 @@ void CBFreeScriptStack(CBScriptStack stack);
  */
 CBScriptStack CBNewEmptyScriptStack(void);
 
+/**
+ @brief Calculates the length of the compact encoding of a script.
+ @param self The CBScript object.
+ @returns The length.
+ */
+int CBScriptCalculateCompactLength(CBScript * self);
+/**
+ @brief Deserialises a script from the compact encoding made by CBScriptCompactSerialise.
+ @param bytes The data.
+ @param offset The offset of the compact script.
+ @param script A new CBScript is set here on success. Scripts written in full reference the data.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBScriptCompactDeserialise(CBByteArray * bytes, int offset, CBScript ** script);
+/**
+ @brief Serialises a script with the compact encoding for storage. Output scripts recognised by CBScriptOutputGetType drop the operations and push lengths given by their template. Other scripts, and scripts which do not exactly match the form the template reproduces, are written in full, so that every script is decoded to the same bytes.
+ @param self The CBScript object.
+ @param bytes The data to write to, with CBScriptCalculateCompactLength bytes available at the offset.
+ @param offset The offset to write to.
+ @returns The length written.
+ */
+int CBScriptCompactSerialise(CBScript * self, CBByteArray * bytes, int offset);
 /**
  @brief Executes a bitcoin script.
  @param self The CBScript object with the program
@@ -12,6 +12,9 @@
 //  or distributed except according to the terms contained in the
 //  LICENSE file.
 
+#ifndef CBTHREADPOOLQUEUEH
+#define CBTHREADPOOLQUEUEH
+
 #include "CBDependencies.h"
 #include "CBObject.h"
 #include <stdlib.h>
@@ -62,3 +65,5 @@ void CBThreadPoolQueueAdd(CBThreadPoolQueue * self, CBQueueItem * item);
 void CBThreadPoolQueueClear(CBThreadPoolQueue * self);
 void CBThreadPoolQueueThreadLoop(void * self);
 void CBThreadPoolQueueWaitUntilFinished(CBThreadPoolQueue * self);
+
+#endif
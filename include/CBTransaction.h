@@ -26,6 +26,8 @@
 #include "CBTransactionInput.h"
 #include "CBTransactionOutput.h"
 #include "CBHDKeys.h"
+#include "CBThreadPoolQueue.h"
+#include "CBHash160Map.h"
 
 // Constants and Macros
 
@@ -33,8 +35,31 @@
 #define CB_TX_MAX_STANDARD_SIZE 100000
 #define CB_TX_HASH_STR_SIZE 41
 #define CB_MAX_DER_SIG_SIZE 74
+#define CB_TX_SIGN_MAX_KEYS 20 // The most keys of a multisig output script.
+#define CB_TX_SIGN_JOB_INPUTS 32 // The number of inputs in each job of CBTransactionSignAll.
 #define CBGetTransaction(x) ((CBTransaction *)x)
 
+/**
+ @brief The input scripts written by CBTransactionSignAll.
+ */
+typedef enum{
+	CB_TX_SIGN_SKIP, /**< The input is left as it is. */
+	CB_TX_SIGN_PUBKEY, /**< A signature, for a pay-to-pubkey output. */
+	CB_TX_SIGN_PUBKEY_HASH, /**< A signature and the public key, for a pay-to-pubkey-hash output. */
+	CB_TX_SIGN_MULTISIG, /**< OP_0 and a signature for each key, for a multisig output. */
+} CBTransactionSignScriptType;
+
+/**
+ @brief How an input is signed, given by the key provider of CBTransactionSignAll.
+ */
+typedef struct{
+	CBTransactionSignScriptType type; /**< The input script to write. */
+	CBKeyPair * keys[CB_TX_SIGN_MAX_KEYS]; /**< The keys to sign with. Pubkey and pubkey hash inputs use the first key. Multisig signatures are written in the order of the keys, which should be the order of the public keys in the output script. */
+	int keyNum; /**< The number of keys. */
+	CBByteArray * prevOutSubScript; /**< The script of the output being spent. */
+	CBSignType signType; /**< The signature hash type. */
+} CBTransactionSignInput;
+
 /**
  @brief Structure for CBTransaction objects. @see CBTransaction.h
 */
@@ -50,6 +75,42 @@ typedef struct{
 	int lockTime; /**< Time for the transaction to be valid */
 } CBTransaction;
 
+/**
+ @brief The state shared by the jobs of CBTransactionSignAll.
+ */
+typedef struct{
+	CBTransaction * tx; /**< The transaction being signed. */
+	CBTransactionSignInput * inputs; /**< How each input is signed. */
+	unsigned char * preimage; /**< The data hashed for SIGHASH_ALL signatures with every input script empty, without the sign type. */
+	int preimageLength; /**< The length of the preimage. */
+	int scriptOffset; /**< The offset in the preimage of the empty script of the first input. */
+	unsigned char * midstates; /**< The SHA-256 states after each block of the preimage. */
+	int maxSubScriptLength; /**< The length of the longest prevOutSubScript. */
+	int * sigStarts; /**< The index of the first signature of each input. */
+	unsigned char * signatures; /**< The signatures, CB_MAX_DER_SIG_SIZE bytes apart. */
+	int * sigLens; /**< The lengths of the signatures, zero if signing failed. */
+} CBTransactionSigner;
+
+/**
+ @brief A job of CBTransactionSignAll, signing a range of inputs.
+ */
+typedef struct{
+	CBQueueItem base; /**< The queue item. */
+	CBTransactionSigner * signer; /**< The shared state. */
+	int start; /**< The first input. */
+	int end; /**< The input after the last input. */
+} CBTransactionSignJob;
+
+/**
+ @brief The previous output transaction hashes of a compact encoding. Each hash is written in full the first time and as its position afterwards. Use one object for all of the transactions of a block, in the same order when serialising and deserialising.
+ */
+typedef struct{
+	CBByteArray ** hashes; /**< The hashes in the order they were first written. */
+	int num; /**< The number of hashes. */
+	int alloc; /**< The number of hashes allocated for. */
+	CBHash160Map positions; /**< The position plus one of each hash by its first 20 bytes, used when serialising. */
+} CBCompactTxIDs;
+
 /**
  @brief Creates a new CBTransaction object with no inputs or outputs.
  @returns A new CBTransaction object.
@@ -68,6 +129,11 @@ CBTransaction * CBNewTransactionFromData(CBByteArray * bytes);
  */
 void CBInitTransaction(CBTransaction * self, int lockTime, int version);
 
+/**
+ @brief Initialises a CBCompactTxIDs with no hashes.
+ @param self The CBCompactTxIDs to initialise.
+ */
+void CBInitCompactTxIDs(CBCompactTxIDs * self);
 /**
  @brief Initialises a new CBTransaction object from the byte data.
  @param self The CBTransaction object to initialise
@@ -81,6 +147,11 @@ void CBInitTransactionFromData(CBTransaction * self, CBByteArray * data);
  */
 void CBDestroyTransaction(void * self);
 
+/**
+ @brief Releases the hashes of a CBCompactTxIDs and frees its memory.
+ @param self The CBCompactTxIDs.
+ */
+void CBFreeCompactTxIDs(CBCompactTxIDs * self);
 /**
  @brief Frees a CBTransaction object and also calls CBDestroyTransaction.
  @param self The CBTransaction object to free.
@@ -112,6 +183,12 @@ int CBTransactionAddSignature(CBTransaction * self, CBScript * inScript, int off
  */
 void CBTransactionCalculateHash(CBTransaction * self, unsigned char * hash);
 
+/**
+ @brief Calculates the length needed for the compact encoding of a transaction, which is the length when no previous output hash is a repeat.
+ @param self The CBTransaction object.
+ @returns The length.
+ */
+int CBTransactionCalculateCompactLength(CBTransaction * self);
 /**
  @brief Calculates the length needed to serialise the object.
  @param self The CBTransaction object.
@@ -119,6 +196,24 @@ void CBTransactionCalculateHash(CBTransaction * self, unsigned char * hash);
  */
 int CBTransactionCalculateLength(CBTransaction * self);
 
+/**
+ @brief Deserialises a transaction from the compact encoding made by CBTransactionCompactSerialise. Input scripts, full output scripts and full previous output hashes reference the data.
+ @param self The CBTransaction object, with no inputs or outputs.
+ @param bytes The data.
+ @param offset The offset of the compact transaction.
+ @param txids The hashes read for earlier transactions, which receives the full hashes of this transaction, or NULL if no hash is written as a position.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBTransactionCompactDeserialise(CBTransaction * self, CBByteArray * bytes, int offset, CBCompactTxIDs * txids);
+/**
+ @brief Serialises a transaction with the compact encoding for storage, which is decoded to the same transaction. The version, numbers of inputs and outputs, and lock time are variable size integers. Each input is a variable size integer of zero followed by the previous output hash, or the position plus one of the hash in txids. Then come variable size integers of the previous output index plus one, so that the index of coinbase inputs is zero, and the sequence with the bits inverted, so that final inputs have zero, and the script with its length. The outputs use CBTransactionOutputCompactSerialise.
+ @param self The CBTransaction object.
+ @param bytes The data to write to, with CBTransactionCalculateCompactLength bytes available at the offset.
+ @param offset The offset to write to.
+ @param txids The hashes written for earlier transactions, which receives the full hashes of this transaction, or NULL to write every hash in full.
+ @returns The length written.
+ */
+int CBTransactionCompactSerialise(CBTransaction * self, CBByteArray * bytes, int offset, CBCompactTxIDs * txids);
 /**
  @brief Deserialises a CBTransaction so that it can be used as an object.
  @param self The CBTransaction object
@@ -173,6 +268,16 @@ bool CBTransactionSignPubKeyHashInput(CBTransaction * self, CBKeyPair * key, CBB
 
 bool CBTransactionSignPubKeyInput(CBTransaction * self, CBKeyPair * key, CBByteArray * prevOutSubScript, int input, CBSignType signType);
 
+/**
+ @brief Signs many inputs of a transaction together. The data hashed for SIGHASH_ALL signatures is made once with every input script empty, and the hash for each input continues from the SHA-256 state before the script of the input. Signatures are made with CBKeySignBatch in jobs of CB_TX_SIGN_JOB_INPUTS inputs, on a thread pool when numThreads is more than one. The input scripts are written once all signatures are made, and the transaction is serialised again if it was serialised.
+ @param self The CBTransaction object.
+ @param getKeys Called with the callback object, the transaction and the index of each input, on the calling thread before signing, to fill in how the input is signed. Return false to stop.
+ @param callbackObject Passed to getKeys.
+ @param numThreads The number of threads to sign with, or zero or one to sign on the calling thread.
+ @returns true on success, or false if getKeys returned false, a key was invalid or an input could not be signed, in which case no input is changed.
+ */
+bool CBTransactionSignAll(CBTransaction * self, bool (*getKeys)(void *, CBTransaction *, int, CBTransactionSignInput *), void * callbackObject, int numThreads);
+
 /**
  @brief Adds an CBTransactionInput to the CBTransaction without retaining it.
  @param self The CBTransaction object.
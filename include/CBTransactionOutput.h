@@ -28,6 +28,7 @@
 // Constants and Macros
 
 #define CB_OUTPUT_VALUE_MINUS_ONE 0xFFFFFFFFFFFFFFFF // In twos complement it represents -1. Bitcoin uses twos compliment.
+#define CB_OUTPUT_COMPACT_FULL_VALUE 0x7FFFFFFFFFFFFFFFLL // Written in the compact encoding in place of the compressed value when the value is more than CB_MAX_MONEY, followed by the full 8 byte value.
 #define CBGetTransactionOutput(x) ((CBTransactionOutput *)x)
 
 /**
@@ -89,6 +90,12 @@ void CBFreeTransactionOutput(void * self);
  
 //  Functions
 
+/**
+ @brief Calculates the length of the compact encoding of an output.
+ @param self The CBTransactionOutput object.
+ @returns The length.
+ */
+int CBTransactionOutputCalculateCompactLength(CBTransactionOutput * self);
 /**
  @brief Calculates the byte length of an output
  @param self The CBTransactionOutput object
@@ -96,6 +103,22 @@ void CBFreeTransactionOutput(void * self);
  */
 int CBTransactionOutputCalculateLength(CBTransactionOutput * self);
 
+/**
+ @brief Deserialises an output from the compact encoding made by CBTransactionOutputCompactSerialise.
+ @param bytes The data.
+ @param offset The offset of the compact output.
+ @param output A new CBTransactionOutput is set here on success.
+ @returns The length read on success, CB_DESERIALISE_ERROR on failure.
+ */
+int CBTransactionOutputCompactDeserialise(CBByteArray * bytes, int offset, CBTransactionOutput ** output);
+/**
+ @brief Serialises an output with the compact encoding for storage. The value is a variable size integer of the value compressed with CBCompressAmount, or CB_OUTPUT_COMPACT_FULL_VALUE followed by the full value when more than CB_MAX_MONEY. The script uses CBScriptCompactSerialise.
+ @param self The CBTransactionOutput object.
+ @param bytes The data to write to, with CBTransactionOutputCalculateCompactLength bytes available at the offset.
+ @param offset The offset to write to.
+ @returns The length written.
+ */
+int CBTransactionOutputCompactSerialise(CBTransactionOutput * self, CBByteArray * bytes, int offset);
 /**
  @brief Deserialises a CBTransactionOutput so that it can be used as an object.
  @param self The CBTransactionOutput object
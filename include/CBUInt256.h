@@ -0,0 +1,132 @@
+//
+//  CBUInt256.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Fixed width 256-bit unsigned integers for targets, hashes and chain work.
+ @details Unlike CBBigInt, a CBUInt256 needs no allocation and is held as four 64-bit limbs, so that comparisons and additions are a few instructions. Arithmetic is modulo 2^256. Hashes are read as little-endian numbers, as they are compared to targets. The compact target format is the 32-bit format used in block headers, with a base-256 exponent in the most significant byte and a 23-bit mantissa with a sign bit.
+ */
+
+#ifndef CBUINT256H
+#define CBUINT256H
+
+//  Includes
+
+#include "CBConstants.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ @brief A 256-bit unsigned integer.
+ */
+typedef struct{
+	uint64_t limbs[4]; /**< The limbs with the least significant first. */
+} CBUInt256;
+
+//  Functions
+
+/**
+ @brief Gets the number of bits needed to represent a CBUInt256.
+ @param a The CBUInt256.
+ @returns The position of the highest set bit plus one, or zero if a is zero.
+ */
+int CBUInt256Bits(CBUInt256 * a);
+/**
+ @brief Compares two CBUInt256. You can replicate "a op b" as "CBUInt256CompareToUInt256(a, b) op 0" replacing "op" with a comparison operator.
+ @param a The first CBUInt256.
+ @param b The second CBUInt256.
+ @returns The result of the comparison as a CBCompare constant. Returns what a is in relation to b.
+ */
+CBCompare CBUInt256CompareToUInt256(CBUInt256 * a, CBUInt256 * b);
+/**
+ @brief Adds a CBUInt256 to another. Like "a += b".
+ @param a The CBUInt256 to add to.
+ @param b The CBUInt256 to add.
+ @returns true if the addition overflowed, false otherwise.
+ */
+bool CBUInt256EqualsAdditionByUInt256(CBUInt256 * a, CBUInt256 * b);
+/**
+ @brief Divides a CBUInt256 by another. Like "a /= b".
+ @param a The CBUInt256 to divide.
+ @param b The divisor.
+ @param remainder If not NULL, the remainder is set here.
+ @returns false if b is zero, in which case a is unchanged, true otherwise.
+ */
+bool CBUInt256EqualsDivisionByUInt256(CBUInt256 * a, CBUInt256 * b, CBUInt256 * remainder);
+/**
+ @brief Multiplies a CBUInt256 by another. Like "a *= b".
+ @param a The CBUInt256 to multiply.
+ @param b The CBUInt256 to multiply by.
+ @returns true if the multiplication overflowed, false otherwise.
+ */
+bool CBUInt256EqualsMultiplicationByUInt256(CBUInt256 * a, CBUInt256 * b);
+/**
+ @brief Shifts a CBUInt256 left. Like "a <<= bits".
+ @param a The CBUInt256.
+ @param bits The number of bits to shift by.
+ */
+void CBUInt256EqualsShiftLeft(CBUInt256 * a, int bits);
+/**
+ @brief Shifts a CBUInt256 right. Like "a >>= bits".
+ @param a The CBUInt256.
+ @param bits The number of bits to shift by.
+ */
+void CBUInt256EqualsShiftRight(CBUInt256 * a, int bits);
+/**
+ @brief Subtracts a CBUInt256 from another. Like "a -= b".
+ @param a The CBUInt256 to subtract from.
+ @param b The CBUInt256 to subtract.
+ @returns true if the subtraction underflowed, false otherwise.
+ */
+bool CBUInt256EqualsSubtractionByUInt256(CBUInt256 * a, CBUInt256 * b);
+/**
+ @brief Reads a CBUInt256 from 32 little-endian bytes, such as a hash.
+ @param a The CBUInt256 to set.
+ @param bytes The 32 bytes.
+ */
+void CBUInt256FromBytes(CBUInt256 * a, unsigned char * bytes);
+/**
+ @brief Sets a CBUInt256 from a compact target.
+ @param a The CBUInt256 to set.
+ @param compact The compact target.
+ @returns false if the compact target is negative or overflows 256 bits, true otherwise.
+ */
+bool CBUInt256FromCompact(CBUInt256 * a, uint32_t compact);
+/**
+ @brief Sets a CBUInt256 to a 64-bit integer.
+ @param a The CBUInt256 to set.
+ @param b The 64-bit integer.
+ */
+void CBUInt256FromUInt64(CBUInt256 * a, uint64_t b);
+/**
+ @brief Determines if a CBUInt256 is zero.
+ @param a The CBUInt256.
+ @returns true if a is zero, false otherwise.
+ */
+bool CBUInt256IsZero(CBUInt256 * a);
+/**
+ @brief Writes a CBUInt256 as 32 little-endian bytes.
+ @param a The CBUInt256.
+ @param bytes The 32 bytes are written here.
+ */
+void CBUInt256ToBytes(CBUInt256 * a, unsigned char * bytes);
+/**
+ @brief Gets the compact target for a CBUInt256, rounding down to the three most significant bytes.
+ @param a The CBUInt256.
+ @returns The compact target.
+ */
+uint32_t CBUInt256ToCompact(CBUInt256 * a);
+
+#endif
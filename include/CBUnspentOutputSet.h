@@ -0,0 +1,130 @@
+//
+//  CBUnspentOutputSet.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Holds the unspent transaction outputs indexed by the outpoint (transaction hash and output index). Each unspent output is stored in a single allocation together with its script, so that outputs can be moved between the set and block undo data without copying. Inherits CBObject
+*/
+
+#ifndef CBUNSPENTOUTPUTSETH
+#define CBUNSPENTOUTPUTSETH
+
+//  Includes
+
+#include "CBObject.h"
+#include "CBAssociativeArray.h"
+
+// Constants and Macros
+
+#define CB_OUTPOINT_KEY_SIZE 36 // 32 bytes for the transaction hash and 4 bytes for the output index.
+#define CBGetUnspentOutputSet(x) ((CBUnspentOutputSet *)x)
+
+/**
+ @brief An unspent output. The outpoint is placed first so that it can be used as the key in a CBAssociativeArray.
+ */
+typedef struct{
+	unsigned char outPoint[CB_OUTPOINT_KEY_SIZE]; /**< The transaction hash followed by the output index as a little-endian 32 bit integer. */
+	unsigned long long int value; /**< The value of the output in satoshis. */
+	unsigned int height; /**< The height of the block containing the transaction for this output. */
+	bool coinbase; /**< True if the output belongs to a coinbase transaction. */
+	int scriptLength; /**< The length of the output script. */
+	unsigned char script[]; /**< The output script data. */
+} CBUnspentOutput;
+
+/**
+ @brief Structure for CBUnspentOutputSet objects. @see CBUnspentOutputSet.h
+*/
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	CBAssociativeArray outputs; /**< The CBUnspentOutput structures ordered by outpoint. */
+	int outputNum; /**< The number of unspent outputs in the set. */
+} CBUnspentOutputSet;
+
+/**
+ @brief Creates a new CBUnspentOutputSet object.
+ @returns A new CBUnspentOutputSet object.
+ */
+CBUnspentOutputSet * CBNewUnspentOutputSet(void);
+/**
+ @brief Allocates a new CBUnspentOutput. Free it with free() unless it is given to a set.
+ @param txHash The hash of the transaction with the output. If NULL the outpoint is set to zero.
+ @param index The index of the output in the transaction.
+ @param value The value of the output.
+ @param script The script data which is copied.
+ @param scriptLength The length of the script data.
+ @param height The height of the block containing the transaction.
+ @param coinbase True if the transaction is a coinbase transaction.
+ @returns The new CBUnspentOutput.
+ */
+CBUnspentOutput * CBNewUnspentOutput(unsigned char * txHash, unsigned int index, unsigned long long int value, unsigned char * script, int scriptLength, unsigned int height, bool coinbase);
+
+/**
+ @brief Initialises a CBUnspentOutputSet object.
+ @param self The CBUnspentOutputSet object to initialise.
+ */
+void CBInitUnspentOutputSet(CBUnspentOutputSet * self);
+
+/**
+ @brief Frees all of the unspent outputs held by the CBUnspentOutputSet object.
+ @param self The CBUnspentOutputSet object to destroy.
+ */
+void CBDestroyUnspentOutputSet(void * self);
+/**
+ @brief Frees a CBUnspentOutputSet object and also calls CBDestroyUnspentOutputSet.
+ @param self The CBUnspentOutputSet object to free.
+ */
+void CBFreeUnspentOutputSet(void * self);
+
+//  Functions
+
+/**
+ @brief Writes the key for an outpoint.
+ @param key The CB_OUTPOINT_KEY_SIZE bytes to write the key to.
+ @param txHash The hash of the transaction.
+ @param index The output index.
+ */
+void CBMakeOutPointKey(unsigned char * key, unsigned char * txHash, unsigned int index);
+/**
+ @brief Gets an unspent output from the set.
+ @param self The CBUnspentOutputSet object.
+ @param txHash The hash of the transaction with the output.
+ @param index The index of the output.
+ @returns The CBUnspentOutput which remains owned by the set or NULL if the output is not in the set.
+ */
+CBUnspentOutput * CBUnspentOutputSetGetOutput(CBUnspentOutputSet * self, unsigned char * txHash, unsigned int index);
+/**
+ @brief Removes and frees an unspent output in the set.
+ @param self The CBUnspentOutputSet object.
+ @param txHash The hash of the transaction with the output.
+ @param index The index of the output.
+ @returns true if the output was removed or false if it was not found.
+ */
+bool CBUnspentOutputSetRemoveOutput(CBUnspentOutputSet * self, unsigned char * txHash, unsigned int index);
+/**
+ @brief Removes an unspent output from the set, giving ownership of the output to the caller.
+ @param self The CBUnspentOutputSet object.
+ @param txHash The hash of the transaction with the output.
+ @param index The index of the output.
+ @returns The spent output or NULL if the output was not found.
+ */
+CBUnspentOutput * CBUnspentOutputSetSpendOutput(CBUnspentOutputSet * self, unsigned char * txHash, unsigned int index);
+/**
+ @brief Takes an unspent output into the set. The outpoint should be set.
+ @param self The CBUnspentOutputSet object.
+ @param output The output to take. This is freed if it cannot be taken.
+ @returns true if the output was added or false if the outpoint already exists in the set.
+ */
+bool CBUnspentOutputSetTakeOutput(CBUnspentOutputSet * self, CBUnspentOutput * output);
+
+#endif
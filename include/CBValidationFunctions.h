@@ -22,6 +22,7 @@
 
 #include "CBConstants.h"
 #include "CBBlock.h"
+#include "CBUInt256.h"
 
 // Constants and Macros
 
@@ -29,6 +30,10 @@
 #define CB_TARGET_INTERVAL 1209600 // Two week interval
 #define CB_MAX_TARGET 0x1D00FFFF
 #define CB_MAX_MONEY 21000000LL * CB_ONE_BITCOIN // 21 million Bitcoins.
+#define CB_BLOCK_ALLOWED_TIME_DRIFT 7200 // Two hours from network time
+#define CB_MAX_SIG_OPS (CB_BLOCK_MAX_SIZE/50) // Maximum number of signature operations in a block.
+#define CB_COINBASE_MATURITY 100 // Number of blocks before coinbase outputs can be spent.
+#define CB_BIP16_SWITCH_TIME 1333238400 // Blocks with a timestamp on or after this time validate P2SH scripts.
 
 /**
  @brief Calculates the block reward at a particular block height
@@ -38,12 +43,19 @@
 long long int CBCalculateBlockReward(long long int blockHeight);
 
 /**
- @brief Calculates the block work which is 256^31 divided by the target
+ @brief Calculates the block work which is 2^256 divided by the target
  @param work The block work to be created as a CBBigInt.
  @param target The target to calculate the work for.
  */
 void CBCalculateBlockWork(CBBigInt * work, int target);
 
+/**
+ @brief Calculates the block work, which is 2^256 divided by the target, as a CBUInt256 so that the work of a chain can be added without allocations.
+ @param work The block work is set here, or zero if the target is invalid.
+ @param target The target to calculate the work for.
+ */
+void CBCalculateBlockWorkUInt256(CBUInt256 * work, int target);
+
 /**
  @brief Calculates the merkle root from a list of hashes.
  @param hashes The hashes stored as continuous byte data with each 32 byte hash after each other. The data pointed to by "hashes" will be modified and will result in the merkle root as the first 32 bytes.
@@ -75,6 +87,21 @@ int CBTransactionGetSigOps(CBTransaction * tx);
  */
 bool CBTransactionValidateBasic(CBTransaction * tx, bool coinbase, long long int * outputValue);
 
+/**
+ @brief Determines if any two inputs of a transaction spend the same output. The previous outputs are sorted so that this is O(n log n) in the number of inputs.
+ @param tx The transaction.
+ @returns true if an output is spent more than once, false otherwise.
+ */
+bool CBTransactionHasDuplicateInputs(CBTransaction * tx);
+
+/**
+ @brief Finds an output spent more than once by the inputs of a list of transactions, such as those of a block, including twice within the same transaction. All inputs are sorted together in a single pass. Coinbase inputs are ignored.
+ @param transactions The transactions.
+ @param transactionNum The number of transactions.
+ @returns The index of the transaction with the later spend of a double spent output, or -1 if there are no double spends.
+ */
+int CBTransactionsFindDoubleSpend(CBTransaction ** transactions, int transactionNum);
+
 /**
  @brief Determines if a transaction is final and therefore can exist in a block. A transaction is final if the lockTime has been reached or if all inputs are final.
  @param tx The transaction.
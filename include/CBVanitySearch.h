@@ -0,0 +1,124 @@
+//
+//  CBVanitySearch.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Searches for key pairs with addresses beginning with a pattern, without encoding every address in base-58. Inherits CBObject
+ @details An address is the base-58 encoding of the 25 byte number made of the version byte, the hash and the checksum. The addresses beginning with a pattern are those with as many leading zero bytes as the pattern has leading '1' characters, and with the rest of the number between the value of the rest of the pattern and one more than it, multiplied by a power of 58 for each length of address. When the pattern is made, these ranges are turned into ranges of hashes, so that candidate hashes are filtered with integer comparisons and only the hits are encoded to be checked. Matches ignoring case are found by making the ranges of every way of writing the pattern in the base-58 alphabet.
+ Key pairs are stepped from random keys in batches with CBKeyPairGetNextKeys on a number of threads, one of which is the calling thread, which reports the progress.
+ */
+
+#ifndef CBVANITYSEARCHH
+#define CBVANITYSEARCHH
+
+//  Includes
+
+#include "CBAddress.h"
+#include "CBHDKeys.h"
+
+// Constants and Macros
+
+#define CB_VANITY_SEARCH_MAX_PATTERNS 65536 // The most ways of writing a pattern ignoring case, beyond which the search would never end anyway.
+#define CBGetVanitySearch(x) ((CBVanitySearch *)x)
+
+/**
+ @brief A range of hashes of a CBVanitySearch.
+ */
+typedef struct{
+	uint64_t low; /**< The first eight bytes of the lowest hash as a big-endian integer. */
+	uint64_t high; /**< The first eight bytes of the highest hash as a big-endian integer. */
+	unsigned char lowHash[20]; /**< The lowest hash. */
+	unsigned char highHash[20]; /**< The highest hash. */
+} CBVanitySearchRange;
+
+/**
+ @brief Structure for CBVanitySearch objects. @see CBVanitySearch.h
+ */
+typedef struct{
+	CBObject base; /**< CBObject base structure */
+	char * pattern; /**< The pattern the addresses begin with. */
+	CBBase58Prefix prefix; /**< The version byte of the addresses. */
+	bool caseInsensitive; /**< true if case is ignored. */
+	CBVanitySearchRange * ranges; /**< The ranges of hashes with the pattern, in order and not overlapping. Hashes at the ends of ranges may not have the pattern, depending on their checksums. */
+	int rangeNum; /**< The number of ranges. */
+	double difficulty; /**< The expected number of key pairs to try for a match. */
+	CBDepObject mutex; /**< Guards the search state during a search. */
+	uint64_t tried; /**< The number of key pairs tried by the search. */
+	bool stop; /**< true when the threads of a search should stop. */
+	bool found; /**< true if the search found a key pair. */
+	CBKeyPair key; /**< The key pair found. */
+	char address[CB_ADDRESS_STRING_SIZE]; /**< The address found. */
+} CBVanitySearch;
+
+/**
+ @brief Creates a new CBVanitySearch object.
+ @param pattern The pattern the addresses should begin with, including the leading character given by the prefix.
+ @param prefix The version byte of the addresses.
+ @param caseInsensitive If true, addresses match when they begin with the pattern ignoring case.
+ @returns A new CBVanitySearch object or NULL if the pattern has characters which are not base-58, no address with the prefix can begin with it, or it can be written in too many ways ignoring case.
+ */
+CBVanitySearch * CBNewVanitySearch(char * pattern, CBBase58Prefix prefix, bool caseInsensitive);
+
+/**
+ @brief Initialises a CBVanitySearch object.
+ @param self The CBVanitySearch object to initialise.
+ @param pattern The pattern the addresses should begin with.
+ @param prefix The version byte of the addresses.
+ @param caseInsensitive If true, case is ignored.
+ @returns true on success, false if there are no addresses which begin with the pattern.
+ */
+bool CBInitVanitySearch(CBVanitySearch * self, char * pattern, CBBase58Prefix prefix, bool caseInsensitive);
+
+/**
+ @brief Frees the pattern and ranges of a CBVanitySearch object.
+ @param self The CBVanitySearch object to destroy.
+ */
+void CBDestroyVanitySearch(void * self);
+/**
+ @brief Frees a CBVanitySearch object and also calls CBDestroyVanitySearch.
+ @param self The CBVanitySearch object to free.
+ */
+void CBFreeVanitySearch(void * self);
+
+//  Functions
+
+/**
+ @brief Checks if the address of a hash begins with the pattern, encoding the address only when the hash is in a range.
+ @param self The CBVanitySearch object.
+ @param hash The 20 byte hash.
+ @param address Set to the address when it is encoded, or NULL. Must have space for CB_ADDRESS_STRING_SIZE characters.
+ @returns true if the address begins with the pattern.
+ */
+bool CBVanitySearchCheckHash(CBVanitySearch * self, unsigned char * hash, char * address);
+/**
+ @brief Searches for a key pair with an address beginning with the pattern.
+ @param self The CBVanitySearch object.
+ @param numThreads The number of threads to search with, including the calling thread.
+ @param onProgress Called on the calling thread every progress interval with the callback object, the number of key pairs tried and the number tried per second. The search stops if it returns false. May be NULL.
+ @param callbackObject Passed to onProgress.
+ @param progressInterval The number of milliseconds between calls to onProgress.
+ @param key Set to the key pair found.
+ @param address Set to the address found. Must have space for CB_ADDRESS_STRING_SIZE characters.
+ @returns true if a key pair was found, false if the search was stopped or a random key could not be generated.
+ */
+bool CBVanitySearchFind(CBVanitySearch * self, int numThreads, bool (*onProgress)(void *, uint64_t, double), void * callbackObject, int progressInterval, CBKeyPair * key, char * address);
+/**
+ @brief Checks if the hash is in a range of the pattern with integer comparisons.
+ @param self The CBVanitySearch object.
+ @param hash The 20 byte hash.
+ @returns true if the hash is in a range. The address can only begin with the pattern if true.
+ */
+bool CBVanitySearchInRange(CBVanitySearch * self, unsigned char * hash);
+
+#endif
@@ -32,7 +32,28 @@ typedef struct{
 	int size; /**< Size of the integer when encoded in bytes */
 }CBVarInt;
 
+/**
+ @brief Compresses an amount of satoshis so that round amounts encode into small integers. Trailing decimal zeros are moved into the lowest digit. Suitable for encoding as a variable size integer.
+ @param amount The amount to compress.
+ @returns The compressed amount.
+ */
+unsigned long long int CBCompressAmount(unsigned long long int amount);
+/**
+ @brief Reverses CBCompressAmount.
+ @param compressed The compressed amount.
+ @returns The original amount.
+ */
+unsigned long long int CBDecompressAmount(unsigned long long int compressed);
 CBVarInt CBVarIntDecodeData(unsigned char * bytes, int offset);
+/**
+ @brief Decodes a variable size integer which must lie within some data.
+ @param bytes The data.
+ @param length The length of the data.
+ @param offset The offset of the variable size integer.
+ @param varInt The decoded variable size integer.
+ @returns true on success, false if the variable size integer goes past the end of the data.
+ */
+bool CBVarIntDecodeDataChecked(unsigned char * bytes, int length, int offset, CBVarInt * varInt);
 int CBVarIntDecodeSize(unsigned char * bytes, int offset);
 
 /**
@@ -84,3 +84,73 @@ void CBFreeAddress(void * self) {
 
 //  Functions
 
+int CBAddressDecodeBatch(char * strings, int num, unsigned char * hashes, CBBase58Prefix * prefixes, bool * valid) {
+	
+	unsigned char data[CB_ADDRESS_BATCH_SIZE][21], checksums[CB_ADDRESS_BATCH_SIZE][4];
+	unsigned char hash1[CB_ADDRESS_BATCH_SIZE][32], hash2[CB_ADDRESS_BATCH_SIZE][32];
+	unsigned char * dataPtrs[CB_ADDRESS_BATCH_SIZE], * hash1Ptrs[CB_ADDRESS_BATCH_SIZE];
+	int positions[CB_ADDRESS_BATCH_SIZE];
+	int validNum = 0;
+	for (int x = 0; x < num; x += CB_ADDRESS_BATCH_SIZE) {
+		int batchNum = num - x < CB_ADDRESS_BATCH_SIZE ? num - x : CB_ADDRESS_BATCH_SIZE;
+		// Decode the strings, keeping those which are 25 bytes for hashing.
+		int decodedNum = 0;
+		for (int y = 0; y < batchNum; y++) {
+			unsigned char bytes[25];
+			valid[x + y] = CBBase58Decode(strings + (x + y) * CB_ADDRESS_STRING_SIZE, bytes, 25) == 25;
+			if (! valid[x + y])
+				continue;
+			// Base 58 gives little-endian bytes.
+			for (int z = 0; z < 21; z++)
+				data[decodedNum][z] = bytes[24 - z];
+			for (int z = 0; z < 4; z++)
+				checksums[decodedNum][z] = bytes[3 - z];
+			dataPtrs[decodedNum] = data[decodedNum];
+			hash1Ptrs[decodedNum] = hash1[decodedNum];
+			positions[decodedNum++] = x + y;
+		}
+		CBSha256Batch(dataPtrs, 21, decodedNum, hash1[0]);
+		CBSha256Batch(hash1Ptrs, 32, decodedNum, hash2[0]);
+		for (int y = 0; y < decodedNum; y++) {
+			if (memcmp(hash2[y], checksums[y], 4)) {
+				valid[positions[y]] = false;
+				continue;
+			}
+			memcpy(hashes + positions[y] * 20, data[y] + 1, 20);
+			if (prefixes)
+				prefixes[positions[y]] = data[y][0];
+			validNum++;
+		}
+	}
+	return validNum;
+	
+}
+
+void CBAddressEncodeBatch(unsigned char * hashes, CBBase58Prefix prefix, int num, char * strings) {
+	
+	unsigned char data[CB_ADDRESS_BATCH_SIZE][21];
+	unsigned char hash1[CB_ADDRESS_BATCH_SIZE][32], hash2[CB_ADDRESS_BATCH_SIZE][32];
+	unsigned char * dataPtrs[CB_ADDRESS_BATCH_SIZE], * hash1Ptrs[CB_ADDRESS_BATCH_SIZE];
+	for (int x = 0; x < num; x += CB_ADDRESS_BATCH_SIZE) {
+		int batchNum = num - x < CB_ADDRESS_BATCH_SIZE ? num - x : CB_ADDRESS_BATCH_SIZE;
+		for (int y = 0; y < batchNum; y++) {
+			data[y][0] = prefix;
+			memcpy(data[y] + 1, hashes + (x + y) * 20, 20);
+			dataPtrs[y] = data[y];
+			hash1Ptrs[y] = hash1[y];
+		}
+		// The checksum is the first four bytes of SHA-256 applied twice.
+		CBSha256Batch(dataPtrs, 21, batchNum, hash1[0]);
+		CBSha256Batch(hash1Ptrs, 32, batchNum, hash2[0]);
+		for (int y = 0; y < batchNum; y++) {
+			// Base 58 takes little-endian bytes.
+			unsigned char bytes[25];
+			for (int z = 0; z < 21; z++)
+				bytes[24 - z] = data[y][z];
+			for (int z = 0; z < 4; z++)
+				bytes[3 - z] = hash2[y][z];
+			CBBase58Encode(bytes, 25, strings + (x + y) * CB_ADDRESS_STRING_SIZE);
+		}
+	}
+	
+}
@@ -16,51 +16,80 @@
 
 #include "CBBase58.h"
 
-void CBDecodeBase58(CBBigInt * bi, char * str){
-	// ??? Quite likely these functions can be improved
-	CBBigInt bi2;
-	CBBigIntAlloc(&bi2, 1);
-	bi->data[0] = 0;
-	bi->length = 1;
-	for (int x = strlen(str) - 1;; x--){ // Working backwards
-		// Get index in alphabet array
-		int alphaIndex = str[x];
-		if (alphaIndex != 49){ // If not 1
-			if (str[x] < 58){ // Numbers
-				alphaIndex -= 49;
-			}else if (str[x] < 73){ // A-H
-				alphaIndex -= 56;
-			}else if (str[x] < 79){ // J-N
-				alphaIndex -= 57;
-			}else if (str[x] < 91){ // P-Z
-				alphaIndex -= 58;
-			}else if (str[x] < 108){ // a-k
-				alphaIndex -= 64;
-			}else{ // m-z
-				alphaIndex -= 65;
+#define CB_BASE58_POW5 656356768 // 58^5, the base of the limbs when encoding.
+
+/**
+ @brief The value of each ASCII character in base 58, or -1 for characters which are not in the alphabet.
+ */
+static const signed char CBBase58Values[128] = {
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1, 0, 1, 2, 3, 4, 5, 6, 7, 8,-1,-1,-1,-1,-1,-1,
+	-1, 9,10,11,12,13,14,15,16,-1,17,18,19,20,21,-1,
+	22,23,24,25,26,27,28,29,30,31,32,-1,-1,-1,-1,-1,
+	-1,33,34,35,36,37,38,39,40,41,42,43,-1,44,45,46,
+	47,48,49,50,51,52,53,54,55,56,57,-1,-1,-1,-1,-1,
+};
+
+int CBBase58Decode(char * str, unsigned char * bytes, int size){
+	int zeros = 0;
+	while (str[zeros] == '1')
+		zeros++;
+	int length = zeros + (int)strlen(str + zeros);
+	// The number as 32-bit limbs with the least significant first. Each digit is under six bits.
+	uint32_t stackLimbs[CB_BASE58_STACK_LIMBS];
+	int maxLimbs = (length - zeros) * 6 / 32 + 1;
+	uint32_t * limbs = maxLimbs > CB_BASE58_STACK_LIMBS ? malloc(sizeof(*limbs) * maxLimbs) : stackLimbs;
+	int limbNum = 0;
+	// Take five digits at a time, with a shorter first chunk so that the rest are whole.
+	for (int x = zeros; x < length;) {
+		int chunk = (length - x) % 5 ? (length - x) % 5 : 5;
+		uint64_t carry = 0, mult = 1;
+		for (int y = 0; y < chunk; y++, x++) {
+			int value = (unsigned char)str[x] < 128 ? CBBase58Values[(unsigned char)str[x]] : -1;
+			if (value < 0) {
+				if (limbs != stackLimbs)
+					free(limbs);
+				return -1;
 			}
-			CBBigIntFromPowUInt8(&bi2, 58, strlen(str) - 1 - x);
-			CBBigIntEqualsMultiplicationByUInt8(&bi2, alphaIndex);
-			CBBigIntEqualsAdditionByBigInt(bi, &bi2);
+			carry = carry * 58 + value;
+			mult *= 58;
+		}
+		for (int y = 0; y < limbNum; y++) {
+			uint64_t num = (uint64_t)limbs[y] * mult + carry;
+			limbs[y] = (uint32_t)num;
+			carry = num >> 32;
 		}
-		if (! x)
-			break;
+		if (carry)
+			limbs[limbNum++] = (uint32_t)carry;
 	}
-	free(bi2.data);
-	// Got CBBigInt from base-58 string. Add zeros on end.
-	int zeros = 0;
-	for (size_t x = 0; x < strlen(str); x++)
-		if (str[x] == '1')
-			zeros++;
-		else
-			break;
-	if (zeros) {
-		bi->length += zeros;
-		CBBigIntRealloc(bi, bi->length);
-		memset(bi->data + bi->length - zeros, 0, zeros);
-	}else
-		// Reallocate to actual length
-		CBBigIntRealloc(bi, bi->length);
+	int byteNum = limbNum * 4;
+	while (byteNum && ! (limbs[(byteNum - 1) / 4] >> ((byteNum - 1) % 4 * 8) & 0xFF))
+		byteNum--;
+	if (byteNum + zeros > size) {
+		if (limbs != stackLimbs)
+			free(limbs);
+		return -1;
+	}
+	for (int x = 0; x < byteNum; x++)
+		bytes[x] = (unsigned char)(limbs[x / 4] >> (x % 4 * 8));
+	memset(bytes + byteNum, 0, zeros);
+	if (limbs != stackLimbs)
+		free(limbs);
+	return byteNum + zeros;
+}
+void CBDecodeBase58(CBBigInt * bi, char * str){
+	CBBigIntRealloc(bi, (int)strlen(str) + 1);
+	int length = CBBase58Decode(str, bi->data, bi->allocLen);
+	if (length == -1) {
+		CBLogError("The string passed into CBDecodeBase58 has an invalid character.");
+		bi->data[0] = 0;
+		length = 1;
+	}else if (length == (int)strspn(str, "1"))
+		// The number is zero, which is represented by one byte before the leading zeros.
+		bi->data[length++] = 0;
+	bi->length = length;
 }
 bool CBDecodeBase58Checked(CBBigInt * bi, char * str){
 	CBDecodeBase58(bi, str);
@@ -69,14 +98,16 @@ bool CBDecodeBase58Checked(CBBigInt * bi, char * str){
 		return false;
 	}
 	// Reverse bytes for checksum generation
-	unsigned char * reversed = malloc(bi->length - 4);
+	unsigned char stackReversed[CB_BASE58_STACK_LIMBS * 4];
+	unsigned char * reversed = bi->length - 4 > CB_BASE58_STACK_LIMBS * 4 ? malloc(bi->length - 4) : stackReversed;
 	for (int x = 4; x < bi->length; x++)
 		reversed[bi->length - 1 - x] = bi->data[x];
 	// The checksum uses SHA-256, twice, for some reason unknown to man.
 	unsigned char checksum[32];
 	unsigned char checksum2[32];
 	CBSha256(reversed, bi->length - 4, checksum);
-	free(reversed);
+	if (reversed != stackReversed)
+		free(reversed);
 	CBSha256(checksum, 32, checksum2);
 	bool ok = true;
 	for (int x = 0; x < 4; x++)
@@ -88,65 +119,54 @@ bool CBDecodeBase58Checked(CBBigInt * bi, char * str){
 	}
 	return true;
 }
-
-char * CBEncodeBase58(CBBigInt * bi) {
-
-	// XXX Improvements?
-	
-	int x = 0;
-	char * str = malloc(bi->length);
-
-	// Zeros
-	
-	for (int y = bi->length - 1;; y--)
-		if (! bi->data[y]){
-			str[x] = '1';
-			x++;
-			if (! y)
-				break;
-		}else
-			break;
-
-	int zeros = x;
-
-	// Make temporary data store
-	unsigned char * temp = malloc(bi->length);
-
-	// Encode
-	
-	int mod;
-	int size = bi->length;
-
-	for (;CBBigIntCompareTo58(bi) >= 0;x++) {
-		mod = CBBigIntModuloWith58(bi);
-		if (bi->length < x + 3) {
-			size = x + 3;
-			if (size > bi->length) {
-				char * temp = realloc(str, size);
-				str = temp;
-			}
+int CBBase58Encode(unsigned char * bytes, int length, char * str){
+	int zeros = 0;
+	while (zeros < length && ! bytes[length - 1 - zeros])
+		zeros++;
+	int sigLength = length - zeros;
+	// The number as limbs below 58^5 with the least significant first.
+	uint32_t stackLimbs[CB_BASE58_STACK_LIMBS];
+	int maxLimbs = CBBase58MaxLength(sigLength) / 5 + 1;
+	uint32_t * limbs = maxLimbs > CB_BASE58_STACK_LIMBS ? malloc(sizeof(*limbs) * maxLimbs) : stackLimbs;
+	int limbNum = 0;
+	// Take 32-bit words from the most significant end, with a shorter first word so that the rest are whole.
+	for (int x = sigLength; x > 0;) {
+		int wordBytes = x % 4 ? x % 4 : 4;
+		uint64_t carry = 0;
+		for (int y = 0; y < wordBytes; y++)
+			carry = carry << 8 | bytes[--x];
+		for (int y = 0; y < limbNum; y++) {
+			uint64_t num = (uint64_t)limbs[y] << (wordBytes * 8) | carry;
+			limbs[y] = (uint32_t)(num % CB_BASE58_POW5);
+			carry = num / CB_BASE58_POW5;
+		}
+		while (carry) {
+			limbs[limbNum++] = (uint32_t)(carry % CB_BASE58_POW5);
+			carry /= CB_BASE58_POW5;
 		}
-		str[x] = base58Characters[mod];
-		CBBigIntEqualsSubtractionByUInt8(bi, mod);
-		memset(temp, 0, bi->length);
-		CBBigIntEqualsDivisionBy58(bi, temp);
 	}
-	str[x++] = base58Characters[bi->data[bi->length-1]];
-
-	// Reversal
-	for (int y = 0; y < (x-zeros) / 2; y++) {
-		char temp = str[y+zeros];
-		str[y+zeros] = str[x-y-1];
-		str[x-y-1] = temp;
+	memset(str, '1', zeros);
+	int strLength = zeros;
+	for (int x = limbNum; x--;) {
+		char digits[5];
+		uint32_t limb = limbs[x];
+		for (int y = 5; y--; limb /= 58)
+			digits[y] = base58Characters[limb % 58];
+		// The most significant limb is not zero padded.
+		int start = 0;
+		if (x == limbNum - 1)
+			while (digits[start] == '1')
+				start++;
+		memcpy(str + strLength, digits + start, 5 - start);
+		strLength += 5 - start;
 	}
-
-	str[x] = '\0';
-
-	// Cleanup
-	
-	free(temp);
-
+	str[strLength] = '\0';
+	if (limbs != stackLimbs)
+		free(limbs);
+	return strLength;
+}
+char * CBEncodeBase58(CBBigInt * bi){
+	char * str = malloc(CBBase58MaxLength(bi->length) + 1);
+	CBBase58Encode(bi->data, bi->length, str);
 	return str;
-
 }
-
@@ -193,6 +193,104 @@ unsigned char * CBBlockCalculateMerkleRoot(CBBlock * self) {
 	
 }
 
+int CBBlockCalculateCompactLength(CBBlock * self) {
+	
+	int len = 80 + CBVarIntSizeOf(self->transactionNum);
+	
+	for (int x = 0; x < self->transactionNum; x++)
+		len += CBTransactionCalculateCompactLength(self->transactions[x]);
+	
+	return len;
+	
+}
+
+int CBBlockCompactDeserialise(CBBlock * self, CBByteArray * bytes, int offset) {
+	
+	if (bytes->length < offset + 81) {
+		CBLogError("Attempting to deserialise a compact CBBlock with less than 81 bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	
+	unsigned char * data = CBByteArrayGetData(bytes);
+	unsigned char hash2[32];
+	
+	self->version = CBByteArrayReadInt32(bytes, offset);
+	self->prevBlockHash = CBByteArraySubReference(bytes, offset + 4, 32);
+	self->merkleRoot = CBByteArraySubReference(bytes, offset + 36, 32);
+	self->time = CBByteArrayReadInt32(bytes, offset + 68);
+	self->target = CBByteArrayReadInt32(bytes, offset + 72);
+	self->nonce = CBByteArrayReadInt32(bytes, offset + 76);
+	
+	// The header is stored as it is for the network, so the hash is found without serialising the block.
+	CBSha256(data + offset, 80, hash2);
+	CBSha256(hash2, 32, self->hash);
+	self->hashSet = true;
+	
+	CBVarInt txNum;
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, offset + 80, &txNum)
+		// Each transaction takes at least four bytes.
+		|| txNum.val > (bytes->length - offset - 80 - txNum.size) / 4) {
+		CBLogError("Attempting to deserialise a compact CBBlock with a bad number of transactions.");
+		return CB_DESERIALISE_ERROR;
+	}
+	
+	int cursor = offset + 80 + txNum.size;
+	
+	self->transactions = malloc(sizeof(*self->transactions) * (size_t)txNum.val);
+	self->transactionNum = 0;
+	
+	CBCompactTxIDs txids;
+	CBInitCompactTxIDs(&txids);
+	
+	for (int x = 0; x < txNum.val; x++) {
+		
+		CBTransaction * tx = CBNewTransaction(0, 0);
+		int len = CBTransactionCompactDeserialise(tx, bytes, cursor, &txids);
+		
+		if (len == CB_DESERIALISE_ERROR) {
+			CBReleaseObject(tx);
+			CBFreeCompactTxIDs(&txids);
+			CBLogError("Compact CBBlock has a transaction that failed to deserialise.");
+			return CB_DESERIALISE_ERROR;
+		}
+		
+		self->transactions[self->transactionNum++] = tx;
+		cursor += len;
+		
+	}
+	
+	CBFreeCompactTxIDs(&txids);
+	
+	return cursor - offset;
+	
+}
+
+int CBBlockCompactSerialise(CBBlock * self, CBByteArray * bytes, int offset) {
+	
+	CBByteArraySetInt32(bytes, offset, self->version);
+	CBByteArrayCopyByteArray(bytes, offset + 4, self->prevBlockHash);
+	CBByteArrayCopyByteArray(bytes, offset + 36, self->merkleRoot);
+	CBByteArraySetInt32(bytes, offset + 68, self->time);
+	CBByteArraySetInt32(bytes, offset + 72, self->target);
+	CBByteArraySetInt32(bytes, offset + 76, self->nonce);
+	
+	int cursor = offset + 80;
+	CBVarInt txNum = CBVarIntFromUInt64(self->transactionNum);
+	CBByteArraySetVarIntData(CBByteArrayGetData(bytes), cursor, txNum);
+	cursor += txNum.size;
+	
+	CBCompactTxIDs txids;
+	CBInitCompactTxIDs(&txids);
+	
+	for (int x = 0; x < self->transactionNum; x++)
+		cursor += CBTransactionCompactSerialise(self->transactions[x], bytes, cursor, &txids);
+	
+	CBFreeCompactTxIDs(&txids);
+	
+	return cursor - offset;
+	
+}
+
 int CBBlockDeserialise(CBBlock * self, bool transactions) {
 	
 	CBByteArray * bytes = CBGetMessage(self)->bytes;
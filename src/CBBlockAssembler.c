@@ -0,0 +1,245 @@
+//
+//  CBBlockAssembler.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBlockAssembler.h"
+
+static unsigned char CBBlockAssemblerHashKeySize = 32;
+
+/**
+ @brief Appends a transaction to the template and the merkle tree.
+ @param self The CBBlockAssembler object.
+ @param tx The transaction, which is retained.
+ */
+static void CBBlockAssemblerAppend(CBBlockAssembler * self, CBTransaction * tx);
+/**
+ @brief Determines if a transaction is in the template.
+ @param self The CBBlockAssembler object.
+ @param hash The transaction hash.
+ @returns true if the transaction is in the template, false otherwise.
+ */
+static bool CBBlockAssemblerIsIncluded(CBBlockAssembler * self, unsigned char * hash);
+/**
+ @brief Makes the coinbase transaction for the current fees and extra nonce and updates the merkle tree.
+ @param self The CBBlockAssembler object.
+ */
+static void CBBlockAssemblerMakeCoinbase(CBBlockAssembler * self);
+
+//  Constructor
+
+CBBlockAssembler * CBNewBlockAssembler(CBMempool * mempool, CBScript * outputScript){
+	CBBlockAssembler * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockAssembler;
+	CBInitBlockAssembler(self, mempool, outputScript);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitBlockAssembler(CBBlockAssembler * self, CBMempool * mempool, CBScript * outputScript){
+	CBInitObject(CBGetObject(self), false);
+	CBRetainObject(mempool);
+	CBRetainObject(outputScript);
+	self->mempool = mempool;
+	self->outputScript = outputScript;
+	memset(self->prevBlockHash, 0, 32);
+	self->height = 0;
+	self->time = 0;
+	self->target = CB_MAX_TARGET;
+	self->extraNonce = 0;
+	self->transactions = NULL;
+	self->transactionNum = 0;
+	self->transactionAlloc = 0;
+	CBInitAssociativeArray(&self->included, CBFixedKeyCompare, &CBBlockAssemblerHashKeySize, free);
+	self->size = 0;
+	self->sigOps = 0;
+	self->fees = 0;
+	CBInitMerkleTree(&self->merkleTree);
+}
+
+//  Destructor
+
+void CBDestroyBlockAssembler(void * vself){
+	CBBlockAssembler * self = vself;
+	for (int x = 0; x < self->transactionNum; x++)
+		CBReleaseObject(self->transactions[x]);
+	free(self->transactions);
+	CBFreeAssociativeArray(&self->included);
+	CBDestroyMerkleTree(&self->merkleTree);
+	CBReleaseObject(self->mempool);
+	CBReleaseObject(self->outputScript);
+}
+void CBFreeBlockAssembler(void * self){
+	CBDestroyBlockAssembler(self);
+	free(self);
+}
+
+//  Functions
+
+bool CBBlockAssemblerAddTransaction(CBBlockAssembler * self, CBMempoolTransaction * tx){
+	// There is no template, and so no place for the coinbase, until CBBlockAssemblerNewTemplate.
+	if (! self->transactionNum)
+		return false;
+	if (CBBlockAssemblerIsIncluded(self, tx->hash))
+		return true;
+	// Find the package of the transaction with its ancestors which are not in the template.
+	CBMempoolTransaction * package[CB_MEMPOOL_MAX_ANCESTORS];
+	int num = 1;
+	package[0] = tx;
+	int size = 0, sigOps = 0;
+	unsigned long long int fee = 0;
+	for (int x = 0; x < num; x++) {
+		size += package[x]->size;
+		sigOps += package[x]->sigOps;
+		fee += package[x]->fee;
+		for (int y = 0; y < package[x]->parentNum; y++) {
+			CBMempoolTransaction * parent = package[x]->parents[y];
+			int z;
+			for (z = 0; z < num && package[z] != parent; z++);
+			if (z == num && ! CBBlockAssemblerIsIncluded(self, parent->hash))
+				package[num++] = parent;
+		}
+	}
+	if (self->size + size > CB_BLOCK_MAX_SIZE || self->sigOps + sigOps > CB_MAX_SIG_OPS)
+		return false;
+	// A parent has fewer ancestors than its children, so ordering by the number of ancestors places parents first.
+	for (int x = 1; x < num; x++) {
+		CBMempoolTransaction * move = package[x];
+		int y;
+		for (y = x; y > 0 && package[y - 1]->ancestorNum > move->ancestorNum; y--)
+			package[y] = package[y - 1];
+		package[y] = move;
+	}
+	for (int x = 0; x < num; x++) {
+		CBTransaction * transaction = CBMempoolTransactionGetTransaction(package[x]);
+		CBBlockAssemblerAppend(self, transaction);
+		CBReleaseObject(transaction);
+	}
+	self->size += size;
+	self->sigOps += sigOps;
+	self->fees += fee;
+	CBBlockAssemblerMakeCoinbase(self);
+	return true;
+}
+static void CBBlockAssemblerAppend(CBBlockAssembler * self, CBTransaction * tx){
+	if (self->transactionNum == self->transactionAlloc) {
+		self->transactionAlloc = self->transactionAlloc ? self->transactionAlloc * 2 : 64;
+		self->transactions = realloc(self->transactions, sizeof(*self->transactions) * self->transactionAlloc);
+	}
+	CBRetainObject(tx);
+	self->transactions[self->transactionNum++] = tx;
+	unsigned char * hash = CBTransactionGetHash(tx);
+	unsigned char * key = malloc(32);
+	memcpy(key, hash, 32);
+	CBFindResult res = CBAssociativeArrayFind(&self->included, key);
+	CBAssociativeArrayInsert(&self->included, key, res.position, NULL);
+	CBMerkleTreeAppend(&self->merkleTree, hash);
+}
+CBBlock * CBBlockAssemblerGetBlock(CBBlockAssembler * self){
+	CBBlock * block = CBNewBlock();
+	block->version = CB_BLOCK_ASSEMBLER_VERSION;
+	block->prevBlockHash = CBNewByteArrayWithDataCopy(self->prevBlockHash, 32);
+	block->merkleRoot = CBNewByteArrayWithDataCopy(CBBlockAssemblerGetMerkleRoot(self), 32);
+	block->time = self->time;
+	block->target = self->target;
+	block->nonce = 0;
+	block->transactionNum = self->transactionNum;
+	block->transactions = malloc(sizeof(*block->transactions) * self->transactionNum);
+	for (int x = 0; x < self->transactionNum; x++) {
+		CBRetainObject(self->transactions[x]);
+		block->transactions[x] = self->transactions[x];
+	}
+	CBBlockPrepareBytes(block, true);
+	CBBlockSerialise(block, true, false);
+	return block;
+}
+unsigned char * CBBlockAssemblerGetMerkleRoot(CBBlockAssembler * self){
+	return CBMerkleTreeGetRoot(&self->merkleTree);
+}
+static bool CBBlockAssemblerIsIncluded(CBBlockAssembler * self, unsigned char * hash){
+	return CBAssociativeArrayFind(&self->included, hash).found;
+}
+static void CBBlockAssemblerMakeCoinbase(CBBlockAssembler * self){
+	// The input script has the height as in BIP34 followed by the extra nonce.
+	unsigned char scriptData[11];
+	int len = 1;
+	for (unsigned int height = self->height; height; height >>= 8)
+		scriptData[len++] = height;
+	if (len > 1 && scriptData[len - 1] & 0x80)
+		// Keep the height positive
+		scriptData[len++] = 0;
+	scriptData[0] = len - 1;
+	scriptData[len++] = 4;
+	CBInt32ToArray(scriptData, len, self->extraNonce);
+	len += 4;
+	CBScript * script = CBNewScriptWithDataCopy(scriptData, len);
+	CBByteArray * nullHash = CBNewByteArrayOfSize(32);
+	memset(CBByteArrayGetData(nullHash), 0, 32);
+	CBTransaction * coinbase = CBNewTransaction(0, 1);
+	CBTransactionTakeInput(coinbase, CBNewTransactionInput(script, CB_TX_INPUT_FINAL, nullHash, 0xFFFFFFFF));
+	CBTransactionTakeOutput(coinbase, CBNewTransactionOutput(CBCalculateBlockReward(self->height) + self->fees, self->outputScript));
+	CBReleaseObject(script);
+	CBReleaseObject(nullHash);
+	CBTransactionPrepareBytes(coinbase);
+	CBTransactionSerialise(coinbase, false);
+	if (self->transactions[0]) {
+		CBReleaseObject(self->transactions[0]);
+		CBMerkleTreeUpdate(&self->merkleTree, 0, CBTransactionGetHash(coinbase));
+	}else
+		CBMerkleTreeAppend(&self->merkleTree, CBTransactionGetHash(coinbase));
+	self->transactions[0] = coinbase;
+}
+void CBBlockAssemblerNewTemplate(CBBlockAssembler * self, unsigned char * prevBlockHash, unsigned int height, unsigned int time, int target){
+	for (int x = 0; x < self->transactionNum; x++)
+		CBReleaseObject(self->transactions[x]);
+	CBAssociativeArrayClear(&self->included);
+	CBMerkleTreeClear(&self->merkleTree);
+	memcpy(self->prevBlockHash, prevBlockHash, 32);
+	self->height = height;
+	self->time = time;
+	self->target = target;
+	self->fees = 0;
+	// Start with the coinbase
+	if (! self->transactionAlloc) {
+		self->transactionAlloc = 64;
+		self->transactions = malloc(sizeof(*self->transactions) * self->transactionAlloc);
+	}
+	self->transactions[0] = NULL;
+	self->transactionNum = 1;
+	CBBlockAssemblerMakeCoinbase(self);
+	CBBlock * block = CBNewBlock();
+	block->transactionNum = 1;
+	block->transactions = malloc(sizeof(*block->transactions));
+	block->transactions[0] = self->transactions[0];
+	CBRetainObject(self->transactions[0]);
+	// Reserve two bytes for the number of transactions going to three bytes.
+	self->size = CBBlockCalculateLength(block, true) + 2;
+	CBReleaseObject(block);
+	self->sigOps = CBTransactionGetSigOps(self->transactions[0]);
+	// Add the transactions with the highest ancestor fee rate first
+	CBPosition pos;
+	int failures = 0;
+	if (CBAssociativeArrayGetLast(&self->mempool->ancestorScores, &pos)) do {
+		if (CBBlockAssemblerAddTransaction(self, pos.node->elements[pos.index]))
+			failures = 0;
+		else if (CB_BLOCK_MAX_SIZE - self->size < CB_BLOCK_ASSEMBLER_NEARLY_FULL
+				 && ++failures == CB_BLOCK_ASSEMBLER_MAX_FAILURES)
+			break;
+	} while (! CBAssociativeArrayIterateBack(&self->mempool->ancestorScores, &pos));
+}
+void CBBlockAssemblerSetExtraNonce(CBBlockAssembler * self, unsigned int extraNonce){
+	self->extraNonce = extraNonce;
+	CBBlockAssemblerMakeCoinbase(self);
+}
@@ -0,0 +1,170 @@
+//
+//  CBBlockFilterData.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBlockFilterData.h"
+
+/**
+ @brief Adds the non-empty data pushed by a script to the elements.
+ @param self The CBBlockFilterData object.
+ @param script The script.
+ @param outputIndex The index of the output or -1 for an input script.
+ @param isPubKey For outputs, true if the output is pay-to-pubkey or multisig.
+ @param elementAlloc The number of elements allocated for, which may be increased.
+ */
+static void CBBlockFilterDataAddScript(CBBlockFilterData * self, CBScript * script, int outputIndex, bool isPubKey, int * elementAlloc);
+
+//  Constructor
+
+CBBlockFilterData * CBNewBlockFilterData(CBBlock * block){
+	CBBlockFilterData * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockFilterData;
+	CBInitBlockFilterData(self, block);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitBlockFilterData(CBBlockFilterData * self, CBBlock * block){
+	CBInitObject(CBGetObject(self), false);
+	CBRetainObject(block);
+	self->block = block;
+	self->hashes = malloc(block->transactionNum * 32);
+	self->transactions = malloc(sizeof(*self->transactions) * block->transactionNum);
+	int elementAlloc = block->transactionNum * 4 + 4;
+	self->elements = malloc(sizeof(*self->elements) * elementAlloc);
+	self->elementNum = 0;
+	int outPointAlloc = 0;
+	for (int x = 0; x < block->transactionNum; x++)
+		outPointAlloc += block->transactions[x]->inputNum;
+	self->outPoints = malloc(outPointAlloc * 36);
+	self->outPointNum = 0;
+	for (int x = 0; x < block->transactionNum; x++) {
+		CBTransaction * tx = block->transactions[x];
+		CBBlockFilterTransaction * filterTx = self->transactions + x;
+		memcpy(self->hashes + x * 32, CBTransactionGetHash(tx), 32);
+		filterTx->outputStart = self->elementNum;
+		for (int y = 0; y < tx->outputNum; y++) {
+			CBScriptOutputType type = CBScriptOutputGetType(tx->outputs[y]->scriptObject);
+			CBBlockFilterDataAddScript(self, tx->outputs[y]->scriptObject, y, type == CB_TX_OUTPUT_TYPE_PUBKEY || type == CB_TX_OUTPUT_TYPE_MULTISIG, &elementAlloc);
+		}
+		filterTx->inputStart = self->elementNum;
+		filterTx->outPointStart = self->outPointNum;
+		for (int y = 0; y < tx->inputNum; y++) {
+			unsigned char * outPoint = self->outPoints + self->outPointNum++ * 36;
+			memcpy(outPoint, CBByteArrayGetData(tx->inputs[y]->prevOut.hash), 32);
+			CBInt32ToArray(outPoint, 32, tx->inputs[y]->prevOut.index);
+			CBBlockFilterDataAddScript(self, tx->inputs[y]->scriptObject, -1, false, &elementAlloc);
+		}
+		filterTx->outPointEnd = self->outPointNum;
+		filterTx->end = self->elementNum;
+	}
+}
+
+//  Destructor
+
+void CBDestroyBlockFilterData(void * vself){
+	CBBlockFilterData * self = vself;
+	free(self->hashes);
+	free(self->transactions);
+	free(self->elements);
+	free(self->outPoints);
+	CBReleaseObject(self->block);
+}
+void CBFreeBlockFilterData(void * self){
+	CBDestroyBlockFilterData(self);
+	free(self);
+}
+
+//  Functions
+
+static void CBBlockFilterDataAddScript(CBBlockFilterData * self, CBScript * script, int outputIndex, bool isPubKey, int * elementAlloc){
+	unsigned char * data = CBByteArrayGetData(script);
+	for (int cursor = 0; cursor < script->length;) {
+		unsigned char op = data[cursor++];
+		if (op > CB_SCRIPT_OP_PUSHDATA4)
+			continue;
+		unsigned int length;
+		if (op < CB_SCRIPT_OP_PUSHDATA1)
+			length = op;
+		else{
+			int lengthBytes = op == CB_SCRIPT_OP_PUSHDATA1 ? 1 : (op == CB_SCRIPT_OP_PUSHDATA2 ? 2 : 4);
+			if (cursor + lengthBytes > script->length)
+				return;
+			length = lengthBytes == 1 ? data[cursor] : (lengthBytes == 2 ? CBArrayToInt16(data, cursor) : CBArrayToInt32(data, cursor));
+			cursor += lengthBytes;
+		}
+		if (length > (unsigned int)(script->length - cursor))
+			// Invalid push, stop here.
+			return;
+		if (length) {
+			if (self->elementNum == *elementAlloc) {
+				*elementAlloc *= 2;
+				self->elements = realloc(self->elements, sizeof(*self->elements) * *elementAlloc);
+			}
+			CBBlockFilterElement * element = self->elements + self->elementNum++;
+			element->data = data + cursor;
+			element->length = length;
+			element->outputIndex = outputIndex;
+			element->isPubKey = isPubKey;
+		}
+		cursor += length;
+	}
+}
+CBMerkleBlock * CBBlockFilterDataGetMerkleBlock(CBBlockFilterData * self, CBBloomFilter * filter, CBTransaction ** matches, int * matchNum){
+	bool * matched = malloc(sizeof(*matched) * self->block->transactionNum);
+	*matchNum = 0;
+	for (int x = 0; x < self->block->transactionNum; x++) {
+		matched[x] = CBBlockFilterDataMatchTransaction(self, filter, x);
+		if (matched[x])
+			matches[(*matchNum)++] = self->block->transactions[x];
+	}
+	CBMerkleBlock * merkleBlock = CBNewMerkleBlock(self->block, self->hashes, self->block->transactionNum, matched);
+	free(matched);
+	return merkleBlock;
+}
+bool CBBlockFilterDataMatchTransaction(CBBlockFilterData * self, CBBloomFilter * filter, int index){
+	if (filter->empty)
+		return false;
+	CBBlockFilterTransaction * tx = self->transactions + index;
+	unsigned char * hash = self->hashes + index * 32;
+	bool found = CBBloomFilterContains(filter, hash, 32);
+	// Check the outputs, adding the outpoints of matched outputs when updating the filter.
+	int matchedOutput = -1;
+	for (int x = tx->outputStart; x < tx->inputStart; x++) {
+		CBBlockFilterElement * element = self->elements + x;
+		if (element->outputIndex == matchedOutput
+			|| ! CBBloomFilterContains(filter, element->data, element->length))
+			continue;
+		found = true;
+		matchedOutput = element->outputIndex;
+		if (filter->update == CB_BLOOM_FILTER_UPDATE_ALL
+			|| (filter->update == CB_BLOOM_FILTER_UPDATE_P2PUBKEY_ONLY && element->isPubKey)) {
+			unsigned char outPoint[36];
+			memcpy(outPoint, hash, 32);
+			CBInt32ToArray(outPoint, 32, element->outputIndex);
+			CBBloomFilterInsert(filter, outPoint, 36);
+		}
+	}
+	if (found)
+		return true;
+	for (int x = tx->outPointStart; x < tx->outPointEnd; x++)
+		if (CBBloomFilterContains(filter, self->outPoints + x * 36, 36))
+			return true;
+	for (int x = tx->inputStart; x < tx->end; x++)
+		if (CBBloomFilterContains(filter, self->elements[x].data, self->elements[x].length))
+			return true;
+	return false;
+}
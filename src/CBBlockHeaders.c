@@ -43,6 +43,8 @@ CBBlockHeaders * CBNewBlockHeadersFromData(CBByteArray * data) {
 void CBInitBlockHeaders(CBBlockHeaders * self) {
 	
 	self->headerNum = 0;
+	self->headers = NULL;
+	self->ownHeaders = false;
 	CBInitMessageByObject(CBGetMessage(self));
 	
 }
@@ -50,6 +52,8 @@ void CBInitBlockHeaders(CBBlockHeaders * self) {
 void CBInitBlockHeadersFromData(CBBlockHeaders * self, CBByteArray * data) {
 	
 	self->headerNum = 0;
+	self->headers = NULL;
+	self->ownHeaders = false;
 	CBInitMessageByData(CBGetMessage(self), data);
 	
 }
@@ -59,7 +63,10 @@ void CBInitBlockHeadersFromData(CBBlockHeaders * self, CBByteArray * data) {
 void CBDestroyBlockHeaders(void * vself) {
 	
 	CBBlockHeaders * self = vself;
-	for (int x = 0; x < self->headerNum; x++)
+	if (self->headers) {
+		if (self->ownHeaders)
+			free(self->headers);
+	}else for (int x = 0; x < self->headerNum; x++)
 		CBReleaseObject(self->blockHeaders[x]);
 	CBDestroyMessage(self);
 	
@@ -81,9 +88,64 @@ void CBBlockHeadersAddBlockHeader(CBBlockHeaders * self, CBBlock * header) {
 	
 }
 
+bool CBBlockHeadersAddHeader(CBBlockHeaders * self, unsigned char * header, int transactionNum) {
+	
+	if (self->headerNum >= CB_BLOCK_HEADERS_MAX_NUM) {
+		CBLogError("Attempting to add a header to a CBBlockHeaders with the maximum of %i headers.", CB_BLOCK_HEADERS_MAX_NUM);
+		return false;
+	}
+	if (! self->ownHeaders) {
+		// Allocate for the maximum number of headers so that the headers are never reallocated.
+		unsigned char * headers = malloc(CB_BLOCK_HEADERS_MAX_NUM * CB_BLOCK_HEADERS_ENTRY_SIZE);
+		if (self->headers)
+			memcpy(headers, self->headers, self->headerNum * CB_BLOCK_HEADERS_ENTRY_SIZE);
+		self->headers = headers;
+		self->ownHeaders = true;
+	}
+	unsigned char * entry = self->headers + self->headerNum++ * CB_BLOCK_HEADERS_ENTRY_SIZE;
+	memcpy(entry, header, 80);
+	entry[80] = transactionNum;
+	entry[81] = 0;
+	
+	return true;
+	
+}
+
+void CBBlockHeadersCalculateHash(CBBlockHeaders * self, int index, unsigned char * hash) {
+	
+	unsigned char hash1[32];
+	CBSha256(CBBlockHeadersGetHeader(self, index), 80, hash1);
+	CBSha256(hash1, 32, hash);
+	
+}
+
 int CBBlockHeadersCalculateLength(CBBlockHeaders * self) {
 	
-	return CBVarIntSizeOf(self->headerNum) + self->headerNum * 81;
+	int len = CBVarIntSizeOf(self->headerNum);
+	if (self->headers)
+		return len + self->headerNum * CB_BLOCK_HEADERS_ENTRY_SIZE;
+	// Each header has the transaction number and the null byte after the 80 header bytes.
+	for (int x = 0; x < self->headerNum; x++)
+		len += CBBlockCalculateLength(self->blockHeaders[x], false);
+	return len;
+	
+}
+
+int CBBlockHeadersCheckChain(CBBlockHeaders * self, unsigned char * prevHash, unsigned char * hashes) {
+	
+	// Without an output, alternate between two hashes so that the previous hash is kept for the link check.
+	unsigned char hash[2][32];
+	for (int x = 0; x < self->headerNum; x++) {
+		unsigned char * header = CBBlockHeadersGetHeader(self, x);
+		if (prevHash && memcmp(CBBlockHeaderGetPrevBlockHash(header), prevHash, 32))
+			return x;
+		unsigned char * out = hashes ? hashes + x * 32 : hash[x & 1];
+		CBBlockHeadersCalculateHash(self, x, out);
+		if (! CBValidateProofOfWork(out, CBBlockHeaderGetTarget(header)))
+			return x;
+		prevHash = out;
+	}
+	return self->headerNum;
 	
 }
 
@@ -134,6 +196,67 @@ int CBBlockHeadersDeserialise(CBBlockHeaders * self) {
 	
 }
 
+int CBBlockHeadersDeserialiseFlat(CBBlockHeaders * self) {
+	
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBBlockHeaders with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 1) {
+		CBLogError("Attempting to deserialise a CBBlockHeaders with no header number.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt headerNum = CBByteArrayReadVarInt(bytes, 0);
+	if ((uint64_t)headerNum.val > CB_BLOCK_HEADERS_MAX_NUM) {
+		CBLogError("Attempting to deserialise a CBBlockHeaders with a var int over 2000.");
+		return CB_DESERIALISE_ERROR;
+	}
+	int len = headerNum.size + (int)headerNum.val * CB_BLOCK_HEADERS_ENTRY_SIZE;
+	if (bytes->length < len) {
+		CBLogError("Attempting to deserialise a CBBlockHeaders with less bytes than required for the headers.");
+		return CB_DESERIALISE_ERROR;
+	}
+	unsigned char * headers = CBByteArrayGetData(bytes) + headerNum.size;
+	// Each header must have a one byte transaction number and the null byte so that the headers are evenly spaced.
+	for (int x = 0; x < headerNum.val; x++) {
+		unsigned char * entry = headers + x * CB_BLOCK_HEADERS_ENTRY_SIZE;
+		if (entry[80] >= 0xFD || entry[81]) {
+			CBLogError("CBBlockHeaders cannot be deserialised flat because of the CBBlock number %i.", x);
+			return CB_DESERIALISE_ERROR;
+		}
+	}
+	if (self->ownHeaders)
+		free(self->headers);
+	self->headers = headers;
+	self->ownHeaders = false;
+	self->headerNum = (int)headerNum.val;
+	return len;
+	
+}
+
+CBBlock * CBBlockHeadersGetBlock(CBBlockHeaders * self, int index) {
+	
+	CBByteArray * data = CBNewByteArrayWithDataCopy(CBBlockHeadersGetHeader(self, index), CB_BLOCK_HEADERS_ENTRY_SIZE);
+	CBBlock * block = CBNewBlockFromData(data);
+	CBReleaseObject(data);
+	CBBlockDeserialise(block, false);
+	return block;
+	
+}
+
+unsigned char * CBBlockHeadersGetHeader(CBBlockHeaders * self, int index) {
+	
+	return self->headers + index * CB_BLOCK_HEADERS_ENTRY_SIZE;
+	
+}
+
+int CBBlockHeadersGetTransactionNum(CBBlockHeaders * self, int index) {
+	
+	return self->headers[index * CB_BLOCK_HEADERS_ENTRY_SIZE + 80];
+	
+}
+
 void CBBlockHeadersPrepareBytes(CBBlockHeaders * self) {
 	
 	CBMessagePrepareBytes(CBGetMessage(self), CBBlockHeadersCalculateLength(self));
@@ -147,7 +270,7 @@ int CBBlockHeadersSerialise(CBBlockHeaders * self, bool force) {
 		CBLogError("Attempting to serialise a CBBlockHeaders with no bytes.");
 		return 0;
 	}
-	if (bytes->length < 81 * self->headerNum) {
+	if (bytes->length < 82 * self->headerNum) {
 		CBLogError("Attempting to deserialise a CBBlockHeaders with less bytes than minimally required.");
 		return 0;
 	}
@@ -156,6 +279,23 @@ int CBBlockHeadersSerialise(CBBlockHeaders * self, bool force) {
 	CBByteArraySetVarInt(bytes, 0, num);
 	int cursor = num.size;
 	
+	if (self->headers) {
+		
+		int len = cursor + self->headerNum * CB_BLOCK_HEADERS_ENTRY_SIZE;
+		if (bytes->length < len) {
+			CBLogError("Attempting to serialise a CBBlockHeaders with less bytes than required for the headers.");
+			return 0;
+		}
+		unsigned char * data = CBByteArrayGetData(bytes) + cursor;
+		// Nothing to copy when the headers were deserialised from these bytes.
+		if (data != self->headers)
+			memmove(data, self->headers, self->headerNum * CB_BLOCK_HEADERS_ENTRY_SIZE);
+		bytes->length = len;
+		CBGetMessage(self)->serialised = true;
+		return len;
+		
+	}
+	
 	for (int x = 0; x < num.val; x++) {
 		
 		if (! CBGetMessage(self->blockHeaders[x])->serialised // Serailise if not serialised yet.
@@ -0,0 +1,321 @@
+//
+//  CBBlockScanner.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBlockScanner.h"
+
+static unsigned char CBBlockScannerOutPointKeySize = 36;
+
+/**
+ @brief Adds a match to a block.
+ @param block The block being scanned.
+ @param type The type of the match.
+ @param txIndex The index of the transaction.
+ @param index The index of the input or output.
+ @param value The value of an output.
+ @param watched The pointer for the watched hash or outpoint.
+ */
+static void CBBlockScannerAddMatch(CBBlockScannerBlock * block, CBBlockScannerMatchType type, int txIndex, int index, uint64_t value, void * watched);
+/**
+ @brief Orders matches by transaction, with inputs before outputs.
+ @param vmatch1 The first match.
+ @param vmatch2 The second match.
+ @returns A negative number if the first match comes first, a positive number if it comes second or zero if they are equal.
+ */
+static int CBBlockScannerCompareMatches(const void * vmatch1, const void * vmatch2);
+/**
+ @brief Does nothing as jobs have nothing to free.
+ @param job The CBBlockScannerJob.
+ */
+static void CBBlockScannerDestroyJob(void * job);
+/**
+ @brief Gets the hash to look up for an output script.
+ @param script The output script.
+ @param hash Space for the hash of a public key in the script.
+ @returns A pointer to the 20 byte hash or NULL if the script is not of a template with a hash.
+ */
+static unsigned char * CBBlockScannerGetHash(CBScript * script, unsigned char * hash);
+/**
+ @brief Scans a block on the thread pool.
+ @param queue The thread pool queue.
+ @param vjob The CBBlockScannerJob.
+ */
+static void CBBlockScannerProcess(CBThreadPoolQueue * queue, void * vjob);
+/**
+ @brief Reads the transactions of a serialised block and adds the matches. The watched hashes and outpoints are only read, so blocks can be read concurrently.
+ @param self The CBBlockScanner object.
+ @param block The block to read.
+ @param addedOnly If true, only inputs spending outpoints which are being added are found.
+ @returns true if the block was read, false if it is malformed.
+ */
+static bool CBBlockScannerRead(CBBlockScanner * self, CBBlockScannerBlock * block, bool addedOnly);
+/**
+ @brief Reads a variable integer from serialised data.
+ @param data The data.
+ @param length The length of the data.
+ @param cursor The offset of the variable integer, which is moved past it.
+ @param value Set to the value.
+ @returns true if the integer is within the data, false otherwise.
+ */
+static bool CBBlockScannerReadVarInt(unsigned char * data, int length, int * cursor, uint64_t * value);
+
+//  Constructor
+
+CBBlockScanner * CBNewBlockScanner(int numThreads, void (*onMatch)(void *, CBBlockScannerMatch *), void * callbackObject){
+	CBBlockScanner * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockScanner;
+	CBInitBlockScanner(self, numThreads, onMatch, callbackObject);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitBlockScanner(CBBlockScanner * self, int numThreads, void (*onMatch)(void *, CBBlockScannerMatch *), void * callbackObject){
+	CBInitObject(CBGetObject(self), false);
+	self->numThreads = numThreads;
+	if (numThreads) {
+		CBInitThreadPoolQueue(&self->pool, numThreads, CBBlockScannerProcess, CBBlockScannerDestroyJob);
+		self->pool.object = self;
+	}
+	CBInitHash160Map(&self->hashes, 0);
+	CBInitAssociativeArray(&self->outPoints, CBFixedKeyCompare, &CBBlockScannerOutPointKeySize, free);
+	self->onMatch = onMatch;
+	self->callbackObject = callbackObject;
+}
+
+//  Destructor
+
+void CBDestroyBlockScanner(void * vself){
+	CBBlockScanner * self = vself;
+	if (self->numThreads)
+		CBDestroyThreadPoolQueue(&self->pool);
+	CBFreeHash160Map(&self->hashes);
+	CBFreeAssociativeArray(&self->outPoints);
+}
+void CBFreeBlockScanner(void * self){
+	CBDestroyBlockScanner(self);
+	free(self);
+}
+
+//  Functions
+
+static void CBBlockScannerAddMatch(CBBlockScannerBlock * block, CBBlockScannerMatchType type, int txIndex, int index, uint64_t value, void * watched){
+	if (block->matchNum == block->matchAlloc) {
+		block->matchAlloc = block->matchAlloc ? block->matchAlloc * 2 : 8;
+		block->matches = realloc(block->matches, sizeof(*block->matches) * block->matchAlloc);
+	}
+	CBBlockScannerMatch * match = block->matches + block->matchNum++;
+	match->type = type;
+	match->height = block->height;
+	match->txIndex = txIndex;
+	match->index = index;
+	match->value = value;
+	match->watched = watched;
+}
+static int CBBlockScannerCompareMatches(const void * vmatch1, const void * vmatch2){
+	const CBBlockScannerMatch * match1 = vmatch1, * match2 = vmatch2;
+	if (match1->txIndex != match2->txIndex)
+		return match1->txIndex - match2->txIndex;
+	if (match1->type != match2->type)
+		return (int)match1->type - (int)match2->type;
+	return match1->index - match2->index;
+}
+static void CBBlockScannerDestroyJob(void * job){
+	UNUSED(job);
+}
+static unsigned char * CBBlockScannerGetHash(CBScript * script, unsigned char * hash){
+	if (CBScriptIsKeyHash(script))
+		return CBByteArrayGetData(script) + 3;
+	if (CBScriptIsP2SH(script))
+		return CBByteArrayGetData(script) + 2;
+	// Only check for pay-to-pubkey when the push fills the script up to OP_CHECKSIG, so that nothing past the script is read.
+	if ((script->length == 35 || script->length == 67)
+		&& CBByteArrayGetByte(script, 0) == script->length - 2
+		&& CBScriptIsPubkey(script)) {
+		unsigned char sha[32];
+		CBSha256(CBByteArrayGetData(script) + 1, script->length - 2, sha);
+		CBRipemd160(sha, 32, hash);
+		return hash;
+	}
+	return NULL;
+}
+static void CBBlockScannerProcess(CBThreadPoolQueue * queue, void * vjob){
+	UNUSED(queue);
+	CBBlockScannerJob * job = vjob;
+	job->block->ok = CBBlockScannerRead(job->scanner, job->block, false);
+}
+static bool CBBlockScannerRead(CBBlockScanner * self, CBBlockScannerBlock * block, bool addedOnly){
+	unsigned char * data = CBByteArrayGetData(block->bytes);
+	int length = block->bytes->length;
+	int cursor = 80;
+	uint64_t txNum, inputNum, outputNum, scriptLen;
+	bool outPoints = ! CBAssociativeArrayIsEmpty(&self->outPoints);
+	// The output scripts are read in place through a script which references the block data.
+	CBScript script = *block->bytes;
+	if (! CBBlockScannerReadVarInt(data, length, &cursor, &txNum))
+		return false;
+	for (uint64_t x = 0; x < txNum; x++) {
+		int txStart = cursor;
+		int firstMatch = block->matchNum;
+		cursor += 4;
+		if (! CBBlockScannerReadVarInt(data, length, &cursor, &inputNum))
+			return false;
+		for (uint64_t y = 0; y < inputNum; y++) {
+			if (cursor > length - 36)
+				return false;
+			if (outPoints) {
+				CBFindResult res = CBAssociativeArrayFind(&self->outPoints, data + cursor);
+				if (res.found) {
+					CBBlockScannerOutPoint * outPoint = CBFindResultToPointer(res);
+					if (! addedOnly || outPoint->added)
+						CBBlockScannerAddMatch(block, CB_BLOCK_SCANNER_SPEND, (int)x, (int)y, 0, outPoint->watched);
+				}
+			}
+			cursor += 36;
+			if (! CBBlockScannerReadVarInt(data, length, &cursor, &scriptLen) || scriptLen > (uint64_t)(length - cursor))
+				return false;
+			cursor += (int)scriptLen + 4;
+		}
+		if (! CBBlockScannerReadVarInt(data, length, &cursor, &outputNum))
+			return false;
+		for (uint64_t y = 0; y < outputNum; y++) {
+			if (cursor > length - 8)
+				return false;
+			uint64_t value = CBArrayToInt64(data, cursor);
+			cursor += 8;
+			if (! CBBlockScannerReadVarInt(data, length, &cursor, &scriptLen) || scriptLen > (uint64_t)(length - cursor))
+				return false;
+			if (! addedOnly) {
+				script.offset = block->bytes->offset + cursor;
+				script.length = (int)scriptLen;
+				unsigned char keyHash[20];
+				unsigned char * hash = CBBlockScannerGetHash(&script, keyHash);
+				void * watched;
+				if (hash && (watched = CBHash160MapGet(&self->hashes, hash)))
+					CBBlockScannerAddMatch(block, CB_BLOCK_SCANNER_OUTPUT, (int)x, (int)y, value, watched);
+			}
+			cursor += (int)scriptLen;
+		}
+		cursor += 4;
+		if (cursor > length)
+			return false;
+		if (block->matchNum != firstMatch) {
+			// Only transactions with matches are hashed.
+			unsigned char hash[32];
+			CBSha256(data + txStart, cursor - txStart, hash);
+			CBSha256(hash, 32, hash);
+			for (int y = firstMatch; y < block->matchNum; y++)
+				memcpy(block->matches[y].txHash, hash, 32);
+		}
+	}
+	return true;
+}
+static bool CBBlockScannerReadVarInt(unsigned char * data, int length, int * cursor, uint64_t * value){
+	if (*cursor >= length)
+		return false;
+	int size = CBVarIntDecodeSize(data, *cursor);
+	if (size > length - *cursor)
+		return false;
+	*value = CBVarIntDecodeData(data, *cursor).val;
+	*cursor += size;
+	return true;
+}
+bool CBBlockScannerScanBlocks(CBBlockScanner * self, CBBlock ** blocks, int num, unsigned int firstHeight){
+	CBBlockScannerBlock * scanned = malloc(sizeof(*scanned) * num);
+	for (int x = 0; x < num; x++) {
+		scanned[x].bytes = CBGetMessage(blocks[x])->bytes;
+		scanned[x].height = firstHeight + x;
+		scanned[x].matches = NULL;
+		scanned[x].matchNum = 0;
+		scanned[x].matchAlloc = 0;
+	}
+	// Stage 1: Find the outputs paying watched hashes and the inputs spending outpoints watched before this call.
+	if (self->numThreads && num > 1) {
+		for (int x = 0; x < num; x++) {
+			CBBlockScannerJob * job = malloc(sizeof(*job));
+			job->scanner = self;
+			job->block = scanned + x;
+			CBThreadPoolQueueAdd(&self->pool, &job->base);
+		}
+		CBThreadPoolQueueWaitUntilFinished(&self->pool);
+	}else for (int x = 0; x < num; x++)
+		scanned[x].ok = CBBlockScannerRead(self, scanned + x, false);
+	int end = 0;
+	while (end < num && scanned[end].ok)
+		end++;
+	if (end != num)
+		CBLogError("The block at height %u could not be read for scanning.", firstHeight + end);
+	// Stage 2: Watch the outpoints of the outputs found, in order of height.
+	CBBlockScannerOutPoint ** added = NULL;
+	int addedNum = 0;
+	int firstAdded = end;
+	for (int x = 0; x < end; x++)
+		for (int y = 0; y < scanned[x].matchNum; y++) {
+			CBBlockScannerMatch * match = scanned[x].matches + y;
+			if (match->type != CB_BLOCK_SCANNER_OUTPUT)
+				continue;
+			unsigned char key[36];
+			memcpy(key, match->txHash, 32);
+			CBInt32ToArray(key, 32, match->index);
+			CBFindResult res = CBAssociativeArrayFind(&self->outPoints, key);
+			if (res.found)
+				continue;
+			CBBlockScannerOutPoint * outPoint = malloc(sizeof(*outPoint));
+			memcpy(outPoint->outPoint, key, 36);
+			outPoint->watched = match->watched;
+			outPoint->added = true;
+			CBAssociativeArrayInsert(&self->outPoints, outPoint, res.position, NULL);
+			added = realloc(added, sizeof(*added) * (addedNum + 1));
+			added[addedNum++] = outPoint;
+			if (firstAdded == end)
+				firstAdded = x;
+		}
+	// Stage 3: Find the inputs spending the new outpoints, which can only be in the same or later blocks.
+	for (int x = firstAdded; x < end; x++) {
+		int matchNum = scanned[x].matchNum;
+		CBBlockScannerRead(self, scanned + x, true);
+		if (scanned[x].matchNum != matchNum)
+			qsort(scanned[x].matches, scanned[x].matchNum, sizeof(*scanned[x].matches), CBBlockScannerCompareMatches);
+	}
+	for (int x = 0; x < addedNum; x++)
+		added[x]->added = false;
+	free(added);
+	for (int x = 0; x < num; x++) {
+		if (x < end)
+			for (int y = 0; y < scanned[x].matchNum; y++)
+				self->onMatch(self->callbackObject, scanned[x].matches + y);
+		free(scanned[x].matches);
+	}
+	free(scanned);
+	return end == num;
+}
+void CBBlockScannerWatchHash(CBBlockScanner * self, unsigned char * hash, void * watched){
+	CBHash160MapInsert(&self->hashes, hash, watched);
+}
+void CBBlockScannerWatchOutPoint(CBBlockScanner * self, unsigned char * txHash, unsigned int index, void * watched){
+	unsigned char key[36];
+	memcpy(key, txHash, 32);
+	CBInt32ToArray(key, 32, index);
+	CBFindResult res = CBAssociativeArrayFind(&self->outPoints, key);
+	if (res.found) {
+		((CBBlockScannerOutPoint *)CBFindResultToPointer(res))->watched = watched;
+		return;
+	}
+	CBBlockScannerOutPoint * outPoint = malloc(sizeof(*outPoint));
+	memcpy(outPoint->outPoint, key, 36);
+	outPoint->watched = watched;
+	outPoint->added = false;
+	CBAssociativeArrayInsert(&self->outPoints, outPoint, res.position, NULL);
+}
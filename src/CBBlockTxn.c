@@ -0,0 +1,140 @@
+//
+//  CBBlockTxn.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBlockTxn.h"
+
+//  Constructors
+
+CBBlockTxn * CBNewBlockTxn(CBGetBlockTxn * request, CBTransaction ** transactions){
+	CBBlockTxn * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockTxn;
+	CBInitBlockTxn(self, request, transactions);
+	return self;
+}
+CBBlockTxn * CBNewBlockTxnFromData(CBByteArray * data){
+	CBBlockTxn * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockTxn;
+	CBInitBlockTxnFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitBlockTxn(CBBlockTxn * self, CBGetBlockTxn * request, CBTransaction ** transactions){
+	CBInitMessageByObject(CBGetMessage(self));
+	self->blockHash = CBByteArrayCopy(request->blockHash);
+	self->transactionNum = request->indexNum;
+	self->transactions = malloc(sizeof(*self->transactions) * self->transactionNum);
+	for (int x = 0; x < self->transactionNum; x++) {
+		self->transactions[x] = transactions[request->indexes[x]];
+		CBRetainObject(self->transactions[x]);
+	}
+}
+void CBInitBlockTxnFromData(CBBlockTxn * self, CBByteArray * data){
+	CBInitMessageByData(CBGetMessage(self), data);
+	self->blockHash = NULL;
+	self->transactions = NULL;
+	self->transactionNum = 0;
+}
+
+//  Destructor
+
+void CBDestroyBlockTxn(void * vself){
+	CBBlockTxn * self = vself;
+	if (self->blockHash)
+		CBReleaseObject(self->blockHash);
+	for (int x = 0; x < self->transactionNum; x++)
+		CBReleaseObject(self->transactions[x]);
+	free(self->transactions);
+	CBDestroyMessage(self);
+}
+void CBFreeBlockTxn(void * self){
+	CBDestroyBlockTxn(self);
+	free(self);
+}
+
+//  Functions
+
+int CBBlockTxnCalculateLength(CBBlockTxn * self){
+	int length = 32 + CBVarIntSizeOf(self->transactionNum);
+	for (int x = 0; x < self->transactionNum; x++)
+		length += CBGetMessage(self->transactions[x])->bytes->length;
+	return length;
+}
+int CBBlockTxnDeserialise(CBBlockTxn * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBBlockTxn with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 33 || bytes->length < 32 + CBByteArrayReadVarIntSize(bytes, 32)) {
+		CBLogError("Attempting to deserialise a CBBlockTxn with less bytes than required for the hash and transaction number.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt num = CBByteArrayReadVarInt(bytes, 32);
+	int cursor = 32 + num.size;
+	if ((uint64_t)num.val > (uint64_t)(bytes->length - cursor) / 60) {
+		CBLogError("Attempting to deserialise a CBBlockTxn with too many transactions for the byte data length.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->blockHash = CBNewByteArraySubReference(bytes, 0, 32);
+	int transactionNum = (int)num.val;
+	self->transactions = malloc(sizeof(*self->transactions) * transactionNum);
+	for (int x = 0; x < transactionNum; x++) {
+		CBByteArray * data = CBByteArraySubReference(bytes, cursor, bytes->length - cursor);
+		CBTransaction * tx = CBNewTransactionFromData(data);
+		int len = CBTransactionDeserialise(tx);
+		if (len == CB_DESERIALISE_ERROR) {
+			CBLogError("CBBlockTxn cannot be deserialised because of an error with the transaction number %i.", x);
+			CBReleaseObject(data);
+			CBReleaseObject(tx);
+			return CB_DESERIALISE_ERROR;
+		}
+		data->length = len;
+		CBReleaseObject(data);
+		self->transactions[self->transactionNum++] = tx;
+		cursor += len;
+	}
+	return cursor;
+}
+void CBBlockTxnPrepareBytes(CBBlockTxn * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBBlockTxnCalculateLength(self));
+}
+int CBBlockTxnSerialise(CBBlockTxn * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBBlockTxn with no bytes.");
+		return 0;
+	}
+	int length = CBBlockTxnCalculateLength(self);
+	if (bytes->length < length) {
+		CBLogError("Attempting to serialise a CBBlockTxn with less bytes than required.");
+		return 0;
+	}
+	CBByteArrayCopyByteArray(bytes, 0, self->blockHash);
+	CBByteArrayChangeReference(self->blockHash, bytes, 0);
+	int cursor = 32;
+	CBByteArraySetVarInt(bytes, cursor, CBVarIntFromUInt64(self->transactionNum));
+	cursor += CBVarIntSizeOf(self->transactionNum);
+	for (int x = 0; x < self->transactionNum; x++) {
+		// The transactions may be shared with a block, so only the data is copied.
+		CBByteArrayCopyByteArray(bytes, cursor, CBGetMessage(self->transactions[x])->bytes);
+		cursor += CBGetMessage(self->transactions[x])->bytes->length;
+	}
+	bytes->length = length;
+	CBGetMessage(self)->serialised = true;
+	return length;
+}
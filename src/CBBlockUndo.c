@@ -0,0 +1,246 @@
+//
+//  CBBlockUndo.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBlockUndo.h"
+
+/**
+ @brief Reverts the changes made to an unspent output set by the first transactions of a block, using the spent outputs at the end of the undo data.
+ @param block The block.
+ @param set The unspent output set.
+ @param undo The undo data.
+ @param txNum The index of the transaction which has only had inputs applied. All transactions before it are reverted entirely. Use the number of transactions to revert the whole block.
+ @param inputNum The number of inputs applied for the transaction at txNum.
+ @returns true if the set was consistent with the changes being reverted, false otherwise.
+ */
+static bool CBBlockRevert(CBBlock * block, CBUnspentOutputSet * set, CBBlockUndo * undo, int txNum, int inputNum);
+
+//  Constructors
+
+CBBlockUndo * CBNewBlockUndo(void){
+	CBBlockUndo * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockUndo;
+	CBInitBlockUndo(self);
+	return self;
+}
+CBBlockUndo * CBNewBlockUndoFromData(CBByteArray * data){
+	CBBlockUndo * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockUndo;
+	CBInitBlockUndoFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitBlockUndo(CBBlockUndo * self){
+	memset(self->blockHash, 0, 32);
+	self->spentNum = 0;
+	self->spentAlloc = 0;
+	self->spent = NULL;
+	CBInitMessageByObject(CBGetMessage(self));
+}
+void CBInitBlockUndoFromData(CBBlockUndo * self, CBByteArray * data){
+	memset(self->blockHash, 0, 32);
+	self->spentNum = 0;
+	self->spentAlloc = 0;
+	self->spent = NULL;
+	CBInitMessageByData(CBGetMessage(self), data);
+}
+
+//  Destructor
+
+void CBDestroyBlockUndo(void * vself){
+	CBBlockUndo * self = vself;
+	for (int x = 0; x < self->spentNum; x++)
+		free(self->spent[x]);
+	free(self->spent);
+	CBDestroyMessage(self);
+}
+void CBFreeBlockUndo(void * self){
+	CBDestroyBlockUndo(self);
+	free(self);
+}
+
+//  Functions
+
+bool CBBlockConnect(CBBlock * block, CBUnspentOutputSet * set, unsigned int height, CBBlockUndo * undo){
+	memcpy(undo->blockHash, CBBlockGetHash(block), 32);
+	for (int x = 0; x < block->transactionNum; x++) {
+		CBTransaction * tx = block->transactions[x];
+		bool coinbase = CBTransactionIsCoinBase(tx);
+		if (! coinbase) for (int y = 0; y < tx->inputNum; y++) {
+			CBPrevOut * prevOut = &tx->inputs[y]->prevOut;
+			CBUnspentOutput * spent = CBUnspentOutputSetSpendOutput(set, CBByteArrayGetData(prevOut->hash), prevOut->index);
+			if (! spent) {
+				CBLogError("Input %i of transaction %i in a block being connected spends an output which does not exist.", y, x);
+				CBBlockRevert(block, set, undo, x, y);
+				return false;
+			}
+			CBBlockUndoTakeSpentOutput(undo, spent);
+		}
+		unsigned char * hash = CBTransactionGetHash(tx);
+		for (int y = 0; y < tx->outputNum; y++) {
+			CBTransactionOutput * output = tx->outputs[y];
+			CBUnspentOutput * unspent = CBNewUnspentOutput(hash, y, output->value, CBByteArrayGetData(output->scriptObject), output->scriptObject->length, height, coinbase);
+			if (! CBUnspentOutputSetTakeOutput(set, unspent)) {
+				CBLogError("Output %i of transaction %i in a block being connected already exists as an unspent output.", y, x);
+				while (y--)
+					CBUnspentOutputSetRemoveOutput(set, hash, y);
+				CBBlockRevert(block, set, undo, x, coinbase ? 0 : tx->inputNum);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+bool CBBlockDisconnect(CBBlock * block, CBUnspentOutputSet * set, CBBlockUndo * undo){
+	if (memcmp(undo->blockHash, CBBlockGetHash(block), 32)) {
+		CBLogError("Attempting to disconnect a block with undo data for a different block.");
+		return false;
+	}
+	int inputNum = 0;
+	for (int x = 0; x < block->transactionNum; x++)
+		if (! CBTransactionIsCoinBase(block->transactions[x]))
+			inputNum += block->transactions[x]->inputNum;
+	if (inputNum != undo->spentNum) {
+		CBLogError("Attempting to disconnect a block with undo data that has %i spent outputs when %i are required.", undo->spentNum, inputNum);
+		return false;
+	}
+	return CBBlockRevert(block, set, undo, block->transactionNum, 0);
+}
+static bool CBBlockRevert(CBBlock * block, CBUnspentOutputSet * set, CBBlockUndo * undo, int txNum, int inputNum){
+	bool consistent = true;
+	for (int x = txNum; x >= 0; x--) {
+		if (x == block->transactionNum)
+			continue;
+		CBTransaction * tx = block->transactions[x];
+		int inputs = inputNum;
+		if (x != txNum) {
+			// Remove the outputs of this transaction
+			unsigned char * hash = CBTransactionGetHash(tx);
+			for (int y = tx->outputNum; y--;)
+				if (! CBUnspentOutputSetRemoveOutput(set, hash, y))
+					consistent = false;
+			inputs = CBTransactionIsCoinBase(tx) ? 0 : tx->inputNum;
+		}
+		// Move the spent outputs back into the set in reverse
+		for (int y = inputs; y--;) {
+			CBUnspentOutput * spent = undo->spent[--undo->spentNum];
+			CBPrevOut * prevOut = &tx->inputs[y]->prevOut;
+			CBMakeOutPointKey(spent->outPoint, CBByteArrayGetData(prevOut->hash), prevOut->index);
+			if (! CBUnspentOutputSetTakeOutput(set, spent))
+				consistent = false;
+		}
+	}
+	if (! consistent)
+		CBLogError("The unspent output set was inconsistent with a block being reverted.");
+	return consistent;
+}
+int CBBlockUndoCalculateLength(CBBlockUndo * self){
+	int len = 32 + CBVarIntSizeOf(self->spentNum);
+	for (int x = 0; x < self->spentNum; x++) {
+		CBUnspentOutput * spent = self->spent[x];
+		len += CBVarIntSizeOf(((long long int)spent->height << 1) | spent->coinbase)
+			+ CBVarIntSizeOf(CBCompressAmount(spent->value))
+			+ CBVarIntSizeOf(spent->scriptLength) + spent->scriptLength;
+	}
+	return len;
+}
+int CBBlockUndoDeserialise(CBBlockUndo * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBBlockUndo with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 33) {
+		CBLogError("Attempting to deserialise a CBBlockUndo with less bytes than required for the block hash and number of spent outputs.");
+		return CB_DESERIALISE_ERROR;
+	}
+	unsigned char * data = CBByteArrayGetData(bytes);
+	memcpy(self->blockHash, data, 32);
+	int cursor = 32;
+	if (CBVarIntDecodeSize(data, cursor) > bytes->length - cursor) {
+		CBLogError("Attempting to deserialise a CBBlockUndo with a variable size integer for the number of spent outputs going past the end of the data.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt spentNum = CBVarIntDecodeData(data, cursor);
+	cursor += spentNum.size;
+	// Each spent output needs at least 3 bytes.
+	if (spentNum.val > (bytes->length - cursor)/3) {
+		CBLogError("Attempting to deserialise a CBBlockUndo with less bytes than required for the spent outputs.");
+		return CB_DESERIALISE_ERROR;
+	}
+	for (int x = 0; x < spentNum.val; x++) {
+		CBVarInt fields[3];
+		for (int y = 0; y < 3; y++) {
+			if (cursor >= bytes->length || CBVarIntDecodeSize(data, cursor) > bytes->length - cursor) {
+				CBLogError("Attempting to deserialise a CBBlockUndo with a spent output going past the end of the data.");
+				return CB_DESERIALISE_ERROR;
+			}
+			fields[y] = CBVarIntDecodeData(data, cursor);
+			cursor += fields[y].size;
+		}
+		if (fields[2].val > bytes->length - cursor) {
+			CBLogError("Attempting to deserialise a CBBlockUndo with a spent output script going past the end of the data.");
+			return CB_DESERIALISE_ERROR;
+		}
+		CBBlockUndoTakeSpentOutput(self, CBNewUnspentOutput(NULL, 0, CBDecompressAmount(fields[1].val), data + cursor, (int)fields[2].val, (unsigned int)(fields[0].val >> 1), fields[0].val & 1));
+		cursor += fields[2].val;
+	}
+	return cursor;
+}
+void CBBlockUndoPrepareBytes(CBBlockUndo * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBBlockUndoCalculateLength(self));
+}
+int CBBlockUndoSerialise(CBBlockUndo * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBBlockUndo with no bytes.");
+		return 0;
+	}
+	if (bytes->length < CBBlockUndoCalculateLength(self)) {
+		CBLogError("Attempting to serialise a CBBlockUndo with less bytes than required.");
+		return 0;
+	}
+	unsigned char * data = CBByteArrayGetData(bytes);
+	memcpy(data, self->blockHash, 32);
+	CBVarInt varInt = CBVarIntFromUInt64(self->spentNum);
+	CBByteArraySetVarIntData(data, 32, varInt);
+	int cursor = 32 + varInt.size;
+	for (int x = 0; x < self->spentNum; x++) {
+		CBUnspentOutput * spent = self->spent[x];
+		varInt = CBVarIntFromUInt64(((long long int)spent->height << 1) | spent->coinbase);
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		varInt = CBVarIntFromUInt64(CBCompressAmount(spent->value));
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		varInt = CBVarIntFromUInt64(spent->scriptLength);
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		memcpy(data + cursor, spent->script, spent->scriptLength);
+		cursor += spent->scriptLength;
+	}
+	bytes->length = cursor;
+	CBGetMessage(self)->serialised = true;
+	return cursor;
+}
+void CBBlockUndoTakeSpentOutput(CBBlockUndo * self, CBUnspentOutput * spent){
+	if (self->spentNum == self->spentAlloc) {
+		self->spentAlloc = self->spentAlloc ? self->spentAlloc * 2 : 8;
+		self->spent = realloc(self->spent, sizeof(*self->spent) * self->spentAlloc);
+	}
+	self->spent[self->spentNum++] = spent;
+}
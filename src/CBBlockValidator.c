@@ -0,0 +1,353 @@
+//
+//  CBBlockValidator.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBlockValidator.h"
+
+typedef enum{
+	CB_VALIDATION_JOB_MERKLE,
+	CB_VALIDATION_JOB_SCRIPTS,
+} CBValidationJobType;
+
+/**
+ @brief An item for the thread pool of a CBBlockValidator.
+ */
+typedef struct{
+	CBQueueItem base;
+	CBBlockValidator * validator;
+	CBValidationJobType type;
+	int start; /**< The first input to verify for script jobs. */
+	int end; /**< The input after the last to verify for script jobs. */
+} CBValidationJob;
+
+static void CBBlockValidatorAddJob(CBBlockValidator * self, CBValidationJobType type, int start, int end);
+static void CBBlockValidatorProcess(CBThreadPoolQueue * queue, void * vjob);
+static void CBBlockValidatorDestroyJob(void * job);
+static int CBHashCompare(const void * hash1, const void * hash2);
+
+//  Constructor
+
+CBBlockValidator * CBNewBlockValidator(int numThreads){
+	CBBlockValidator * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBlockValidator;
+	CBInitBlockValidator(self, numThreads);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitBlockValidator(CBBlockValidator * self, int numThreads){
+	CBInitObject(CBGetObject(self), false);
+	self->numThreads = numThreads;
+	if (numThreads) {
+		CBInitThreadPoolQueue(&self->pool, numThreads, CBBlockValidatorProcess, CBBlockValidatorDestroyJob);
+		self->pool.object = self;
+		CBNewMutex(&self->resultMutex);
+	}
+	self->block = NULL;
+	self->inputs = NULL;
+	self->inputNum = 0;
+	self->inputAlloc = 0;
+	self->failedTransaction = -1;
+	self->assumeValidHashes = NULL;
+	self->assumeValidNum = 0;
+	self->assumeValidFirstHeight = 0;
+	self->assumedValid = false;
+}
+
+//  Destructor
+
+void CBDestroyBlockValidator(void * vself){
+	CBBlockValidator * self = vself;
+	if (self->numThreads) {
+		CBDestroyThreadPoolQueue(&self->pool);
+		CBFreeMutex(self->resultMutex);
+	}
+	free(self->inputs);
+	free(self->assumeValidHashes);
+}
+void CBFreeBlockValidator(void * self){
+	CBDestroyBlockValidator(self);
+	free(self);
+}
+
+//  Functions
+
+bool CBBlockValidatorIsAssumedValid(CBBlockValidator * self, unsigned char * hash, unsigned int height){
+	if (height < self->assumeValidFirstHeight || height - self->assumeValidFirstHeight >= (unsigned int)self->assumeValidNum)
+		return false;
+	return ! memcmp(self->assumeValidHashes + (height - self->assumeValidFirstHeight) * 32, hash, 32);
+}
+bool CBBlockValidatorSetAssumeValid(CBBlockValidator * self, unsigned char * trustedHash, CBBlock ** headers, int headerNum, unsigned int firstHeight){
+	free(self->assumeValidHashes);
+	self->assumeValidHashes = NULL;
+	self->assumeValidNum = 0;
+	self->assumeValidFirstHeight = 0;
+	if (! trustedHash)
+		return true;
+	if (! headerNum || memcmp(CBBlockGetHash(headers[headerNum - 1]), trustedHash, 32)) {
+		CBLogError("The headers for assume-valid do not end with the trusted block.");
+		return false;
+	}
+	unsigned char * hashes = malloc(headerNum * 32);
+	for (int x = 0; x < headerNum; x++) {
+		unsigned char * hash = CBBlockGetHash(headers[x]);
+		// Each header must have valid proof of work and link to the previous header so that the trusted hash commits to every hash stored.
+		if (! CBValidateProofOfWork(hash, headers[x]->target)
+			|| (x && memcmp(CBByteArrayGetData(headers[x]->prevBlockHash), hashes + (x - 1) * 32, 32))) {
+			CBLogError("The header at height %u for assume-valid is not part of a valid chain of headers.", firstHeight + x);
+			free(hashes);
+			return false;
+		}
+		memcpy(hashes + x * 32, hash, 32);
+	}
+	self->assumeValidHashes = hashes;
+	self->assumeValidNum = headerNum;
+	self->assumeValidFirstHeight = firstHeight;
+	return true;
+}
+static void CBBlockValidatorAddJob(CBBlockValidator * self, CBValidationJobType type, int start, int end){
+	CBValidationJob * job = malloc(sizeof(*job));
+	job->validator = self;
+	job->type = type;
+	job->start = start;
+	job->end = end;
+	CBThreadPoolQueueAdd(&self->pool, &job->base);
+}
+static void CBBlockValidatorDestroyJob(void * job){
+	UNUSED(job);
+}
+static void CBBlockValidatorProcess(CBThreadPoolQueue * queue, void * vjob){
+	UNUSED(queue);
+	CBValidationJob * job = vjob;
+	CBBlockValidator * self = job->validator;
+	if (job->type == CB_VALIDATION_JOB_MERKLE) {
+		// Only this job writes the merkle result, which is read after the pool has finished.
+		self->merkleResult = CBValidateBlockMerkleRoot(self->block);
+		return;
+	}
+	// Skip the job if another job has already found an invalid script.
+	CBMutexLock(self->resultMutex);
+	bool failed = self->scriptResult != CB_BLOCK_VALIDATION_OK;
+	CBMutexUnlock(self->resultMutex);
+	if (failed)
+		return;
+	for (int x = job->start; x < job->end; x++) {
+		if (! CBValidateInputScripts(self->inputs + x, self->p2sh)) {
+			CBMutexLock(self->resultMutex);
+			if (self->scriptResult == CB_BLOCK_VALIDATION_OK
+				|| self->inputs[x].txIndex < self->failedTransaction) {
+				self->scriptResult = CB_BLOCK_VALIDATION_BAD_SCRIPT;
+				self->failedTransaction = self->inputs[x].txIndex;
+			}
+			CBMutexUnlock(self->resultMutex);
+			return;
+		}
+	}
+}
+CBBlockValidationResult CBValidateBlock(CBBlockValidator * self, CBBlock * block, CBUnspentOutputSet * set, unsigned int height, unsigned int networkTime, CBBlockUndo * undo){
+	// Stage 1: Context-free checks
+	self->failedTransaction = -1;
+	self->assumedValid = false;
+	CBBlockValidationResult res = CBValidateBlockContextFree(block, networkTime, &self->failedTransaction);
+	if (res != CB_BLOCK_VALIDATION_OK)
+		return res;
+	self->block = block;
+	// The block hash has been checked against the proof of work, so it can be compared with the trusted chain.
+	self->assumedValid = CBBlockValidatorIsAssumedValid(self, CBBlockGetHash(block), height);
+	self->merkleResult = CB_BLOCK_VALIDATION_OK;
+	self->scriptResult = CB_BLOCK_VALIDATION_OK;
+	// Stage 2: Merkle root and duplicate transactions, concurrently with stage 3 when there are threads.
+	if (self->numThreads)
+		CBBlockValidatorAddJob(self, CB_VALIDATION_JOB_MERKLE, 0, 0);
+	else if ((res = CBValidateBlockMerkleRoot(block)) != CB_BLOCK_VALIDATION_OK)
+		return res;
+	// Stage 3: Unspent outputs, values and fees
+	res = CBValidateBlockSpends(self, block, set, height, undo);
+	if (self->numThreads) {
+		CBThreadPoolQueueWaitUntilFinished(&self->pool);
+		if (self->merkleResult != CB_BLOCK_VALIDATION_OK) {
+			if (res == CB_BLOCK_VALIDATION_OK)
+				CBBlockDisconnect(block, set, undo);
+			self->failedTransaction = -1;
+			return self->merkleResult;
+		}
+	}
+	if (res != CB_BLOCK_VALIDATION_OK)
+		return res;
+	// Stage 4: Scripts, skipped for blocks on the trusted chain. The merkle root has been verified so the transactions are those committed to by the trusted hash.
+	if (self->assumedValid)
+		return CB_BLOCK_VALIDATION_OK;
+	self->p2sh = block->time >= CB_BIP16_SWITCH_TIME;
+	if (self->numThreads && self->inputNum > CB_VALIDATION_INPUTS_PER_JOB) {
+		int jobs = self->numThreads * 4;
+		int perJob = (self->inputNum + jobs - 1) / jobs;
+		if (perJob < CB_VALIDATION_INPUTS_PER_JOB)
+			perJob = CB_VALIDATION_INPUTS_PER_JOB;
+		for (int x = 0; x < self->inputNum; x += perJob)
+			CBBlockValidatorAddJob(self, CB_VALIDATION_JOB_SCRIPTS, x, x + perJob < self->inputNum ? x + perJob : self->inputNum);
+		CBThreadPoolQueueWaitUntilFinished(&self->pool);
+	}else for (int x = 0; x < self->inputNum; x++)
+		if (! CBValidateInputScripts(self->inputs + x, self->p2sh)) {
+			self->scriptResult = CB_BLOCK_VALIDATION_BAD_SCRIPT;
+			self->failedTransaction = self->inputs[x].txIndex;
+			break;
+		}
+	if (self->scriptResult != CB_BLOCK_VALIDATION_OK) {
+		CBBlockDisconnect(block, set, undo);
+		return self->scriptResult;
+	}
+	return CB_BLOCK_VALIDATION_OK;
+}
+CBBlockValidationResult CBValidateBlockContextFree(CBBlock * block, unsigned int networkTime, int * failedTransaction){
+	*failedTransaction = -1;
+	// Deserialised headers have the transaction number but no transactions.
+	if (! block->transactionNum || ! block->transactions)
+		return CB_BLOCK_VALIDATION_NO_TRANSACTIONS;
+	int length;
+	if (CBGetMessage(block)->bytes)
+		length = CBGetMessage(block)->bytes->length;
+	else
+		length = CBBlockCalculateLength(block, true);
+	if (length > CB_BLOCK_MAX_SIZE)
+		return CB_BLOCK_VALIDATION_BAD_SIZE;
+	if (! CBValidateProofOfWork(CBBlockGetHash(block), block->target))
+		return CB_BLOCK_VALIDATION_BAD_POW;
+	if (block->time > (long long int)networkTime + CB_BLOCK_ALLOWED_TIME_DRIFT)
+		return CB_BLOCK_VALIDATION_BAD_TIME;
+	int sigOps = 0;
+	for (int x = 0; x < block->transactionNum; x++) {
+		CBTransaction * tx = block->transactions[x];
+		long long int outputValue;
+		*failedTransaction = x;
+		if (CBTransactionIsCoinBase(tx) != (x == 0))
+			return CB_BLOCK_VALIDATION_BAD_COINBASE;
+		if (! CBTransactionValidateBasic(tx, x == 0, &outputValue))
+			return CB_BLOCK_VALIDATION_BAD_TRANSACTION;
+		sigOps += CBTransactionGetSigOps(tx);
+		if (sigOps > CB_MAX_SIG_OPS)
+			return CB_BLOCK_VALIDATION_TOO_MANY_SIGOPS;
+		// Calculate the hash now so that later stages only read it.
+		CBTransactionGetHash(tx);
+	}
+	// Reject double spends between transactions before touching the unspent output set.
+	*failedTransaction = CBTransactionsFindDoubleSpend(block->transactions, block->transactionNum);
+	if (*failedTransaction != -1)
+		return CB_BLOCK_VALIDATION_DOUBLE_SPEND;
+	return CB_BLOCK_VALIDATION_OK;
+}
+CBBlockValidationResult CBValidateBlockMerkleRoot(CBBlock * block){
+	unsigned char * hashes = malloc(block->transactionNum * 32);
+	for (int x = 0; x < block->transactionNum; x++)
+		memcpy(hashes + x*32, CBTransactionGetHash(block->transactions[x]), 32);
+	// Look for duplicate transactions by sorting a copy of the hashes
+	unsigned char * sorted = malloc(block->transactionNum * 32);
+	memcpy(sorted, hashes, block->transactionNum * 32);
+	qsort(sorted, block->transactionNum, 32, CBHashCompare);
+	for (int x = 1; x < block->transactionNum; x++)
+		if (! memcmp(sorted + (x-1)*32, sorted + x*32, 32)) {
+			free(sorted);
+			free(hashes);
+			return CB_BLOCK_VALIDATION_DUPLICATE_TRANSACTION;
+		}
+	free(sorted);
+	CBCalculateMerkleRoot(hashes, block->transactionNum);
+	bool match = ! memcmp(hashes, CBByteArrayGetData(block->merkleRoot), 32);
+	free(hashes);
+	return match ? CB_BLOCK_VALIDATION_OK : CB_BLOCK_VALIDATION_BAD_MERKLE_ROOT;
+}
+CBBlockValidationResult CBValidateBlockSpends(CBBlockValidator * self, CBBlock * block, CBUnspentOutputSet * set, unsigned int height, CBBlockUndo * undo){
+	if (! CBBlockConnect(block, set, height, undo))
+		return CB_BLOCK_VALIDATION_BAD_SPEND;
+	CBBlockValidationResult res = CB_BLOCK_VALIDATION_OK;
+	long long int fees = 0;
+	int cursor = 0;
+	int x;
+	self->inputNum = 0;
+	for (x = 0; x < block->transactionNum; x++) {
+		CBTransaction * tx = block->transactions[x];
+		if (! CBTransactionIsFinal(tx, block->time, height)) {
+			res = CB_BLOCK_VALIDATION_NOT_FINAL;
+			break;
+		}
+		if (! x)
+			// Coinbase has no outputs to spend.
+			continue;
+		long long int inputValue = 0;
+		long long int outputValue = 0;
+		for (int y = 0; y < tx->inputNum; y++) {
+			CBUnspentOutput * spent = undo->spent[cursor++];
+			if (spent->coinbase && height - spent->height < CB_COINBASE_MATURITY) {
+				res = CB_BLOCK_VALIDATION_IMMATURE_COINBASE;
+				break;
+			}
+			inputValue += spent->value;
+			if (spent->value > CB_MAX_MONEY || inputValue > CB_MAX_MONEY) {
+				res = CB_BLOCK_VALIDATION_BAD_VALUE;
+				break;
+			}
+			// Add the input for script verification
+			if (self->inputNum == self->inputAlloc) {
+				self->inputAlloc = self->inputAlloc ? self->inputAlloc * 2 : 64;
+				self->inputs = realloc(self->inputs, sizeof(*self->inputs) * self->inputAlloc);
+			}
+			self->inputs[self->inputNum++] = (CBValidationInput){tx, x, y, spent};
+		}
+		if (res != CB_BLOCK_VALIDATION_OK)
+			break;
+		// Output values have been checked for overflow by CBTransactionValidateBasic
+		for (int y = 0; y < tx->outputNum; y++)
+			outputValue += tx->outputs[y]->value;
+		if (inputValue < outputValue) {
+			res = CB_BLOCK_VALIDATION_BAD_VALUE;
+			break;
+		}
+		fees += inputValue - outputValue;
+	}
+	if (res == CB_BLOCK_VALIDATION_OK) {
+		long long int coinbaseValue = 0;
+		CBTransaction * coinbase = block->transactions[0];
+		for (int y = 0; y < coinbase->outputNum; y++)
+			coinbaseValue += coinbase->outputs[y]->value;
+		if (coinbaseValue > CBCalculateBlockReward(height) + fees) {
+			res = CB_BLOCK_VALIDATION_BAD_COINBASE_VALUE;
+			x = 0;
+		}
+	}
+	if (res != CB_BLOCK_VALIDATION_OK) {
+		self->failedTransaction = x;
+		CBBlockDisconnect(block, set, undo);
+	}
+	return res;
+}
+bool CBValidateInputScripts(CBValidationInput * input, bool p2sh){
+	CBScript * inputScript = input->tx->inputs[input->index]->scriptObject;
+	CBScript * outputScript = CBNewScriptWithDataCopy(input->spent->script, input->spent->scriptLength);
+	bool valid;
+	if (p2sh && CBScriptIsP2SH(outputScript) && ! CBScriptIsPushOnly(inputScript))
+		// P2SH requires at least one push and only pushes in the input script.
+		valid = false;
+	else{
+		CBScriptStack stack = CBNewEmptyScriptStack();
+		valid = CBScriptExecute(inputScript, &stack, CBTransactionGetInputHashForSignature, input->tx, input->index, false) != CB_SCRIPT_INVALID
+			&& CBScriptExecute(outputScript, &stack, CBTransactionGetInputHashForSignature, input->tx, input->index, p2sh) == CB_SCRIPT_TRUE;
+		CBFreeScriptStack(stack);
+	}
+	CBReleaseObject(outputScript);
+	return valid;
+}
+static int CBHashCompare(const void * hash1, const void * hash2){
+	return memcmp(hash1, hash2, 32);
+}
@@ -0,0 +1,267 @@
+//
+//  CBBloomFilter.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBBloomFilter.h"
+
+#define CB_LN2 0.6931471805599453
+#define CB_LN2_SQUARED 0.4804530139182014
+
+/**
+ @brief Calculates the natural logarithm of a positive number, so that the library does not need libm.
+ @param x The number.
+ @returns The natural logarithm.
+ */
+static double CBBloomFilterLog(double x);
+/**
+ @brief Gets the bit index of data for a hash function.
+ @param self The CBBloomFilter object.
+ @param hashFunc The hash function number.
+ @param data The data.
+ @param length The length of the data.
+ @returns The index of the bit.
+ */
+static uint32_t CBBloomFilterHash(CBBloomFilter * self, unsigned int hashFunc, unsigned char * data, int length);
+/**
+ @brief Sets "full" and "empty" for the filter bits.
+ @param self The CBBloomFilter object.
+ */
+static void CBBloomFilterUpdateFullEmpty(CBBloomFilter * self);
+
+//  Constructors
+
+CBBloomFilter * CBNewBloomFilter(int elementNum, double falsePositiveRate, unsigned int tweak, CBBloomFilterUpdate update){
+	CBBloomFilter * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBloomFilter;
+	CBInitBloomFilter(self, elementNum, falsePositiveRate, tweak, update);
+	return self;
+}
+CBBloomFilter * CBNewBloomFilterFromData(CBByteArray * data){
+	CBBloomFilter * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeBloomFilter;
+	CBInitBloomFilterFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitBloomFilter(CBBloomFilter * self, int elementNum, double falsePositiveRate, unsigned int tweak, CBBloomFilterUpdate update){
+	CBInitMessageByObject(CBGetMessage(self));
+	// The optimal size is -n*ln(p)/ln(2)^2 bits and the optimal number of hash functions is the bits per element times ln(2).
+	if (elementNum < 1)
+		elementNum = 1;
+	// CBBloomFilterLog cannot reduce zero, negative or infinite rates. Rates of one and over all give the smallest filter.
+	if (! (falsePositiveRate >= CB_BLOOM_FILTER_MIN_FALSE_POSITIVE_RATE))
+		falsePositiveRate = CB_BLOOM_FILTER_MIN_FALSE_POSITIVE_RATE;
+	else if (falsePositiveRate > 1)
+		falsePositiveRate = 1;
+	double bits = -elementNum * CBBloomFilterLog(falsePositiveRate) / CB_LN2_SQUARED;
+	int size = bits / 8;
+	if (size > CB_BLOOM_FILTER_MAX_SIZE)
+		size = CB_BLOOM_FILTER_MAX_SIZE;
+	if (size < 1)
+		size = 1;
+	self->hashFuncNum = size * 8.0 / elementNum * CB_LN2;
+	if (self->hashFuncNum > CB_BLOOM_FILTER_MAX_HASH_FUNCS)
+		self->hashFuncNum = CB_BLOOM_FILTER_MAX_HASH_FUNCS;
+	if (self->hashFuncNum < 1)
+		self->hashFuncNum = 1;
+	self->filter = CBNewByteArrayWithData(calloc(size, 1), size);
+	self->tweak = tweak;
+	self->update = update;
+	self->full = false;
+	self->empty = true;
+}
+void CBInitBloomFilterFromData(CBBloomFilter * self, CBByteArray * data){
+	CBInitMessageByData(CBGetMessage(self), data);
+	self->filter = NULL;
+}
+
+//  Destructor
+
+void CBDestroyBloomFilter(void * vself){
+	CBBloomFilter * self = vself;
+	if (self->filter)
+		CBReleaseObject(self->filter);
+	CBDestroyMessage(self);
+}
+void CBFreeBloomFilter(void * self){
+	CBDestroyBloomFilter(self);
+	free(self);
+}
+
+//  Functions
+
+int CBBloomFilterCalculateLength(CBBloomFilter * self){
+	return CBVarIntSizeOf(self->filter->length) + self->filter->length + 9;
+}
+bool CBBloomFilterContains(CBBloomFilter * self, unsigned char * data, int length){
+	if (self->full)
+		return true;
+	if (self->empty)
+		return false;
+	unsigned char * filter = CBByteArrayGetData(self->filter);
+	for (unsigned int x = 0; x < self->hashFuncNum; x++) {
+		uint32_t bit = CBBloomFilterHash(self, x, data, length);
+		if (!(filter[bit >> 3] & (1 << (bit & 7))))
+			return false;
+	}
+	return true;
+}
+int CBBloomFilterDeserialise(CBBloomFilter * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBBloomFilter with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 10) {
+		CBLogError("Attempting to deserialise a CBBloomFilter with less than 10 bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt size = CBByteArrayReadVarInt(bytes, 0);
+	if (size.val > CB_BLOOM_FILTER_MAX_SIZE) {
+		CBLogError("Attempting to deserialise a CBBloomFilter which is too large.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < size.size + size.val + 9) {
+		CBLogError("Attempting to deserialise a CBBloomFilter with less bytes than required.");
+		return CB_DESERIALISE_ERROR;
+	}
+	int cursor = size.size;
+	unsigned int hashFuncNum = CBByteArrayReadInt32(bytes, cursor + size.val);
+	if (hashFuncNum > CB_BLOOM_FILTER_MAX_HASH_FUNCS) {
+		CBLogError("Attempting to deserialise a CBBloomFilter with too many hash functions.");
+		return CB_DESERIALISE_ERROR;
+	}
+	// Copy the filter as it is updated with matched outputs.
+	if (self->filter)
+		CBReleaseObject(self->filter);
+	self->filter = CBNewByteArrayWithDataCopy(CBByteArrayGetData(bytes) + cursor, size.val);
+	cursor += size.val;
+	self->hashFuncNum = hashFuncNum;
+	cursor += 4;
+	self->tweak = CBByteArrayReadInt32(bytes, cursor);
+	cursor += 4;
+	self->update = CBByteArrayGetByte(bytes, cursor) & 3;
+	cursor++;
+	CBBloomFilterUpdateFullEmpty(self);
+	return cursor;
+}
+static uint32_t CBBloomFilterHash(CBBloomFilter * self, unsigned int hashFunc, unsigned char * data, int length){
+	return CBMurmurHash3(hashFunc * CB_BLOOM_FILTER_SEED_MULTIPLIER + self->tweak, data, length) % (self->filter->length * 8);
+}
+void CBBloomFilterInsert(CBBloomFilter * self, unsigned char * data, int length){
+	if (self->full)
+		return;
+	unsigned char * filter = CBByteArrayGetData(self->filter);
+	for (unsigned int x = 0; x < self->hashFuncNum; x++) {
+		uint32_t bit = CBBloomFilterHash(self, x, data, length);
+		filter[bit >> 3] |= 1 << (bit & 7);
+	}
+	self->empty = false;
+}
+static double CBBloomFilterLog(double x){
+	// Reduce to [0.5, 1) and use ln(m) = 2 * atanh((m - 1)/(m + 1))
+	int exponent = 0;
+	for (; x >= 1; exponent++)
+		x /= 2;
+	for (; x < 0.5; exponent--)
+		x *= 2;
+	double y = (x - 1) / (x + 1);
+	double y2 = y * y;
+	double term = y;
+	double sum = 0;
+	for (int n = 1; n < 40; n += 2) {
+		sum += term / n;
+		term *= y2;
+	}
+	return 2 * sum + exponent * CB_LN2;
+}
+void CBBloomFilterPrepareBytes(CBBloomFilter * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBBloomFilterCalculateLength(self));
+}
+int CBBloomFilterSerialise(CBBloomFilter * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBBloomFilter with no bytes.");
+		return 0;
+	}
+	int length = CBBloomFilterCalculateLength(self);
+	if (bytes->length < length) {
+		CBLogError("Attempting to serialise a CBBloomFilter with less bytes than required.");
+		return 0;
+	}
+	CBByteArraySetVarInt(bytes, 0, CBVarIntFromUInt64(self->filter->length));
+	int cursor = CBVarIntSizeOf(self->filter->length);
+	CBByteArrayCopyByteArray(bytes, cursor, self->filter);
+	cursor += self->filter->length;
+	CBByteArraySetInt32(bytes, cursor, self->hashFuncNum);
+	cursor += 4;
+	CBByteArraySetInt32(bytes, cursor, self->tweak);
+	cursor += 4;
+	CBByteArraySetByte(bytes, cursor, self->update);
+	bytes->length = length;
+	CBGetMessage(self)->serialised = true;
+	return length;
+}
+static void CBBloomFilterUpdateFullEmpty(CBBloomFilter * self){
+	unsigned char * filter = CBByteArrayGetData(self->filter);
+	self->full = true;
+	self->empty = true;
+	for (int x = 0; x < self->filter->length; x++) {
+		if (filter[x] != 0xFF)
+			self->full = false;
+		if (filter[x])
+			self->empty = false;
+	}
+}
+uint32_t CBMurmurHash3(uint32_t seed, unsigned char * data, int length){
+	uint32_t c1 = 0xcc9e2d51;
+	uint32_t c2 = 0x1b873593;
+	uint32_t h = seed;
+	int blockNum = length / 4;
+	for (int x = 0; x < blockNum; x++) {
+		uint32_t k = CBArrayToInt32(data, x * 4);
+		k *= c1;
+		k = (k << 15) | (k >> 17);
+		k *= c2;
+		h ^= k;
+		h = (h << 13) | (h >> 19);
+		h = h * 5 + 0xe6546b64;
+	}
+	unsigned char * tail = data + blockNum * 4;
+	uint32_t k = 0;
+	switch (length & 3) {
+		case 3:
+			k ^= tail[2] << 16;
+			// Fall through
+		case 2:
+			k ^= tail[1] << 8;
+			// Fall through
+		case 1:
+			k ^= tail[0];
+			k *= c1;
+			k = (k << 15) | (k >> 17);
+			k *= c2;
+			h ^= k;
+	}
+	h ^= length;
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
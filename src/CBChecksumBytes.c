@@ -128,12 +128,8 @@ CBByteArray * CBChecksumBytesGetString(CBChecksumBytes * self){
 	}else{
 		// Make string
 		CBByteArrayReverseBytes(CBGetByteArray(self)); // Make this into little-endian
-		CBBigInt bytes;
-		CBBigIntAlloc(&bytes, CBGetByteArray(self)->length);
-		bytes.length = CBGetByteArray(self)->length;
-		memcpy(bytes.data, CBByteArrayGetData(CBGetByteArray(self)), bytes.length);
-		char * string = CBEncodeBase58(&bytes);
-		free(bytes.data);
+		char * string = malloc(CBBase58MaxLength(CBGetByteArray(self)->length) + 1);
+		CBBase58Encode(CBByteArrayGetData(CBGetByteArray(self)), CBGetByteArray(self)->length, string);
 		CBByteArray * str = CBNewByteArrayFromString(string, true);
 		free(string);
 		CBByteArrayReverseBytes(CBGetByteArray(self)); // Now the string is got, back to big-endian.
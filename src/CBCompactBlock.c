@@ -0,0 +1,280 @@
+//
+//  CBCompactBlock.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBCompactBlock.h"
+
+#define CBSipRound(v0, v1, v2, v3) \
+	v0 += v1; v1 = (v1 << 13) | (v1 >> 51); v1 ^= v0; v0 = (v0 << 32) | (v0 >> 32); \
+	v2 += v3; v3 = (v3 << 16) | (v3 >> 48); v3 ^= v2; \
+	v0 += v3; v3 = (v3 << 21) | (v3 >> 43); v3 ^= v0; \
+	v2 += v1; v1 = (v1 << 17) | (v1 >> 47); v1 ^= v2; v2 = (v2 << 32) | (v2 >> 32);
+
+/**
+ @brief Calculates the SipHash keys from the serialised header and the short ID nonce.
+ @param self The CBCompactBlock object.
+ @param header The 80 byte serialised header.
+ */
+static void CBCompactBlockCalculateKeys(CBCompactBlock * self, unsigned char * header);
+
+//  Constructors
+
+CBCompactBlock * CBNewCompactBlock(CBBlock * block, uint64_t shortIDNonce){
+	CBCompactBlock * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeCompactBlock;
+	CBInitCompactBlock(self, block, shortIDNonce);
+	return self;
+}
+CBCompactBlock * CBNewCompactBlockFromData(CBByteArray * data){
+	CBCompactBlock * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeCompactBlock;
+	CBInitCompactBlockFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitCompactBlock(CBCompactBlock * self, CBBlock * block, uint64_t shortIDNonce){
+	CBInitMessageByObject(CBGetMessage(self));
+	self->version = block->version;
+	// Copy the hashes as they are changed to reference the serialised data.
+	self->prevBlockHash = CBByteArrayCopy(block->prevBlockHash);
+	self->merkleRoot = CBByteArrayCopy(block->merkleRoot);
+	self->time = block->time;
+	self->target = block->target;
+	self->nonce = block->nonce;
+	self->shortIDNonce = shortIDNonce;
+	CBCompactBlockCalculateKeys(self, CBByteArrayGetData(CBGetMessage(block)->bytes));
+	// Prefill the coinbase transaction
+	self->prefilledNum = 1;
+	self->prefilledIndexes = malloc(sizeof(*self->prefilledIndexes));
+	self->prefilledIndexes[0] = 0;
+	self->prefilled = malloc(sizeof(*self->prefilled));
+	CBRetainObject(block->transactions[0]);
+	self->prefilled[0] = block->transactions[0];
+	self->shortIDNum = block->transactionNum - 1;
+	self->shortIDs = malloc(sizeof(*self->shortIDs) * self->shortIDNum);
+	for (int x = 0; x < self->shortIDNum; x++)
+		self->shortIDs[x] = CBCompactBlockGetShortID(self, CBTransactionGetHash(block->transactions[x + 1]));
+}
+void CBInitCompactBlockFromData(CBCompactBlock * self, CBByteArray * data){
+	CBInitMessageByData(CBGetMessage(self), data);
+	self->prevBlockHash = NULL;
+	self->merkleRoot = NULL;
+	self->shortIDs = NULL;
+	self->prefilledIndexes = NULL;
+	self->prefilled = NULL;
+	self->prefilledNum = 0;
+}
+
+//  Destructor
+
+void CBDestroyCompactBlock(void * vself){
+	CBCompactBlock * self = vself;
+	if (self->prevBlockHash)
+		CBReleaseObject(self->prevBlockHash);
+	if (self->merkleRoot)
+		CBReleaseObject(self->merkleRoot);
+	free(self->shortIDs);
+	for (int x = 0; x < self->prefilledNum; x++)
+		CBReleaseObject(self->prefilled[x]);
+	free(self->prefilled);
+	free(self->prefilledIndexes);
+	CBDestroyMessage(self);
+}
+void CBFreeCompactBlock(void * self){
+	CBDestroyCompactBlock(self);
+	free(self);
+}
+
+//  Functions
+
+static void CBCompactBlockCalculateKeys(CBCompactBlock * self, unsigned char * header){
+	unsigned char data[88];
+	unsigned char hash[32];
+	memcpy(data, header, 80);
+	CBInt64ToArray(data, 80, self->shortIDNonce);
+	CBSha256(data, 88, hash);
+	self->keys[0] = CBArrayToInt64(hash, 0);
+	self->keys[1] = CBArrayToInt64(hash, 8);
+}
+int CBCompactBlockCalculateLength(CBCompactBlock * self){
+	int length = 88 + CBVarIntSizeOf(self->shortIDNum) + self->shortIDNum * CB_COMPACT_BLOCK_SHORT_ID_SIZE + CBVarIntSizeOf(self->prefilledNum);
+	for (int x = 0; x < self->prefilledNum; x++)
+		length += CBVarIntSizeOf(self->prefilledIndexes[x] - (x ? self->prefilledIndexes[x - 1] + 1 : 0))
+			+ CBGetMessage(self->prefilled[x])->bytes->length;
+	return length;
+}
+void CBCompactBlockCalculateHash(CBCompactBlock * self, unsigned char * hash){
+	unsigned char headerHash[32];
+	CBSha256(CBByteArrayGetData(CBGetMessage(self)->bytes), 80, headerHash);
+	CBSha256(headerHash, 32, hash);
+}
+int CBCompactBlockDeserialise(CBCompactBlock * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBCompactBlock with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 89) {
+		CBLogError("Attempting to deserialise a CBCompactBlock with less than 89 bytes for the header, nonce and short ID number.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->version = CBByteArrayReadInt32(bytes, 0);
+	self->prevBlockHash = CBByteArraySubReference(bytes, 4, 32);
+	self->merkleRoot = CBByteArraySubReference(bytes, 36, 32);
+	self->time = CBByteArrayReadInt32(bytes, 68);
+	self->target = CBByteArrayReadInt32(bytes, 72);
+	self->nonce = CBByteArrayReadInt32(bytes, 76);
+	self->shortIDNonce = CBByteArrayReadInt64(bytes, 80);
+	CBCompactBlockCalculateKeys(self, CBByteArrayGetData(bytes));
+	// Short IDs
+	int cursor = 88;
+	if (bytes->length < cursor + CBByteArrayReadVarIntSize(bytes, cursor)) {
+		CBLogError("Attempting to deserialise a CBCompactBlock with less bytes than required for the short ID number.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt num = CBByteArrayReadVarInt(bytes, cursor);
+	cursor += num.size;
+	if ((uint64_t)num.val > (uint64_t)(bytes->length - cursor) / CB_COMPACT_BLOCK_SHORT_ID_SIZE) {
+		CBLogError("Attempting to deserialise a CBCompactBlock with too many short IDs for the byte data length.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->shortIDNum = (int)num.val;
+	self->shortIDs = malloc(sizeof(*self->shortIDs) * self->shortIDNum);
+	unsigned char * data = CBByteArrayGetData(bytes);
+	for (int x = 0; x < self->shortIDNum; x++, cursor += CB_COMPACT_BLOCK_SHORT_ID_SIZE)
+		self->shortIDs[x] = CBArrayToInt48(data, cursor);
+	// Prefilled transactions
+	if (bytes->length < cursor + 1 || bytes->length < cursor + CBByteArrayReadVarIntSize(bytes, cursor)) {
+		CBLogError("Attempting to deserialise a CBCompactBlock with less bytes than required for the prefilled transaction number.");
+		return CB_DESERIALISE_ERROR;
+	}
+	num = CBByteArrayReadVarInt(bytes, cursor);
+	cursor += num.size;
+	if ((uint64_t)num.val > (uint64_t)(bytes->length - cursor) / 61) {
+		CBLogError("Attempting to deserialise a CBCompactBlock with too many prefilled transactions for the byte data length.");
+		return CB_DESERIALISE_ERROR;
+	}
+	int prefilledNum = (int)num.val;
+	self->prefilledIndexes = malloc(sizeof(*self->prefilledIndexes) * prefilledNum);
+	self->prefilled = malloc(sizeof(*self->prefilled) * prefilledNum);
+	uint64_t index = 0;
+	for (int x = 0; x < prefilledNum; x++) {
+		// The indexes are the differences from the last index plus one.
+		if (bytes->length < cursor + 1 || bytes->length < cursor + CBByteArrayReadVarIntSize(bytes, cursor)) {
+			CBLogError("Attempting to deserialise a CBCompactBlock with less bytes than required for a prefilled transaction index.");
+			return CB_DESERIALISE_ERROR;
+		}
+		num = CBByteArrayReadVarInt(bytes, cursor);
+		cursor += num.size;
+		index += num.val;
+		if ((uint64_t)num.val > (uint64_t)(self->shortIDNum + prefilledNum) || index >= (uint64_t)(self->shortIDNum + prefilledNum)) {
+			CBLogError("Attempting to deserialise a CBCompactBlock with a prefilled transaction index outside of the block.");
+			return CB_DESERIALISE_ERROR;
+		}
+		self->prefilledIndexes[x] = (int)index++;
+		CBByteArray * txData = CBByteArraySubReference(bytes, cursor, bytes->length - cursor);
+		CBTransaction * tx = CBNewTransactionFromData(txData);
+		int len = CBTransactionDeserialise(tx);
+		if (len == CB_DESERIALISE_ERROR) {
+			CBLogError("Attempting to deserialise a CBCompactBlock with an invalid prefilled transaction.");
+			CBReleaseObject(txData);
+			CBReleaseObject(tx);
+			return CB_DESERIALISE_ERROR;
+		}
+		txData->length = len;
+		CBReleaseObject(txData);
+		self->prefilled[self->prefilledNum++] = tx;
+		cursor += len;
+	}
+	return cursor;
+}
+uint64_t CBCompactBlockGetShortID(CBCompactBlock * self, unsigned char * txHash){
+	return CBSipHash(self->keys[0], self->keys[1], txHash, 32) & 0xFFFFFFFFFFFF;
+}
+void CBCompactBlockPrepareBytes(CBCompactBlock * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBCompactBlockCalculateLength(self));
+}
+int CBCompactBlockSerialise(CBCompactBlock * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBCompactBlock with no bytes.");
+		return 0;
+	}
+	int length = CBCompactBlockCalculateLength(self);
+	if (bytes->length < length) {
+		CBLogError("Attempting to serialise a CBCompactBlock with less bytes than required.");
+		return 0;
+	}
+	CBByteArraySetInt32(bytes, 0, self->version);
+	CBByteArrayCopyByteArray(bytes, 4, self->prevBlockHash);
+	CBByteArrayChangeReference(self->prevBlockHash, bytes, 4);
+	CBByteArrayCopyByteArray(bytes, 36, self->merkleRoot);
+	CBByteArrayChangeReference(self->merkleRoot, bytes, 36);
+	CBByteArraySetInt32(bytes, 68, self->time);
+	CBByteArraySetInt32(bytes, 72, self->target);
+	CBByteArraySetInt32(bytes, 76, self->nonce);
+	CBByteArraySetInt64(bytes, 80, self->shortIDNonce);
+	int cursor = 88;
+	CBByteArraySetVarInt(bytes, cursor, CBVarIntFromUInt64(self->shortIDNum));
+	cursor += CBVarIntSizeOf(self->shortIDNum);
+	unsigned char * data = CBByteArrayGetData(bytes);
+	for (int x = 0; x < self->shortIDNum; x++, cursor += CB_COMPACT_BLOCK_SHORT_ID_SIZE) {
+		CBInt32ToArray(data, cursor, self->shortIDs[x]);
+		CBInt16ToArray(data, cursor + 4, self->shortIDs[x] >> 32);
+	}
+	CBByteArraySetVarInt(bytes, cursor, CBVarIntFromUInt64(self->prefilledNum));
+	cursor += CBVarIntSizeOf(self->prefilledNum);
+	for (int x = 0; x < self->prefilledNum; x++) {
+		int diff = self->prefilledIndexes[x] - (x ? self->prefilledIndexes[x - 1] + 1 : 0);
+		CBByteArraySetVarInt(bytes, cursor, CBVarIntFromUInt64(diff));
+		cursor += CBVarIntSizeOf(diff);
+		// The transactions may be shared with a block, so only the data is copied.
+		CBByteArrayCopyByteArray(bytes, cursor, CBGetMessage(self->prefilled[x])->bytes);
+		cursor += CBGetMessage(self->prefilled[x])->bytes->length;
+	}
+	bytes->length = length;
+	CBGetMessage(self)->serialised = true;
+	return length;
+}
+uint64_t CBSipHash(uint64_t k0, uint64_t k1, unsigned char * data, int length){
+	uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+	uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+	uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+	uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+	int end = length & ~7;
+	for (int x = 0; x < end; x += 8) {
+		uint64_t m = CBArrayToInt64(data, x);
+		v3 ^= m;
+		CBSipRound(v0, v1, v2, v3)
+		CBSipRound(v0, v1, v2, v3)
+		v0 ^= m;
+	}
+	// The last block has the remaining bytes and the length in the top byte.
+	uint64_t m = (uint64_t)length << 56;
+	for (int x = length & 7; x--;)
+		m |= (uint64_t)data[end + x] << (8 * x);
+	v3 ^= m;
+	CBSipRound(v0, v1, v2, v3)
+	CBSipRound(v0, v1, v2, v3)
+	v0 ^= m;
+	v2 ^= 0xFF;
+	CBSipRound(v0, v1, v2, v3)
+	CBSipRound(v0, v1, v2, v3)
+	CBSipRound(v0, v1, v2, v3)
+	CBSipRound(v0, v1, v2, v3)
+	return v0 ^ v1 ^ v2 ^ v3;
+}
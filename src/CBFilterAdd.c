@@ -0,0 +1,103 @@
+//
+//  CBFilterAdd.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBFilterAdd.h"
+
+//  Constructors
+
+CBFilterAdd * CBNewFilterAdd(CBByteArray * data){
+	CBFilterAdd * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeFilterAdd;
+	CBInitFilterAdd(self, data);
+	return self;
+}
+CBFilterAdd * CBNewFilterAddFromData(CBByteArray * data){
+	CBFilterAdd * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeFilterAdd;
+	CBInitFilterAddFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitFilterAdd(CBFilterAdd * self, CBByteArray * data){
+	CBInitMessageByObject(CBGetMessage(self));
+	CBRetainObject(data);
+	self->data = data;
+}
+void CBInitFilterAddFromData(CBFilterAdd * self, CBByteArray * data){
+	CBInitMessageByData(CBGetMessage(self), data);
+	self->data = NULL;
+}
+
+//  Destructor
+
+void CBDestroyFilterAdd(void * vself){
+	CBFilterAdd * self = vself;
+	if (self->data)
+		CBReleaseObject(self->data);
+	CBDestroyMessage(self);
+}
+void CBFreeFilterAdd(void * self){
+	CBDestroyFilterAdd(self);
+	free(self);
+}
+
+//  Functions
+
+int CBFilterAddCalculateLength(CBFilterAdd * self){
+	return CBVarIntSizeOf(self->data->length) + self->data->length;
+}
+int CBFilterAddDeserialise(CBFilterAdd * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBFilterAdd with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 1 || bytes->length < CBByteArrayReadVarIntSize(bytes, 0)) {
+		CBLogError("Attempting to deserialise a CBFilterAdd with less bytes than required for the data length.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt length = CBByteArrayReadVarInt(bytes, 0);
+	if (length.val > CB_FILTER_ADD_MAX_SIZE || bytes->length < length.size + length.val) {
+		CBLogError("Attempting to deserialise a CBFilterAdd with a bad data length.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (self->data)
+		CBReleaseObject(self->data);
+	self->data = CBNewByteArraySubReference(bytes, length.size, length.val);
+	return length.size + length.val;
+}
+void CBFilterAddPrepareBytes(CBFilterAdd * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBFilterAddCalculateLength(self));
+}
+int CBFilterAddSerialise(CBFilterAdd * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBFilterAdd with no bytes.");
+		return 0;
+	}
+	int length = CBFilterAddCalculateLength(self);
+	if (bytes->length < length) {
+		CBLogError("Attempting to serialise a CBFilterAdd with less bytes than required.");
+		return 0;
+	}
+	CBByteArraySetVarInt(bytes, 0, CBVarIntFromUInt64(self->data->length));
+	CBByteArrayCopyByteArray(bytes, CBVarIntSizeOf(self->data->length), self->data);
+	bytes->length = length;
+	CBGetMessage(self)->serialised = true;
+	return length;
+}
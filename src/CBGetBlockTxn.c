@@ -0,0 +1,134 @@
+//
+//  CBGetBlockTxn.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBGetBlockTxn.h"
+
+//  Constructors
+
+CBGetBlockTxn * CBNewGetBlockTxn(unsigned char * blockHash, int * indexes, int indexNum){
+	CBGetBlockTxn * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeGetBlockTxn;
+	CBInitGetBlockTxn(self, blockHash, indexes, indexNum);
+	return self;
+}
+CBGetBlockTxn * CBNewGetBlockTxnFromData(CBByteArray * data){
+	CBGetBlockTxn * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeGetBlockTxn;
+	CBInitGetBlockTxnFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitGetBlockTxn(CBGetBlockTxn * self, unsigned char * blockHash, int * indexes, int indexNum){
+	CBInitMessageByObject(CBGetMessage(self));
+	self->blockHash = CBNewByteArrayWithDataCopy(blockHash, 32);
+	self->indexNum = indexNum;
+	self->indexes = malloc(sizeof(*self->indexes) * indexNum);
+	memcpy(self->indexes, indexes, sizeof(*self->indexes) * indexNum);
+}
+void CBInitGetBlockTxnFromData(CBGetBlockTxn * self, CBByteArray * data){
+	CBInitMessageByData(CBGetMessage(self), data);
+	self->blockHash = NULL;
+	self->indexes = NULL;
+}
+
+//  Destructor
+
+void CBDestroyGetBlockTxn(void * vself){
+	CBGetBlockTxn * self = vself;
+	if (self->blockHash)
+		CBReleaseObject(self->blockHash);
+	free(self->indexes);
+	CBDestroyMessage(self);
+}
+void CBFreeGetBlockTxn(void * self){
+	CBDestroyGetBlockTxn(self);
+	free(self);
+}
+
+//  Functions
+
+int CBGetBlockTxnCalculateLength(CBGetBlockTxn * self){
+	int length = 32 + CBVarIntSizeOf(self->indexNum);
+	for (int x = 0; x < self->indexNum; x++)
+		length += CBVarIntSizeOf(self->indexes[x] - (x ? self->indexes[x - 1] + 1 : 0));
+	return length;
+}
+int CBGetBlockTxnDeserialise(CBGetBlockTxn * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBGetBlockTxn with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 33 || bytes->length < 32 + CBByteArrayReadVarIntSize(bytes, 32)) {
+		CBLogError("Attempting to deserialise a CBGetBlockTxn with less bytes than required for the hash and index number.");
+		return CB_DESERIALISE_ERROR;
+	}
+	CBVarInt num = CBByteArrayReadVarInt(bytes, 32);
+	int cursor = 32 + num.size;
+	if ((uint64_t)num.val > (uint64_t)(bytes->length - cursor)) {
+		CBLogError("Attempting to deserialise a CBGetBlockTxn with too many indexes for the byte data length.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->blockHash = CBNewByteArraySubReference(bytes, 0, 32);
+	self->indexNum = (int)num.val;
+	self->indexes = malloc(sizeof(*self->indexes) * self->indexNum);
+	uint64_t index = 0;
+	for (int x = 0; x < self->indexNum; x++) {
+		if (bytes->length < cursor + 1 || bytes->length < cursor + CBByteArrayReadVarIntSize(bytes, cursor)) {
+			CBLogError("Attempting to deserialise a CBGetBlockTxn with less bytes than required for an index.");
+			return CB_DESERIALISE_ERROR;
+		}
+		num = CBByteArrayReadVarInt(bytes, cursor);
+		cursor += num.size;
+		index += num.val;
+		if ((uint64_t)num.val > INT32_MAX || index > INT32_MAX) {
+			CBLogError("Attempting to deserialise a CBGetBlockTxn with an index which is too large.");
+			return CB_DESERIALISE_ERROR;
+		}
+		self->indexes[x] = (int)index++;
+	}
+	return cursor;
+}
+void CBGetBlockTxnPrepareBytes(CBGetBlockTxn * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBGetBlockTxnCalculateLength(self));
+}
+int CBGetBlockTxnSerialise(CBGetBlockTxn * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBGetBlockTxn with no bytes.");
+		return 0;
+	}
+	int length = CBGetBlockTxnCalculateLength(self);
+	if (bytes->length < length) {
+		CBLogError("Attempting to serialise a CBGetBlockTxn with less bytes than required.");
+		return 0;
+	}
+	CBByteArrayCopyByteArray(bytes, 0, self->blockHash);
+	CBByteArrayChangeReference(self->blockHash, bytes, 0);
+	int cursor = 32;
+	CBByteArraySetVarInt(bytes, cursor, CBVarIntFromUInt64(self->indexNum));
+	cursor += CBVarIntSizeOf(self->indexNum);
+	for (int x = 0; x < self->indexNum; x++) {
+		int diff = self->indexes[x] - (x ? self->indexes[x - 1] + 1 : 0);
+		CBByteArraySetVarInt(bytes, cursor, CBVarIntFromUInt64(diff));
+		cursor += CBVarIntSizeOf(diff);
+	}
+	bytes->length = length;
+	CBGetMessage(self)->serialised = true;
+	return length;
+}
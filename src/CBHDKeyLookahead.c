@@ -0,0 +1,233 @@
+//
+//  CBHDKeyLookahead.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBHDKeyLookahead.h"
+
+/**
+ @brief Does nothing as jobs have nothing to free.
+ @param job The CBHDKeyLookaheadJob.
+ */
+static void CBHDKeyLookaheadDestroyJob(void * job);
+/**
+ @brief Derives children of a chain until there are gap limit children after the last used child. Batches of children are derived without holding the mutex, and are only added if no other thread added them first.
+ @param self The CBHDKeyLookahead object.
+ @param chain The chain to extend.
+ @returns true on success, false if a child would be an invalid key.
+ */
+static bool CBHDKeyLookaheadExtend(CBHDKeyLookahead * self, CBHDKeyLookaheadChain * chain);
+/**
+ @brief Locks the mutex when chains are extended on the thread of the object.
+ @param self The CBHDKeyLookahead object.
+ */
+static void CBHDKeyLookaheadLock(CBHDKeyLookahead * self);
+/**
+ @brief Extends the chain of a job on the thread of the object.
+ @param queue The thread pool queue.
+ @param vjob The CBHDKeyLookaheadJob.
+ */
+static void CBHDKeyLookaheadProcess(CBThreadPoolQueue * queue, void * vjob);
+/**
+ @brief Unlocks the mutex when chains are extended on the thread of the object.
+ @param self The CBHDKeyLookahead object.
+ */
+static void CBHDKeyLookaheadUnlock(CBHDKeyLookahead * self);
+
+//  Constructor
+
+CBHDKeyLookahead * CBNewHDKeyLookahead(unsigned int gapLimit, bool background){
+	CBHDKeyLookahead * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeHDKeyLookahead;
+	CBInitHDKeyLookahead(self, gapLimit, background);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitHDKeyLookahead(CBHDKeyLookahead * self, unsigned int gapLimit, bool background){
+	CBInitObject(CBGetObject(self), false);
+	self->gapLimit = gapLimit;
+	self->chains = NULL;
+	self->chainNum = 0;
+	self->chunks = NULL;
+	self->chunkNum = 0;
+	self->entryNum = 0;
+	CBInitHash160Map(&self->hashes, gapLimit);
+	self->background = background;
+	if (background) {
+		CBInitThreadPoolQueue(&self->pool, 1, CBHDKeyLookaheadProcess, CBHDKeyLookaheadDestroyJob);
+		self->pool.object = self;
+		CBNewMutex(&self->mutex);
+	}
+}
+
+//  Destructor
+
+void CBDestroyHDKeyLookahead(void * vself){
+	CBHDKeyLookahead * self = vself;
+	if (self->background) {
+		CBDestroyThreadPoolQueue(&self->pool);
+		CBFreeMutex(self->mutex);
+	}
+	CBFreeHash160Map(&self->hashes);
+	for (int x = 0; x < self->chunkNum; x++)
+		free(self->chunks[x]);
+	free(self->chunks);
+	for (int x = 0; x < self->chainNum; x++) {
+		free(self->chains[x]->key);
+		free(self->chains[x]);
+	}
+	free(self->chains);
+}
+void CBFreeHDKeyLookahead(void * self){
+	CBDestroyHDKeyLookahead(self);
+	free(self);
+}
+
+//  Functions
+
+CBHDKeyLookaheadChain * CBHDKeyLookaheadAddChain(CBHDKeyLookahead * self, CBHDKey * key, unsigned int chainID, unsigned int used){
+	CBHDKeyLookaheadChain * chain = malloc(sizeof(*chain));
+	// Only the public key is needed for the hashes, so derive public children.
+	chain->key = CBNewHDKey(false);
+	chain->key->versionBytes = CBHDKeyGetNetwork(key->versionBytes) == CB_NETWORK_PRODUCTION ? CB_HD_KEY_VERSION_PROD_PUBLIC : CB_HD_KEY_VERSION_TEST_PUBLIC;
+	chain->key->childID = key->childID;
+	chain->key->depth = key->depth;
+	memcpy(chain->key->chainCode, key->chainCode, 32);
+	memcpy(chain->key->parentFingerprint, key->parentFingerprint, 4);
+	memcpy(&chain->key->keyPair->pubkey, &key->keyPair->pubkey, sizeof(CBPubKeyInfo));
+	chain->chainID = chainID;
+	chain->derived = 0;
+	chain->used = used;
+	chain->queued = false;
+	CBHDKeyLookaheadLock(self);
+	self->chains = realloc(self->chains, sizeof(*self->chains) * (self->chainNum + 1));
+	self->chains[self->chainNum++] = chain;
+	CBHDKeyLookaheadUnlock(self);
+	if (! CBHDKeyLookaheadExtend(self, chain))
+		return NULL;
+	return chain;
+}
+static void CBHDKeyLookaheadDestroyJob(void * job){
+	UNUSED(job);
+}
+static bool CBHDKeyLookaheadExtend(CBHDKeyLookahead * self, CBHDKeyLookaheadChain * chain){
+	CBHDKey * children[CB_HD_KEY_DERIVE_BATCH];
+	unsigned char * pubKeys[CB_HD_KEY_DERIVE_BATCH];
+	unsigned char hashes[CB_HD_KEY_DERIVE_BATCH * 20];
+	for (int x = 0; x < CB_HD_KEY_DERIVE_BATCH; x++) {
+		children[x] = CBNewHDKey(false);
+		pubKeys[x] = CBHDKeyGetPublicKey(children[x]);
+	}
+	bool ok = true;
+	for (;;) {
+		CBHDKeyLookaheadLock(self);
+		unsigned int start = chain->derived;
+		unsigned int end = chain->used + self->gapLimit;
+		CBHDKeyLookaheadUnlock(self);
+		if (start >= end)
+			break;
+		int num = end - start > CB_HD_KEY_DERIVE_BATCH ? CB_HD_KEY_DERIVE_BATCH : (int)(end - start);
+		CBHDKeyChildID firstChildID = {false, start};
+		if (! CBHDKeyDeriveChildren(chain->key, firstChildID, num, children, 0)) {
+			CBLogError("Could not derive children %u to %u of the chain %u for the lookahead.", start, start + num - 1, chain->chainID);
+			ok = false;
+			break;
+		}
+		CBHash160Batch(pubKeys, CB_PUBKEY_SIZE, num, hashes);
+		CBHDKeyLookaheadLock(self);
+		// Another thread may have added these children while the mutex was unlocked.
+		if (chain->derived == start) {
+			for (int x = 0; x < num; x++) {
+				if (self->entryNum == (unsigned int)self->chunkNum * CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE) {
+					self->chunks = realloc(self->chunks, sizeof(*self->chunks) * (self->chunkNum + 1));
+					self->chunks[self->chunkNum++] = malloc(sizeof(**self->chunks) * CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE);
+				}
+				CBHDKeyLookaheadEntry * entry = self->chunks[self->entryNum / CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE] + self->entryNum % CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE;
+				self->entryNum++;
+				memcpy(entry->hash, hashes + x * 20, 20);
+				entry->chain = chain;
+				entry->childNumber = start + x;
+				CBHash160MapInsert(&self->hashes, entry->hash, entry);
+			}
+			chain->derived = start + num;
+		}
+		CBHDKeyLookaheadUnlock(self);
+	}
+	for (int x = 0; x < CB_HD_KEY_DERIVE_BATCH; x++)
+		free(children[x]);
+	return ok;
+}
+CBHDKeyLookaheadEntry * CBHDKeyLookaheadFind(CBHDKeyLookahead * self, unsigned char * hash){
+	CBHDKeyLookaheadLock(self);
+	CBHDKeyLookaheadEntry * entry = CBHash160MapGet(&self->hashes, hash);
+	CBHDKeyLookaheadUnlock(self);
+	return entry;
+}
+CBHDKeyLookaheadEntry * CBHDKeyLookaheadFindScript(CBHDKeyLookahead * self, CBScript * script){
+	if (CBScriptIsKeyHash(script))
+		return CBHDKeyLookaheadFind(self, CBByteArrayGetData(script) + 3);
+	if (script->length == CB_PUBKEY_SIZE + 2 && CBScriptIsPubkey(script)) {
+		unsigned char hash[32];
+		CBSha256(CBByteArrayGetData(script) + 1, CB_PUBKEY_SIZE, hash);
+		CBRipemd160(hash, 32, hash);
+		return CBHDKeyLookaheadFind(self, hash);
+	}
+	return NULL;
+}
+static void CBHDKeyLookaheadLock(CBHDKeyLookahead * self){
+	if (self->background)
+		CBMutexLock(self->mutex);
+}
+bool CBHDKeyLookaheadMarkUsed(CBHDKeyLookahead * self, CBHDKeyLookaheadEntry * entry){
+	CBHDKeyLookaheadChain * chain = entry->chain;
+	CBHDKeyLookaheadLock(self);
+	if (entry->childNumber >= chain->used)
+		chain->used = entry->childNumber + 1;
+	if (chain->derived >= chain->used + self->gapLimit) {
+		CBHDKeyLookaheadUnlock(self);
+		return true;
+	}
+	if (! self->background)
+		return CBHDKeyLookaheadExtend(self, chain);
+	bool queue = ! chain->queued;
+	chain->queued = true;
+	CBHDKeyLookaheadUnlock(self);
+	if (queue) {
+		CBHDKeyLookaheadJob * job = malloc(sizeof(*job));
+		job->lookahead = self;
+		job->chain = chain;
+		CBThreadPoolQueueAdd(&self->pool, &job->base);
+	}
+	return true;
+}
+static void CBHDKeyLookaheadProcess(CBThreadPoolQueue * queue, void * vjob){
+	UNUSED(queue);
+	CBHDKeyLookaheadJob * job = vjob;
+	CBHDKeyLookahead * self = job->lookahead;
+	// Later uses of the chain need another job once this job has read the last used child.
+	CBMutexLock(self->mutex);
+	job->chain->queued = false;
+	CBMutexUnlock(self->mutex);
+	CBHDKeyLookaheadExtend(self, job->chain);
+}
+static void CBHDKeyLookaheadUnlock(CBHDKeyLookahead * self){
+	if (self->background)
+		CBMutexUnlock(self->mutex);
+}
+void CBHDKeyLookaheadWaitUntilExtended(CBHDKeyLookahead * self){
+	if (self->background)
+		CBThreadPoolQueueWaitUntilFinished(&self->pool);
+}
@@ -18,6 +18,40 @@
 
 unsigned char CB_CURVE_ORDER[32] = {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFE,0xBA,0xAE,0xDC,0xE6,0xAF,0x48,0xA0,0x3B,0xBF,0xD2,0x5E,0x8C,0xD0,0x36,0x41,0x41};
 
+/**
+ @brief A range of children for CBHDKeyDeriveChildren.
+ */
+typedef struct{
+	CBHDKey * parentKey;
+	CBHDKeyChildID firstChildID;
+	int count;
+	CBHDKey ** children;
+	unsigned char * midstate; /**< The HMAC-SHA512 midstate for the chain code of the parent. */
+	unsigned char fingerprint[4]; /**< The fingerprint of the parent. */
+	bool ok;
+	CBDepObject thread;
+} CBHDKeyDeriveJob;
+
+/**
+ @brief Adds two private keys modulo the curve order.
+ @param a The first 32 byte big-endian number.
+ @param b The second 32 byte big-endian number.
+ @param result The sum is written here.
+ @returns false if the sum is zero, true otherwise.
+ */
+static bool CBHDKeyAddPrivateKeys(unsigned char * a, unsigned char * b, unsigned char * result);
+/**
+ @brief Derives a range of children.
+ @param job The range.
+ @returns true on success, false if a child would be an invalid key.
+ */
+static bool CBHDKeyDeriveRange(CBHDKeyDeriveJob * job);
+/**
+ @brief Derives a range of children on a thread, setting the ok field of the job.
+ @param vjob The CBHDKeyDeriveJob.
+ */
+static void CBHDKeyDeriveThread(void * vjob);
+
 CBHDKey * CBNewHDKey(bool priv) {
 
 	CBHDKey * key = malloc(sizeof(*key) + (priv ? sizeof(CBKeyPair) : sizeof(CBPubKeyInfo)));
@@ -156,32 +190,15 @@ bool CBHDKeyDeriveChild(CBHDKey * parentKey, CBHDKeyChildID childID, CBHDKey * c
 	// Set depth
 	childKey->depth = parentKey->depth + 1;
 
+	// The child key may have been used for another key
+	childKey->keyPair->pubkey.hashSet = false;
+
 	// Calculate key
 	if (type == CB_HD_KEY_TYPE_PRIVATE) {
 
 		// Calculating the private key
 		// Add private key to first 32 bytes and modulo the order the curve
-		// Split into four 64bit integers and add each one
-		bool overflow = 0;
-		for (int x = 4; x--;) {
-			unsigned long long int a = CBArrayToInt64BigEndian(hash, 8*x);
-			unsigned long long int b = CBArrayToInt64BigEndian(CBHDKeyGetPrivateKey(parentKey), 8*x) + overflow;
-			unsigned long long int c = a + b;
-			overflow = (c < b)? 1 : 0;
-			CBInt64ToArrayBigEndian(CBHDKeyGetPrivateKey(childKey), 8*x, c);
-		}
-
-		if (overflow || memcmp(CBHDKeyGetPrivateKey(childKey), CB_CURVE_ORDER, 32) > 0) {
-			// Take away CB_CURVE_ORDER
-			bool carry = 0;
-			for (int x = 4; x--;) {
-				unsigned long long int a = CBArrayToInt64BigEndian(CBHDKeyGetPrivateKey(childKey), 8*x);
-				unsigned long long int b = CBArrayToInt64BigEndian(CB_CURVE_ORDER, 8*x) + carry;
-				carry = a < b;
-				a -= b;
-				CBInt64ToArrayBigEndian(CBHDKeyGetPrivateKey(childKey), 8*x, a);
-			}
-		}
+		CBHDKeyAddPrivateKeys(hash, CBHDKeyGetPrivateKey(parentKey), CBHDKeyGetPrivateKey(childKey));
 
 		// Derive public key from private key
 		CBKeyGetPublicKey(childKey->keyPair->privkey, CBHDKeyGetPublicKey(childKey));
@@ -200,6 +217,165 @@ bool CBHDKeyDeriveChild(CBHDKey * parentKey, CBHDKeyChildID childID, CBHDKey * c
 
 }
 
+bool CBHDKeyDeriveChildren(CBHDKey * parentKey, CBHDKeyChildID firstChildID, int count, CBHDKey ** children, int numThreads) {
+
+	CBHDKeyType type = CBHDKeyGetType(parentKey->versionBytes);
+
+	if (type == CB_HD_KEY_TYPE_UNKNOWN || (firstChildID.priv && type != CB_HD_KEY_TYPE_PRIVATE)) {
+		CBLogError("Attempting to derive children from an unknown key, or private children from a public key.");
+		return false;
+	}
+
+	if ((unsigned int)firstChildID.childNumber + count > 0x80000000) {
+		CBLogError("Attempting to derive children past the last child number.");
+		return false;
+	}
+
+	// The padded chain code blocks are hashed once for all children.
+	unsigned char midstate[CB_HMAC_SHA512_MIDSTATE_SIZE];
+	CBHmacSha512Midstate(parentKey->chainCode, 32, midstate);
+
+	CBHDKeyDeriveJob job = {parentKey, firstChildID, count, children, midstate, {0}, true, {NULL}};
+	memcpy(job.fingerprint, CBHDKeyGetHash(parentKey), 4);
+
+	if (numThreads > count)
+		numThreads = count;
+
+	if (numThreads < 2)
+		return CBHDKeyDeriveRange(&job);
+
+	// Give each thread a consecutive range of children.
+	CBHDKeyDeriveJob * jobs = malloc(sizeof(*jobs) * numThreads);
+	int start = 0;
+	for (int x = 0; x < numThreads; x++) {
+		jobs[x] = job;
+		jobs[x].firstChildID.childNumber += start;
+		jobs[x].children += start;
+		jobs[x].count = count / numThreads + (x < count % numThreads);
+		start += jobs[x].count;
+		CBNewThread(&jobs[x].thread, CBHDKeyDeriveThread, &jobs[x]);
+	}
+
+	bool ok = true;
+	for (int x = 0; x < numThreads; x++) {
+		CBThreadJoin(jobs[x].thread);
+		CBFreeThread(jobs[x].thread);
+		ok &= jobs[x].ok;
+	}
+	free(jobs);
+
+	return ok;
+
+}
+
+static bool CBHDKeyAddPrivateKeys(unsigned char * a, unsigned char * b, unsigned char * result) {
+
+	// Split into four 64bit integers and add each one
+	bool overflow = 0;
+	for (int x = 4; x--;) {
+		unsigned long long int c = CBArrayToInt64BigEndian(a, 8*x);
+		unsigned long long int d = CBArrayToInt64BigEndian(b, 8*x) + overflow;
+		unsigned long long int e = c + d;
+		overflow = (e < d || (overflow && d == 0))? 1 : 0;
+		CBInt64ToArrayBigEndian(result, 8*x, e);
+	}
+
+	if (overflow || memcmp(result, CB_CURVE_ORDER, 32) >= 0) {
+		// Take away CB_CURVE_ORDER
+		bool carry = 0;
+		for (int x = 4; x--;) {
+			unsigned long long int c = CBArrayToInt64BigEndian(result, 8*x);
+			unsigned long long int d = CBArrayToInt64BigEndian(CB_CURVE_ORDER, 8*x) + carry;
+			carry = c < d || (carry && d == 0);
+			CBInt64ToArrayBigEndian(result, 8*x, c - d);
+		}
+	}
+
+	for (int x = 0; x < 32; x++)
+		if (result[x])
+			return true;
+
+	return false;
+
+}
+
+static bool CBHDKeyDeriveRange(CBHDKeyDeriveJob * job) {
+
+	CBHDKey * parentKey = job->parentKey;
+	bool privateParent = CBHDKeyGetType(parentKey->versionBytes) == CB_HD_KEY_TYPE_PRIVATE;
+	unsigned char inputData[37], hash[64];
+	unsigned char scalars[CB_HD_KEY_DERIVE_BATCH][CB_PRIVKEY_SIZE], pubKeys[CB_HD_KEY_DERIVE_BATCH][CB_PUBKEY_SIZE];
+
+	// Only the child number changes in the HMAC input.
+	if (job->firstChildID.priv) {
+		inputData[0] = 0;
+		memcpy(inputData + 1, CBHDKeyGetPrivateKey(parentKey), 32);
+	}else
+		memcpy(inputData, CBHDKeyGetPublicKey(parentKey), 33);
+
+	for (int x = 0; x < job->count; x += CB_HD_KEY_DERIVE_BATCH) {
+
+		int batchNum = job->count - x < CB_HD_KEY_DERIVE_BATCH ? job->count - x : CB_HD_KEY_DERIVE_BATCH;
+
+		for (int y = 0; y < batchNum; y++) {
+
+			CBHDKey * childKey = job->children[x + y];
+			childKey->childID.priv = job->firstChildID.priv;
+			childKey->childID.childNumber = job->firstChildID.childNumber + x + y;
+			CBInt32ToArrayBigEndian(inputData, 33, CBHDKeyGetChildNumber(childKey->childID));
+			CBHmacSha512FromMidstate(job->midstate, inputData, 37, hash);
+
+			if (memcmp(hash, CB_CURVE_ORDER, 32) >= 0) {
+				CBLogError("The child %u is an invalid key.", childKey->childID.childNumber);
+				return false;
+			}
+
+			memcpy(childKey->chainCode, hash + 32, 32);
+			childKey->versionBytes = parentKey->versionBytes;
+			childKey->depth = parentKey->depth + 1;
+			memcpy(childKey->parentFingerprint, job->fingerprint, 4);
+			childKey->keyPair->pubkey.hashSet = false;
+
+			if (privateParent) {
+				if (! CBHDKeyAddPrivateKeys(hash, CBHDKeyGetPrivateKey(parentKey), CBHDKeyGetPrivateKey(childKey))) {
+					CBLogError("The child %u is an invalid key.", childKey->childID.childNumber);
+					return false;
+				}
+				memcpy(scalars[y], CBHDKeyGetPrivateKey(childKey), 32);
+			}else
+				memcpy(scalars[y], hash, 32);
+
+		}
+
+		// Make the public keys of the batch together.
+		if (privateParent)
+			CBKeyGetPublicKeys(scalars[0], batchNum, pubKeys[0]);
+		else if (! CBKeyTweakPublicKeys(CBHDKeyGetPublicKey(parentKey), scalars[0], batchNum, pubKeys[0])) {
+			CBLogError("The parent public key is invalid.");
+			return false;
+		}
+
+		for (int y = 0; y < batchNum; y++) {
+			if (! pubKeys[y][0]) {
+				CBLogError("The child %u is the point at infinity.", job->firstChildID.childNumber + x + y);
+				return false;
+			}
+			memcpy(CBHDKeyGetPublicKey(job->children[x + y]), pubKeys[y], 33);
+		}
+
+	}
+
+	return true;
+
+}
+
+static void CBHDKeyDeriveThread(void * vjob) {
+
+	CBHDKeyDeriveJob * job = vjob;
+	job->ok = CBHDKeyDeriveRange(job);
+
+}
+
 bool CBHDKeyGenerateMaster(CBHDKey * key, bool production) {
 
 	key->versionBytes = production ? CB_HD_KEY_VERSION_PROD_PRIVATE : CB_HD_KEY_VERSION_TEST_PRIVATE;
@@ -351,6 +527,7 @@ bool CBKeyPairGenerate(CBKeyPair * keyPair) {
 
 	// Get public key
 	CBKeyGetPublicKey(keyPair->privkey, keyPair->pubkey.key);
+	keyPair->pubkey.hashSet = false;
 
 	return true;
 
@@ -362,6 +539,7 @@ unsigned char * CBKeyPairGetHash(CBKeyPair * key) {
 		unsigned char hash[32];
 		CBSha256(key->pubkey.key, 33, hash);
 		CBRipemd160(hash, 32, key->pubkey.hash);
+		key->pubkey.hashSet = true;
 	}
 
 	return key->pubkey.hash;
@@ -379,3 +557,35 @@ void CBKeyPairGetNext(CBKeyPair * key) {
 
 }
 
+void CBKeyPairGetNextKeys(CBKeyPair * key, int num, CBKeyPair * keys) {
+
+	unsigned char * pubKeys = malloc(num * CB_PUBKEY_SIZE);
+	unsigned char * hashes = malloc(num * 20);
+	unsigned char ** hashData = malloc(sizeof(*hashData) * num);
+
+	// Get the public keys together
+	CBKeyGetNextPublicKeys(key->pubkey.key, num, pubKeys);
+
+	unsigned char * privKey = key->privkey;
+	for (int x = 0; x < num; x++) {
+		// Increment the private key
+		memcpy(keys[x].privkey, privKey, CB_PRIVKEY_SIZE);
+		for (int y = CB_PRIVKEY_SIZE - 1; ++keys[x].privkey[y--] == 0;);
+		privKey = keys[x].privkey;
+		memcpy(keys[x].pubkey.key, pubKeys + x * CB_PUBKEY_SIZE, CB_PUBKEY_SIZE);
+		hashData[x] = keys[x].pubkey.key;
+	}
+
+	// Hash the public keys together
+	CBHash160Batch(hashData, CB_PUBKEY_SIZE, num, hashes);
+	for (int x = 0; x < num; x++) {
+		memcpy(keys[x].pubkey.hash, hashes + x * 20, 20);
+		keys[x].pubkey.hashSet = true;
+	}
+
+	free(pubKeys);
+	free(hashes);
+	free(hashData);
+
+}
+
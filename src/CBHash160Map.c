@@ -0,0 +1,109 @@
+//
+//  CBHash160Map.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBHash160Map.h"
+
+/**
+ @brief Gets the slot where the search for a key starts.
+ @param self The CBHash160Map.
+ @param hash The 20 byte key.
+ @returns The index of the slot.
+ */
+static unsigned int CBHash160MapGetHome(CBHash160Map * self, unsigned char * hash);
+/**
+ @brief Finds the slot of a key or the empty slot where it would be inserted.
+ @param self The CBHash160Map.
+ @param hash The 20 byte key.
+ @returns The slot.
+ */
+static CBHash160MapEntry * CBHash160MapGetSlot(CBHash160Map * self, unsigned char * hash);
+/**
+ @brief Doubles the number of slots and inserts the keys again.
+ @param self The CBHash160Map.
+ */
+static void CBHash160MapGrow(CBHash160Map * self);
+
+//  Initialiser
+
+void CBInitHash160Map(CBHash160Map * self, unsigned int num){
+	self->capacity = CB_HASH160_MAP_MIN_CAPACITY;
+	while (self->capacity < num * 2)
+		self->capacity *= 2;
+	self->entries = calloc(self->capacity, sizeof(*self->entries));
+	self->num = 0;
+}
+
+//  Destructor
+
+void CBFreeHash160Map(CBHash160Map * self){
+	free(self->entries);
+}
+
+//  Functions
+
+void * CBHash160MapGet(CBHash160Map * self, unsigned char * hash){
+	return CBHash160MapGetSlot(self, hash)->value;
+}
+static unsigned int CBHash160MapGetHome(CBHash160Map * self, unsigned char * hash){
+	return (hash[0] | (unsigned int)hash[1] << 8 | (unsigned int)hash[2] << 16 | (unsigned int)hash[3] << 24) & (self->capacity - 1);
+}
+static CBHash160MapEntry * CBHash160MapGetSlot(CBHash160Map * self, unsigned char * hash){
+	unsigned int x = CBHash160MapGetHome(self, hash);
+	while (self->entries[x].value && memcmp(self->entries[x].hash, hash, 20))
+		x = (x + 1) & (self->capacity - 1);
+	return self->entries + x;
+}
+static void CBHash160MapGrow(CBHash160Map * self){
+	CBHash160MapEntry * old = self->entries;
+	unsigned int oldCapacity = self->capacity;
+	self->capacity *= 2;
+	self->entries = calloc(self->capacity, sizeof(*self->entries));
+	for (unsigned int x = 0; x < oldCapacity; x++)
+		if (old[x].value)
+			*CBHash160MapGetSlot(self, old[x].hash) = old[x];
+	free(old);
+}
+bool CBHash160MapInsert(CBHash160Map * self, unsigned char * hash, void * value){
+	if ((self->num + 1) * 2 > self->capacity)
+		CBHash160MapGrow(self);
+	CBHash160MapEntry * slot = CBHash160MapGetSlot(self, hash);
+	bool added = slot->value == NULL;
+	memcpy(slot->hash, hash, 20);
+	slot->value = value;
+	if (added)
+		self->num++;
+	return added;
+}
+void * CBHash160MapRemove(CBHash160Map * self, unsigned char * hash){
+	CBHash160MapEntry * slot = CBHash160MapGetSlot(self, hash);
+	void * value = slot->value;
+	if (! value)
+		return NULL;
+	self->num--;
+	// Move back later keys of the cluster which would no longer be found past the empty slot.
+	unsigned int mask = self->capacity - 1;
+	unsigned int empty = (unsigned int)(slot - self->entries);
+	for (unsigned int x = (empty + 1) & mask; self->entries[x].value; x = (x + 1) & mask) {
+		unsigned int home = CBHash160MapGetHome(self, self->entries[x].hash);
+		// The key can move when its home is not in the cyclic range after the empty slot up to its slot.
+		if (((x - home) & mask) >= ((x - empty) & mask)) {
+			self->entries[empty] = self->entries[x];
+			empty = x;
+		}
+	}
+	self->entries[empty].value = NULL;
+	return value;
+}
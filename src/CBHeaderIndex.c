@@ -0,0 +1,234 @@
+//
+//  CBHeaderIndex.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBHeaderIndex.h"
+
+static unsigned char CBHeaderIndexHashKeySize = 32;
+
+/**
+ @brief Adds a header onto the tip of the index without any checks.
+ @param self The CBHeaderIndex object.
+ @param header The 80 byte header.
+ @param hash The 32 byte hash of the header.
+ */
+static void CBHeaderIndexAppend(CBHeaderIndex * self, unsigned char * header, unsigned char * hash);
+/**
+ @brief Calculates the hash of a header.
+ @param header The 80 byte header.
+ @param hash The 32 byte hash is written here.
+ */
+static void CBHeaderIndexCalculateHash(unsigned char * header, unsigned char * hash);
+/**
+ @brief Gets the height of the first block to send for a "getblocks" or "getheaders" request.
+ @param self The CBHeaderIndex object.
+ @param request The request.
+ @param stop Set to the entry of the stop hash, or NULL if the stop hash is not in the index or not given.
+ @returns The height after the fork point.
+ */
+static unsigned int CBHeaderIndexGetStart(CBHeaderIndex * self, CBGetBlocks * request, CBHeaderIndexEntry ** stop);
+
+//  Constructor
+
+CBHeaderIndex * CBNewHeaderIndex(unsigned char * firstHeader, unsigned int firstHeight){
+	CBHeaderIndex * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeHeaderIndex;
+	CBInitHeaderIndex(self, firstHeader, firstHeight);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitHeaderIndex(CBHeaderIndex * self, unsigned char * firstHeader, unsigned int firstHeight){
+	CBInitObject(CBGetObject(self), false);
+	CBInitAssociativeArray(&self->hashes, CBFixedKeyCompare, &CBHeaderIndexHashKeySize, NULL);
+	self->chunks = NULL;
+	self->chunkNum = 0;
+	self->firstHeight = firstHeight;
+	self->headerNum = 0;
+	CBHeaderIndexLoadHeader(self, firstHeader);
+}
+
+//  Destructor
+
+void CBDestroyHeaderIndex(void * vself){
+	CBHeaderIndex * self = vself;
+	CBFreeAssociativeArray(&self->hashes);
+	for (int x = 0; x < self->chunkNum; x++)
+		free(self->chunks[x]);
+	free(self->chunks);
+}
+void CBFreeHeaderIndex(void * self){
+	CBDestroyHeaderIndex(self);
+	free(self);
+}
+
+//  Functions
+
+bool CBHeaderIndexAddHeader(CBHeaderIndex * self, unsigned char * header){
+	if (memcmp(CBBlockHeaderGetPrevBlockHash(header), CBHeaderIndexGetTip(self)->hash, 32))
+		return false;
+	unsigned char hash[32];
+	CBHeaderIndexCalculateHash(header, hash);
+	if (! CBValidateProofOfWork(hash, CBBlockHeaderGetTarget(header)))
+		return false;
+	CBHeaderIndexAppend(self, header, hash);
+	return true;
+}
+int CBHeaderIndexAddHeaders(CBHeaderIndex * self, CBBlockHeaders * headers){
+	int added = 0;
+	unsigned char hash[32];
+	for (int x = 0; x < headers->headerNum; x++) {
+		unsigned char * header = CBBlockHeadersGetHeader(headers, x);
+		CBBlockHeadersCalculateHash(headers, x, hash);
+		if (! added && CBHeaderIndexFind(self, hash))
+			// Already have this header
+			continue;
+		if (memcmp(CBBlockHeaderGetPrevBlockHash(header), CBHeaderIndexGetTip(self)->hash, 32)
+			|| ! CBValidateProofOfWork(hash, CBBlockHeaderGetTarget(header)))
+			break;
+		CBHeaderIndexAppend(self, header, hash);
+		added++;
+	}
+	return added;
+}
+static void CBHeaderIndexAppend(CBHeaderIndex * self, unsigned char * header, unsigned char * hash){
+	if (self->headerNum == (unsigned int)self->chunkNum * CB_HEADER_INDEX_CHUNK_SIZE) {
+		self->chunks = realloc(self->chunks, sizeof(*self->chunks) * (self->chunkNum + 1));
+		self->chunks[self->chunkNum++] = malloc(sizeof(**self->chunks) * CB_HEADER_INDEX_CHUNK_SIZE);
+	}
+	CBHeaderIndexEntry * entry = self->chunks[self->headerNum / CB_HEADER_INDEX_CHUNK_SIZE] + self->headerNum % CB_HEADER_INDEX_CHUNK_SIZE;
+	memcpy(entry->hash, hash, 32);
+	memcpy(entry->header, header, 80);
+	CBCalculateBlockWorkUInt256(&entry->chainWork, CBBlockHeaderGetTarget(header));
+	if (self->headerNum)
+		CBUInt256EqualsAdditionByUInt256(&entry->chainWork, &CBHeaderIndexGetTip(self)->chainWork);
+	entry->height = self->firstHeight + self->headerNum++;
+	CBFindResult res = CBAssociativeArrayFind(&self->hashes, entry);
+	CBAssociativeArrayInsert(&self->hashes, entry, res.position, NULL);
+}
+static void CBHeaderIndexCalculateHash(unsigned char * header, unsigned char * hash){
+	unsigned char hash1[32];
+	CBSha256(header, 80, hash1);
+	CBSha256(hash1, 32, hash);
+}
+CBHeaderIndexEntry * CBHeaderIndexFind(CBHeaderIndex * self, unsigned char * hash){
+	CBFindResult res = CBAssociativeArrayFind(&self->hashes, hash);
+	if (! res.found)
+		return NULL;
+	return CBFindResultToPointer(res);
+}
+CBHeaderIndexEntry * CBHeaderIndexFindFork(CBHeaderIndex * self, CBChainDescriptor * locator){
+	for (int x = 0; x < locator->hashNum; x++) {
+		if (locator->hashes[x]->length != 32)
+			continue;
+		CBHeaderIndexEntry * entry = CBHeaderIndexFind(self, CBByteArrayGetData(locator->hashes[x]));
+		if (entry)
+			return entry;
+	}
+	return CBHeaderIndexGetEntry(self, self->firstHeight);
+}
+CBInventory * CBHeaderIndexGetBlocksInventory(CBHeaderIndex * self, CBGetBlocks * request){
+	CBHeaderIndexEntry * stop;
+	unsigned int start = CBHeaderIndexGetStart(self, request, &stop);
+	unsigned int end = self->firstHeight + self->headerNum;
+	if (end - start > CB_HEADER_INDEX_MAX_INV)
+		end = start + CB_HEADER_INDEX_MAX_INV;
+	if (stop && stop->height >= start && stop->height < end)
+		end = stop->height + 1;
+	if (start >= end)
+		return NULL;
+	// Serialise the inventory directly from the hashes.
+	CBVarInt num = CBVarIntFromUInt64(end - start);
+	CBByteArray * bytes = CBNewByteArrayOfSize(num.size + (end - start) * 36);
+	CBByteArraySetVarInt(bytes, 0, num);
+	int cursor = num.size;
+	for (unsigned int x = start; x < end; x++, cursor += 36) {
+		CBByteArraySetInt32(bytes, cursor, CB_INVENTORY_ITEM_BLOCK);
+		CBByteArraySetBytes(bytes, cursor + 4, CBHeaderIndexGetEntry(self, x)->hash, 32);
+	}
+	CBInventory * inv = CBNewInventoryFromData(bytes);
+	CBReleaseObject(bytes);
+	CBGetMessage(inv)->type = CB_MESSAGE_TYPE_INV;
+	return inv;
+}
+CBHeaderIndexEntry * CBHeaderIndexGetEntry(CBHeaderIndex * self, unsigned int height){
+	if (height < self->firstHeight || height - self->firstHeight >= self->headerNum)
+		return NULL;
+	height -= self->firstHeight;
+	return self->chunks[height / CB_HEADER_INDEX_CHUNK_SIZE] + height % CB_HEADER_INDEX_CHUNK_SIZE;
+}
+CBBlockHeaders * CBHeaderIndexGetHeaders(CBHeaderIndex * self, CBGetBlocks * request){
+	CBBlockHeaders * headers = CBNewBlockHeaders();
+	CBGetMessage(headers)->type = CB_MESSAGE_TYPE_HEADERS;
+	CBHeaderIndexEntry * stop;
+	unsigned int start = CBHeaderIndexGetStart(self, request, &stop);
+	unsigned int end = self->firstHeight + self->headerNum;
+	if (! request->chainDescriptor || ! request->chainDescriptor->hashNum) {
+		// Only the header for the stop hash
+		if (stop)
+			CBBlockHeadersAddHeader(headers, stop->header, 0);
+		return headers;
+	}
+	if (end - start > CB_BLOCK_HEADERS_MAX_NUM)
+		end = start + CB_BLOCK_HEADERS_MAX_NUM;
+	if (stop && stop->height >= start && stop->height < end)
+		end = stop->height + 1;
+	for (unsigned int x = start; x < end; x++)
+		CBBlockHeadersAddHeader(headers, CBHeaderIndexGetEntry(self, x)->header, 0);
+	return headers;
+}
+CBChainDescriptor * CBHeaderIndexGetLocator(CBHeaderIndex * self, unsigned int height){
+	if (! CBHeaderIndexGetEntry(self, height))
+		return NULL;
+	CBChainDescriptor * locator = CBNewChainDescriptor();
+	unsigned int step = 1;
+	for (;;) {
+		CBChainDescriptorTakeHash(locator, CBNewByteArrayWithDataCopy(CBHeaderIndexGetEntry(self, height)->hash, 32));
+		if (height == self->firstHeight)
+			break;
+		if (locator->hashNum >= CB_HEADER_INDEX_LOCATOR_DENSE)
+			step *= 2;
+		height = height - self->firstHeight > step ? height - step : self->firstHeight;
+	}
+	return locator;
+}
+void CBHeaderIndexLoadHeader(CBHeaderIndex * self, unsigned char * header){
+	unsigned char hash[32];
+	CBHeaderIndexCalculateHash(header, hash);
+	CBHeaderIndexAppend(self, header, hash);
+}
+static unsigned int CBHeaderIndexGetStart(CBHeaderIndex * self, CBGetBlocks * request, CBHeaderIndexEntry ** stop){
+	*stop = NULL;
+	if (request->stopAtHash && request->stopAtHash->length == 32)
+		*stop = CBHeaderIndexFind(self, CBByteArrayGetData(request->stopAtHash));
+	if (! request->chainDescriptor)
+		return self->firstHeight + 1;
+	return CBHeaderIndexFindFork(self, request->chainDescriptor)->height + 1;
+}
+CBHeaderIndexEntry * CBHeaderIndexGetTip(CBHeaderIndex * self){
+	return CBHeaderIndexGetEntry(self, self->firstHeight + self->headerNum - 1);
+}
+bool CBHeaderIndexTruncate(CBHeaderIndex * self, unsigned int height){
+	if (! CBHeaderIndexGetEntry(self, height))
+		return false;
+	unsigned int num = height - self->firstHeight + 1;
+	for (unsigned int x = height + 1; x < self->firstHeight + self->headerNum; x++) {
+		CBFindResult res = CBAssociativeArrayFind(&self->hashes, CBHeaderIndexGetEntry(self, x));
+		CBAssociativeArrayDelete(&self->hashes, res.position, false);
+	}
+	self->headerNum = num;
+	return true;
+}
@@ -0,0 +1,465 @@
+//
+//  CBMempool.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBMempool.h"
+
+static unsigned char CBMempoolHashKeySize = 32;
+static unsigned char CBMempoolOutPointKeySize = CB_OUTPOINT_KEY_SIZE;
+
+/**
+ @brief Compares two transactions by ancestor fee rate and then hash.
+ */
+static CBCompare CBMempoolCompareAncestorScore(CBAssociativeArray * array, void * vtx1, void * vtx2);
+/**
+ @brief Compares two transactions by descendant fee rate and then hash.
+ */
+static CBCompare CBMempoolCompareDescendantScore(CBAssociativeArray * array, void * vtx1, void * vtx2);
+/**
+ @brief Compares two fee rates and then two hashes.
+ */
+static CBCompare CBMempoolCompareScores(unsigned long long int score1, unsigned long long int score2, unsigned char * hash1, unsigned char * hash2);
+/**
+ @brief Deletes an element which is in an array.
+ @param array The array.
+ @param element The element, which is used to find its position.
+ */
+static void CBMempoolDelete(CBAssociativeArray * array, void * element);
+/**
+ @brief Frees a transaction in the pool.
+ @param vtx The CBMempoolTransaction.
+ */
+static void CBFreeMempoolTransaction(void * vtx);
+/**
+ @brief Gets the ancestors of transactions with the given parents.
+ @param self The CBMempool object.
+ @param parents The parents.
+ @param parentNum The number of parents.
+ @param ancestors The array to fill with the ancestors.
+ @param max The maximum number of ancestors to find.
+ @returns The number of ancestors, or -1 if there are more than max.
+ */
+static int CBMempoolGetAncestors(CBMempool * self, CBMempoolTransaction ** parents, int parentNum, CBMempoolTransaction ** ancestors, int max);
+/**
+ @brief Gets the descendants of a transaction, not including the transaction.
+ @param self The CBMempool object.
+ @param tx The transaction.
+ @param descendants The array to fill with the descendants, with at least tx->descendantNum - 1 elements.
+ @returns The number of descendants.
+ */
+static int CBMempoolGetDescendants(CBMempool * self, CBMempoolTransaction * tx, CBMempoolTransaction ** descendants);
+/**
+ @brief Gets a new mark for searching ancestors and descendants.
+ @param self The CBMempool object.
+ @returns The mark.
+ */
+static unsigned int CBMempoolNewMark(CBMempool * self);
+/**
+ @brief Inserts a transaction into the fee rate orderings after calculating the fee rates.
+ @param self The CBMempool object.
+ @param tx The transaction.
+ */
+static void CBMempoolScoresInsert(CBMempool * self, CBMempoolTransaction * tx);
+/**
+ @brief Removes a transaction from the fee rate orderings. This must be done before changing the ancestor or descendant totals.
+ @param self The CBMempool object.
+ @param tx The transaction.
+ */
+static void CBMempoolScoresRemove(CBMempool * self, CBMempoolTransaction * tx);
+/**
+ @brief Removes a single transaction from the pool and frees it, updating the totals of its ancestors and descendants, which remain in the pool.
+ @param self The CBMempool object.
+ @param tx The transaction.
+ */
+static void CBMempoolUnlinkTransaction(CBMempool * self, CBMempoolTransaction * tx);
+
+//  Constructor
+
+CBMempool * CBNewMempool(unsigned long long int maxSize, unsigned long long int minFeeRate){
+	CBMempool * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeMempool;
+	CBInitMempool(self, maxSize, minFeeRate);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitMempool(CBMempool * self, unsigned long long int maxSize, unsigned long long int minFeeRate){
+	CBInitObject(CBGetObject(self), false);
+	CBInitAssociativeArray(&self->transactions, CBFixedKeyCompare, &CBMempoolHashKeySize, CBFreeMempoolTransaction);
+	CBInitAssociativeArray(&self->spends, CBFixedKeyCompare, &CBMempoolOutPointKeySize, NULL);
+	CBInitAssociativeArray(&self->ancestorScores, CBMempoolCompareAncestorScore, NULL, NULL);
+	CBInitAssociativeArray(&self->descendantScores, CBMempoolCompareDescendantScore, NULL, NULL);
+	self->transactionNum = 0;
+	self->size = 0;
+	self->maxSize = maxSize;
+	self->minFeeRate = minFeeRate;
+	self->mark = 0;
+}
+
+//  Destructor
+
+void CBDestroyMempool(void * vself){
+	CBMempool * self = vself;
+	CBFreeAssociativeArray(&self->spends);
+	CBFreeAssociativeArray(&self->ancestorScores);
+	CBFreeAssociativeArray(&self->descendantScores);
+	CBFreeAssociativeArray(&self->transactions);
+}
+void CBFreeMempool(void * self){
+	CBDestroyMempool(self);
+	free(self);
+}
+static void CBFreeMempoolTransaction(void * vtx){
+	CBMempoolTransaction * tx = vtx;
+	free(tx->children);
+	free(tx);
+}
+
+//  Functions
+
+CBMempoolResult CBMempoolAddTransaction(CBMempool * self, CBTransaction * tx, CBUnspentOutputSet * set, unsigned int height, unsigned int time){
+	long long int outputValue;
+	if (CBTransactionIsCoinBase(tx) || ! CBTransactionValidateBasic(tx, false, &outputValue))
+		return CB_MEMPOOL_INVALID;
+	unsigned char * hash = CBTransactionGetHash(tx);
+	if (CBMempoolGetTransaction(self, hash))
+		return CB_MEMPOOL_ALREADY_HAVE;
+	// The transaction must be able to go into the next block.
+	if (! CBTransactionIsFinal(tx, time, height + 1))
+		return CB_MEMPOOL_NOT_FINAL;
+	int sigOps = CBTransactionGetSigOps(tx);
+	if (sigOps > CB_MEMPOOL_MAX_TX_SIG_OPS)
+		return CB_MEMPOOL_TOO_MANY_SIGOPS;
+	int size = CBGetMessage(tx)->bytes->length;
+	// Allocate the entry with the spent outputs, parents and serialised data together.
+	CBMempoolTransaction * entry = malloc(sizeof(*entry) + tx->inputNum * (sizeof(*entry->spends) + sizeof(*entry->parents)) + size);
+	entry->spends = (CBMempoolSpend *)(entry + 1);
+	entry->parents = (CBMempoolTransaction **)(entry->spends + tx->inputNum);
+	entry->data = (unsigned char *)(entry->parents + tx->inputNum);
+	entry->parentNum = 0;
+	// Find the spent outputs in the pool or the unspent output set
+	CBValidationInput * inputs = malloc(sizeof(*inputs) * tx->inputNum);
+	CBUnspentOutput ** parentOutputs = malloc(sizeof(*parentOutputs) * tx->inputNum);
+	int parentOutputNum = 0;
+	CBMempoolResult res = CB_MEMPOOL_OK;
+	long long int inputValue = 0;
+	for (int x = 0; x < tx->inputNum; x++) {
+		CBPrevOut * prevOut = &tx->inputs[x]->prevOut;
+		unsigned char * prevHash = CBByteArrayGetData(prevOut->hash);
+		CBMempoolSpend * spend = entry->spends + x;
+		CBMakeOutPointKey(spend->outPoint, prevHash, prevOut->index);
+		spend->spender = entry;
+		if (CBAssociativeArrayFind(&self->spends, spend).found) {
+			res = CB_MEMPOOL_CONFLICT;
+			break;
+		}
+		CBUnspentOutput * output;
+		CBMempoolTransaction * parent = CBMempoolGetTransaction(self, prevHash);
+		if (parent) {
+			CBTransaction * parentTx = CBMempoolTransactionGetTransaction(parent);
+			if (prevOut->index >= (unsigned int)parentTx->outputNum) {
+				CBReleaseObject(parentTx);
+				res = CB_MEMPOOL_MISSING_INPUTS;
+				break;
+			}
+			CBTransactionOutput * parentOutput = parentTx->outputs[prevOut->index];
+			output = CBNewUnspentOutput(prevHash, prevOut->index, parentOutput->value, CBByteArrayGetData(parentOutput->scriptObject), parentOutput->scriptObject->length, height + 1, false);
+			parentOutputs[parentOutputNum++] = output;
+			CBReleaseObject(parentTx);
+			int y;
+			for (y = 0; y < entry->parentNum && entry->parents[y] != parent; y++);
+			if (y == entry->parentNum)
+				entry->parents[entry->parentNum++] = parent;
+		}else{
+			output = CBUnspentOutputSetGetOutput(set, prevHash, prevOut->index);
+			if (! output) {
+				res = CB_MEMPOOL_MISSING_INPUTS;
+				break;
+			}
+			if (output->coinbase && height + 1 - output->height < CB_COINBASE_MATURITY) {
+				res = CB_MEMPOOL_IMMATURE_COINBASE;
+				break;
+			}
+		}
+		inputValue += output->value;
+		if (output->value > CB_MAX_MONEY || inputValue > CB_MAX_MONEY) {
+			res = CB_MEMPOOL_BAD_VALUE;
+			break;
+		}
+		inputs[x] = (CBValidationInput){tx, 0, x, output};
+	}
+	if (res == CB_MEMPOOL_OK && inputValue < outputValue)
+		res = CB_MEMPOOL_BAD_VALUE;
+	unsigned long long int fee = inputValue - outputValue;
+	if (res == CB_MEMPOOL_OK && fee * 1000 / size < self->minFeeRate)
+		res = CB_MEMPOOL_LOW_FEE;
+	// Check the ancestor and descendant limits
+	CBMempoolTransaction * ancestors[CB_MEMPOOL_MAX_ANCESTORS];
+	int ancestorNum = 0;
+	if (res == CB_MEMPOOL_OK) {
+		ancestorNum = CBMempoolGetAncestors(self, entry->parents, entry->parentNum, ancestors, CB_MEMPOOL_MAX_ANCESTORS - 1);
+		if (ancestorNum == -1)
+			res = CB_MEMPOOL_TOO_LONG_CHAIN;
+		else for (int x = 0; x < ancestorNum; x++)
+			if (ancestors[x]->descendantNum >= CB_MEMPOOL_MAX_DESCENDANTS) {
+				res = CB_MEMPOOL_TOO_LONG_CHAIN;
+				break;
+			}
+	}
+	// Verify the scripts last as it is the most expensive check.
+	if (res == CB_MEMPOOL_OK)
+		for (int x = 0; x < tx->inputNum; x++)
+			if (! CBValidateInputScripts(inputs + x, true)) {
+				res = CB_MEMPOOL_BAD_SCRIPT;
+				break;
+			}
+	for (int x = 0; x < parentOutputNum; x++)
+		free(parentOutputs[x]);
+	free(parentOutputs);
+	free(inputs);
+	if (res != CB_MEMPOOL_OK) {
+		free(entry);
+		return res;
+	}
+	// Add the transaction
+	memcpy(entry->hash, hash, 32);
+	memcpy(entry->data, CBByteArrayGetData(CBGetMessage(tx)->bytes), size);
+	entry->fee = fee;
+	entry->size = size;
+	entry->sigOps = sigOps;
+	entry->inputNum = tx->inputNum;
+	entry->children = NULL;
+	entry->childNum = 0;
+	entry->childAlloc = 0;
+	entry->mark = 0;
+	entry->ancestorNum = entry->descendantNum = 1;
+	entry->ancestorSize = entry->descendantSize = size;
+	entry->ancestorFee = entry->descendantFee = fee;
+	entry->ancestorSigOps = sigOps;
+	for (int x = 0; x < ancestorNum; x++) {
+		CBMempoolTransaction * ancestor = ancestors[x];
+		entry->ancestorNum++;
+		entry->ancestorSize += ancestor->size;
+		entry->ancestorFee += ancestor->fee;
+		entry->ancestorSigOps += ancestor->sigOps;
+		CBMempoolScoresRemove(self, ancestor);
+		ancestor->descendantNum++;
+		ancestor->descendantSize += size;
+		ancestor->descendantFee += fee;
+		CBMempoolScoresInsert(self, ancestor);
+	}
+	for (int x = 0; x < entry->parentNum; x++) {
+		CBMempoolTransaction * parent = entry->parents[x];
+		if (parent->childNum == parent->childAlloc) {
+			parent->childAlloc = parent->childAlloc ? parent->childAlloc * 2 : 4;
+			parent->children = realloc(parent->children, sizeof(*parent->children) * parent->childAlloc);
+		}
+		parent->children[parent->childNum++] = entry;
+	}
+	CBFindResult find = CBAssociativeArrayFind(&self->transactions, entry);
+	CBAssociativeArrayInsert(&self->transactions, entry, find.position, NULL);
+	for (int x = 0; x < entry->inputNum; x++) {
+		find = CBAssociativeArrayFind(&self->spends, entry->spends + x);
+		CBAssociativeArrayInsert(&self->spends, entry->spends + x, find.position, NULL);
+	}
+	CBMempoolScoresInsert(self, entry);
+	self->transactionNum++;
+	self->size += size;
+	// Evict the lowest fee rate transactions with their descendants until the pool fits.
+	while (self->size > self->maxSize) {
+		CBPosition pos;
+		CBAssociativeArrayGetFirst(&self->descendantScores, &pos);
+		CBMempoolRemoveTransaction(self, pos.node->elements[pos.index]);
+	}
+	if (! CBMempoolGetTransaction(self, hash))
+		return CB_MEMPOOL_FULL;
+	return CB_MEMPOOL_OK;
+}
+static CBCompare CBMempoolCompareAncestorScore(CBAssociativeArray * array, void * vtx1, void * vtx2){
+	UNUSED(array);
+	CBMempoolTransaction * tx1 = vtx1, * tx2 = vtx2;
+	return CBMempoolCompareScores(tx1->ancestorScore, tx2->ancestorScore, tx1->hash, tx2->hash);
+}
+static CBCompare CBMempoolCompareDescendantScore(CBAssociativeArray * array, void * vtx1, void * vtx2){
+	UNUSED(array);
+	CBMempoolTransaction * tx1 = vtx1, * tx2 = vtx2;
+	return CBMempoolCompareScores(tx1->descendantScore, tx2->descendantScore, tx1->hash, tx2->hash);
+}
+static CBCompare CBMempoolCompareScores(unsigned long long int score1, unsigned long long int score2, unsigned char * hash1, unsigned char * hash2){
+	if (score1 > score2)
+		return CB_COMPARE_MORE_THAN;
+	if (score1 < score2)
+		return CB_COMPARE_LESS_THAN;
+	int cmp = memcmp(hash1, hash2, 32);
+	if (cmp > 0)
+		return CB_COMPARE_MORE_THAN;
+	if (cmp < 0)
+		return CB_COMPARE_LESS_THAN;
+	return CB_COMPARE_EQUAL;
+}
+static void CBMempoolDelete(CBAssociativeArray * array, void * element){
+	CBFindResult res = CBAssociativeArrayFind(array, element);
+	CBAssociativeArrayDelete(array, res.position, false);
+}
+static int CBMempoolGetAncestors(CBMempool * self, CBMempoolTransaction ** parents, int parentNum, CBMempoolTransaction ** ancestors, int max){
+	unsigned int mark = CBMempoolNewMark(self);
+	int num = 0;
+	// Search breadth first, starting with the given parents.
+	for (int x = -1; x < num; x++) {
+		CBMempoolTransaction ** next = x == -1 ? parents : ancestors[x]->parents;
+		int nextNum = x == -1 ? parentNum : ancestors[x]->parentNum;
+		for (int y = 0; y < nextNum; y++) {
+			if (next[y]->mark == mark)
+				continue;
+			if (num == max)
+				return -1;
+			next[y]->mark = mark;
+			ancestors[num++] = next[y];
+		}
+	}
+	return num;
+}
+static int CBMempoolGetDescendants(CBMempool * self, CBMempoolTransaction * tx, CBMempoolTransaction ** descendants){
+	unsigned int mark = CBMempoolNewMark(self);
+	int num = 0;
+	tx->mark = mark;
+	for (int x = -1; x < num; x++) {
+		CBMempoolTransaction * parent = x == -1 ? tx : descendants[x];
+		for (int y = 0; y < parent->childNum; y++) {
+			if (parent->children[y]->mark == mark)
+				continue;
+			parent->children[y]->mark = mark;
+			descendants[num++] = parent->children[y];
+		}
+	}
+	return num;
+}
+CBMempoolTransaction * CBMempoolGetSpender(CBMempool * self, unsigned char * txHash, unsigned int index){
+	unsigned char key[CB_OUTPOINT_KEY_SIZE];
+	CBMakeOutPointKey(key, txHash, index);
+	CBFindResult res = CBAssociativeArrayFind(&self->spends, key);
+	if (! res.found)
+		return NULL;
+	return ((CBMempoolSpend *)CBFindResultToPointer(res))->spender;
+}
+CBMempoolTransaction * CBMempoolGetTransaction(CBMempool * self, unsigned char * hash){
+	CBFindResult res = CBAssociativeArrayFind(&self->transactions, hash);
+	if (! res.found)
+		return NULL;
+	return CBFindResultToPointer(res);
+}
+static unsigned int CBMempoolNewMark(CBMempool * self){
+	if (! ++self->mark) {
+		// Reset the marks when the counter wraps around.
+		CBMempoolTransaction * tx;
+		CBAssociativeArrayForEach(tx, &self->transactions)
+			tx->mark = 0;
+		self->mark = 1;
+	}
+	return self->mark;
+}
+void CBMempoolRemoveBlockTransactions(CBMempool * self, CBBlock * block){
+	for (int x = 1; x < block->transactionNum; x++) {
+		CBTransaction * tx = block->transactions[x];
+		CBMempoolTransaction * entry = CBMempoolGetTransaction(self, CBTransactionGetHash(tx));
+		if (entry) {
+			// The descendants remain valid as they now spend confirmed outputs.
+			CBMempoolUnlinkTransaction(self, entry);
+			continue;
+		}
+		// Remove transactions spending the same outputs as the block.
+		for (int y = 0; y < tx->inputNum; y++) {
+			CBPrevOut * prevOut = &tx->inputs[y]->prevOut;
+			CBMempoolTransaction * conflict = CBMempoolGetSpender(self, CBByteArrayGetData(prevOut->hash), prevOut->index);
+			if (conflict)
+				CBMempoolRemoveTransaction(self, conflict);
+		}
+	}
+}
+void CBMempoolRemoveTransaction(CBMempool * self, CBMempoolTransaction * tx){
+	CBMempoolTransaction * descendants[CB_MEMPOOL_MAX_DESCENDANTS];
+	int num = CBMempoolGetDescendants(self, tx, descendants);
+	// Remove the furthest descendants first
+	while (num--)
+		CBMempoolUnlinkTransaction(self, descendants[num]);
+	CBMempoolUnlinkTransaction(self, tx);
+}
+static void CBMempoolScoresInsert(CBMempool * self, CBMempoolTransaction * tx){
+	tx->ancestorScore = tx->ancestorFee * 1000 / tx->ancestorSize;
+	tx->descendantScore = tx->descendantFee * 1000 / tx->descendantSize;
+	CBFindResult res = CBAssociativeArrayFind(&self->ancestorScores, tx);
+	CBAssociativeArrayInsert(&self->ancestorScores, tx, res.position, NULL);
+	res = CBAssociativeArrayFind(&self->descendantScores, tx);
+	CBAssociativeArrayInsert(&self->descendantScores, tx, res.position, NULL);
+}
+static void CBMempoolScoresRemove(CBMempool * self, CBMempoolTransaction * tx){
+	CBMempoolDelete(&self->ancestorScores, tx);
+	CBMempoolDelete(&self->descendantScores, tx);
+}
+CBTransaction * CBMempoolTransactionGetTransaction(CBMempoolTransaction * tx){
+	CBByteArray * bytes = CBNewByteArrayWithDataCopy(tx->data, tx->size);
+	CBTransaction * transaction = CBNewTransactionFromData(bytes);
+	CBReleaseObject(bytes);
+	CBTransactionDeserialise(transaction);
+	return transaction;
+}
+static void CBMempoolUnlinkTransaction(CBMempool * self, CBMempoolTransaction * tx){
+	CBMempoolTransaction * related[CB_MEMPOOL_MAX_ANCESTORS > CB_MEMPOOL_MAX_DESCENDANTS ? CB_MEMPOOL_MAX_ANCESTORS : CB_MEMPOOL_MAX_DESCENDANTS];
+	// The ancestors lose a descendant
+	int num = CBMempoolGetAncestors(self, tx->parents, tx->parentNum, related, CB_MEMPOOL_MAX_ANCESTORS);
+	for (int x = 0; x < num; x++) {
+		CBMempoolScoresRemove(self, related[x]);
+		related[x]->descendantNum--;
+		related[x]->descendantSize -= tx->size;
+		related[x]->descendantFee -= tx->fee;
+		CBMempoolScoresInsert(self, related[x]);
+	}
+	// The descendants lose an ancestor
+	num = CBMempoolGetDescendants(self, tx, related);
+	for (int x = 0; x < num; x++) {
+		CBMempoolScoresRemove(self, related[x]);
+		related[x]->ancestorNum--;
+		related[x]->ancestorSize -= tx->size;
+		related[x]->ancestorFee -= tx->fee;
+		related[x]->ancestorSigOps -= tx->sigOps;
+		CBMempoolScoresInsert(self, related[x]);
+	}
+	// Remove the links to this transaction
+	for (int x = 0; x < tx->parentNum; x++) {
+		CBMempoolTransaction * parent = tx->parents[x];
+		for (int y = 0; y < parent->childNum; y++)
+			if (parent->children[y] == tx) {
+				parent->children[y] = parent->children[--parent->childNum];
+				break;
+			}
+	}
+	for (int x = 0; x < tx->childNum; x++) {
+		CBMempoolTransaction * child = tx->children[x];
+		for (int y = 0; y < child->parentNum; y++)
+			if (child->parents[y] == tx) {
+				child->parents[y] = child->parents[--child->parentNum];
+				break;
+			}
+	}
+	CBMempoolScoresRemove(self, tx);
+	for (int x = 0; x < tx->inputNum; x++)
+		CBMempoolDelete(&self->spends, tx->spends + x);
+	self->transactionNum--;
+	self->size -= tx->size;
+	// Deleting from the transactions does not free, so free afterwards.
+	CBMempoolDelete(&self->transactions, tx);
+	CBFreeMempoolTransaction(tx);
+}
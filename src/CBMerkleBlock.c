@@ -0,0 +1,133 @@
+//
+//  CBMerkleBlock.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBMerkleBlock.h"
+
+//  Constructors
+
+CBMerkleBlock * CBNewMerkleBlock(CBBlock * block, unsigned char * hashes, int hashNum, bool * matches){
+	CBMerkleBlock * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeMerkleBlock;
+	CBInitMerkleBlock(self, block, hashes, hashNum, matches);
+	return self;
+}
+CBMerkleBlock * CBNewMerkleBlockFromData(CBByteArray * data){
+	CBMerkleBlock * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeMerkleBlock;
+	CBInitMerkleBlockFromData(self, data);
+	return self;
+}
+
+//  Initialisers
+
+void CBInitMerkleBlock(CBMerkleBlock * self, CBBlock * block, unsigned char * hashes, int hashNum, bool * matches){
+	CBInitMessageByObject(CBGetMessage(self));
+	self->version = block->version;
+	// Copy the hashes as they are changed to reference the serialised data.
+	self->prevBlockHash = CBByteArrayCopy(block->prevBlockHash);
+	self->merkleRoot = CBByteArrayCopy(block->merkleRoot);
+	self->time = block->time;
+	self->target = block->target;
+	self->nonce = block->nonce;
+	CBInitPartialMerkleTree(&self->tree, hashes, hashNum, matches);
+}
+void CBInitMerkleBlockFromData(CBMerkleBlock * self, CBByteArray * data){
+	CBInitMessageByData(CBGetMessage(self), data);
+	self->prevBlockHash = NULL;
+	self->merkleRoot = NULL;
+	self->tree.hashes = NULL;
+	self->tree.flags = NULL;
+}
+
+//  Destructor
+
+void CBDestroyMerkleBlock(void * vself){
+	CBMerkleBlock * self = vself;
+	if (self->prevBlockHash)
+		CBReleaseObject(self->prevBlockHash);
+	if (self->merkleRoot)
+		CBReleaseObject(self->merkleRoot);
+	CBDestroyPartialMerkleTree(&self->tree);
+	CBDestroyMessage(self);
+}
+void CBFreeMerkleBlock(void * self){
+	CBDestroyMerkleBlock(self);
+	free(self);
+}
+
+//  Functions
+
+int CBMerkleBlockCalculateLength(CBMerkleBlock * self){
+	return 80 + CBPartialMerkleTreeCalculateLength(&self->tree);
+}
+void CBMerkleBlockCalculateHash(CBMerkleBlock * self, unsigned char * hash){
+	unsigned char headerHash[32];
+	CBSha256(CBByteArrayGetData(CBGetMessage(self)->bytes), 80, headerHash);
+	CBSha256(headerHash, 32, hash);
+}
+int CBMerkleBlockDeserialise(CBMerkleBlock * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to deserialise a CBMerkleBlock with no bytes.");
+		return CB_DESERIALISE_ERROR;
+	}
+	if (bytes->length < 80) {
+		CBLogError("Attempting to deserialise a CBMerkleBlock with less than 80 bytes for the header.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->version = CBByteArrayReadInt32(bytes, 0);
+	self->prevBlockHash = CBByteArraySubReference(bytes, 4, 32);
+	self->merkleRoot = CBByteArraySubReference(bytes, 36, 32);
+	self->time = CBByteArrayReadInt32(bytes, 68);
+	self->target = CBByteArrayReadInt32(bytes, 72);
+	self->nonce = CBByteArrayReadInt32(bytes, 76);
+	int len = CBPartialMerkleTreeDeserialise(&self->tree, bytes, 80);
+	if (! len) {
+		CBLogError("Attempting to deserialise a CBMerkleBlock with a bad partial merkle tree.");
+		return CB_DESERIALISE_ERROR;
+	}
+	return 80 + len;
+}
+void CBMerkleBlockPrepareBytes(CBMerkleBlock * self){
+	CBMessagePrepareBytes(CBGetMessage(self), CBMerkleBlockCalculateLength(self));
+}
+int CBMerkleBlockSerialise(CBMerkleBlock * self){
+	CBByteArray * bytes = CBGetMessage(self)->bytes;
+	if (! bytes) {
+		CBLogError("Attempting to serialise a CBMerkleBlock with no bytes.");
+		return 0;
+	}
+	int length = CBMerkleBlockCalculateLength(self);
+	if (bytes->length < length) {
+		CBLogError("Attempting to serialise a CBMerkleBlock with less bytes than required.");
+		return 0;
+	}
+	CBByteArraySetInt32(bytes, 0, self->version);
+	CBByteArrayCopyByteArray(bytes, 4, self->prevBlockHash);
+	CBByteArrayChangeReference(self->prevBlockHash, bytes, 4);
+	CBByteArrayCopyByteArray(bytes, 36, self->merkleRoot);
+	CBByteArrayChangeReference(self->merkleRoot, bytes, 36);
+	CBByteArraySetInt32(bytes, 68, self->time);
+	CBByteArraySetInt32(bytes, 72, self->target);
+	CBByteArraySetInt32(bytes, 76, self->nonce);
+	CBPartialMerkleTreeSerialise(&self->tree, bytes, 80);
+	bytes->length = length;
+	CBGetMessage(self)->serialised = true;
+	return length;
+}
+bool CBMerkleBlockVerify(CBMerkleBlock * self, unsigned char * matches, int * indexes, int * matchNum){
+	return CBPartialMerkleTreeVerify(&self->tree, CBByteArrayGetData(self->merkleRoot), matches, indexes, matchNum);
+}
@@ -0,0 +1,185 @@
+//
+//  CBMerkleTree.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBMerkleTree.h"
+
+/**
+ @brief Hashes two nodes on a level into their parent on the level above.
+ @param self The merkle tree.
+ @param level The level of the two nodes.
+ @param parent The index of the parent on the level above.
+ @param hashNum The number of hashes on the level.
+ */
+static void CBMerkleTreeHashNode(CBMerkleTree * self, int level, int parent, int hashNum);
+/**
+ @brief Rehashes the path from a leaf to the root.
+ @param self The merkle tree.
+ @param index The index of the leaf.
+ */
+static void CBMerkleTreeRehash(CBMerkleTree * self, int index);
+/**
+ @brief Makes sure there is room for a number of leaves, moving the levels if the memory is reallocated.
+ @param self The merkle tree.
+ @param hashNum The number of leaves.
+ */
+static void CBMerkleTreeReserve(CBMerkleTree * self, int hashNum);
+
+void CBInitMerkleTree(CBMerkleTree * self){
+	self->hashes = NULL;
+	self->levelNum = 0;
+	self->hashNum = 0;
+	self->hashAlloc = 0;
+}
+void CBDestroyMerkleTree(CBMerkleTree * self){
+	free(self->hashes);
+}
+void CBMerkleTreeAppend(CBMerkleTree * self, unsigned char * hash){
+	CBMerkleTreeReserve(self, self->hashNum + 1);
+	memcpy(self->hashes + self->hashNum * 32, hash, 32);
+	CBMerkleTreeRehash(self, self->hashNum++);
+}
+void CBMerkleTreeClear(CBMerkleTree * self){
+	self->hashNum = 0;
+	self->levelNum = 0;
+}
+unsigned char * CBMerkleTreeGetHash(CBMerkleTree * self, int level, int index){
+	return self->hashes + (self->levelOffsets[level] + index) * 32;
+}
+int CBMerkleTreeGetLevelHashNum(CBMerkleTree * self, int level){
+	int hashNum = self->hashNum;
+	for (int x = 0; x < level; x++)
+		hashNum = (hashNum + 1) / 2;
+	return hashNum;
+}
+unsigned char * CBMerkleTreeGetRoot(CBMerkleTree * self){
+	if (! self->levelNum)
+		return NULL;
+	return CBMerkleTreeGetHash(self, self->levelNum - 1, 0);
+}
+static void CBMerkleTreeHashNode(CBMerkleTree * self, int level, int parent, int hashNum){
+	unsigned char * left = CBMerkleTreeGetHash(self, level, parent * 2);
+	unsigned char cat[64];
+	unsigned char hash[32];
+	memcpy(cat, left, 32);
+	// The last hash of an odd level is paired with itself
+	memcpy(cat + 32, parent * 2 + 1 < hashNum ? left + 32 : left, 32);
+	CBSha256(cat, 64, hash);
+	CBSha256(hash, 32, CBMerkleTreeGetHash(self, level + 1, parent));
+}
+static void CBMerkleTreeRehash(CBMerkleTree * self, int index){
+	int level = 0;
+	for (int hashNum = self->hashNum; hashNum > 1; hashNum = (hashNum + 1) / 2, level++) {
+		index /= 2;
+		CBMerkleTreeHashNode(self, level, index, hashNum);
+	}
+	self->levelNum = level + 1;
+}
+static void CBMerkleTreeReserve(CBMerkleTree * self, int hashNum){
+	if (hashNum <= self->hashAlloc)
+		return;
+	int alloc = self->hashAlloc ? self->hashAlloc : 16;
+	while (alloc < hashNum)
+		alloc *= 2;
+	// Lay out the levels for the new capacity
+	int offsets[CB_MERKLE_TREE_MAX_LEVELS] = {0};
+	int total = 0;
+	for (int level = 0, levelAlloc = alloc;; level++) {
+		offsets[level] = total;
+		total += levelAlloc;
+		if (levelAlloc == 1)
+			break;
+		levelAlloc = (levelAlloc + 1) / 2;
+	}
+	unsigned char * hashes = malloc(total * 32);
+	// Move the existing levels
+	for (int level = 0, levelNum = self->hashNum; level < self->levelNum; level++, levelNum = (levelNum + 1) / 2)
+		memcpy(hashes + offsets[level] * 32, self->hashes + self->levelOffsets[level] * 32, levelNum * 32);
+	free(self->hashes);
+	self->hashes = hashes;
+	memcpy(self->levelOffsets, offsets, sizeof(offsets));
+	self->hashAlloc = alloc;
+}
+void CBMerkleTreeSetHashes(CBMerkleTree * self, unsigned char * hashes, int hashNum){
+	if (! hashNum) {
+		CBMerkleTreeClear(self);
+		return;
+	}
+	CBMerkleTreeReserve(self, hashNum);
+	memcpy(self->hashes, hashes, hashNum * 32);
+	self->hashNum = hashNum;
+	// Build each level upwards to the root
+	int level = 0;
+	for (; hashNum > 1; hashNum = (hashNum + 1) / 2, level++)
+		for (int x = 0; x < (hashNum + 1) / 2; x++)
+			CBMerkleTreeHashNode(self, level, x, hashNum);
+	self->levelNum = level + 1;
+}
+void CBMerkleTreeUpdate(CBMerkleTree * self, int index, unsigned char * hash){
+	memcpy(CBMerkleTreeGetHash(self, 0, index), hash, 32);
+	CBMerkleTreeRehash(self, index);
+}
+int CBCalculateMerkleBranch(unsigned char * hashes, int hashNum, int index, unsigned char * branch){
+	int branchNum = 0;
+	for (int height = 0; CBMerkleTreeWidth(hashNum, height) > 1; height++, index /= 2) {
+		int sibling = index ^ 1;
+		if (sibling >= CBMerkleTreeWidth(hashNum, height))
+			sibling = index;
+		CBCalculateMerkleNode(hashes, hashNum, height, sibling, branch + 32 * branchNum++);
+	}
+	return branchNum;
+}
+void CBCalculateMerkleNode(unsigned char * hashes, int hashNum, int height, int index, unsigned char * hash){
+	if (! height) {
+		memcpy(hash, hashes + index * 32, 32);
+		return;
+	}
+	unsigned char cat[64];
+	unsigned char hash2[32];
+	CBCalculateMerkleNode(hashes, hashNum, height - 1, index * 2, cat);
+	if (index * 2 + 1 < CBMerkleTreeWidth(hashNum, height - 1))
+		CBCalculateMerkleNode(hashes, hashNum, height - 1, index * 2 + 1, cat + 32);
+	else
+		memcpy(cat + 32, cat, 32);
+	CBSha256(cat, 64, hash2);
+	CBSha256(hash2, 32, hash);
+}
+void CBMerkleBranchCalculateRoot(unsigned char * hash, unsigned char * branch, int branchNum, int index, unsigned char * root){
+	unsigned char cat[64];
+	unsigned char hash2[32];
+	memcpy(root, hash, 32);
+	for (int x = 0; x < branchNum; x++, index /= 2) {
+		if (index & 1) {
+			memcpy(cat, branch + x * 32, 32);
+			memcpy(cat + 32, root, 32);
+		}else{
+			memcpy(cat, root, 32);
+			memcpy(cat + 32, branch + x * 32, 32);
+		}
+		CBSha256(cat, 64, hash2);
+		CBSha256(hash2, 32, root);
+	}
+}
+int CBMerkleTreeGetBranch(CBMerkleTree * self, int index, unsigned char * branch){
+	int hashNum = self->hashNum;
+	for (int level = 0; level < self->levelNum - 1; level++, index /= 2, hashNum = (hashNum + 1) / 2) {
+		int sibling = index ^ 1;
+		memcpy(branch + level * 32, CBMerkleTreeGetHash(self, level, sibling < hashNum ? sibling : index), 32);
+	}
+	return self->levelNum ? self->levelNum - 1 : 0;
+}
+int CBMerkleTreeWidth(int hashNum, int height){
+	return (int)(((long long int)hashNum + (1LL << height) - 1) >> height);
+}
@@ -106,10 +106,34 @@ void CBMessageTypeToString(CBMessageType type, char output[CB_MESSAGE_TYPE_STR_S
 			strcpy(output, "block");
 			break;
 			
+		case CB_MESSAGE_TYPE_BLOCKTXN:
+			strcpy(output, "blocktxn");
+			break;
+			
+		case CB_MESSAGE_TYPE_CMPCTBLOCK:
+			strcpy(output, "cmpctblock");
+			break;
+			
+		case CB_MESSAGE_TYPE_FILTERADD:
+			strcpy(output, "filteradd");
+			break;
+			
+		case CB_MESSAGE_TYPE_FILTERCLEAR:
+			strcpy(output, "filterclear");
+			break;
+			
+		case CB_MESSAGE_TYPE_FILTERLOAD:
+			strcpy(output, "filterload");
+			break;
+			
 		case CB_MESSAGE_TYPE_GETADDR:
 			strcpy(output, "getaddr");
 			break;
 			
+		case CB_MESSAGE_TYPE_GETBLOCKTXN:
+			strcpy(output, "getblocktxn");
+			break;
+			
 		case CB_MESSAGE_TYPE_GETBLOCKS:
 			strcpy(output, "getblocks");
 			break;
@@ -130,6 +154,10 @@ void CBMessageTypeToString(CBMessageType type, char output[CB_MESSAGE_TYPE_STR_S
 			strcpy(output, "inv");
 			break;
 			
+		case CB_MESSAGE_TYPE_MERKLEBLOCK:
+			strcpy(output, "merkleblock");
+			break;
+			
 		case CB_MESSAGE_TYPE_PING:
 			strcpy(output, "ping");
 			break;
@@ -512,6 +512,27 @@ void CBNetworkCommunicatorOnCanSend(void * vself, void * vpeer){
 				case CB_MESSAGE_TYPE_ALERT:
 					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "alert\0\0\0\0\0\0\0", 12);
 					break;
+				case CB_MESSAGE_TYPE_FILTERLOAD:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "filterload\0\0", 12);
+					break;
+				case CB_MESSAGE_TYPE_FILTERADD:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "filteradd\0\0\0", 12);
+					break;
+				case CB_MESSAGE_TYPE_FILTERCLEAR:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "filterclear\0", 12);
+					break;
+				case CB_MESSAGE_TYPE_MERKLEBLOCK:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "merkleblock\0", 12);
+					break;
+				case CB_MESSAGE_TYPE_CMPCTBLOCK:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "cmpctblock\0\0", 12);
+					break;
+				case CB_MESSAGE_TYPE_GETBLOCKTXN:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "getblocktxn\0", 12);
+					break;
+				case CB_MESSAGE_TYPE_BLOCKTXN:
+					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, "blocktxn\0\0\0\0", 12);
+					break;
 				default:
 					memcpy(peer->sendingHeader + CB_MESSAGE_HEADER_TYPE, toSend->altText, 12);
 					break;
@@ -659,6 +680,39 @@ void CBNetworkCommunicatorOnHeaderRecieved(CBNetworkCommunicator * self, CBPeer
 		}else if (! memcmp(CBByteArrayGetData(typeBytes), "alert\0\0\0\0\0\0\0", 12)){
 			// Alert message
 			type = CB_MESSAGE_TYPE_ALERT;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "filterload\0\0", 12)){
+			// Bloom filter message
+			type = CB_MESSAGE_TYPE_FILTERLOAD;
+			if (size > CB_BLOOM_FILTER_MAX_SIZE + 12)
+				error = true;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "filteradd\0\0\0", 12)){
+			// Add to bloom filter message
+			type = CB_MESSAGE_TYPE_FILTERADD;
+			if (size > CB_FILTER_ADD_MAX_SIZE + 3)
+				error = true;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "filterclear\0", 12)){
+			// Remove bloom filter message
+			type = CB_MESSAGE_TYPE_FILTERCLEAR;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "merkleblock\0", 12)){
+			// Filtered block message
+			type = CB_MESSAGE_TYPE_MERKLEBLOCK;
+			if (size > CB_BLOCK_MAX_SIZE)
+				error = true;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "cmpctblock\0\0", 12)){
+			// Compact block message
+			type = CB_MESSAGE_TYPE_CMPCTBLOCK;
+			if (size > CB_BLOCK_MAX_SIZE)
+				error = true;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "getblocktxn\0", 12)){
+			// Request for compact block transactions
+			type = CB_MESSAGE_TYPE_GETBLOCKTXN;
+			if (size > CB_BLOCK_MAX_SIZE)
+				error = true;
+		}else if (! memcmp(CBByteArrayGetData(typeBytes), "blocktxn\0\0\0\0", 12)){
+			// Compact block transactions message
+			type = CB_MESSAGE_TYPE_BLOCKTXN;
+			if (size > CB_BLOCK_MAX_SIZE)
+				error = true;
 		}else{
 			// Either alternative or unknown. ??? Add tests for this.
 			if (self->alternativeMessages) {
@@ -793,7 +847,14 @@ void CBNetworkCommunicatorOnMessageReceived(CBNetworkCommunicator * self, CBPeer
 		case CB_MESSAGE_TYPE_HEADERS:
 			peer->receive = realloc(peer->receive, sizeof(CBBlockHeaders));
 			CBGetObject(peer->receive)->free = CBFreeBlockHeaders;
-			len = CBBlockHeadersDeserialise(CBGetBlockHeaders(peer->receive));
+			CBGetBlockHeaders(peer->receive)->headerNum = 0;
+			CBGetBlockHeaders(peer->receive)->headers = NULL;
+			CBGetBlockHeaders(peer->receive)->ownHeaders = false;
+			if (self->flags & CB_NETWORK_COMMUNICATOR_FLAT_HEADERS)
+				// Flat headers referencing the received bytes, so that they can be checked without a CBBlock for each.
+				len = CBBlockHeadersDeserialiseFlat(CBGetBlockHeaders(peer->receive));
+			else
+				len = CBBlockHeadersDeserialise(CBGetBlockHeaders(peer->receive));
 			break;
 		case CB_MESSAGE_TYPE_PING:
 			if (peer->versionMessage->version >= 60000 && self->version >= 60000){
@@ -811,6 +872,53 @@ void CBNetworkCommunicatorOnMessageReceived(CBNetworkCommunicator * self, CBPeer
 			CBGetObject(peer->receive)->free = CBFreeAlert;
 			len = CBAlertDeserialise(CBGetAlert(peer->receive));
 			break;
+		case CB_MESSAGE_TYPE_FILTERLOAD:
+			peer->receive = realloc(peer->receive, sizeof(CBBloomFilter));
+			CBGetObject(peer->receive)->free = CBFreeBloomFilter;
+			CBGetBloomFilter(peer->receive)->filter = NULL;
+			len = CBBloomFilterDeserialise(CBGetBloomFilter(peer->receive));
+			break;
+		case CB_MESSAGE_TYPE_FILTERADD:
+			peer->receive = realloc(peer->receive, sizeof(CBFilterAdd));
+			CBGetObject(peer->receive)->free = CBFreeFilterAdd;
+			CBGetFilterAdd(peer->receive)->data = NULL;
+			len = CBFilterAddDeserialise(CBGetFilterAdd(peer->receive));
+			break;
+		case CB_MESSAGE_TYPE_MERKLEBLOCK:
+			peer->receive = realloc(peer->receive, sizeof(CBMerkleBlock));
+			CBGetObject(peer->receive)->free = CBFreeMerkleBlock;
+			CBGetMerkleBlock(peer->receive)->prevBlockHash = NULL;
+			CBGetMerkleBlock(peer->receive)->merkleRoot = NULL;
+			CBGetMerkleBlock(peer->receive)->tree.hashes = NULL;
+			CBGetMerkleBlock(peer->receive)->tree.flags = NULL;
+			len = CBMerkleBlockDeserialise(CBGetMerkleBlock(peer->receive));
+			break;
+		case CB_MESSAGE_TYPE_CMPCTBLOCK:
+			peer->receive = realloc(peer->receive, sizeof(CBCompactBlock));
+			CBGetObject(peer->receive)->free = CBFreeCompactBlock;
+			CBGetCompactBlock(peer->receive)->prevBlockHash = NULL;
+			CBGetCompactBlock(peer->receive)->merkleRoot = NULL;
+			CBGetCompactBlock(peer->receive)->shortIDs = NULL;
+			CBGetCompactBlock(peer->receive)->prefilledIndexes = NULL;
+			CBGetCompactBlock(peer->receive)->prefilled = NULL;
+			CBGetCompactBlock(peer->receive)->prefilledNum = 0;
+			len = CBCompactBlockDeserialise(CBGetCompactBlock(peer->receive));
+			break;
+		case CB_MESSAGE_TYPE_GETBLOCKTXN:
+			peer->receive = realloc(peer->receive, sizeof(CBGetBlockTxn));
+			CBGetObject(peer->receive)->free = CBFreeGetBlockTxn;
+			CBGetGetBlockTxn(peer->receive)->blockHash = NULL;
+			CBGetGetBlockTxn(peer->receive)->indexes = NULL;
+			len = CBGetBlockTxnDeserialise(CBGetGetBlockTxn(peer->receive));
+			break;
+		case CB_MESSAGE_TYPE_BLOCKTXN:
+			peer->receive = realloc(peer->receive, sizeof(CBBlockTxn));
+			CBGetObject(peer->receive)->free = CBFreeBlockTxn;
+			CBGetBlockTxn(peer->receive)->blockHash = NULL;
+			CBGetBlockTxn(peer->receive)->transactions = NULL;
+			CBGetBlockTxn(peer->receive)->transactionNum = 0;
+			len = CBBlockTxnDeserialise(CBGetBlockTxn(peer->receive));
+			break;
 		default:
 			len = 0; // Zero default
 			break;
@@ -825,11 +933,15 @@ void CBNetworkCommunicatorOnMessageReceived(CBNetworkCommunicator * self, CBPeer
 	char messageTypeStr[CB_MESSAGE_TYPE_STR_SIZE];
 	CBMessageTypeToString(peer->receive->type, messageTypeStr);
 	CBLogVerbose("Processing message from %s with the type %s.", peer->peerStr, messageTypeStr);
-	CBOnMessageReceivedAction action;
+	CBOnMessageReceivedAction action = CB_MESSAGE_ACTION_CONTINUE;
 	// Automatic responses
 	if (peer->handshakeStatus == CB_HANDSHAKE_DONE) {
-		// Handshake done, do discovery and pings
-		if (self->flags & CB_NETWORK_COMMUNICATOR_AUTO_DISCOVERY)
+		// Handshake done, do filters, discovery and pings
+		if (self->flags & CB_NETWORK_COMMUNICATOR_BLOOM_FILTERS)
+			// Bloom filter changes
+			action = CBPeerProcessFilterMessage(peer) ? CB_MESSAGE_ACTION_CONTINUE : CB_MESSAGE_ACTION_DISCONNECT;
+		if (self->flags & CB_NETWORK_COMMUNICATOR_AUTO_DISCOVERY
+			&& action == CB_MESSAGE_ACTION_CONTINUE)
 			// Auto discovery responses
 			action = CBNetworkCommunicatorProcessMessageAutoDiscovery(self, peer);
 		if (self->flags & CB_NETWORK_COMMUNICATOR_AUTO_PING
@@ -1263,6 +1375,36 @@ bool CBNetworkCommunicatorSendMessage(CBNetworkCommunicator * self, CBPeer * pee
 				return false;
 				break;
 				
+			case CB_MESSAGE_TYPE_FILTERLOAD:
+				CBBloomFilterPrepareBytes(CBGetBloomFilter(message));
+				len = CBBloomFilterSerialise(CBGetBloomFilter(message));
+				break;
+				
+			case CB_MESSAGE_TYPE_FILTERADD:
+				CBFilterAddPrepareBytes(CBGetFilterAdd(message));
+				len = CBFilterAddSerialise(CBGetFilterAdd(message));
+				break;
+				
+			case CB_MESSAGE_TYPE_MERKLEBLOCK:
+				CBMerkleBlockPrepareBytes(CBGetMerkleBlock(message));
+				len = CBMerkleBlockSerialise(CBGetMerkleBlock(message));
+				break;
+				
+			case CB_MESSAGE_TYPE_CMPCTBLOCK:
+				CBCompactBlockPrepareBytes(CBGetCompactBlock(message));
+				len = CBCompactBlockSerialise(CBGetCompactBlock(message));
+				break;
+				
+			case CB_MESSAGE_TYPE_GETBLOCKTXN:
+				CBGetBlockTxnPrepareBytes(CBGetGetBlockTxn(message));
+				len = CBGetBlockTxnSerialise(CBGetGetBlockTxn(message));
+				break;
+				
+			case CB_MESSAGE_TYPE_BLOCKTXN:
+				CBBlockTxnPrepareBytes(CBGetBlockTxn(message));
+				len = CBBlockTxnSerialise(CBGetBlockTxn(message));
+				break;
+				
 			default:
 				break;
 				
@@ -0,0 +1,173 @@
+//
+//  CBPartialBlock.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBPartialBlock.h"
+
+/**
+ @brief A short ID with the index of the transaction in the block, for sorting and searching.
+ */
+typedef struct{
+	uint64_t shortID;
+	int index;
+} CBPartialBlockShortID;
+
+/**
+ @brief Compares two CBPartialBlockShortID structures by short ID, for qsort and bsearch.
+ @param vid1 The first CBPartialBlockShortID.
+ @param vid2 The second CBPartialBlockShortID.
+ @returns Less than, equal to or more than zero when the first short ID is lower, equal or higher.
+ */
+static int CBPartialBlockCompareShortIDs(const void * vid1, const void * vid2);
+
+//  Constructor
+
+CBPartialBlock * CBNewPartialBlock(CBCompactBlock * compactBlock){
+	CBPartialBlock * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreePartialBlock;
+	CBInitPartialBlock(self, compactBlock);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitPartialBlock(CBPartialBlock * self, CBCompactBlock * compactBlock){
+	CBInitObject(CBGetObject(self), false);
+	CBRetainObject(compactBlock);
+	self->compactBlock = compactBlock;
+	CBCompactBlockCalculateHash(compactBlock, self->hash);
+	self->transactionNum = compactBlock->shortIDNum + compactBlock->prefilledNum;
+	self->transactions = calloc(self->transactionNum, sizeof(*self->transactions));
+	for (int x = 0; x < compactBlock->prefilledNum; x++) {
+		CBRetainObject(compactBlock->prefilled[x]);
+		self->transactions[compactBlock->prefilledIndexes[x]] = compactBlock->prefilled[x];
+	}
+	self->missingNum = compactBlock->shortIDNum;
+}
+
+//  Destructor
+
+void CBDestroyPartialBlock(void * vself){
+	CBPartialBlock * self = vself;
+	for (int x = 0; x < self->transactionNum; x++)
+		if (self->transactions[x])
+			CBReleaseObject(self->transactions[x]);
+	free(self->transactions);
+	CBReleaseObject(self->compactBlock);
+}
+void CBFreePartialBlock(void * self){
+	CBDestroyPartialBlock(self);
+	free(self);
+}
+
+//  Functions
+
+static int CBPartialBlockCompareShortIDs(const void * vid1, const void * vid2){
+	const CBPartialBlockShortID * id1 = vid1, * id2 = vid2;
+	return (id1->shortID > id2->shortID) - (id1->shortID < id2->shortID);
+}
+CBPartialBlockStatus CBPartialBlockFillFromBlockTxn(CBPartialBlock * self, CBBlockTxn * blockTxn){
+	if (blockTxn->transactionNum != self->missingNum
+		|| memcmp(CBByteArrayGetData(blockTxn->blockHash), self->hash, 32))
+		return CB_PARTIAL_BLOCK_INVALID;
+	for (int x = 0, y = 0; x < self->transactionNum; x++)
+		if (! self->transactions[x]) {
+			CBRetainObject(blockTxn->transactions[y]);
+			self->transactions[x] = blockTxn->transactions[y++];
+		}
+	self->missingNum = 0;
+	return CB_PARTIAL_BLOCK_COMPLETE;
+}
+CBPartialBlockStatus CBPartialBlockFillFromMempool(CBPartialBlock * self, CBMempool * mempool){
+	CBCompactBlock * compactBlock = self->compactBlock;
+	if (! compactBlock->shortIDNum)
+		return CB_PARTIAL_BLOCK_COMPLETE;
+	// Sort the short IDs with the indexes of the transactions, which skip the prefilled transactions.
+	CBPartialBlockShortID * shortIDs = malloc(sizeof(*shortIDs) * compactBlock->shortIDNum);
+	for (int x = 0, y = 0; x < self->transactionNum; x++)
+		if (! self->transactions[x]) {
+			shortIDs[y].shortID = compactBlock->shortIDs[y];
+			shortIDs[y++].index = x;
+		}
+	qsort(shortIDs, compactBlock->shortIDNum, sizeof(*shortIDs), CBPartialBlockCompareShortIDs);
+	for (int x = 1; x < compactBlock->shortIDNum; x++)
+		if (shortIDs[x].shortID == shortIDs[x - 1].shortID) {
+			free(shortIDs);
+			return CB_PARTIAL_BLOCK_FULL_BLOCK;
+		}
+	// Look for each mempool transaction. Transactions with the same short ID as another are not used.
+	bool * collided = calloc(self->transactionNum, sizeof(*collided));
+	int found = 0;
+	CBMempoolTransaction * entry;
+	CBAssociativeArrayForEach(entry, &mempool->transactions) {
+		CBPartialBlockShortID key = {CBCompactBlockGetShortID(compactBlock, entry->hash), 0};
+		CBPartialBlockShortID * match = bsearch(&key, shortIDs, compactBlock->shortIDNum, sizeof(*shortIDs), CBPartialBlockCompareShortIDs);
+		if (! match || collided[match->index])
+			continue;
+		if (self->transactions[match->index]) {
+			CBReleaseObject(self->transactions[match->index]);
+			self->transactions[match->index] = NULL;
+			collided[match->index] = true;
+			found--;
+			self->missingNum++;
+			continue;
+		}
+		self->transactions[match->index] = CBMempoolTransactionGetTransaction(entry);
+		self->missingNum--;
+		if (++found == compactBlock->shortIDNum)
+			break;
+	}
+	free(collided);
+	free(shortIDs);
+	return self->missingNum ? CB_PARTIAL_BLOCK_MISSING : CB_PARTIAL_BLOCK_COMPLETE;
+}
+CBBlock * CBPartialBlockGetBlock(CBPartialBlock * self){
+	if (self->missingNum)
+		return NULL;
+	CBCompactBlock * compactBlock = self->compactBlock;
+	CBBlock * block = CBNewBlock();
+	block->version = compactBlock->version;
+	block->prevBlockHash = CBByteArrayCopy(compactBlock->prevBlockHash);
+	block->merkleRoot = CBByteArrayCopy(compactBlock->merkleRoot);
+	block->time = compactBlock->time;
+	block->target = compactBlock->target;
+	block->nonce = compactBlock->nonce;
+	block->transactionNum = self->transactionNum;
+	block->transactions = malloc(sizeof(*block->transactions) * self->transactionNum);
+	for (int x = 0; x < self->transactionNum; x++) {
+		CBRetainObject(self->transactions[x]);
+		block->transactions[x] = self->transactions[x];
+	}
+	// A short ID may have matched the wrong transaction.
+	unsigned char * root = CBBlockCalculateMerkleRoot(block);
+	bool match = ! memcmp(root, CBByteArrayGetData(block->merkleRoot), 32);
+	free(root);
+	if (! match) {
+		CBReleaseObject(block);
+		return NULL;
+	}
+	CBBlockPrepareBytes(block, true);
+	CBBlockSerialise(block, true, false);
+	return block;
+}
+CBGetBlockTxn * CBPartialBlockGetRequest(CBPartialBlock * self){
+	int * indexes = malloc(sizeof(*indexes) * self->missingNum);
+	for (int x = 0, y = 0; x < self->transactionNum; x++)
+		if (! self->transactions[x])
+			indexes[y++] = x;
+	CBGetBlockTxn * request = CBNewGetBlockTxn(self->hash, indexes, self->missingNum);
+	free(indexes);
+	return request;
+}
@@ -0,0 +1,209 @@
+//
+//  CBPartialMerkleTree.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBPartialMerkleTree.h"
+
+/**
+ @brief The state for verifying a partial merkle tree.
+ */
+typedef struct{
+	int flagsUsed; /**< The number of flag bits used so far. */
+	int hashesUsed; /**< The number of hashes used so far. */
+	unsigned char * matches; /**< The matched hashes. */
+	int * indexes; /**< The indexes of the matched hashes or NULL. */
+	int matchNum; /**< The number of matched hashes. */
+} CBPartialMerkleTreeExtract;
+
+/**
+ @brief Adds the nodes below and including a node to the tree.
+ @param self The partial merkle tree.
+ @param hashes The transaction hashes.
+ @param matchCounts For each transaction index, the number of matched transactions before it. Has an extra count at the end for all transactions.
+ @param height The height of the node.
+ @param index The index of the node on its level.
+ */
+static void CBPartialMerkleTreeBuild(CBPartialMerkleTree * self, unsigned char * hashes, int * matchCounts, int height, int index);
+/**
+ @brief Gets the hash of a node from the tree and adds any matches below it.
+ @param self The partial merkle tree.
+ @param extract The verification state.
+ @param height The height of the node.
+ @param index The index of the node on its level.
+ @param hash The hash of the node is written here.
+ @returns true if the tree is correct so far, false otherwise.
+ */
+static bool CBPartialMerkleTreeTraverse(CBPartialMerkleTree * self, CBPartialMerkleTreeExtract * extract, int height, int index, unsigned char * hash);
+
+void CBInitPartialMerkleTree(CBPartialMerkleTree * self, unsigned char * hashes, int hashNum, bool * matches){
+	self->transactionNum = hashNum;
+	self->hashNum = 0;
+	self->flagNum = 0;
+	if (! hashNum) {
+		self->hashes = NULL;
+		self->flags = NULL;
+		return;
+	}
+	// There are no more hashes than transactions and no more flags than nodes.
+	int nodeNum = 0;
+	int height = 0;
+	for (;; height++) {
+		nodeNum += CBMerkleTreeWidth(hashNum, height);
+		if (CBMerkleTreeWidth(hashNum, height) <= 1)
+			break;
+	}
+	self->hashes = malloc(hashNum * 32);
+	self->flags = calloc((nodeNum + 7) / 8, 1);
+	int * matchCounts = malloc(sizeof(*matchCounts) * (hashNum + 1));
+	matchCounts[0] = 0;
+	for (int x = 0; x < hashNum; x++)
+		matchCounts[x + 1] = matchCounts[x] + matches[x];
+	CBPartialMerkleTreeBuild(self, hashes, matchCounts, height, 0);
+	free(matchCounts);
+}
+void CBDestroyPartialMerkleTree(CBPartialMerkleTree * self){
+	free(self->hashes);
+	free(self->flags);
+}
+static void CBPartialMerkleTreeBuild(CBPartialMerkleTree * self, unsigned char * hashes, int * matchCounts, int height, int index){
+	// Check for any match below this node
+	int first = index << height;
+	int end = (index + 1) << height;
+	if (end > self->transactionNum)
+		end = self->transactionNum;
+	bool parentOfMatch = matchCounts[end] != matchCounts[first];
+	if (parentOfMatch)
+		self->flags[self->flagNum / 8] |= 1 << (self->flagNum % 8);
+	self->flagNum++;
+	if (! height || ! parentOfMatch) {
+		CBCalculateMerkleNode(hashes, self->transactionNum, height, index, self->hashes + self->hashNum++ * 32);
+		return;
+	}
+	CBPartialMerkleTreeBuild(self, hashes, matchCounts, height - 1, index * 2);
+	if (index * 2 + 1 < CBMerkleTreeWidth(self->transactionNum, height - 1))
+		CBPartialMerkleTreeBuild(self, hashes, matchCounts, height - 1, index * 2 + 1);
+}
+int CBPartialMerkleTreeCalculateLength(CBPartialMerkleTree * self){
+	int flagBytes = (self->flagNum + 7) / 8;
+	return 4 + CBVarIntSizeOf(self->hashNum) + self->hashNum * 32 + CBVarIntSizeOf(flagBytes) + flagBytes;
+}
+int CBPartialMerkleTreeDeserialise(CBPartialMerkleTree * self, CBByteArray * bytes, int offset){
+	self->hashes = NULL;
+	self->flags = NULL;
+	int start = offset;
+	if (bytes->length < offset + 5) {
+		CBLogError("Attempting to deserialise a partial merkle tree with less bytes than required.");
+		return 0;
+	}
+	unsigned int transactionNum = CBByteArrayReadInt32(bytes, offset);
+	offset += 4;
+	if (bytes->length < offset + CBByteArrayReadVarIntSize(bytes, offset)) {
+		CBLogError("Attempting to deserialise a partial merkle tree with less bytes than required for the hash number.");
+		return 0;
+	}
+	CBVarInt hashNum = CBByteArrayReadVarInt(bytes, offset);
+	offset += hashNum.size;
+	if (! transactionNum || transactionNum > CB_PARTIAL_MERKLE_TREE_MAX_TRANSACTIONS || hashNum.val > transactionNum) {
+		CBLogError("Attempting to deserialise a partial merkle tree with a bad number of transactions or hashes.");
+		return 0;
+	}
+	if (bytes->length < offset + hashNum.val * 32 + 1
+		|| bytes->length < offset + hashNum.val * 32 + CBByteArrayReadVarIntSize(bytes, offset + hashNum.val * 32)) {
+		CBLogError("Attempting to deserialise a partial merkle tree with less bytes than required for the hashes.");
+		return 0;
+	}
+	self->transactionNum = transactionNum;
+	self->hashNum = hashNum.val;
+	self->hashes = malloc(self->hashNum * 32);
+	memcpy(self->hashes, CBByteArrayGetData(bytes) + offset, self->hashNum * 32);
+	offset += self->hashNum * 32;
+	CBVarInt flagBytes = CBByteArrayReadVarInt(bytes, offset);
+	offset += flagBytes.size;
+	if (flagBytes.val > (transactionNum * 2 + 32) / 8 + 1 || bytes->length < offset + flagBytes.val) {
+		CBLogError("Attempting to deserialise a partial merkle tree with a bad number of flag bytes.");
+		return 0;
+	}
+	self->flagNum = flagBytes.val * 8;
+	self->flags = malloc(flagBytes.val);
+	memcpy(self->flags, CBByteArrayGetData(bytes) + offset, flagBytes.val);
+	offset += flagBytes.val;
+	return offset - start;
+}
+int CBPartialMerkleTreeSerialise(CBPartialMerkleTree * self, CBByteArray * bytes, int offset){
+	int start = offset;
+	int flagBytes = (self->flagNum + 7) / 8;
+	CBByteArraySetInt32(bytes, offset, self->transactionNum);
+	offset += 4;
+	CBByteArraySetVarInt(bytes, offset, CBVarIntFromUInt64(self->hashNum));
+	offset += CBVarIntSizeOf(self->hashNum);
+	CBByteArraySetBytes(bytes, offset, self->hashes, self->hashNum * 32);
+	offset += self->hashNum * 32;
+	CBByteArraySetVarInt(bytes, offset, CBVarIntFromUInt64(flagBytes));
+	offset += CBVarIntSizeOf(flagBytes);
+	CBByteArraySetBytes(bytes, offset, self->flags, flagBytes);
+	offset += flagBytes;
+	return offset - start;
+}
+static bool CBPartialMerkleTreeTraverse(CBPartialMerkleTree * self, CBPartialMerkleTreeExtract * extract, int height, int index, unsigned char * hash){
+	if (extract->flagsUsed >= self->flagNum)
+		return false;
+	bool parentOfMatch = self->flags[extract->flagsUsed / 8] & (1 << (extract->flagsUsed % 8));
+	extract->flagsUsed++;
+	if (! height || ! parentOfMatch) {
+		if (extract->hashesUsed >= self->hashNum)
+			return false;
+		memcpy(hash, self->hashes + extract->hashesUsed++ * 32, 32);
+		if (! height && parentOfMatch) {
+			memcpy(extract->matches + extract->matchNum * 32, hash, 32);
+			if (extract->indexes)
+				extract->indexes[extract->matchNum] = index;
+			extract->matchNum++;
+		}
+		return true;
+	}
+	unsigned char cat[64];
+	unsigned char hash2[32];
+	if (! CBPartialMerkleTreeTraverse(self, extract, height - 1, index * 2, cat))
+		return false;
+	if (index * 2 + 1 < CBMerkleTreeWidth(self->transactionNum, height - 1)) {
+		if (! CBPartialMerkleTreeTraverse(self, extract, height - 1, index * 2 + 1, cat + 32))
+			return false;
+		// Identical children would allow different transaction lists with the same root.
+		if (! memcmp(cat, cat + 32, 32))
+			return false;
+	}else
+		memcpy(cat + 32, cat, 32);
+	CBSha256(cat, 64, hash2);
+	CBSha256(hash2, 32, hash);
+	return true;
+}
+bool CBPartialMerkleTreeVerify(CBPartialMerkleTree * self, unsigned char * merkleRoot, unsigned char * matches, int * indexes, int * matchNum){
+	*matchNum = 0;
+	if (! self->transactionNum || self->transactionNum > CB_PARTIAL_MERKLE_TREE_MAX_TRANSACTIONS
+		|| self->hashNum > self->transactionNum || self->flagNum < self->hashNum)
+		return false;
+	int height = 0;
+	while (CBMerkleTreeWidth(self->transactionNum, height) > 1)
+		height++;
+	CBPartialMerkleTreeExtract extract = {0, 0, matches, indexes, 0};
+	unsigned char root[32];
+	if (! CBPartialMerkleTreeTraverse(self, &extract, height, 0, root))
+		return false;
+	// All hashes and all flag bytes should be used.
+	if ((extract.flagsUsed + 7) / 8 != (self->flagNum + 7) / 8 || extract.hashesUsed != self->hashNum)
+		return false;
+	*matchNum = extract.matchNum;
+	return ! memcmp(root, merkleRoot, 32);
+}
@@ -50,13 +50,45 @@ void CBInitPeer(CBPeer * self, CBNetworkAddress * addr){
 	self->allowRelay = true;
 	self->disconnected = false;
 	self->typeExpected = CB_MESSAGE_TYPE_NONE;
+	self->bloomFilter = NULL;
 	strcpy(self->peerStr, "unknown");
 }
 
 void CBDestroyPeer(CBPeer * peer){
 	CBReleaseObject(peer->addr);
+	if (peer->bloomFilter)
+		CBReleaseObject(peer->bloomFilter);
 }
 void CBFreePeer(void * peer){
 	CBDestroyPeer(peer);
 	free(peer);
 }
+
+//  Functions
+
+bool CBPeerProcessFilterMessage(CBPeer * self){
+	switch (self->receive->type) {
+		case CB_MESSAGE_TYPE_FILTERLOAD:
+			// Replace the filter of the peer
+			if (self->bloomFilter)
+				CBReleaseObject(self->bloomFilter);
+			CBRetainObject(self->receive);
+			self->bloomFilter = CBGetBloomFilter(self->receive);
+			break;
+		case CB_MESSAGE_TYPE_FILTERADD:
+			if (! self->bloomFilter)
+				// The peer should load a filter before adding to it.
+				return false;
+			CBBloomFilterInsert(self->bloomFilter, CBByteArrayGetData(CBGetFilterAdd(self->receive)->data), CBGetFilterAdd(self->receive)->data->length);
+			break;
+		case CB_MESSAGE_TYPE_FILTERCLEAR:
+			if (self->bloomFilter) {
+				CBReleaseObject(self->bloomFilter);
+				self->bloomFilter = NULL;
+			}
+			break;
+		default:
+			break;
+	}
+	return true;
+}
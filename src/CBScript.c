@@ -15,6 +15,14 @@
 //  SEE HEADER FILE FOR DOCUMENTATION
 
 #include "CBScript.h"
+#include "CBMessage.h"
+
+/**
+ @brief Gets the template used for a script by CBScriptCompactSerialise. A script only uses a template when it is written exactly as the template would reproduce it.
+ @param self The CBScript object.
+ @returns The template, or CB_SCRIPT_COMPACT_RAW when the script is written in full.
+ */
+static CBScriptCompactTemplate CBScriptGetCompactTemplate(CBScript * self);
 
 //  Constructor
 
@@ -603,6 +611,163 @@ CBScriptStack CBNewEmptyScriptStack(){
 	stack.length = 0;
 	return stack;
 }
+int CBScriptCalculateCompactLength(CBScript * self){
+	switch (CBScriptGetCompactTemplate(self)) {
+		case CB_SCRIPT_COMPACT_KEYHASH:
+		case CB_SCRIPT_COMPACT_P2SH:
+			return 21;
+		case CB_SCRIPT_COMPACT_PUBKEY_EVEN:
+		case CB_SCRIPT_COMPACT_PUBKEY_ODD:
+			return 33;
+		case CB_SCRIPT_COMPACT_PUBKEY_UNCOMPRESSED:
+			return 65;
+		case CB_SCRIPT_COMPACT_MULTISIG:{
+			// The keys without their push operations, the template, the numbers and the key length bits.
+			int n = CBByteArrayGetByte(self, self->length - 2) - CB_SCRIPT_OP_1 + 1;
+			return self->length - 3 - n + 2 + (n + 7)/8;
+		}
+		default:
+			return CBVarIntSizeOf(self->length + CB_SCRIPT_COMPACT_RAW) + self->length;
+	}
+}
+int CBScriptCompactDeserialise(CBByteArray * bytes, int offset, CBScript ** script){
+	unsigned char * data = CBByteArrayGetData(bytes);
+	CBVarInt varInt;
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, offset, &varInt)) {
+		CBLogError("Attempting to deserialise a compact script with the template going past the end of the data.");
+		return CB_DESERIALISE_ERROR;
+	}
+	int cursor = offset + varInt.size;
+	if (varInt.val < 0 || varInt.val >= CB_SCRIPT_COMPACT_RAW) {
+		if (varInt.val < 0 || varInt.val - CB_SCRIPT_COMPACT_RAW > 10000) {
+			CBLogError("Attempting to deserialise a compact script which is too big.");
+			return CB_DESERIALISE_ERROR;
+		}
+		int len = (int)(varInt.val - CB_SCRIPT_COMPACT_RAW);
+		if (len > bytes->length - cursor) {
+			CBLogError("Attempting to deserialise a compact script going past the end of the data.");
+			return CB_DESERIALISE_ERROR;
+		}
+		*script = CBNewScriptFromReference(bytes, cursor, len);
+		return cursor + len - offset;
+	}
+	int dataLen = (int []){20, 20, 32, 32, 64, 1}[varInt.val];
+	if (dataLen > bytes->length - cursor) {
+		CBLogError("Attempting to deserialise a compact script with template data going past the end of the data.");
+		return CB_DESERIALISE_ERROR;
+	}
+	unsigned char * scriptData;
+	switch (varInt.val) {
+		case CB_SCRIPT_COMPACT_KEYHASH:
+			*script = CBNewScriptPubKeyHashOutput(data + cursor);
+			break;
+		case CB_SCRIPT_COMPACT_P2SH:
+			*script = CBNewScriptOfSize(23);
+			scriptData = CBByteArrayGetData(*script);
+			scriptData[0] = CB_SCRIPT_OP_HASH160;
+			scriptData[1] = 20;
+			memcpy(scriptData + 2, data + cursor, 20);
+			scriptData[22] = CB_SCRIPT_OP_EQUAL;
+			break;
+		case CB_SCRIPT_COMPACT_PUBKEY_EVEN:
+		case CB_SCRIPT_COMPACT_PUBKEY_ODD:
+		case CB_SCRIPT_COMPACT_PUBKEY_UNCOMPRESSED:{
+			int keyLen = dataLen + 1;
+			*script = CBNewScriptOfSize(keyLen + 2);
+			scriptData = CBByteArrayGetData(*script);
+			scriptData[0] = keyLen;
+			scriptData[1] = varInt.val == CB_SCRIPT_COMPACT_PUBKEY_UNCOMPRESSED ? 4 : (unsigned char)varInt.val;
+			memcpy(scriptData + 2, data + cursor, dataLen);
+			scriptData[keyLen + 1] = CB_SCRIPT_OP_CHECKSIG;
+			break;
+		}
+		default:{
+			// Multisig
+			int m = (data[cursor] >> 4) + 1, n = (data[cursor] & 0xF) + 1;
+			cursor++;
+			if (m > n) {
+				CBLogError("Attempting to deserialise a compact multisig script requiring more signatures than keys.");
+				return CB_DESERIALISE_ERROR;
+			}
+			int bitsLen = (n + 7)/8;
+			if (bitsLen > bytes->length - cursor) {
+				CBLogError("Attempting to deserialise a compact multisig script with the key lengths going past the end of the data.");
+				return CB_DESERIALISE_ERROR;
+			}
+			unsigned char * bits = data + cursor;
+			cursor += bitsLen;
+			int len = 3;
+			for (int x = 0; x < n; x++)
+				len += (bits[x / 8] >> (x % 8) & 1 ? 65 : 33) + 1;
+			if (len - 3 - n > bytes->length - cursor) {
+				CBLogError("Attempting to deserialise a compact multisig script with keys going past the end of the data.");
+				return CB_DESERIALISE_ERROR;
+			}
+			*script = CBNewScriptOfSize(len);
+			scriptData = CBByteArrayGetData(*script);
+			scriptData[0] = CB_SCRIPT_OP_1 + m - 1;
+			int scriptCursor = 1;
+			for (int x = 0; x < n; x++) {
+				int keyLen = bits[x / 8] >> (x % 8) & 1 ? 65 : 33;
+				scriptData[scriptCursor] = keyLen;
+				memcpy(scriptData + scriptCursor + 1, data + cursor, keyLen);
+				scriptCursor += keyLen + 1;
+				cursor += keyLen;
+			}
+			scriptData[scriptCursor] = CB_SCRIPT_OP_1 + n - 1;
+			scriptData[scriptCursor + 1] = CB_SCRIPT_OP_CHECKMULTISIG;
+			return cursor - offset;
+		}
+	}
+	return cursor + dataLen - offset;
+}
+int CBScriptCompactSerialise(CBScript * self, CBByteArray * bytes, int offset){
+	unsigned char * data = CBByteArrayGetData(bytes) + offset;
+	unsigned char * scriptData = self->length ? CBByteArrayGetData(self) : NULL;
+	CBScriptCompactTemplate template = CBScriptGetCompactTemplate(self);
+	switch (template) {
+		case CB_SCRIPT_COMPACT_KEYHASH:
+			data[0] = template;
+			memcpy(data + 1, scriptData + 3, 20);
+			return 21;
+		case CB_SCRIPT_COMPACT_P2SH:
+			data[0] = template;
+			memcpy(data + 1, scriptData + 2, 20);
+			return 21;
+		case CB_SCRIPT_COMPACT_PUBKEY_EVEN:
+		case CB_SCRIPT_COMPACT_PUBKEY_ODD:
+			data[0] = template;
+			memcpy(data + 1, scriptData + 2, 32);
+			return 33;
+		case CB_SCRIPT_COMPACT_PUBKEY_UNCOMPRESSED:
+			data[0] = template;
+			memcpy(data + 1, scriptData + 2, 64);
+			return 65;
+		case CB_SCRIPT_COMPACT_MULTISIG:{
+			int m = scriptData[0] - CB_SCRIPT_OP_1 + 1, n = scriptData[self->length - 2] - CB_SCRIPT_OP_1 + 1;
+			data[0] = template;
+			data[1] = (m - 1) << 4 | (n - 1);
+			int bitsLen = (n + 7)/8, cursor = 2 + bitsLen;
+			memset(data + 2, 0, bitsLen);
+			for (int x = 0, scriptCursor = 1; x < n; x++) {
+				int keyLen = scriptData[scriptCursor];
+				if (keyLen == 65)
+					data[2 + x / 8] |= 1 << (x % 8);
+				memcpy(data + cursor, scriptData + scriptCursor + 1, keyLen);
+				cursor += keyLen;
+				scriptCursor += keyLen + 1;
+			}
+			return cursor;
+		}
+		default:{
+			CBVarInt varInt = CBVarIntFromUInt64(self->length + CB_SCRIPT_COMPACT_RAW);
+			CBByteArraySetVarIntData(data, 0, varInt);
+			if (self->length)
+				memcpy(data + varInt.size, scriptData, self->length);
+			return varInt.size + self->length;
+		}
+	}
+}
 CBScriptExecuteReturn CBScriptExecute(CBScript * self, CBScriptStack * stack, bool (*getHashForSig)(void *, CBByteArray *, int, CBSignType, unsigned char *), void * transaction, int inputIndex, bool p2sh){
 	// ??? Adding syntax parsing to the begining of the interpreter is maybe a good idea.
 	// This looks confusing but isn't too bad, trust me.
@@ -1319,6 +1484,44 @@ CBScriptExecuteReturn CBScriptExecute(CBScript * self, CBScriptStack * stack, bo
 		return CB_SCRIPT_TRUE;
 	}else return CB_SCRIPT_FALSE;
 }
+static CBScriptCompactTemplate CBScriptGetCompactTemplate(CBScript * self){
+	if (! self->length)
+		return CB_SCRIPT_COMPACT_RAW;
+	unsigned char * data = CBByteArrayGetData(self);
+	switch (CBScriptOutputGetType(self)) {
+		case CB_TX_OUTPUT_TYPE_KEYHASH:
+			// The hash must be pushed directly, as CBScriptIsKeyHash also accepts OP_PUSHDATA1.
+			if (self->length == 25 && data[2] == 20 && data[23] == CB_SCRIPT_OP_EQUALVERIFY && data[24] == CB_SCRIPT_OP_CHECKSIG)
+				return CB_SCRIPT_COMPACT_KEYHASH;
+			break;
+		case CB_TX_OUTPUT_TYPE_P2SH:
+			return CB_SCRIPT_COMPACT_P2SH;
+		case CB_TX_OUTPUT_TYPE_PUBKEY:
+			if (self->length == 35 && data[0] == 33 && (data[1] == 2 || data[1] == 3))
+				return data[1] == 2 ? CB_SCRIPT_COMPACT_PUBKEY_EVEN : CB_SCRIPT_COMPACT_PUBKEY_ODD;
+			if (self->length == 67 && data[0] == 65 && data[1] == 4)
+				return CB_SCRIPT_COMPACT_PUBKEY_UNCOMPRESSED;
+			break;
+		case CB_TX_OUTPUT_TYPE_MULTISIG:{
+			// The numbers must be OP_1 to OP_16 and the keys pushed directly with 33 or 65 bytes.
+			int mOp = data[0], nOp = data[self->length - 2];
+			if (mOp < CB_SCRIPT_OP_1 || mOp > CB_SCRIPT_OP_16 || nOp < mOp || nOp > CB_SCRIPT_OP_16)
+				break;
+			int cursor = 1, keyNum = 0;
+			for (; cursor < self->length - 2; keyNum++) {
+				if (data[cursor] != 33 && data[cursor] != 65)
+					return CB_SCRIPT_COMPACT_RAW;
+				cursor += data[cursor] + 1;
+			}
+			if (cursor == self->length - 2 && keyNum == nOp - CB_SCRIPT_OP_1 + 1)
+				return CB_SCRIPT_COMPACT_MULTISIG;
+			break;
+		}
+		default:
+			break;
+	}
+	return CB_SCRIPT_COMPACT_RAW;
+}
 int CBScriptGetLengthOfPushOp(int dataLen){
 	if (dataLen < CB_SCRIPT_OP_PUSHDATA1)
 		return 1;
@@ -1334,6 +1537,8 @@ int CBScriptGetPushAmount(CBScript * self, int * offset){
 		return CB_NOT_A_PUSH_OP;
 	if (op < CB_SCRIPT_OP_PUSHDATA1){
 		*offset += 1 + op;
+		if (*offset > self->length)
+			return false;
 		return op;
 	}
 	(*offset)++;
@@ -1407,6 +1612,7 @@ bool CBScriptIsKeyHash(CBScript * self){
 		&& CBByteArrayGetByte(self, 0) == CB_SCRIPT_OP_DUP
 		&& CBByteArrayGetByte(self, 1) == CB_SCRIPT_OP_HASH160
 		&& CBScriptGetPushAmount(self, &cursor) == 0x14
+		&& cursor + 1 < self->length
 		&& CBByteArrayGetByte(self, cursor) == CB_SCRIPT_OP_EQUALVERIFY
 		&& CBByteArrayGetByte(self, cursor + 1) == CB_SCRIPT_OP_CHECKSIG);
 }
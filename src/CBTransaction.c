@@ -18,6 +18,40 @@
 #include <stdio.h>
 #include <assert.h>
 
+/**
+ @brief Appends a hash to a CBCompactTxIDs, retaining it.
+ @param self The CBCompactTxIDs.
+ @param hash The 32 byte hash.
+ */
+static void CBCompactTxIDsAppend(CBCompactTxIDs * self, CBByteArray * hash);
+/**
+ @brief Does nothing for the jobs of CBTransactionSignAll, which have nothing to free.
+ @param job The CBTransactionSignJob.
+ */
+static void CBTransactionSignAllDestroyJob(void * job);
+/**
+ @brief Gets the hash for a signature of an input, continuing from the SHA-256 state before the input script in the shared preimage for SIGHASH_ALL.
+ @param signer The shared state.
+ @param input The index of the input.
+ @param buffer Space for the data after the state.
+ @param hash The 32-byte hash is written here.
+ @returns true on success, false if the hash could not be made.
+ */
+static bool CBTransactionSignAllGetHash(CBTransactionSigner * signer, int input, unsigned char * buffer, unsigned char * hash);
+/**
+ @brief Signs the inputs of a CBTransactionSignJob on the thread pool.
+ @param queue The thread pool.
+ @param job The CBTransactionSignJob.
+ */
+static void CBTransactionSignAllProcess(CBThreadPoolQueue * queue, void * job);
+/**
+ @brief Signs a range of inputs for CBTransactionSignAll, writing the signatures for the inputs to the shared state.
+ @param signer The shared state.
+ @param start The first input.
+ @param end The input after the last input.
+ */
+static void CBTransactionSignAllRange(CBTransactionSigner * signer, int start, int end);
+
 //  Constructor
 
 CBTransaction * CBNewTransaction(int lockTime, int version) {
@@ -42,6 +76,14 @@ CBTransaction * CBNewTransactionFromData(CBByteArray * bytes) {
 
 //  Initialiser
 
+void CBInitCompactTxIDs(CBCompactTxIDs * self) {
+	
+	self->hashes = NULL;
+	self->num = 0;
+	self->alloc = 0;
+	CBInitHash160Map(&self->positions, 0);
+	
+}
 void CBInitTransaction(CBTransaction * self, int lockTime, int version) {
 	
 	self->lockTime = lockTime;
@@ -69,6 +111,15 @@ void CBInitTransactionFromData(CBTransaction * self, CBByteArray * data) {
 
 //  Destructor
 
+void CBFreeCompactTxIDs(CBCompactTxIDs * self) {
+	
+	for (int x = 0; x < self->num; x++)
+		CBReleaseObject(self->hashes[x]);
+	free(self->hashes);
+	CBFreeHash160Map(&self->positions);
+	
+}
+
 void CBDestroyTransaction(void * vself) {
 	
 	CBTransaction * self = vself;
@@ -94,6 +145,17 @@ void CBFreeTransaction(void * self) {
 
 //  Functions
 
+static void CBCompactTxIDsAppend(CBCompactTxIDs * self, CBByteArray * hash) {
+	
+	if (self->num == self->alloc) {
+		self->alloc = self->alloc ? self->alloc * 2 : 64;
+		self->hashes = realloc(self->hashes, sizeof(*self->hashes) * self->alloc);
+	}
+	CBRetainObject(hash);
+	self->hashes[self->num++] = hash;
+	
+}
+
 void CBTransactionAddInput(CBTransaction * self, CBTransactionInput * input) {
 	
 	CBRetainObject(input);
@@ -155,6 +217,23 @@ void CBTransactionCalculateHash(CBTransaction * self, unsigned char * hash) {
 	
 }
 
+int CBTransactionCalculateCompactLength(CBTransaction * self) {
+	
+	int len = CBVarIntSizeOf((unsigned int)self->version) + CBVarIntSizeOf(self->inputNum)
+		+ CBVarIntSizeOf(self->outputNum) + CBVarIntSizeOf((unsigned int)self->lockTime);
+	
+	for (int x = 0; x < self->inputNum; x++) {
+		CBTransactionInput * input = self->inputs[x];
+		len += 33 + CBVarIntSizeOf((unsigned int)(input->prevOut.index + 1)) + CBVarIntSizeOf((unsigned int)~input->sequence)
+			+ CBVarIntSizeOf(input->scriptObject->length) + input->scriptObject->length;
+	}
+	
+	for (int x = 0; x < self->outputNum; x++)
+		len += CBTransactionOutputCalculateCompactLength(self->outputs[x]);
+	
+	return len;
+	
+}
 int CBTransactionCalculateLength(CBTransaction * self) {
 	
 	// 8 is for version and lockTime.
@@ -170,6 +249,160 @@ int CBTransactionCalculateLength(CBTransaction * self) {
 	
 }
 
+int CBTransactionCompactDeserialise(CBTransaction * self, CBByteArray * bytes, int offset, CBCompactTxIDs * txids) {
+	
+	unsigned char * data = CBByteArrayGetData(bytes);
+	int cursor = offset;
+	CBVarInt varInt;
+	
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, cursor, &varInt)) {
+		CBLogError("Attempting to deserialise a compact CBTransaction with the version going past the end of the data.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->version = (int)varInt.val;
+	cursor += varInt.size;
+	
+	// Each input needs at least 4 bytes.
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, cursor, &varInt)
+		|| varInt.val < 0 || varInt.val > (bytes->length - cursor - varInt.size)/4) {
+		CBLogError("Attempting to deserialise a compact CBTransaction with less bytes than required for the inputs.");
+		return CB_DESERIALISE_ERROR;
+	}
+	cursor += varInt.size;
+	self->inputs = malloc(sizeof(*self->inputs) * (varInt.val ? varInt.val : 1));
+	for (int inputNum = (int)varInt.val; self->inputNum < inputNum;) {
+		// The previous output hash
+		if (! CBVarIntDecodeDataChecked(data, bytes->length, cursor, &varInt)) {
+			CBLogError("Attempting to deserialise a compact CBTransactionInput with the hash position going past the end of the data.");
+			return CB_DESERIALISE_ERROR;
+		}
+		cursor += varInt.size;
+		CBByteArray * hash;
+		if (varInt.val == 0) {
+			if (bytes->length - cursor < 32) {
+				CBLogError("Attempting to deserialise a compact CBTransactionInput with the hash going past the end of the data.");
+				return CB_DESERIALISE_ERROR;
+			}
+			hash = CBByteArraySubReference(bytes, cursor, 32);
+			cursor += 32;
+			if (txids)
+				CBCompactTxIDsAppend(txids, hash);
+		}else{
+			if (! txids || varInt.val < 0 || varInt.val > txids->num) {
+				CBLogError("Attempting to deserialise a compact CBTransactionInput with the position of a hash which has not been read.");
+				return CB_DESERIALISE_ERROR;
+			}
+			hash = txids->hashes[varInt.val - 1];
+			CBRetainObject(hash);
+		}
+		// The index, sequence and script length
+		CBVarInt fields[3];
+		for (int y = 0; y < 3; y++) {
+			if (! CBVarIntDecodeDataChecked(data, bytes->length, cursor, fields + y)) {
+				CBLogError("Attempting to deserialise a compact CBTransactionInput going past the end of the data.");
+				CBReleaseObject(hash);
+				return CB_DESERIALISE_ERROR;
+			}
+			cursor += fields[y].size;
+		}
+		if (fields[2].val < 0 || fields[2].val > 10000 || fields[2].val > bytes->length - cursor) {
+			CBLogError("Attempting to deserialise a compact CBTransactionInput with a script going past the end of the data or too big.");
+			CBReleaseObject(hash);
+			return CB_DESERIALISE_ERROR;
+		}
+		CBScript * script = CBNewScriptFromReference(bytes, cursor, (int)fields[2].val);
+		cursor += fields[2].val;
+		self->inputs[self->inputNum++] = CBNewTransactionInputTakeScriptAndHash(script, (unsigned int)~fields[1].val, hash, (unsigned int)fields[0].val - 1);
+	}
+	
+	// Each output needs at least 2 bytes.
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, cursor, &varInt)
+		|| varInt.val < 0 || varInt.val > (bytes->length - cursor - varInt.size)/2) {
+		CBLogError("Attempting to deserialise a compact CBTransaction with less bytes than required for the outputs.");
+		return CB_DESERIALISE_ERROR;
+	}
+	cursor += varInt.size;
+	self->outputs = malloc(sizeof(*self->outputs) * (varInt.val ? varInt.val : 1));
+	for (int outputNum = (int)varInt.val; self->outputNum < outputNum;) {
+		int len = CBTransactionOutputCompactDeserialise(bytes, cursor, self->outputs + self->outputNum);
+		if (len == CB_DESERIALISE_ERROR) {
+			CBLogError("Could not deserialise a compact CBTransactionOutput.");
+			return CB_DESERIALISE_ERROR;
+		}
+		self->outputNum++;
+		cursor += len;
+	}
+	
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, cursor, &varInt)) {
+		CBLogError("Attempting to deserialise a compact CBTransaction with the lock time going past the end of the data.");
+		return CB_DESERIALISE_ERROR;
+	}
+	self->lockTime = (int)varInt.val;
+	cursor += varInt.size;
+	
+	return cursor - offset;
+	
+}
+int CBTransactionCompactSerialise(CBTransaction * self, CBByteArray * bytes, int offset, CBCompactTxIDs * txids) {
+	
+	unsigned char * data = CBByteArrayGetData(bytes);
+	int cursor = offset;
+	CBVarInt varInt = CBVarIntFromUInt64((unsigned int)self->version);
+	CBByteArraySetVarIntData(data, cursor, varInt);
+	cursor += varInt.size;
+	
+	varInt = CBVarIntFromUInt64(self->inputNum);
+	CBByteArraySetVarIntData(data, cursor, varInt);
+	cursor += varInt.size;
+	for (int x = 0; x < self->inputNum; x++) {
+		CBTransactionInput * input = self->inputs[x];
+		unsigned char * hash = CBByteArrayGetData(input->prevOut.hash);
+		// Find the hash by its first 20 bytes and check the rest.
+		int pos = 0;
+		if (txids) {
+			pos = (int)(uintptr_t)CBHash160MapGet(&txids->positions, hash);
+			if (pos && memcmp(CBByteArrayGetData(txids->hashes[pos - 1]), hash, 32))
+				pos = 0;
+		}
+		varInt = CBVarIntFromUInt64(pos);
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		if (! pos) {
+			memcpy(data + cursor, hash, 32);
+			cursor += 32;
+			if (txids) {
+				CBCompactTxIDsAppend(txids, input->prevOut.hash);
+				if (! CBHash160MapGet(&txids->positions, hash))
+					CBHash160MapInsert(&txids->positions, hash, (void *)(uintptr_t)txids->num);
+			}
+		}
+		varInt = CBVarIntFromUInt64((unsigned int)(input->prevOut.index + 1));
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		varInt = CBVarIntFromUInt64((unsigned int)~input->sequence);
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		varInt = CBVarIntFromUInt64(input->scriptObject->length);
+		CBByteArraySetVarIntData(data, cursor, varInt);
+		cursor += varInt.size;
+		if (input->scriptObject->length)
+			memcpy(data + cursor, CBByteArrayGetData(input->scriptObject), input->scriptObject->length);
+		cursor += input->scriptObject->length;
+	}
+	
+	varInt = CBVarIntFromUInt64(self->outputNum);
+	CBByteArraySetVarIntData(data, cursor, varInt);
+	cursor += varInt.size;
+	for (int x = 0; x < self->outputNum; x++)
+		cursor += CBTransactionOutputCompactSerialise(self->outputs[x], bytes, cursor);
+	
+	varInt = CBVarIntFromUInt64((unsigned int)self->lockTime);
+	CBByteArraySetVarIntData(data, cursor, varInt);
+	cursor += varInt.size;
+	
+	return cursor - offset;
+	
+}
 int CBTransactionDeserialise(CBTransaction * self) {
 	
 	CBByteArray * bytes = CBGetMessage(self)->bytes;
@@ -663,6 +896,248 @@ int CBTransactionSerialise(CBTransaction * self, bool force) {
 	
 }
 
+bool CBTransactionSignAll(CBTransaction * self, bool (*getKeys)(void *, CBTransaction *, int, CBTransactionSignInput *), void * callbackObject, int numThreads) {
+	
+	CBTransactionSigner signer;
+	signer.tx = self;
+	signer.inputs = calloc(self->inputNum, sizeof(*signer.inputs));
+	signer.sigStarts = malloc(sizeof(*signer.sigStarts) * (self->inputNum + 1));
+	signer.maxSubScriptLength = 0;
+	signer.preimage = NULL;
+	signer.midstates = NULL;
+	signer.signatures = NULL;
+	signer.sigLens = NULL;
+	bool ok = true, anyAll = false;
+	
+	// Get the keys for every input on the calling thread.
+	int sigNum = 0;
+	for (int x = 0; x < self->inputNum; x++) {
+		CBTransactionSignInput * input = signer.inputs + x;
+		signer.sigStarts[x] = sigNum;
+		if (! getKeys(callbackObject, self, x, input)) {
+			ok = false;
+			break;
+		}
+		if (input->type == CB_TX_SIGN_SKIP)
+			continue;
+		if (input->keyNum < 1 || input->keyNum > CB_TX_SIGN_MAX_KEYS
+			|| (input->type != CB_TX_SIGN_MULTISIG && input->keyNum != 1)) {
+			CBLogError("Attempting to sign a transaction input with a bad number of keys.");
+			ok = false;
+			break;
+		}
+		sigNum += input->keyNum;
+		if (input->prevOutSubScript->length > signer.maxSubScriptLength)
+			signer.maxSubScriptLength = input->prevOutSubScript->length;
+		int last5Bits = input->signType & 0x1f;
+		if (! (input->signType & CB_SIGHASH_ANYONECANPAY) && last5Bits != CB_SIGHASH_NONE && last5Bits != CB_SIGHASH_SINGLE)
+			anyAll = true;
+	}
+	signer.sigStarts[self->inputNum] = sigNum;
+	
+	if (ok && anyAll) {
+		
+		// Make the preimage for SIGHASH_ALL with every input script empty.
+		CBVarInt inputNum = CBVarIntFromUInt64(self->inputNum);
+		CBVarInt outputNum = CBVarIntFromUInt64(self->outputNum);
+		int length = 8 + inputNum.size + self->inputNum * 41 + outputNum.size;
+		for (int x = 0; x < self->outputNum; x++) {
+			int len = CBGetByteArray(self->outputs[x]->scriptObject)->length;
+			length += 8 + CBVarIntSizeOf(len) + len;
+		}
+		CBByteArray * data = CBNewByteArrayOfSize(length);
+		CBByteArraySetInt32(data, 0, self->version);
+		CBByteArraySetVarInt(data, 4, inputNum);
+		int cursor = 4 + inputNum.size;
+		signer.scriptOffset = cursor + 36;
+		for (int x = 0; x < self->inputNum; x++) {
+			CBByteArrayCopyByteArray(data, cursor, self->inputs[x]->prevOut.hash);
+			CBByteArraySetInt32(data, cursor + 32, self->inputs[x]->prevOut.index);
+			CBByteArraySetByte(data, cursor + 36, 0);
+			CBByteArraySetInt32(data, cursor + 37, self->inputs[x]->sequence);
+			cursor += 41;
+		}
+		CBByteArraySetVarInt(data, cursor, outputNum);
+		cursor += outputNum.size;
+		for (int x = 0; x < self->outputNum; x++) {
+			CBByteArraySetInt64(data, cursor, self->outputs[x]->value);
+			cursor += 8;
+			CBVarInt varInt = CBVarIntFromUInt64(CBGetByteArray(self->outputs[x]->scriptObject)->length);
+			CBByteArraySetVarInt(data, cursor, varInt);
+			cursor += varInt.size;
+			CBByteArrayCopyByteArray(data, cursor, CBGetByteArray(self->outputs[x]->scriptObject));
+			cursor += varInt.val;
+		}
+		CBByteArraySetInt32(data, cursor, self->lockTime);
+		assert(cursor + 4 == length);
+		signer.preimageLength = length;
+		signer.preimage = malloc(length);
+		memcpy(signer.preimage, CBByteArrayGetData(data), length);
+		CBReleaseObject(data);
+		
+		// Keep the SHA-256 states for the blocks up to the script of the last input.
+		int blocks = (signer.scriptOffset + (self->inputNum - 1) * 41) / 64;
+		signer.midstates = malloc(32 * (blocks ? blocks : 1));
+		CBSha256Midstates(signer.preimage, blocks, signer.midstates);
+		
+	}
+	
+	if (ok) {
+		
+		signer.signatures = malloc(CB_MAX_DER_SIG_SIZE * (sigNum ? sigNum : 1));
+		signer.sigLens = malloc(sizeof(*signer.sigLens) * (sigNum ? sigNum : 1));
+		if (numThreads > 1 && self->inputNum > CB_TX_SIGN_JOB_INPUTS) {
+			CBThreadPoolQueue pool;
+			CBInitThreadPoolQueue(&pool, numThreads, CBTransactionSignAllProcess, CBTransactionSignAllDestroyJob);
+			for (int x = 0; x < self->inputNum; x += CB_TX_SIGN_JOB_INPUTS) {
+				CBTransactionSignJob * job = malloc(sizeof(*job));
+				job->signer = &signer;
+				job->start = x;
+				job->end = self->inputNum - x < CB_TX_SIGN_JOB_INPUTS ? self->inputNum : x + CB_TX_SIGN_JOB_INPUTS;
+				CBThreadPoolQueueAdd(&pool, &job->base);
+			}
+			CBThreadPoolQueueWaitUntilFinished(&pool);
+			CBDestroyThreadPoolQueue(&pool);
+		}else
+			CBTransactionSignAllRange(&signer, 0, self->inputNum);
+		for (int x = 0; x < sigNum; x++)
+			if (! signer.sigLens[x]) {
+				CBLogError("Unable to sign a transaction input.");
+				ok = false;
+				break;
+			}
+		
+	}
+	
+	if (ok) {
+		
+		// Write every input script at its final size.
+		for (int x = 0; x < self->inputNum; x++) {
+			CBTransactionSignInput * input = signer.inputs + x;
+			if (input->type == CB_TX_SIGN_SKIP)
+				continue;
+			int first = signer.sigStarts[x], length = input->type == CB_TX_SIGN_MULTISIG;
+			for (int y = 0; y < input->keyNum; y++)
+				length += signer.sigLens[first + y] + 2;
+			if (input->type == CB_TX_SIGN_PUBKEY_HASH)
+				length += CB_PUBKEY_SIZE + 1;
+			CBScript * script = CBNewScriptOfSize(length);
+			unsigned char * bytes = CBByteArrayGetData(script);
+			int cursor = 0;
+			if (input->type == CB_TX_SIGN_MULTISIG)
+				bytes[cursor++] = CB_SCRIPT_OP_0;
+			for (int y = 0; y < input->keyNum; y++) {
+				int len = signer.sigLens[first + y];
+				bytes[cursor] = len + 1;
+				memcpy(bytes + cursor + 1, signer.signatures + (first + y) * CB_MAX_DER_SIG_SIZE, len);
+				bytes[cursor + len + 1] = input->signType;
+				cursor += len + 2;
+			}
+			if (input->type == CB_TX_SIGN_PUBKEY_HASH) {
+				bytes[cursor] = CB_PUBKEY_SIZE;
+				memcpy(bytes + cursor + 1, input->keys[0]->pubkey.key, CB_PUBKEY_SIZE);
+			}
+			if (self->inputs[x]->scriptObject)
+				CBReleaseObject(self->inputs[x]->scriptObject);
+			self->inputs[x]->scriptObject = script;
+		}
+		
+		// Serialise once for all of the new scripts.
+		if (CBGetMessage(self)->serialised) {
+			CBTransactionPrepareBytes(self);
+			if (! CBTransactionSerialise(self, true))
+				ok = false;
+		}
+		
+	}
+	
+	free(signer.inputs);
+	free(signer.sigStarts);
+	free(signer.preimage);
+	free(signer.midstates);
+	free(signer.signatures);
+	free(signer.sigLens);
+	
+	return ok;
+	
+}
+
+static void CBTransactionSignAllDestroyJob(void * job) {
+	
+	UNUSED(job);
+	
+}
+
+static bool CBTransactionSignAllGetHash(CBTransactionSigner * signer, int input, unsigned char * buffer, unsigned char * hash) {
+	
+	CBTransactionSignInput * signInput = signer->inputs + input;
+	int last5Bits = signInput->signType & 0x1f;
+	if (signInput->signType & CB_SIGHASH_ANYONECANPAY || last5Bits == CB_SIGHASH_NONE || last5Bits == CB_SIGHASH_SINGLE)
+		return CBTransactionGetInputHashForSignature(signer->tx, signInput->prevOutSubScript, input, signInput->signType, hash);
+	
+	// Continue from the last state before the script of the input, placing the prevOutSubScript in the empty script.
+	int scriptStart = signer->scriptOffset + input * 41, blocks = scriptStart / 64, cursor = scriptStart - blocks * 64;
+	memcpy(buffer, signer->preimage + blocks * 64, cursor);
+	CBVarInt varInt = CBVarIntFromUInt64(signInput->prevOutSubScript->length);
+	CBByteArraySetVarIntData(buffer, cursor, varInt);
+	cursor += varInt.size;
+	memcpy(buffer + cursor, CBByteArrayGetData(signInput->prevOutSubScript), signInput->prevOutSubScript->length);
+	cursor += signInput->prevOutSubScript->length;
+	memcpy(buffer + cursor, signer->preimage + scriptStart + 1, signer->preimageLength - scriptStart - 1);
+	cursor += signer->preimageLength - scriptStart - 1;
+	CBInt32ToArray(buffer, cursor, signInput->signType);
+	cursor += 4;
+	unsigned char firstHash[32];
+	CBSha256FromMidstate(blocks ? signer->midstates + (blocks - 1) * 32 : NULL, blocks, buffer, cursor, firstHash);
+	CBSha256(firstHash, 32, hash);
+	return true;
+	
+}
+
+static void CBTransactionSignAllProcess(CBThreadPoolQueue * queue, void * vjob) {
+	
+	UNUSED(queue);
+	CBTransactionSignJob * job = vjob;
+	CBTransactionSignAllRange(job->signer, job->start, job->end);
+	
+}
+
+static void CBTransactionSignAllRange(CBTransactionSigner * signer, int start, int end) {
+	
+	int first = signer->sigStarts[start], num = signer->sigStarts[end] - first;
+	if (! num)
+		return;
+	unsigned char * buffer = signer->preimage ? malloc(signer->preimageLength + signer->maxSubScriptLength + 13) : NULL;
+	unsigned char * hashes = malloc(32 * (end - start));
+	unsigned char ** privKeys = malloc(sizeof(*privKeys) * num), ** hashPtrs = malloc(sizeof(*hashPtrs) * num), ** sigPtrs = malloc(sizeof(*sigPtrs) * num);
+	// Failed inputs keep zero lengths for their signatures.
+	memset(signer->sigLens + first, 0, sizeof(*signer->sigLens) * num);
+	int sig = 0;
+	for (int x = start; x < end; x++) {
+		CBTransactionSignInput * input = signer->inputs + x;
+		if (input->type == CB_TX_SIGN_SKIP
+			|| ! CBTransactionSignAllGetHash(signer, x, buffer, hashes + (x - start) * 32))
+			continue;
+		for (int y = 0; y < input->keyNum; y++) {
+			privKeys[sig] = input->keys[y]->privkey;
+			hashPtrs[sig] = hashes + (x - start) * 32;
+			sigPtrs[sig] = signer->signatures + (signer->sigStarts[x] + y) * CB_MAX_DER_SIG_SIZE;
+			sig++;
+		}
+	}
+	int * sigLens = malloc(sizeof(*sigLens) * (sig ? sig : 1));
+	CBKeySignBatch(privKeys, hashPtrs, sig, sigPtrs, sigLens);
+	for (int x = 0; x < sig; x++)
+		signer->sigLens[(sigPtrs[x] - signer->signatures) / CB_MAX_DER_SIG_SIZE] = sigLens[x];
+	free(sigLens);
+	free(buffer);
+	free(hashes);
+	free(privKeys);
+	free(hashPtrs);
+	free(sigPtrs);
+	
+}
+
 bool CBTransactionSignMultisigInput(CBTransaction * self, CBKeyPair * key, CBByteArray * prevOutSubScript, int input, CBSignType signType) {
 	
 	CBScript * inScript;
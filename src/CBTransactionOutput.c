@@ -15,6 +15,7 @@
 //  SEE HEADER FILE FOR DOCUMENTATION
 
 #include "CBTransactionOutput.h"
+#include "CBValidationFunctions.h"
 
 //  Constructors
 
@@ -90,10 +91,64 @@ void CBFreeTransactionOutput(void * self) {
 
 //  Functions
 
+int CBTransactionOutputCalculateCompactLength(CBTransactionOutput * self) {
+	
+	int len = self->value > CB_MAX_MONEY ? 9 + 8 : CBVarIntSizeOf(CBCompressAmount(self->value));
+	return len + CBScriptCalculateCompactLength(self->scriptObject);
+	
+}
 int CBTransactionOutputCalculateLength(CBTransactionOutput * self) {
 	
 	return CBVarIntSizeOf(self->scriptObject->length) + self->scriptObject->length + 8;
 	
+}
+int CBTransactionOutputCompactDeserialise(CBByteArray * bytes, int offset, CBTransactionOutput ** output) {
+	
+	unsigned char * data = CBByteArrayGetData(bytes);
+	CBVarInt value;
+	if (! CBVarIntDecodeDataChecked(data, bytes->length, offset, &value)) {
+		CBLogError("Attempting to deserialise a compact CBTransactionOutput with the value going past the end of the data.");
+		return CB_DESERIALISE_ERROR;
+	}
+	int cursor = offset + value.size;
+	unsigned long long int amount;
+	if (value.val == CB_OUTPUT_COMPACT_FULL_VALUE) {
+		if (bytes->length - cursor < 8) {
+			CBLogError("Attempting to deserialise a compact CBTransactionOutput with the full value going past the end of the data.");
+			return CB_DESERIALISE_ERROR;
+		}
+		amount = CBArrayToInt64(data, cursor);
+		cursor += 8;
+	}else
+		amount = CBDecompressAmount(value.val);
+	
+	CBScript * script;
+	int len = CBScriptCompactDeserialise(bytes, cursor, &script);
+	if (len == CB_DESERIALISE_ERROR) {
+		CBLogError("Could not deserialise the script of a compact CBTransactionOutput.");
+		return CB_DESERIALISE_ERROR;
+	}
+	*output = CBNewTransactionOutputTakeScript(amount, script);
+	
+	return cursor + len - offset;
+	
+}
+int CBTransactionOutputCompactSerialise(CBTransactionOutput * self, CBByteArray * bytes, int offset) {
+	
+	unsigned char * data = CBByteArrayGetData(bytes);
+	int cursor = offset;
+	if (self->value > CB_MAX_MONEY) {
+		CBByteArraySetVarIntData(data, cursor, CBVarIntFromUInt64(CB_OUTPUT_COMPACT_FULL_VALUE));
+		CBInt64ToArray(data, cursor + 9, self->value);
+		cursor += 9 + 8;
+	}else{
+		CBVarInt value = CBVarIntFromUInt64(CBCompressAmount(self->value));
+		CBByteArraySetVarIntData(data, cursor, value);
+		cursor += value.size;
+	}
+	
+	return cursor + CBScriptCompactSerialise(self->scriptObject, bytes, cursor) - offset;
+	
 }
 int CBTransactionOutputDeserialise(CBTransactionOutput * self) {
 	
@@ -0,0 +1,210 @@
+//
+//  CBUInt256.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBUInt256.h"
+
+/**
+ @brief Divides a CBUInt256 by a 32-bit divisor, one 32-bit word at a time.
+ @param a The CBUInt256 to divide.
+ @param b The divisor, which is not zero.
+ @returns The remainder.
+ */
+static uint32_t CBUInt256EqualsDivisionByUInt32(CBUInt256 * a, uint32_t b);
+
+int CBUInt256Bits(CBUInt256 * a){
+	for (int x = 4; x--;)
+		if (a->limbs[x])
+			for (int bit = 64; bit--;)
+				if (a->limbs[x] >> bit)
+					return x * 64 + bit + 1;
+	return 0;
+}
+CBCompare CBUInt256CompareToUInt256(CBUInt256 * a, CBUInt256 * b){
+	for (int x = 4; x--;) {
+		if (a->limbs[x] > b->limbs[x])
+			return CB_COMPARE_MORE_THAN;
+		if (a->limbs[x] < b->limbs[x])
+			return CB_COMPARE_LESS_THAN;
+	}
+	return CB_COMPARE_EQUAL;
+}
+bool CBUInt256EqualsAdditionByUInt256(CBUInt256 * a, CBUInt256 * b){
+	uint64_t carry = 0;
+	for (int x = 0; x < 4; x++) {
+		uint64_t sum = a->limbs[x] + carry;
+		carry = sum < carry;
+		a->limbs[x] = sum + b->limbs[x];
+		carry += a->limbs[x] < sum;
+	}
+	return carry;
+}
+static uint32_t CBUInt256EqualsDivisionByUInt32(CBUInt256 * a, uint32_t b){
+	uint64_t rem = 0;
+	for (int x = 4; x--;) {
+		uint64_t high = (rem << 32) | (a->limbs[x] >> 32);
+		rem = high % b;
+		uint64_t low = (rem << 32) | (a->limbs[x] & 0xFFFFFFFF);
+		rem = low % b;
+		a->limbs[x] = (high / b) << 32 | (low / b);
+	}
+	return (uint32_t)rem;
+}
+bool CBUInt256EqualsDivisionByUInt256(CBUInt256 * a, CBUInt256 * b, CBUInt256 * remainder){
+	if (CBUInt256IsZero(b))
+		return false;
+	if (! (b->limbs[1] | b->limbs[2] | b->limbs[3]) && b->limbs[0] <= 0xFFFFFFFF) {
+		// Short division for small divisors
+		uint32_t rem = CBUInt256EqualsDivisionByUInt32(a, (uint32_t)b->limbs[0]);
+		if (remainder)
+			CBUInt256FromUInt64(remainder, rem);
+		return true;
+	}
+	// Shift and subtract only for the bits the quotient can have.
+	CBUInt256 num = *a, div = *b, quotient;
+	CBUInt256FromUInt64(&quotient, 0);
+	int shift = CBUInt256Bits(&num) - CBUInt256Bits(&div);
+	if (shift >= 0) {
+		CBUInt256EqualsShiftLeft(&div, shift);
+		for (; shift >= 0; shift--) {
+			if (CBUInt256CompareToUInt256(&num, &div) != CB_COMPARE_LESS_THAN) {
+				CBUInt256EqualsSubtractionByUInt256(&num, &div);
+				quotient.limbs[shift / 64] |= (uint64_t)1 << (shift % 64);
+			}
+			CBUInt256EqualsShiftRight(&div, 1);
+		}
+	}
+	*a = quotient;
+	if (remainder)
+		*remainder = num;
+	return true;
+}
+bool CBUInt256EqualsMultiplicationByUInt256(CBUInt256 * a, CBUInt256 * b){
+	// Schoolbook multiplication with 32-bit words, so that each product fits into 64 bits.
+	uint32_t aWords[8], bWords[8], result[8] = {0};
+	for (int x = 0; x < 4; x++) {
+		aWords[x * 2] = (uint32_t)a->limbs[x];
+		aWords[x * 2 + 1] = (uint32_t)(a->limbs[x] >> 32);
+		bWords[x * 2] = (uint32_t)b->limbs[x];
+		bWords[x * 2 + 1] = (uint32_t)(b->limbs[x] >> 32);
+	}
+	bool overflow = false;
+	for (int x = 0; x < 8; x++) {
+		if (! aWords[x])
+			continue;
+		uint64_t carry = 0;
+		for (int y = 0; y < 8; y++) {
+			if (x + y >= 8) {
+				if (bWords[y])
+					overflow = true;
+				continue;
+			}
+			uint64_t product = (uint64_t)aWords[x] * bWords[y] + result[x + y] + carry;
+			result[x + y] = (uint32_t)product;
+			carry = product >> 32;
+		}
+		if (carry)
+			overflow = true;
+	}
+	for (int x = 0; x < 4; x++)
+		a->limbs[x] = (uint64_t)result[x * 2 + 1] << 32 | result[x * 2];
+	return overflow;
+}
+void CBUInt256EqualsShiftLeft(CBUInt256 * a, int bits){
+	int limbShift = bits / 64;
+	bits %= 64;
+	for (int x = 4; x--;) {
+		uint64_t limb = 0;
+		if (x >= limbShift) {
+			limb = a->limbs[x - limbShift] << bits;
+			if (bits && x > limbShift)
+				limb |= a->limbs[x - limbShift - 1] >> (64 - bits);
+		}
+		a->limbs[x] = limb;
+	}
+}
+void CBUInt256EqualsShiftRight(CBUInt256 * a, int bits){
+	int limbShift = bits / 64;
+	bits %= 64;
+	for (int x = 0; x < 4; x++) {
+		uint64_t limb = 0;
+		if (x + limbShift < 4) {
+			limb = a->limbs[x + limbShift] >> bits;
+			if (bits && x + limbShift < 3)
+				limb |= a->limbs[x + limbShift + 1] << (64 - bits);
+		}
+		a->limbs[x] = limb;
+	}
+}
+bool CBUInt256EqualsSubtractionByUInt256(CBUInt256 * a, CBUInt256 * b){
+	uint64_t borrow = 0;
+	for (int x = 0; x < 4; x++) {
+		uint64_t diff = a->limbs[x] - b->limbs[x];
+		uint64_t newBorrow = diff > a->limbs[x];
+		a->limbs[x] = diff - borrow;
+		borrow = newBorrow | (a->limbs[x] > diff);
+	}
+	return borrow;
+}
+void CBUInt256FromBytes(CBUInt256 * a, unsigned char * bytes){
+	for (int x = 0; x < 4; x++) {
+		uint64_t limb = 0;
+		for (int y = 8; y--;)
+			limb = limb << 8 | bytes[x * 8 + y];
+		a->limbs[x] = limb;
+	}
+}
+bool CBUInt256FromCompact(CBUInt256 * a, uint32_t compact){
+	int size = compact >> 24;
+	uint32_t mantissa = compact & 0x007FFFFF;
+	if (size <= 3) {
+		CBUInt256FromUInt64(a, mantissa >> 8 * (3 - size));
+		// The value is the same whatever the exponent when the mantissa is zero.
+		return ! (mantissa && compact & 0x00800000);
+	}
+	CBUInt256FromUInt64(a, mantissa);
+	if (mantissa && (size > 34 || (mantissa > 0xFF && size > 33) || (mantissa > 0xFFFF && size > 32)))
+		return false;
+	CBUInt256EqualsShiftLeft(a, 8 * (size - 3));
+	return ! (mantissa && compact & 0x00800000);
+}
+void CBUInt256FromUInt64(CBUInt256 * a, uint64_t b){
+	a->limbs[0] = b;
+	a->limbs[1] = a->limbs[2] = a->limbs[3] = 0;
+}
+bool CBUInt256IsZero(CBUInt256 * a){
+	return ! (a->limbs[0] | a->limbs[1] | a->limbs[2] | a->limbs[3]);
+}
+void CBUInt256ToBytes(CBUInt256 * a, unsigned char * bytes){
+	for (int x = 0; x < 32; x++)
+		bytes[x] = (unsigned char)(a->limbs[x / 8] >> (x % 8 * 8));
+}
+uint32_t CBUInt256ToCompact(CBUInt256 * a){
+	int size = (CBUInt256Bits(a) + 7) / 8;
+	uint32_t compact;
+	if (size <= 3)
+		compact = (uint32_t)(a->limbs[0] << 8 * (3 - size));
+	else{
+		CBUInt256 shifted = *a;
+		CBUInt256EqualsShiftRight(&shifted, 8 * (size - 3));
+		compact = (uint32_t)shifted.limbs[0];
+	}
+	// The mantissa is signed, so move it down a byte if the sign bit would be set.
+	if (compact & 0x00800000) {
+		compact >>= 8;
+		size++;
+	}
+	return compact | (uint32_t)size << 24;
+}
@@ -0,0 +1,103 @@
+//
+//  CBUnspentOutputSet.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBUnspentOutputSet.h"
+
+static unsigned char CBOutPointKeySize = CB_OUTPOINT_KEY_SIZE;
+
+//  Constructors
+
+CBUnspentOutputSet * CBNewUnspentOutputSet(void){
+	CBUnspentOutputSet * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeUnspentOutputSet;
+	CBInitUnspentOutputSet(self);
+	return self;
+}
+CBUnspentOutput * CBNewUnspentOutput(unsigned char * txHash, unsigned int index, unsigned long long int value, unsigned char * script, int scriptLength, unsigned int height, bool coinbase){
+	CBUnspentOutput * self = malloc(sizeof(*self) + scriptLength);
+	if (txHash)
+		CBMakeOutPointKey(self->outPoint, txHash, index);
+	else
+		memset(self->outPoint, 0, CB_OUTPOINT_KEY_SIZE);
+	self->value = value;
+	self->height = height;
+	self->coinbase = coinbase;
+	self->scriptLength = scriptLength;
+	if (scriptLength)
+		memcpy(self->script, script, scriptLength);
+	return self;
+}
+
+//  Initialiser
+
+void CBInitUnspentOutputSet(CBUnspentOutputSet * self){
+	CBInitObject(CBGetObject(self), false);
+	CBInitAssociativeArray(&self->outputs, CBFixedKeyCompare, &CBOutPointKeySize, free);
+	self->outputNum = 0;
+}
+
+//  Destructor
+
+void CBDestroyUnspentOutputSet(void * self){
+	CBFreeAssociativeArray(&CBGetUnspentOutputSet(self)->outputs);
+}
+void CBFreeUnspentOutputSet(void * self){
+	CBDestroyUnspentOutputSet(self);
+	free(self);
+}
+
+//  Functions
+
+void CBMakeOutPointKey(unsigned char * key, unsigned char * txHash, unsigned int index){
+	memcpy(key, txHash, 32);
+	CBInt32ToArray(key, 32, index);
+}
+CBUnspentOutput * CBUnspentOutputSetGetOutput(CBUnspentOutputSet * self, unsigned char * txHash, unsigned int index){
+	unsigned char key[CB_OUTPOINT_KEY_SIZE];
+	CBMakeOutPointKey(key, txHash, index);
+	CBFindResult res = CBAssociativeArrayFind(&self->outputs, key);
+	if (! res.found)
+		return NULL;
+	return CBFindResultToPointer(res);
+}
+bool CBUnspentOutputSetRemoveOutput(CBUnspentOutputSet * self, unsigned char * txHash, unsigned int index){
+	CBUnspentOutput * output = CBUnspentOutputSetSpendOutput(self, txHash, index);
+	if (! output)
+		return false;
+	free(output);
+	return true;
+}
+CBUnspentOutput * CBUnspentOutputSetSpendOutput(CBUnspentOutputSet * self, unsigned char * txHash, unsigned int index){
+	unsigned char key[CB_OUTPOINT_KEY_SIZE];
+	CBMakeOutPointKey(key, txHash, index);
+	CBFindResult res = CBAssociativeArrayFind(&self->outputs, key);
+	if (! res.found)
+		return NULL;
+	CBUnspentOutput * output = CBFindResultToPointer(res);
+	CBAssociativeArrayDelete(&self->outputs, res.position, false);
+	self->outputNum--;
+	return output;
+}
+bool CBUnspentOutputSetTakeOutput(CBUnspentOutputSet * self, CBUnspentOutput * output){
+	CBFindResult res = CBAssociativeArrayFind(&self->outputs, output->outPoint);
+	if (res.found) {
+		free(output);
+		return false;
+	}
+	CBAssociativeArrayInsert(&self->outputs, output, res.position, NULL);
+	self->outputNum++;
+	return true;
+}
@@ -14,6 +14,33 @@
 
 #include "CBValidationFunctions.h"
 
+/**
+ @brief A spent output for duplicate detection, as the previous output hash followed by the little-endian index, and the index of the spending transaction.
+ */
+typedef struct{
+	unsigned char outPoint[36];
+	int txIndex;
+} CBSpentOutPoint;
+
+/**
+ @brief Compares two CBSpentOutPoint by the output, then by the transaction index, for qsort.
+ */
+static int CBSpentOutPointCompare(const void * vspent1, const void * vspent2);
+/**
+ @brief Adds the previous outputs of a transaction's inputs to a CBSpentOutPoint array.
+ @param spent The array with enough space for the inputs.
+ @param tx The transaction.
+ @param txIndex The index of the transaction to record.
+ */
+static void CBSpentOutPointAddInputs(CBSpentOutPoint * spent, CBTransaction * tx, int txIndex);
+/**
+ @brief Sorts a CBSpentOutPoint array and finds the first adjacent pair with the same output.
+ @param spent The array.
+ @param num The number of elements.
+ @returns The later of the pair, or NULL if all outputs are different.
+ */
+static CBSpentOutPoint * CBSpentOutPointFindDuplicate(CBSpentOutPoint * spent, int num);
+
 long long int CBCalculateBlockReward(long long int blockHeight) {
 	
 	return (50 * CB_ONE_BITCOIN) >> (blockHeight / 210000);
@@ -22,43 +49,33 @@ long long int CBCalculateBlockReward(long long int blockHeight) {
 
 void CBCalculateBlockWork(CBBigInt * work, int target) {
 	
-	// Get the base-256 exponent and the mantissa.
-	int zeroBytes = target >> 24;
-	target &= 0x00FFFFFF;
+	CBUInt256 work256;
+	CBCalculateBlockWorkUInt256(&work256, target);
 	
 	// Allocate CBBigInt data
 	work->length = 32;
 	CBBigIntAlloc(work, work->length);
-	memset(work->data, 0, 32);
-	
-	// Do base-4294967296 long division and adjust for trailing zeros in target.
+	CBUInt256ToBytes(&work256, work->data);
+	CBBigIntNormalise(work);
 	
-	int workSeg;
-	long long int temp = 0x01000000;
+}
+
+void CBCalculateBlockWorkUInt256(CBUInt256 * work, int target) {
 	
-	for (int x = 0;; x++) {
-		
-		workSeg = (int)(temp / target);
-		int i = 31 - x * 4 - zeroBytes + 4;
-		
-		for (int y = 0; y < 4; y++) {
-			
-			work->data[i] = workSeg >> ((3 - y) * 8);
-			
-			if (! i) {
-				CBBigIntNormalise(work);
-				return;
-			}
-			
-			i--;
-			
-		}
-		
-		temp -= workSeg * target;
-		temp <<= 32;
-		
+	CBUInt256 targetNum;
+	if (! CBUInt256FromCompact(&targetNum, target) || CBUInt256IsZero(&targetNum)) {
+		CBUInt256FromUInt64(work, 0);
+		return;
 	}
 	
+	// The work is 2^256 / target which is (2^256 - target) / target + 1, so that 2^256 is not needed.
+	CBUInt256FromUInt64(work, 0);
+	CBUInt256EqualsSubtractionByUInt256(work, &targetNum);
+	CBUInt256EqualsDivisionByUInt256(work, &targetNum, NULL);
+	CBUInt256 one;
+	CBUInt256FromUInt64(&one, 1);
+	CBUInt256EqualsAdditionByUInt256(work, &one);
+	
 }
 
 void CBCalculateMerkleRoot(unsigned char * hashes, int hashNum) {
@@ -100,52 +117,21 @@ int CBCalculateTarget(int oldTarget, int time) {
 	if (time > CB_TARGET_INTERVAL * 4)
 		time = CB_TARGET_INTERVAL * 4;
 	
-	// Get number of trailing 0 bytes (Base 256 exponent)
-	int zeroBytes = oldTarget >> 24;
-	
-	// Get the three bytes for the target mantissa. Use 8 bytes for overflow. Shift along once for division.
-	long long int num = (oldTarget & 0x00FFFFFF) << 8;
-	
-	// Modify the three bytes
-	num *= time;
-	num /= CB_TARGET_INTERVAL;
-	
-	// Find first byte with data. Check for flow into more or less significant byte.
-	if (num & 0xF00000000) {
-		
-		// Mantissa overflowed into more significant byte.
-		num >>= 16;
-		num &= 0x00FFFFFF; // Clear the forth byte for the number of zero bytes.
-		zeroBytes++;
-		
-	}else if (num & 0xFF000000)
-		// Data within same three bytes
-		num >>= 8;
-	
-	else
-		// Data down a byte
-		zeroBytes--;
-	
-	// Modify in the case of the first byte in the mantissa being over 0x7F... What did you say?... Oh yes, the bitcoin protocol can be dumb in places.
-	if (num > 0x007FFFFF) {
-		
-		// Add trailing zero by shifting right...
-		num >>= 8;
-		
-		// Compensate with additional trailing zero byte.
-		zeroBytes++;
-		
-	}
-	
-	// Apply the number of trailing zero bytes into the compact target representation.
-	num |= zeroBytes << 24;
+	// Multiply the old target by the time and divide by the interval.
+	CBUInt256 target, factor, maxTarget;
+	CBUInt256FromCompact(&target, oldTarget);
+	CBUInt256FromUInt64(&factor, time);
+	CBUInt256EqualsMultiplicationByUInt256(&target, &factor);
+	CBUInt256FromUInt64(&factor, CB_TARGET_INTERVAL);
+	CBUInt256EqualsDivisionByUInt256(&target, &factor, NULL);
 	
 	// Check if the target is too high and if it is, make it equal the maximum target.
-	if (num > CB_MAX_TARGET)
-		num = CB_MAX_TARGET;
+	CBUInt256FromCompact(&maxTarget, CB_MAX_TARGET);
+	if (CBUInt256CompareToUInt256(&target, &maxTarget) == CB_COMPARE_MORE_THAN)
+		return CB_MAX_TARGET;
 	
-	// Return the new target
-	return (int) num;
+	// Return the new target in the compact representation, which removes all but the three most significant bytes.
+	return (int)CBUInt256ToCompact(&target);
 	
 }
 
@@ -223,46 +209,115 @@ bool CBTransactionValidateBasic(CBTransaction * tx, bool coinbase, long long int
 			return false;
 	
 	// Check for duplicate transaction output spends
-	for (int x = 0; x < tx->inputNum; x++)
-		for (int y = 0; y < x; y++)
-			if (CBByteArrayCompare(tx->inputs[y]->prevOut.hash, tx->inputs[x]->prevOut.hash) == CB_COMPARE_EQUAL
-				&& tx->inputs[y]->prevOut.index == tx->inputs[x]->prevOut.index)
-				return false;
+	if (CBTransactionHasDuplicateInputs(tx))
+		return false;
 	
 	return true;
 	
 }
 
-bool CBValidateProofOfWork(unsigned char * hash, int target) {
-	
-	// Get trailing zero bytes
-	int zeroBytes = target >> 24;
+bool CBTransactionHasDuplicateInputs(CBTransaction * tx) {
 	
-	// Check target is less than or equal to maximum.
-	if (target > CB_MAX_TARGET)
+	if (tx->inputNum < 2)
 		return false;
 	
-	// Modify the target to the mantissa (significand).
-	target &= 0x00FFFFFF;
+	// Sort the previous outputs so that duplicates are adjacent, which is O(n log n) rather than comparing every pair of inputs.
+	CBSpentOutPoint * spent = malloc(sizeof(*spent) * tx->inputNum);
+	CBSpentOutPointAddInputs(spent, tx, 0);
+	bool duplicate = CBSpentOutPointFindDuplicate(spent, tx->inputNum) != NULL;
+	free(spent);
 	
-	// Check mantissa is below 0x800000.
-	if (target > 0x7FFFFF)
-		return false;
+	return duplicate;
 	
-	// Fail if hash is above target. First check leading bytes to significant part.
-	// As the hash is seen as little-endian, do this backwards.
-	for (int x = 0; x < 32 - zeroBytes; x++)
-		if (hash[31 - x])
-			// A byte leading to the significant part is not zero
-			return false;
+}
+
+int CBTransactionsFindDoubleSpend(CBTransaction ** transactions, int transactionNum) {
+	
+	// Collect every input, excluding the coinbase.
+	int inputNum = 0;
+	
+	for (int x = 0; x < transactionNum; x++)
+		if (! CBTransactionIsCoinBase(transactions[x]))
+			inputNum += transactions[x]->inputNum;
+	
+	if (inputNum < 2)
+		return -1;
 	
-	// Check significant part
-	int significantPart = hash[zeroBytes - 1] << 16;
-	significantPart |= hash[zeroBytes - 2] << 8;
-	significantPart |= hash[zeroBytes - 3];
-	if (significantPart > target)
+	CBSpentOutPoint * spent = malloc(sizeof(*spent) * inputNum);
+	int cursor = 0;
+	
+	for (int x = 0; x < transactionNum; x++) {
+		
+		CBTransaction * tx = transactions[x];
+		
+		if (! CBTransactionIsCoinBase(tx)) {
+			CBSpentOutPointAddInputs(spent + cursor, tx, x);
+			cursor += tx->inputNum;
+		}
+		
+	}
+	
+	// Sorting by the transaction index after the output means the later spend of a duplicate pair comes second.
+	CBSpentOutPoint * duplicate = CBSpentOutPointFindDuplicate(spent, inputNum);
+	int txIndex = duplicate ? duplicate->txIndex : -1;
+	free(spent);
+	
+	return txIndex;
+	
+}
+
+bool CBValidateProofOfWork(unsigned char * hash, int target) {
+	
+	// Check the target is valid and less than or equal to maximum.
+	CBUInt256 targetNum, maxTarget, hashNum;
+	if (! CBUInt256FromCompact(&targetNum, target))
+		return false;
+	CBUInt256FromCompact(&maxTarget, CB_MAX_TARGET);
+	if (CBUInt256CompareToUInt256(&targetNum, &maxTarget) == CB_COMPARE_MORE_THAN)
 		return false;
 	
-	return true;
+	// Fail if hash is above target. The hash is seen as little-endian.
+	CBUInt256FromBytes(&hashNum, hash);
+	return CBUInt256CompareToUInt256(&hashNum, &targetNum) != CB_COMPARE_MORE_THAN;
+	
+}
+
+static int CBSpentOutPointCompare(const void * vspent1, const void * vspent2) {
+	
+	const CBSpentOutPoint * spent1 = vspent1;
+	const CBSpentOutPoint * spent2 = vspent2;
+	
+	int res = memcmp(spent1->outPoint, spent2->outPoint, 36);
+	
+	if (res)
+		return res;
+	
+	return (spent1->txIndex > spent2->txIndex) - (spent1->txIndex < spent2->txIndex);
+	
+}
+
+static void CBSpentOutPointAddInputs(CBSpentOutPoint * spent, CBTransaction * tx, int txIndex) {
+	
+	for (int x = 0; x < tx->inputNum; x++) {
+		
+		CBPrevOut * prevOut = &tx->inputs[x]->prevOut;
+		
+		memcpy(spent[x].outPoint, CBByteArrayGetData(prevOut->hash), 32);
+		CBInt32ToArray(spent[x].outPoint, 32, prevOut->index);
+		spent[x].txIndex = txIndex;
+		
+	}
+	
+}
+
+static CBSpentOutPoint * CBSpentOutPointFindDuplicate(CBSpentOutPoint * spent, int num) {
+	
+	qsort(spent, num, sizeof(*spent), CBSpentOutPointCompare);
+	
+	for (int x = 1; x < num; x++)
+		if (! memcmp(spent[x - 1].outPoint, spent[x].outPoint, 36))
+			return spent + x;
+	
+	return NULL;
 	
 }
@@ -0,0 +1,426 @@
+//
+//  CBVanitySearch.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+//  SEE HEADER FILE FOR DOCUMENTATION
+
+#include "CBVanitySearch.h"
+#include <ctype.h>
+#include <strings.h>
+#include <time.h>
+
+#define CB_VANITY_SEARCH_LIMBS 8 // The number of 32-bit limbs of the numbers for the ranges, with the least significant first. 25 byte addresses need 200 bits and the bounds for the longest addresses need less than 256 bits.
+
+/**
+ @brief Adds a range of the numbers of addresses as a range of hashes.
+ @param self The CBVanitySearch object.
+ @param low The lowest number, which has the version byte of the addresses.
+ @param high The highest number, which has the version byte of the addresses.
+ */
+static void CBVanitySearchAddRange(CBVanitySearch * self, uint32_t * low, uint32_t * high);
+/**
+ @brief Adds the ranges of the addresses beginning with one way of writing the pattern.
+ @param self The CBVanitySearch object.
+ @param spelling The pattern with every character in the base-58 alphabet.
+ */
+static void CBVanitySearchAddRanges(CBVanitySearch * self, char * spelling);
+/**
+ @brief Adds the ranges of every way of writing the rest of the pattern ignoring case.
+ @param self The CBVanitySearch object.
+ @param spelling The pattern with the characters before the index chosen.
+ @param index The index of the next character to choose.
+ @param num The number of ways the pattern has been written, which is increased.
+ @returns false if the pattern can be written in more than CB_VANITY_SEARCH_MAX_PATTERNS ways.
+ */
+static bool CBVanitySearchAddSpellings(CBVanitySearch * self, char * spelling, int index, int * num);
+/**
+ @brief Compares the lowest hashes of ranges for qsort.
+ @param a The first CBVanitySearchRange.
+ @param b The second CBVanitySearchRange.
+ @returns A negative number if the first range is lower, a positive number if it is higher, or zero.
+ */
+static int CBVanitySearchCompareRanges(const void * a, const void * b);
+/**
+ @brief Gets the time for the progress of a search.
+ @returns The time in milliseconds from an arbitrary point.
+ */
+static long long int CBVanitySearchGetMilliseconds(void);
+/**
+ @brief Checks if a character is in the base-58 alphabet.
+ @param c The character.
+ @returns true if the character is in the alphabet.
+ */
+static bool CBVanitySearchIsBase58(char c);
+/**
+ @brief Compares two numbers.
+ @param a The first number.
+ @param b The second number.
+ @returns A negative number if a is less than b, a positive number if it is greater, or zero.
+ */
+static int CBVanitySearchNumCompare(uint32_t * a, uint32_t * b);
+/**
+ @brief Multiplies a number and adds to it.
+ @param num The number to change.
+ @param mult The multiplier.
+ @param add The number to add.
+ */
+static void CBVanitySearchNumMultiplyAdd(uint32_t * num, uint32_t mult, uint32_t add);
+/**
+ @brief Sets a number to one less than a power of two.
+ @param num The number to set.
+ @param bits The power of two, which is a multiple of eight below 256.
+ */
+static void CBVanitySearchNumSetMask(uint32_t * num, int bits);
+/**
+ @brief Subtracts one from a number which is not zero.
+ @param num The number to change.
+ */
+static void CBVanitySearchNumSubtractOne(uint32_t * num);
+/**
+ @brief Steps key pairs from a random key pair and checks their hashes until the search stops.
+ @param self The CBVanitySearch object.
+ @param onProgress The progress callback or NULL for threads other than the calling thread.
+ @param callbackObject Passed to onProgress.
+ @param progressInterval The number of milliseconds between calls to onProgress.
+ */
+static void CBVanitySearchSearch(CBVanitySearch * self, bool (*onProgress)(void *, uint64_t, double), void * callbackObject, int progressInterval);
+/**
+ @brief Searches on a thread of CBVanitySearchFind.
+ @param vself The CBVanitySearch object.
+ */
+static void CBVanitySearchThread(void * vself);
+
+//  Constructor
+
+CBVanitySearch * CBNewVanitySearch(char * pattern, CBBase58Prefix prefix, bool caseInsensitive){
+	CBVanitySearch * self = malloc(sizeof(*self));
+	CBGetObject(self)->free = CBFreeVanitySearch;
+	if (CBInitVanitySearch(self, pattern, prefix, caseInsensitive))
+		return self;
+	free(self);
+	return NULL;
+}
+
+//  Initialiser
+
+bool CBInitVanitySearch(CBVanitySearch * self, char * pattern, CBBase58Prefix prefix, bool caseInsensitive){
+	CBInitObject(CBGetObject(self), false);
+	size_t length = strlen(pattern);
+	self->pattern = malloc(length + 1);
+	strcpy(self->pattern, pattern);
+	self->prefix = prefix;
+	self->caseInsensitive = caseInsensitive;
+	self->ranges = NULL;
+	self->rangeNum = 0;
+	if (length >= CB_ADDRESS_STRING_SIZE) {
+		CBLogError("The vanity pattern \"%s\" is longer than any address.", pattern);
+		CBDestroyVanitySearch(self);
+		return false;
+	}
+	if (caseInsensitive) {
+		char spelling[CB_ADDRESS_STRING_SIZE];
+		strcpy(spelling, pattern);
+		int num = 0;
+		if (! CBVanitySearchAddSpellings(self, spelling, 0, &num)) {
+			CBLogError("The vanity pattern \"%s\" can be written in too many ways ignoring case.", pattern);
+			CBDestroyVanitySearch(self);
+			return false;
+		}
+	}else{
+		for (size_t x = 0; x < length; x++)
+			if (! CBVanitySearchIsBase58(pattern[x])) {
+				CBLogError("The vanity pattern \"%s\" has a character which is not in the base-58 alphabet.", pattern);
+				CBDestroyVanitySearch(self);
+				return false;
+			}
+		CBVanitySearchAddRanges(self, pattern);
+	}
+	if (self->rangeNum == 0) {
+		CBLogError("No address with the prefix %u can begin with \"%s\".", prefix, pattern);
+		CBDestroyVanitySearch(self);
+		return false;
+	}
+	// Put the ranges in order and join the ranges which overlap, so that they can be searched.
+	qsort(self->ranges, self->rangeNum, sizeof(*self->ranges), CBVanitySearchCompareRanges);
+	int num = 1;
+	for (int x = 1; x < self->rangeNum; x++) {
+		CBVanitySearchRange * last = self->ranges + num - 1;
+		if (memcmp(self->ranges[x].lowHash, last->highHash, 20) <= 0) {
+			if (memcmp(self->ranges[x].highHash, last->highHash, 20) > 0) {
+				memcpy(last->highHash, self->ranges[x].highHash, 20);
+				last->high = self->ranges[x].high;
+			}
+		}else
+			self->ranges[num++] = self->ranges[x];
+	}
+	self->rangeNum = num;
+	// The chance of a hash being in a range is the number of hashes in the ranges over 2^160, which is 1.46e48.
+	double total = 0;
+	for (int x = 0; x < self->rangeNum; x++) {
+		// Subtract before converting, as narrow ranges are below the precision of a double.
+		unsigned char width[20];
+		int borrow = 0;
+		for (int y = 19; y >= 0; y--) {
+			int digit = self->ranges[x].highHash[y] - self->ranges[x].lowHash[y] - borrow;
+			borrow = digit < 0;
+			width[y] = (unsigned char)(digit + borrow * 256);
+		}
+		double size = 0;
+		for (int y = 0; y < 20; y++)
+			size = size * 256 + width[y];
+		total += size + 1;
+	}
+	self->difficulty = 1.461501637330902918e48 / total;
+	return true;
+}
+
+//  Destructor
+
+void CBDestroyVanitySearch(void * vself){
+	CBVanitySearch * self = vself;
+	free(self->pattern);
+	free(self->ranges);
+}
+void CBFreeVanitySearch(void * self){
+	CBDestroyVanitySearch(self);
+	free(self);
+}
+
+//  Functions
+
+static void CBVanitySearchAddRange(CBVanitySearch * self, uint32_t * low, uint32_t * high){
+	self->ranges = realloc(self->ranges, sizeof(*self->ranges) * (self->rangeNum + 1));
+	CBVanitySearchRange * range = self->ranges + self->rangeNum++;
+	// The hash is in the 160 bits above the 32-bit checksum and below the version byte.
+	for (int x = 0; x < 5; x++) {
+		uint32_t lowLimb = low[5 - x], highLimb = high[5 - x];
+		for (int y = 0; y < 4; y++) {
+			range->lowHash[x * 4 + y] = (unsigned char)(lowLimb >> (24 - y * 8));
+			range->highHash[x * 4 + y] = (unsigned char)(highLimb >> (24 - y * 8));
+		}
+	}
+	range->low = (uint64_t)low[5] << 32 | low[4];
+	range->high = (uint64_t)high[5] << 32 | high[4];
+}
+static void CBVanitySearchAddRanges(CBVanitySearch * self, char * spelling){
+	// Each leading '1' is a leading zero byte.
+	int zeros = 0;
+	while (spelling[zeros] == '1')
+		zeros++;
+	char * rest = spelling + zeros;
+	if (zeros > 25 || (*rest && zeros > 24))
+		return;
+	// The numbers of the addresses with the version byte.
+	uint32_t boundLow[CB_VANITY_SEARCH_LIMBS] = {0}, boundHigh[CB_VANITY_SEARCH_LIMBS], bound[CB_VANITY_SEARCH_LIMBS];
+	boundLow[6] = self->prefix;
+	CBVanitySearchNumSetMask(boundHigh, 192);
+	boundHigh[6] = self->prefix;
+	// The numbers with the leading zero bytes, and no more when the rest of the pattern would be encoded after them.
+	CBVanitySearchNumSetMask(bound, (25 - zeros) * 8);
+	if (CBVanitySearchNumCompare(bound, boundHigh) < 0)
+		memcpy(boundHigh, bound, sizeof(bound));
+	if (*rest) {
+		CBVanitySearchNumSetMask(bound, (24 - zeros) * 8);
+		CBVanitySearchNumMultiplyAdd(bound, 1, 1);
+		if (CBVanitySearchNumCompare(bound, boundLow) > 0)
+			memcpy(boundLow, bound, sizeof(bound));
+	}
+	if (CBVanitySearchNumCompare(boundLow, boundHigh) > 0)
+		return;
+	if (! *rest) {
+		CBVanitySearchAddRange(self, boundLow, boundHigh);
+		return;
+	}
+	// The numbers encoded with the rest of the pattern followed by any digits are from the value of the rest up to one more, multiplied by a power of 58 for each number of following digits.
+	uint32_t low[CB_VANITY_SEARCH_LIMBS] = {0}, high[CB_VANITY_SEARCH_LIMBS];
+	for (char * c = rest; *c; c++)
+		CBVanitySearchNumMultiplyAdd(low, 58, (uint32_t)((const char *)memchr(base58Characters, *c, 58) - base58Characters));
+	memcpy(high, low, sizeof(low));
+	CBVanitySearchNumMultiplyAdd(high, 1, 1);
+	while (CBVanitySearchNumCompare(low, boundHigh) <= 0) {
+		uint32_t rangeLow[CB_VANITY_SEARCH_LIMBS], rangeHigh[CB_VANITY_SEARCH_LIMBS];
+		memcpy(rangeLow, CBVanitySearchNumCompare(low, boundLow) < 0 ? boundLow : low, sizeof(low));
+		memcpy(rangeHigh, high, sizeof(high));
+		CBVanitySearchNumSubtractOne(rangeHigh);
+		if (CBVanitySearchNumCompare(rangeHigh, boundHigh) > 0)
+			memcpy(rangeHigh, boundHigh, sizeof(boundHigh));
+		if (CBVanitySearchNumCompare(rangeLow, rangeHigh) <= 0)
+			CBVanitySearchAddRange(self, rangeLow, rangeHigh);
+		CBVanitySearchNumMultiplyAdd(low, 58, 0);
+		CBVanitySearchNumMultiplyAdd(high, 58, 0);
+	}
+}
+static bool CBVanitySearchAddSpellings(CBVanitySearch * self, char * spelling, int index, int * num){
+	char c = spelling[index];
+	if (! c) {
+		if (++*num > CB_VANITY_SEARCH_MAX_PATTERNS)
+			return false;
+		CBVanitySearchAddRanges(self, spelling);
+		return true;
+	}
+	char other = islower((unsigned char)c) ? (char)toupper((unsigned char)c) : (char)tolower((unsigned char)c);
+	if (CBVanitySearchIsBase58(c)) {
+		if (! CBVanitySearchAddSpellings(self, spelling, index + 1, num))
+			return false;
+	}
+	if (other != c && CBVanitySearchIsBase58(other)) {
+		spelling[index] = other;
+		bool ok = CBVanitySearchAddSpellings(self, spelling, index + 1, num);
+		spelling[index] = c;
+		if (! ok)
+			return false;
+	}
+	return true;
+}
+bool CBVanitySearchCheckHash(CBVanitySearch * self, unsigned char * hash, char * address){
+	if (! CBVanitySearchInRange(self, hash))
+		return false;
+	// Hashes at the ends of the ranges depend on the checksum, so check the encoded address.
+	char string[CB_ADDRESS_STRING_SIZE];
+	CBAddressEncodeBatch(hash, self->prefix, 1, string);
+	if (address)
+		strcpy(address, string);
+	size_t length = strlen(self->pattern);
+	if (self->caseInsensitive)
+		return ! strncasecmp(string, self->pattern, length);
+	return ! strncmp(string, self->pattern, length);
+}
+static int CBVanitySearchCompareRanges(const void * a, const void * b){
+	return memcmp(((CBVanitySearchRange *)a)->lowHash, ((CBVanitySearchRange *)b)->lowHash, 20);
+}
+bool CBVanitySearchFind(CBVanitySearch * self, int numThreads, bool (*onProgress)(void *, uint64_t, double), void * callbackObject, int progressInterval, CBKeyPair * key, char * address){
+	self->tried = 0;
+	self->stop = false;
+	self->found = false;
+	CBNewMutex(&self->mutex);
+	CBDepObject * threads = NULL;
+	if (numThreads > 1) {
+		threads = malloc(sizeof(*threads) * (numThreads - 1));
+		for (int x = 0; x < numThreads - 1; x++)
+			CBNewThread(threads + x, CBVanitySearchThread, self);
+	}
+	CBVanitySearchSearch(self, onProgress, callbackObject, progressInterval);
+	for (int x = 0; x < numThreads - 1; x++) {
+		CBThreadJoin(threads[x]);
+		CBFreeThread(threads[x]);
+	}
+	free(threads);
+	CBFreeMutex(self->mutex);
+	if (! self->found)
+		return false;
+	*key = self->key;
+	strcpy(address, self->address);
+	return true;
+}
+static long long int CBVanitySearchGetMilliseconds(void){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (long long int)time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+bool CBVanitySearchInRange(CBVanitySearch * self, unsigned char * hash){
+	uint64_t key = 0;
+	for (int x = 0; x < 8; x++)
+		key = key << 8 | hash[x];
+	// Find the first range which does not end before the hash.
+	int low = 0, high = self->rangeNum;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if (self->ranges[mid].high < key)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	// Ranges can share the first eight bytes, so check each range which may hold the hash.
+	for (; low < self->rangeNum && self->ranges[low].low <= key; low++) {
+		CBVanitySearchRange * range = self->ranges + low;
+		if ((key > range->low || memcmp(hash, range->lowHash, 20) >= 0)
+			&& (key < range->high || memcmp(hash, range->highHash, 20) <= 0))
+			return true;
+	}
+	return false;
+}
+static bool CBVanitySearchIsBase58(char c){
+	return c && memchr(base58Characters, c, 58) != NULL;
+}
+static int CBVanitySearchNumCompare(uint32_t * a, uint32_t * b){
+	for (int x = CB_VANITY_SEARCH_LIMBS - 1; x >= 0; x--)
+		if (a[x] != b[x])
+			return a[x] < b[x] ? -1 : 1;
+	return 0;
+}
+static void CBVanitySearchNumMultiplyAdd(uint32_t * num, uint32_t mult, uint32_t add){
+	uint64_t carry = add;
+	for (int x = 0; x < CB_VANITY_SEARCH_LIMBS; x++) {
+		carry += (uint64_t)num[x] * mult;
+		num[x] = (uint32_t)carry;
+		carry >>= 32;
+	}
+}
+static void CBVanitySearchNumSetMask(uint32_t * num, int bits){
+	for (int x = 0; x < CB_VANITY_SEARCH_LIMBS; x++)
+		num[x] = bits >= (x + 1) * 32 ? 0xFFFFFFFF : (bits > x * 32 ? (1U << (bits - x * 32)) - 1 : 0);
+}
+static void CBVanitySearchNumSubtractOne(uint32_t * num){
+	for (int x = 0; x < CB_VANITY_SEARCH_LIMBS && num[x]-- == 0; x++);
+}
+static void CBVanitySearchSearch(CBVanitySearch * self, bool (*onProgress)(void *, uint64_t, double), void * callbackObject, int progressInterval){
+	CBKeyPair key;
+	if (! CBKeyPairGenerate(&key)) {
+		CBLogError("Could not generate a key pair to start a vanity search from.");
+		CBMutexLock(self->mutex);
+		self->stop = true;
+		CBMutexUnlock(self->mutex);
+		return;
+	}
+	CBKeyPair * keys = malloc(sizeof(*keys) * CB_KEY_PAIR_STEP_BATCH);
+	char address[CB_ADDRESS_STRING_SIZE];
+	long long int start = CBVanitySearchGetMilliseconds(), next = start + progressInterval;
+	for (bool stop = false; ! stop;) {
+		CBKeyPairGetNextKeys(&key, CB_KEY_PAIR_STEP_BATCH, keys);
+		int match = -1;
+		for (int x = 0; x < CB_KEY_PAIR_STEP_BATCH; x++)
+			if (CBVanitySearchCheckHash(self, keys[x].pubkey.hash, address)) {
+				match = x;
+				break;
+			}
+		// Continue from the last key
+		key = keys[CB_KEY_PAIR_STEP_BATCH - 1];
+		CBMutexLock(self->mutex);
+		self->tried += match == -1 ? CB_KEY_PAIR_STEP_BATCH : match + 1;
+		if (match != -1 && ! self->found) {
+			self->found = true;
+			self->key = keys[match];
+			strcpy(self->address, address);
+			self->stop = true;
+		}
+		stop = self->stop;
+		uint64_t tried = self->tried;
+		CBMutexUnlock(self->mutex);
+		if (onProgress && ! stop) {
+			long long int now = CBVanitySearchGetMilliseconds();
+			if (now >= next) {
+				if (! onProgress(callbackObject, tried, now > start ? tried * 1000.0 / (now - start) : 0)) {
+					CBMutexLock(self->mutex);
+					self->stop = true;
+					CBMutexUnlock(self->mutex);
+					stop = true;
+				}
+				next = now + progressInterval;
+			}
+		}
+	}
+	free(keys);
+}
+static void CBVanitySearchThread(void * vself){
+	CBVanitySearchSearch(vself, NULL, NULL, 0);
+}
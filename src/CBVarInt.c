@@ -16,6 +16,40 @@
 
 #include "CBVarInt.h"
 
+unsigned long long int CBCompressAmount(unsigned long long int amount){
+	if (! amount)
+		return 0;
+	// Remove up to 9 trailing decimal zeros
+	int exponent = 0;
+	while (amount % 10 == 0 && exponent < 9) {
+		amount /= 10;
+		exponent++;
+	}
+	if (exponent < 9) {
+		// The last digit cannot be zero so store it as 1-9
+		int digit = (int)(amount % 10);
+		amount /= 10;
+		return 1 + (amount*9 + digit - 1)*10 + exponent;
+	}
+	return 1 + (amount - 1)*10 + 9;
+}
+unsigned long long int CBDecompressAmount(unsigned long long int compressed){
+	if (! compressed)
+		return 0;
+	compressed--;
+	int exponent = compressed % 10;
+	compressed /= 10;
+	unsigned long long int amount;
+	if (exponent < 9) {
+		int digit = (compressed % 9) + 1;
+		compressed /= 9;
+		amount = compressed*10 + digit;
+	}else
+		amount = compressed + 1;
+	while (exponent--)
+		amount *= 10;
+	return amount;
+}
 CBVarInt CBVarIntDecodeData(unsigned char * bytes, int offset){
 	CBVarInt result;
 	result.size = CBVarIntDecodeSize(bytes, offset);
@@ -25,6 +59,12 @@ CBVarInt CBVarIntDecodeData(unsigned char * bytes, int offset){
 	else result.val = CBArrayToInt64(bytes, offset + 1);
 	return result;
 }
+bool CBVarIntDecodeDataChecked(unsigned char * bytes, int length, int offset, CBVarInt * varInt){
+	if (offset >= length || CBVarIntDecodeSize(bytes, offset) > length - offset)
+		return false;
+	*varInt = CBVarIntDecodeData(bytes, offset);
+	return true;
+}
 int CBVarIntDecodeSize(unsigned char * bytes, int offset) {
 	if (bytes[offset] < 253)
 		// 8 bits.
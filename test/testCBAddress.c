@@ -97,5 +97,78 @@ int main(){
 	}
 	CBReleaseObject(str);
 	CBReleaseObject(add);
+	// Test CBSha256Batch against CBSha256 over lengths covering one to three blocks, with a partial group of lanes.
+	unsigned char messages[11][150], * messagePtrs[11], batchHashes[11 * 32], singleHash[32];
+	for (int x = 0; x < 11; x++) {
+		for (int y = 0; y < 150; y++)
+			messages[x][y] = rand();
+		messagePtrs[x] = messages[x];
+	}
+	for (int length = 0; length <= 150; length++) {
+		CBSha256Batch(messagePtrs, length, 11, batchHashes);
+		for (int x = 0; x < 11; x++) {
+			CBSha256(messages[x], length, singleHash);
+			if (memcmp(batchHashes + x * 32, singleHash, 32)) {
+				printf("SHA256 BATCH FAIL FOR LENGTH %i MESSAGE %i\n", length, x);
+				return 1;
+			}
+		}
+	}
+	// Test CBHash160Batch against CBSha256 and CBRipemd160, with a partial group and a single message.
+	unsigned char batchHash160s[11 * 20];
+	for (int length = 0; length <= 150; length++) {
+		for (int num = 1; num <= 11; num += 10) {
+			CBHash160Batch(messagePtrs, length, num, batchHash160s);
+			for (int x = 0; x < num; x++) {
+				CBSha256(messages[x], length, singleHash);
+				CBRipemd160(singleHash, 32, singleHash);
+				if (memcmp(batchHash160s + x * 20, singleHash, 20)) {
+					printf("HASH160 BATCH FAIL FOR LENGTH %i MESSAGE %i OF %i\n", length, x, num);
+					return 1;
+				}
+			}
+		}
+	}
+	// Test batch encoding against CBChecksumBytesGetString and decoding back
+	int batchNum = 150;
+	unsigned char * hashes = malloc(batchNum * 20), * decodedHashes = malloc(batchNum * 20);
+	char * strings = malloc(batchNum * CB_ADDRESS_STRING_SIZE);
+	CBBase58Prefix * prefixes = malloc(batchNum * sizeof(*prefixes));
+	bool * valid = malloc(batchNum);
+	for (int x = 0; x < batchNum * 20; x++)
+		hashes[x] = rand();
+	// Leading zero bytes give leading ones.
+	memset(hashes, 0, 3);
+	CBAddressEncodeBatch(hashes, CB_PREFIX_PRODUCTION_ADDRESS, batchNum, strings);
+	for (int x = 0; x < batchNum; x++) {
+		add = CBNewAddressFromRIPEMD160Hash(hashes + x * 20, CB_PREFIX_PRODUCTION_ADDRESS, false);
+		str = CBChecksumBytesGetString(CBGetChecksumBytes(add));
+		if (strcmp((char *)CBByteArrayGetData(str), strings + x * CB_ADDRESS_STRING_SIZE)) {
+			printf("BATCH ENCODE FAIL %s != %s\n", strings + x * CB_ADDRESS_STRING_SIZE, (char *)CBByteArrayGetData(str));
+			return 1;
+		}
+		CBReleaseObject(str);
+		CBReleaseObject(add);
+	}
+	// Make one string have a bad checksum and another have an invalid character.
+	char * bad = strings + 10 * CB_ADDRESS_STRING_SIZE;
+	bad[strlen(bad) - 1] = bad[strlen(bad) - 1] == 'z' ? 'y' : 'z';
+	strings[100 * CB_ADDRESS_STRING_SIZE + 5] = '0';
+	if (CBAddressDecodeBatch(strings, batchNum, decodedHashes, prefixes, valid) != batchNum - 2
+		|| valid[10] || valid[100]) {
+		printf("BATCH DECODE VALIDITY FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < batchNum; x++)
+		if (x != 10 && x != 100
+			&& (memcmp(decodedHashes + x * 20, hashes + x * 20, 20) || prefixes[x] != CB_PREFIX_PRODUCTION_ADDRESS)) {
+			printf("BATCH DECODE FAIL %i\n", x);
+			return 1;
+		}
+	free(hashes);
+	free(decodedHashes);
+	free(strings);
+	free(prefixes);
+	free(valid);
 	return 0;
 }
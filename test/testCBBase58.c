@@ -95,6 +95,48 @@ int main(){
 
 	}
 
+	// Buffer functions
+	char buf[CBBase58MaxLength(29) + 1];
+	unsigned char bytes[29];
+	if (CBBase58Encode(bi.data, 29, buf) != (int)strlen(buf)
+		|| CBBase58Decode(buf, bytes, 29) != 29
+		|| memcmp(bytes, bi.data, 29)) {
+		printf("BUFFER ROUND TRIP FAIL\n");
+		return 1;
+	}
+	if (CBBase58Decode(buf, bytes, 28) != -1) {
+		printf("BUFFER TOO SMALL FAIL\n");
+		return 1;
+	}
+	if (CBBase58Decode("7EyVQVmCjB3siBN8DdtuG3ws5jW9xsnT25vbt5eU", bytes, 29) != 29
+		|| bytes[0] != 0xc5 || bytes[28] != 0x89) {
+		printf("BUFFER DECODE FAIL\n");
+		return 1;
+	}
+	if (CBBase58Decode("7EyVQVmCjB3siBN8DdtuG3ws5jW9xsnT25vbt5e0", bytes, 29) != -1
+		|| CBBase58Decode("7EyVQVmCjB3siBN8DdtuG3ws5jW9xsnT25vbt5el", bytes, 29) != -1) {
+		printf("BUFFER INVALID CHARACTER FAIL\n");
+		return 1;
+	}
+	// Leading zeros, with the zero bytes at the end.
+	unsigned char zeros[5] = {0x39, 0x00, 0x00, 0x00, 0x00};
+	if (CBBase58Encode(zeros, 5, buf) != 5 || strcmp(buf, "1111z")
+		|| CBBase58Decode("1111z", bytes, 5) != 5 || memcmp(bytes, zeros, 5)) {
+		printf("BUFFER LEADING ZEROS FAIL\n");
+		return 1;
+	}
+	// Larger than the stack limbs
+	unsigned char large[300], largeDecoded[300];
+	char largeStr[CBBase58MaxLength(300) + 1];
+	for (int x = 0; x < 300; x++)
+		large[x] = rand();
+	large[299] |= 1;
+	CBBase58Encode(large, 300, largeStr);
+	if (CBBase58Decode(largeStr, largeDecoded, 300) != 300 || memcmp(large, largeDecoded, 300)) {
+		printf("BUFFER LARGE FAIL\n");
+		return 1;
+	}
+
 	free(bi.data);
 	free(verify);
 
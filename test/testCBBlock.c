@@ -256,5 +256,125 @@ int main(){
 		printf("BYTE DATA NOT ALL THE SAME\n");
 		return 1;
 	}
+	CBReleaseObject(block);
+	// Test the compact encoding with every script template, scripts which look like templates but are not canonical, values too large to compress and repeated previous output hashes.
+	unsigned char keyHashData[25] = {CB_SCRIPT_OP_DUP, CB_SCRIPT_OP_HASH160, 20}, p2shData[23] = {CB_SCRIPT_OP_HASH160, 20}, evenKeyData[35] = {33, 0x02}, oddKeyData[35] = {33, 0x03}, fullKeyData[67] = {65, 0x04}, badKeyData[35] = {33, 0x05}, multisigData[105] = {CB_SCRIPT_OP_2, 33, 0x02}, badMultisigData[71] = {CB_SCRIPT_OP_1, CB_SCRIPT_OP_PUSHDATA1, 33, 0x02}, badKeyHashData[25] = {CB_SCRIPT_OP_DUP, CB_SCRIPT_OP_HASH160, CB_SCRIPT_OP_PUSHDATA1, 20}, returnData[5] = {CB_SCRIPT_OP_RETURN, 3, 1, 2, 3};
+	for (int x = 3; x < 105; x++)
+		multisigData[x] = rand();
+	keyHashData[23] = CB_SCRIPT_OP_EQUALVERIFY;
+	keyHashData[24] = CB_SCRIPT_OP_CHECKSIG;
+	p2shData[22] = CB_SCRIPT_OP_EQUAL;
+	memcpy(keyHashData + 3, multisigData + 3, 20);
+	memcpy(p2shData + 2, multisigData + 23, 20);
+	memcpy(evenKeyData + 2, multisigData + 3, 32);
+	memcpy(oddKeyData + 2, multisigData + 35, 32);
+	memcpy(fullKeyData + 2, multisigData + 3, 64);
+	memcpy(badKeyData + 2, multisigData + 3, 32);
+	evenKeyData[34] = oddKeyData[34] = fullKeyData[66] = badKeyData[34] = CB_SCRIPT_OP_CHECKSIG;
+	// 2 of 2 with one compressed key and one full key.
+	multisigData[35] = 65;
+	multisigData[36] = 0x04;
+	multisigData[101] = CB_SCRIPT_OP_2;
+	multisigData[102] = CB_SCRIPT_OP_CHECKMULTISIG;
+	// Uses OP_PUSHDATA1 for the key, so is not written as a template.
+	memcpy(badMultisigData + 4, multisigData + 3, 32);
+	badMultisigData[36] = 33;
+	memcpy(badMultisigData + 37, multisigData + 35, 33);
+	badMultisigData[37] = 0x03;
+	badMultisigData[69] = CB_SCRIPT_OP_2;
+	badMultisigData[70] = CB_SCRIPT_OP_CHECKMULTISIG;
+	// Uses OP_PUSHDATA1 for the hash, so there is no room for OP_CHECKSIG in 25 bytes.
+	memcpy(badKeyHashData + 4, multisigData + 3, 20);
+	badKeyHashData[24] = CB_SCRIPT_OP_EQUALVERIFY;
+	CBScript * outScripts[10] = {
+		CBNewScriptWithDataCopy(keyHashData, 25),
+		CBNewScriptWithDataCopy(p2shData, 23),
+		CBNewScriptWithDataCopy(evenKeyData, 35),
+		CBNewScriptWithDataCopy(oddKeyData, 35),
+		CBNewScriptWithDataCopy(fullKeyData, 67),
+		CBNewScriptWithDataCopy(badKeyData, 35),
+		CBNewScriptWithDataCopy(multisigData, 103),
+		CBNewScriptWithDataCopy(badMultisigData, 71),
+		CBNewScriptWithDataCopy(returnData, 5),
+		CBNewScriptWithDataCopy(badKeyHashData, 25),
+	};
+	unsigned long long int values[10] = {5000000000, 1, 0, 123456789, CB_MAX_MONEY, CB_MAX_MONEY + 1, 0xFFFFFFFFFFFFFFFF, 50000, 0, 2};
+	CBByteArray * prevHashes[3];
+	for (int x = 0; x < 3; x++) {
+		prevHashes[x] = CBNewByteArrayOfSize(32);
+		for (int y = 0; y < 32; y++)
+			CBByteArrayGetData(prevHashes[x])[y] = x ? rand() : 0;
+	}
+	// The third hash has the same first 20 bytes as the second.
+	memcpy(CBByteArrayGetData(prevHashes[2]), CBByteArrayGetData(prevHashes[1]), 20);
+	block = CBNewBlock();
+	block->version = 2;
+	block->prevBlockHash = CBNewByteArrayWithDataCopy(CBByteArrayGetData(prevHashes[1]), 32);
+	block->time = 1231006505;
+	block->target = 0x1D00FFFF;
+	block->nonce = 2083236893;
+	block->transactionNum = 4;
+	block->transactions = malloc(sizeof(*block->transactions) * 4);
+	// Coinbase
+	block->transactions[0] = CBNewTransaction(0, 1);
+	CBTransactionTakeInput(block->transactions[0], CBNewTransactionInputTakeScriptAndHash(CBNewScriptWithDataCopy(CBByteArrayGetData(genesisInScript), genesisInScript->length), CB_TX_INPUT_FINAL, prevHashes[0], 0xFFFFFFFF));
+	CBTransactionTakeOutput(block->transactions[0], CBNewTransactionOutput(values[0], outScripts[0]));
+	for (int x = 1; x < 4; x++) {
+		// The lock time of the first transaction after the coinbase follows the OP_PUSHDATA1 key hash script and starts with OP_CHECKSIG, which must not be read as part of the script.
+		block->transactions[x] = CBNewTransaction(x == 3 ? 500000 : (x == 1 ? CB_SCRIPT_OP_CHECKSIG : 0), x == 2 ? -1 : 1);
+		for (int y = 0; y < x; y++) {
+			CBScript * inScript = CBNewScriptWithDataCopy(returnData, y + 1);
+			CBTransactionTakeInput(block->transactions[x], CBNewTransactionInput(inScript, y ? 5 : CB_TX_INPUT_FINAL, prevHashes[1 + (x + y) % 2], y));
+			CBReleaseObject(inScript);
+		}
+		for (int y = 0; y < 10; y++)
+			if (y % 3 == x - 1)
+				CBTransactionTakeOutput(block->transactions[x], CBNewTransactionOutput(values[y], outScripts[y]));
+	}
+	// An empty script
+	CBTransactionTakeOutput(block->transactions[3], CBNewTransactionOutputTakeScript(1, CBNewScriptOfSize(0)));
+	block->merkleRoot = CBNewByteArrayWithDataCopy(CBByteArrayGetData(prevHashes[2]), 32);
+	CBGetMessage(block)->bytes = CBNewByteArrayOfSize(CBBlockCalculateLength(block, true));
+	CBBlockSerialise(block, true, false);
+	int compactLen = CBBlockCalculateCompactLength(block);
+	CBByteArray * compact = CBNewByteArrayOfSize(compactLen + 5);
+	int compactWritten = CBBlockCompactSerialise(block, compact, 5);
+	if (compactWritten > compactLen || compactWritten >= CBGetMessage(block)->bytes->length) {
+		printf("COMPACT LENGTH FAIL %i %i %i\n", compactWritten, compactLen, CBGetMessage(block)->bytes->length);
+		return 1;
+	}
+	CBBlock * compactBlock = CBNewBlock();
+	if (CBBlockCompactDeserialise(compactBlock, compact, 5) != compactWritten) {
+		printf("COMPACT DESERIALISE FAIL\n");
+		return 1;
+	}
+	if (memcmp(CBBlockGetHash(compactBlock), CBBlockGetHash(block), 32)) {
+		printf("COMPACT HASH FAIL\n");
+		return 1;
+	}
+	CBGetMessage(compactBlock)->bytes = CBNewByteArrayOfSize(CBBlockCalculateLength(compactBlock, true));
+	if (CBBlockSerialise(compactBlock, true, false) != CBGetMessage(block)->bytes->length
+		|| CBByteArrayCompare(CBGetMessage(compactBlock)->bytes, CBGetMessage(block)->bytes) != CB_COMPARE_EQUAL) {
+		printf("COMPACT ROUND TRIP FAIL\n");
+		return 1;
+	}
+	// Truncated data fails.
+	for (int x = 5; x < 5 + compactWritten; x += 7) {
+		CBByteArray * truncated = CBByteArraySubReference(compact, 0, x);
+		CBBlock * truncatedBlock = CBNewBlock();
+		if (CBBlockCompactDeserialise(truncatedBlock, truncated, 5) != CB_DESERIALISE_ERROR) {
+			printf("COMPACT TRUNCATED FAIL %i\n", x);
+			return 1;
+		}
+		CBReleaseObject(truncatedBlock);
+		CBReleaseObject(truncated);
+	}
+	CBReleaseObject(compactBlock);
+	CBReleaseObject(compact);
+	CBReleaseObject(block);
+	for (int x = 1; x < 3; x++)
+		CBReleaseObject(prevHashes[x]);
+	for (int x = 0; x < 10; x++)
+		CBReleaseObject(outScripts[x]);
 	return 0;
 }
@@ -0,0 +1,151 @@
+//
+//  testCBBlockAssembler.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBBlockAssembler.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+bool checkBlock(CBBlockAssembler * assembler, CBUnspentOutputSet * set);
+bool checkBlock(CBBlockAssembler * assembler, CBUnspentOutputSet * set){
+	CBBlock * block = CBBlockAssemblerGetBlock(assembler);
+	unsigned char * root = CBBlockCalculateMerkleRoot(block);
+	bool ok = ! memcmp(root, CBBlockAssemblerGetMerkleRoot(assembler), 32)
+		&& CBValidateBlockMerkleRoot(block) == CB_BLOCK_VALIDATION_OK
+		&& CBGetMessage(block)->bytes->length <= assembler->size;
+	free(root);
+	// The spends and the coinbase value must be valid.
+	CBBlockValidator * validator = CBNewBlockValidator(0);
+	CBBlockUndo * undo = CBNewBlockUndo();
+	if (CBValidateBlockSpends(validator, block, set, assembler->height, undo) != CB_BLOCK_VALIDATION_OK)
+		ok = false;
+	else
+		CBBlockDisconnect(block, set, undo);
+	CBReleaseObject(undo);
+	CBReleaseObject(validator);
+	CBReleaseObject(block);
+	return ok;
+}
+
+int main(){
+	CBScript * script = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1}, 1);
+	CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+	unsigned char prevHash[32];
+	memset(prevHash, 0x11, 32);
+	for (int x = 0; x < 4; x++)
+		CBUnspentOutputSetTakeOutput(set, CBNewUnspentOutput(prevHash, x, CB_ONE_BITCOIN, (unsigned char []){CB_SCRIPT_OP_1}, 1, 1, false));
+	CBMempool * pool = CBNewMempool(CB_MEMPOOL_DEFAULT_MAX_SIZE, CB_MEMPOOL_DEFAULT_MIN_FEE_RATE);
+	// A has a low fee but its child pays for it, so the package comes before B. C has the lowest fee.
+	CBTransaction * txs[5];
+	txs[0] = newTestTransaction(prevHash, 0, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 10000}, 1);
+	txs[1] = newTestTransaction(CBTransactionGetHash(txs[0]), 0, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 110000}, 1);
+	txs[2] = newTestTransaction(prevHash, 1, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 50000}, 1);
+	txs[3] = newTestTransaction(prevHash, 2, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 20000}, 1);
+	for (int x = 0; x < 4; x++)
+		if (CBMempoolAddTransaction(pool, txs[x], set, 199, 0) != CB_MEMPOOL_OK) {
+			printf("ADD TO POOL FAIL\n");
+			return 1;
+		}
+	CBScript * outputScript = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1}, 1);
+	CBBlockAssembler * assembler = CBNewBlockAssembler(pool, outputScript);
+	// Transactions cannot be added before there is a template.
+	if (CBBlockAssemblerAddTransaction(assembler, CBMempoolGetTransaction(pool, CBTransactionGetHash(txs[0]))) || assembler->transactionNum) {
+		printf("ADD BEFORE TEMPLATE FAIL\n");
+		return 1;
+	}
+	unsigned char tip[32];
+	memset(tip, 0x22, 32);
+	CBBlockAssemblerNewTemplate(assembler, tip, 200, 1400000000, CB_MAX_TARGET);
+	if (assembler->transactionNum != 5 || assembler->fees != 180000) {
+		printf("TEMPLATE NUM FAIL\n");
+		return 1;
+	}
+	int order[4] = {0, 1, 2, 3};
+	for (int x = 0; x < 4; x++)
+		if (memcmp(CBTransactionGetHash(assembler->transactions[x + 1]), CBTransactionGetHash(txs[order[x]]), 32)) {
+			printf("TEMPLATE ORDER FAIL %i\n", x);
+			return 1;
+		}
+	CBTransaction * coinbase = assembler->transactions[0];
+	if (! CBTransactionIsCoinBase(coinbase) || coinbase->outputs[0]->value != (unsigned long long int)CBCalculateBlockReward(200) + 180000
+		|| CBByteArrayGetByte(coinbase->inputs[0]->scriptObject, 0) != 2
+		|| CBByteArrayGetByte(coinbase->inputs[0]->scriptObject, 1) != 200 || CBByteArrayGetByte(coinbase->inputs[0]->scriptObject, 2) != 0) {
+		printf("TEMPLATE COINBASE FAIL\n");
+		return 1;
+	}
+	if (! checkBlock(assembler, set)) {
+		printf("TEMPLATE BLOCK FAIL\n");
+		return 1;
+	}
+	// Add a new transaction to the pool and the template
+	txs[4] = newTestTransaction(prevHash, 3, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 30000}, 1);
+	if (CBMempoolAddTransaction(pool, txs[4], set, 199, 0) != CB_MEMPOOL_OK) {
+		printf("ADD TO POOL FAIL\n");
+		return 1;
+	}
+	// Transactions which do not fit are not added
+	CBMempoolTransaction * entry = CBMempoolGetTransaction(pool, CBTransactionGetHash(txs[4]));
+	int size = assembler->size;
+	assembler->size = CB_BLOCK_MAX_SIZE - entry->size + 1;
+	if (CBBlockAssemblerAddTransaction(assembler, entry) || assembler->transactionNum != 5) {
+		printf("TEMPLATE FULL FAIL\n");
+		return 1;
+	}
+	assembler->size = size;
+	if (! CBBlockAssemblerAddTransaction(assembler, CBMempoolGetTransaction(pool, CBTransactionGetHash(txs[4])))
+		|| assembler->transactionNum != 6 || assembler->fees != 210000) {
+		printf("ADD TRANSACTION FAIL\n");
+		return 1;
+	}
+	if (! checkBlock(assembler, set)) {
+		printf("ADD TRANSACTION BLOCK FAIL\n");
+		return 1;
+	}
+	// Adding again does nothing
+	if (! CBBlockAssemblerAddTransaction(assembler, CBMempoolGetTransaction(pool, CBTransactionGetHash(txs[4]))) || assembler->transactionNum != 6) {
+		printf("ADD TRANSACTION AGAIN FAIL\n");
+		return 1;
+	}
+	// The extra nonce changes the merkle root
+	unsigned char root[32];
+	memcpy(root, CBBlockAssemblerGetMerkleRoot(assembler), 32);
+	CBBlockAssemblerSetExtraNonce(assembler, 1);
+	if (! memcmp(root, CBBlockAssemblerGetMerkleRoot(assembler), 32) || ! checkBlock(assembler, set)) {
+		printf("EXTRA NONCE FAIL\n");
+		return 1;
+	}
+	// A new template for a block with more transactions in the pool
+	CBBlockAssemblerNewTemplate(assembler, tip, 200, 1400000000, CB_MAX_TARGET);
+	if (assembler->transactionNum != 6 || ! checkBlock(assembler, set)) {
+		printf("NEW TEMPLATE FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < 5; x++)
+		CBReleaseObject(txs[x]);
+	CBReleaseObject(assembler);
+	CBReleaseObject(outputScript);
+	CBReleaseObject(pool);
+	CBReleaseObject(set);
+	CBReleaseObject(script);
+	return 0;
+}
@@ -181,6 +181,99 @@ int main(){
 		}
 		return 1;
 	}
+	if (CBBlockHeadersCalculateLength(blockHeaders) != 165) {
+		printf("CALCULATE LENGTH FAIL\n");
+		return 1;
+	}
+	// Test flat deserialisation
+	CBByteArray * flatBytes = CBNewByteArrayWithDataCopy(data, 165);
+	CBBlockHeaders * flatHeaders = CBNewBlockHeadersFromData(flatBytes);
+	if (CBBlockHeadersDeserialiseFlat(flatHeaders) != 165 || flatHeaders->headerNum != 2) {
+		printf("FLAT DESERIALISATION LEN FAIL\n");
+		return 1;
+	}
+	unsigned char * header = CBBlockHeadersGetHeader(flatHeaders, 1);
+	if (header != CBByteArrayGetData(flatBytes) + 83) {
+		printf("FLAT DESERIALISATION COPY FAIL\n");
+		return 1;
+	}
+	if (CBBlockHeaderGetVersion(header) != 2
+		|| memcmp(CBBlockHeaderGetPrevBlockHash(header), data + 5, 32)
+		|| memcmp(CBBlockHeaderGetMerkleRoot(header), data + 119, 32)
+		|| CBBlockHeaderGetTime(header) != 1342135384
+		|| CBBlockHeaderGetTarget(header) != 0x0C21AB69
+		|| CBBlockHeaderGetNonce(header) != 0x0D31AFB2
+		|| CBBlockHeadersGetTransactionNum(flatHeaders, 0) != 0
+		|| CBBlockHeadersGetTransactionNum(flatHeaders, 1) != 7) {
+		printf("FLAT DESERIALISATION SECOND HEADER FAIL\n");
+		return 1;
+	}
+	unsigned char hash[32];
+	CBBlockHeadersCalculateHash(flatHeaders, 0, hash);
+	if (memcmp(hash, CBBlockGetHash(blockHeaders->blockHeaders[0]), 32)) {
+		printf("FLAT HASH FAIL\n");
+		return 1;
+	}
+	CBBlock * block = CBBlockHeadersGetBlock(flatHeaders, 1);
+	if (block->nonce != 0x0D31AFB2 || block->transactionNum != 7) {
+		printf("FLAT GET BLOCK FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block);
+	// Invalid transaction numbers for flat headers
+	CBByteArrayGetData(flatBytes)[163] = 0xFD;
+	CBBlockHeaders * badHeaders = CBNewBlockHeadersFromData(flatBytes);
+	if (CBBlockHeadersDeserialiseFlat(badHeaders) != CB_DESERIALISE_ERROR) {
+		printf("FLAT DESERIALISATION TX NUM FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(badHeaders);
+	CBByteArrayGetData(flatBytes)[163] = 7;
+	// Test flat serialisation in place and from added headers
+	if (CBBlockHeadersSerialise(flatHeaders, false) != 165 || memcmp(data, CBByteArrayGetData(flatBytes), 165)) {
+		printf("FLAT SERIALISATION IN PLACE FAIL\n");
+		return 1;
+	}
+	CBBlockHeaders * addedHeaders = CBNewBlockHeaders();
+	CBBlockHeadersAddHeader(addedHeaders, data + 1, 0);
+	CBBlockHeadersAddHeader(addedHeaders, data + 83, 7);
+	CBBlockHeadersPrepareBytes(addedHeaders);
+	if (CBBlockHeadersSerialise(addedHeaders, false) != 165 || memcmp(data, CBByteArrayGetData(CBGetMessage(addedHeaders)->bytes), 165)) {
+		printf("FLAT SERIALISATION FAIL\n");
+		return 1;
+	}
+	// Headers cannot be added past the maximum.
+	for (int x = 2; x < CB_BLOCK_HEADERS_MAX_NUM; x++)
+		if (! CBBlockHeadersAddHeader(addedHeaders, data + 1, 0)) {
+			printf("FLAT ADD FAIL\n");
+			return 1;
+		}
+	if (CBBlockHeadersAddHeader(addedHeaders, data + 1, 0) || addedHeaders->headerNum != CB_BLOCK_HEADERS_MAX_NUM) {
+		printf("FLAT ADD PAST MAXIMUM FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(addedHeaders);
+	CBReleaseObject(flatHeaders);
+	CBReleaseObject(flatBytes);
+	// Test checking a chain of flat headers with the genesis header, followed by a header with an invalid proof of work.
+	CBBlock * genesis = CBNewBlockGenesisHeader();
+	CBBlockHeaders * chain = CBNewBlockHeaders();
+	CBBlockHeadersAddHeader(chain, CBByteArrayGetData(CBGetMessage(genesis)->bytes), 0);
+	unsigned char next[80];
+	memcpy(next, CBByteArrayGetData(CBGetMessage(genesis)->bytes), 80);
+	memcpy(next + 4, CBBlockGetHash(genesis), 32);
+	CBBlockHeadersAddHeader(chain, next, 0);
+	unsigned char hashes[64];
+	if (CBBlockHeadersCheckChain(chain, NULL, hashes) != 1 || memcmp(hashes, CBBlockGetHash(genesis), 32)) {
+		printf("CHECK CHAIN POW FAIL\n");
+		return 1;
+	}
+	if (CBBlockHeadersCheckChain(chain, next + 4, NULL) != 0) {
+		printf("CHECK CHAIN LINK FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(chain);
+	CBReleaseObject(genesis);
 	CBReleaseObject(blockHeaders);
 	CBReleaseObject(bytes);
 	return 0;
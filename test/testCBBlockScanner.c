@@ -0,0 +1,142 @@
+//
+//  testCBBlockScanner.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBBlockScanner.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+CBBlockScannerMatch matches[20];
+int matchNum;
+
+void onMatch(void * foo, CBBlockScannerMatch * match);
+void onMatch(void * foo, CBBlockScannerMatch * match){
+	UNUSED(foo);
+	if (matchNum < 20)
+		matches[matchNum] = *match;
+	matchNum++;
+}
+
+bool checkMatch(int x, CBBlockScannerMatchType type, unsigned int height, int txIndex, CBTransaction * tx, int index, uint64_t value, void * watched);
+bool checkMatch(int x, CBBlockScannerMatchType type, unsigned int height, int txIndex, CBTransaction * tx, int index, uint64_t value, void * watched){
+	return matches[x].type == type && matches[x].height == height && matches[x].txIndex == txIndex
+		&& ! memcmp(matches[x].txHash, CBTransactionGetHash(tx), 32) && matches[x].index == index
+		&& matches[x].value == value && matches[x].watched == watched;
+}
+
+int main(){
+	CBScript * script = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1, CB_SCRIPT_OP_1}, 2);
+	unsigned long long int values[4] = {1000, 1001, 1002, 1003};
+	int watchedKey, watchedScript, watchedGenesis, watchedOutPoint;
+	unsigned char keyHash[20], scriptHash[20], otherHash[20];
+	for (int x = 0; x < 20; x++) {
+		keyHash[x] = x;
+		scriptHash[x] = 100 + x;
+		otherHash[x] = 200 + x;
+	}
+	CBScript * keyHashScript = CBNewScriptPubKeyHashOutput(keyHash);
+	unsigned char p2sh[23] = {CB_SCRIPT_OP_HASH160, 0x14};
+	memcpy(p2sh + 2, scriptHash, 20);
+	p2sh[22] = CB_SCRIPT_OP_EQUAL;
+	CBScript * scriptHashScript = CBNewScriptWithDataCopy(p2sh, 23);
+	CBScript * otherScript = CBNewScriptPubKeyHashOutput(otherHash);
+	CBScript * emptyScript = CBNewScriptOfSize(0);
+	// Block 1 pays the key hash and the script hash, and has an output and a transaction with no matches.
+	CBTransaction * a = newTestTransaction(NULL, 0, 1, script, (CBScript *[]){otherScript, keyHashScript, emptyScript, scriptHashScript}, values, 4);
+	CBTransaction * b = newTestTransaction(NULL, 0, 1, script, (CBScript *[]){otherScript}, values, 1);
+	// Block 2 spends the key hash output of block 1 and an outpoint watched before the scan.
+	unsigned char watchedTxHash[32];
+	memset(watchedTxHash, 7, 32);
+	CBTransaction * c = newTestTransaction(CBTransactionGetHash(a), 1, 1, script, (CBScript *[]){otherScript}, values, 1);
+	CBTransaction * d = newTestTransaction(watchedTxHash, 3, 1, script, (CBScript *[]){otherScript, otherScript}, values, 2);
+	// Block 3 pays the key hash and spends the output in the same block.
+	CBTransaction * e = newTestTransaction(NULL, 0, 1, script, (CBScript *[]){keyHashScript}, values, 1);
+	CBTransaction * f = newTestTransaction(CBTransactionGetHash(e), 0, 1, script, (CBScript *[]){otherScript}, values, 1);
+	CBBlock * blocks[4];
+	blocks[0] = CBNewBlockGenesis();
+	blocks[1] = newTestBlock((CBTransaction *[]){a, b}, 2, 0);
+	blocks[2] = newTestBlock((CBTransaction *[]){c, d}, 2, 0);
+	blocks[3] = newTestBlock((CBTransaction *[]){e, f}, 2, 0);
+	// The hash of the genesis public key, which is paid to with a pay-to-pubkey output.
+	CBTransaction * genesisTx = blocks[0]->transactions[0];
+	unsigned char genesisHash[32];
+	CBSha256(CBByteArrayGetData(genesisTx->outputs[0]->scriptObject) + 1, 65, genesisHash);
+	CBRipemd160(genesisHash, 32, genesisHash);
+	// Scan the blocks one at a time and together, with and without threads.
+	for (int x = 0; x < 3; x++) {
+		CBBlockScanner * scanner = CBNewBlockScanner(x == 2 ? 2 : 0, onMatch, NULL);
+		CBBlockScannerWatchHash(scanner, keyHash, &watchedKey);
+		CBBlockScannerWatchHash(scanner, scriptHash, &watchedScript);
+		CBBlockScannerWatchHash(scanner, genesisHash, &watchedGenesis);
+		CBBlockScannerWatchOutPoint(scanner, watchedTxHash, 3, &watchedOutPoint);
+		matchNum = 0;
+		if (x == 0) {
+			for (int y = 0; y < 4; y++)
+				if (! CBBlockScannerScanBlocks(scanner, blocks + y, 1, y)) {
+					printf("SCAN BLOCK %i FAIL\n", y);
+					return 1;
+				}
+		}else if (! CBBlockScannerScanBlocks(scanner, blocks, 4, 0)) {
+			printf("SCAN BLOCKS %i FAIL\n", x);
+			return 1;
+		}
+		if (matchNum != 7
+			|| ! checkMatch(0, CB_BLOCK_SCANNER_OUTPUT, 0, 0, genesisTx, 0, 5000000000, &watchedGenesis)
+			|| ! checkMatch(1, CB_BLOCK_SCANNER_OUTPUT, 1, 0, a, 1, 1001, &watchedKey)
+			|| ! checkMatch(2, CB_BLOCK_SCANNER_OUTPUT, 1, 0, a, 3, 1003, &watchedScript)
+			|| ! checkMatch(3, CB_BLOCK_SCANNER_SPEND, 2, 0, c, 0, 0, &watchedKey)
+			|| ! checkMatch(4, CB_BLOCK_SCANNER_SPEND, 2, 1, d, 0, 0, &watchedOutPoint)
+			|| ! checkMatch(5, CB_BLOCK_SCANNER_OUTPUT, 3, 0, e, 0, 1000, &watchedKey)
+			|| ! checkMatch(6, CB_BLOCK_SCANNER_SPEND, 3, 1, f, 0, 0, &watchedKey)) {
+			printf("MATCHES %i FAIL\n", x);
+			return 1;
+		}
+		// Scanning again finds the same matches once each, as the outpoints are already watched.
+		matchNum = 0;
+		CBBlockScannerScanBlocks(scanner, blocks, 4, 0);
+		if (matchNum != 7 || ! checkMatch(6, CB_BLOCK_SCANNER_SPEND, 3, 1, f, 0, 0, &watchedKey)) {
+			printf("RESCAN %i FAIL\n", x);
+			return 1;
+		}
+		// A truncated block cannot be read and the matches of the blocks before it are given.
+		CBByteArray * truncated = CBNewByteArraySubReference(CBGetMessage(blocks[3])->bytes, 0, CBGetMessage(blocks[3])->bytes->length - 10);
+		CBBlock * bad = CBNewBlockFromData(truncated);
+		CBReleaseObject(truncated);
+		CBBlock * withBad[2] = {blocks[2], bad};
+		matchNum = 0;
+		if (CBBlockScannerScanBlocks(scanner, withBad, 2, 2) || matchNum != 2) {
+			printf("TRUNCATED %i FAIL\n", x);
+			return 1;
+		}
+		CBReleaseObject(bad);
+		CBReleaseObject(scanner);
+	}
+	for (int x = 0; x < 4; x++)
+		CBReleaseObject(blocks[x]);
+	CBReleaseObject(keyHashScript);
+	CBReleaseObject(scriptHashScript);
+	CBReleaseObject(otherScript);
+	CBReleaseObject(emptyScript);
+	CBReleaseObject(script);
+	return 0;
+}
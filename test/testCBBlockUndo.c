@@ -0,0 +1,146 @@
+//
+//  testCBBlockUndo.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBBlockUndo.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	CBScript * script = CBNewScriptWithDataCopy((unsigned char []){0x51, 0x51}, 2);
+	// Test amount compression
+	unsigned long long int amounts[] = {0, 1, 9, 10, 50 * CB_ONE_BITCOIN, 12345678, 2100000000000000LL, 1000000000000LL};
+	for (int x = 0; x < 8; x++) {
+		if (CBDecompressAmount(CBCompressAmount(amounts[x])) != amounts[x]) {
+			printf("AMOUNT COMPRESSION ROUND TRIP FAIL %llu\n", amounts[x]);
+			return 1;
+		}
+	}
+	if (CBCompressAmount(50 * CB_ONE_BITCOIN) > 0xFF) {
+		printf("AMOUNT COMPRESSION ROUND VALUE SIZE FAIL\n");
+		return 1;
+	}
+	// Connect a block with a coinbase creating three outputs
+	CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+	CBTransaction * txs[3];
+	txs[0] = newTestTransaction(NULL, 0, 1, script, NULL, (unsigned long long int []){50 * CB_ONE_BITCOIN, 50 * CB_ONE_BITCOIN, 50 * CB_ONE_BITCOIN}, 3);
+	CBBlock * block1 = newTestBlock(txs, 1, 1);
+	CBBlockUndo * undo1 = CBNewBlockUndo();
+	if (! CBBlockConnect(block1, set, 1, undo1) || set->outputNum != 3 || undo1->spentNum) {
+		printf("CONNECT COINBASE FAIL\n");
+		return 1;
+	}
+	unsigned char coinbaseHash[32];
+	memcpy(coinbaseHash, CBTransactionGetHash(txs[0]), 32);
+	CBUnspentOutput * unspent = CBUnspentOutputSetGetOutput(set, coinbaseHash, 2);
+	if (! unspent || ! unspent->coinbase || unspent->height != 1 || unspent->value != 50 * CB_ONE_BITCOIN || unspent->scriptLength != 2) {
+		printf("CONNECT COINBASE OUTPUT FAIL\n");
+		return 1;
+	}
+	// Connect a second block spending two coinbase outputs, then spending an output from within the same block
+	txs[0] = newTestTransaction(NULL, 0, 1, script, NULL, (unsigned long long int []){25 * CB_ONE_BITCOIN}, 1);
+	txs[1] = newTestTransaction(coinbaseHash, 0, 2, script, NULL, (unsigned long long int []){30 * CB_ONE_BITCOIN, 30 * CB_ONE_BITCOIN}, 2);
+	txs[2] = newTestTransaction(CBTransactionGetHash(txs[1]), 1, 1, script, NULL, (unsigned long long int []){20 * CB_ONE_BITCOIN}, 1);
+	CBBlock * block2 = newTestBlock(txs, 3, 3);
+	CBBlockUndo * undo2 = CBNewBlockUndo();
+	if (! CBBlockConnect(block2, set, 2, undo2)) {
+		printf("CONNECT BLOCK FAIL\n");
+		return 1;
+	}
+	// Coinbase outputs 0 and 1 and the second output of the second transaction are spent. Four outputs are added.
+	if (set->outputNum != 4 || undo2->spentNum != 3) {
+		printf("CONNECT BLOCK NUM FAIL %i %i\n", set->outputNum, undo2->spentNum);
+		return 1;
+	}
+	if (CBUnspentOutputSetGetOutput(set, coinbaseHash, 0) || ! CBUnspentOutputSetGetOutput(set, coinbaseHash, 2)) {
+		printf("CONNECT BLOCK SPENT FAIL\n");
+		return 1;
+	}
+	// Serialise and deserialise the undo data
+	CBBlockUndoPrepareBytes(undo2);
+	int len = CBBlockUndoSerialise(undo2);
+	if (len != CBBlockUndoCalculateLength(undo2) || len != 32 + 1 + 3 * 5) {
+		printf("UNDO SERIALISE LENGTH FAIL %i\n", len);
+		return 1;
+	}
+	CBBlockUndo * undo2Copy = CBNewBlockUndoFromData(CBGetMessage(undo2)->bytes);
+	if (CBBlockUndoDeserialise(undo2Copy) != len || undo2Copy->spentNum != 3) {
+		printf("UNDO DESERIALISE FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < 3; x++) {
+		if (undo2Copy->spent[x]->value != undo2->spent[x]->value
+			|| undo2Copy->spent[x]->height != undo2->spent[x]->height
+			|| undo2Copy->spent[x]->coinbase != undo2->spent[x]->coinbase
+			|| undo2Copy->spent[x]->scriptLength != undo2->spent[x]->scriptLength
+			|| memcmp(undo2Copy->spent[x]->script, undo2->spent[x]->script, 2)) {
+			printf("UNDO DESERIALISE SPENT OUTPUT FAIL\n");
+			return 1;
+		}
+	}
+	CBReleaseObject(undo2);
+	// Disconnect with the deserialised undo data
+	if (CBBlockDisconnect(block1, set, undo2Copy)) {
+		printf("DISCONNECT WRONG BLOCK FAIL\n");
+		return 1;
+	}
+	if (! CBBlockDisconnect(block2, set, undo2Copy) || set->outputNum != 3 || undo2Copy->spentNum) {
+		printf("DISCONNECT BLOCK FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < 3; x++) {
+		unspent = CBUnspentOutputSetGetOutput(set, coinbaseHash, x);
+		if (! unspent || ! unspent->coinbase || unspent->height != 1 || unspent->value != 50 * CB_ONE_BITCOIN) {
+			printf("DISCONNECT BLOCK RESTORE FAIL\n");
+			return 1;
+		}
+	}
+	CBReleaseObject(undo2Copy);
+	// Connecting a block that spends a missing output fails and leaves the set unchanged
+	CBBlockUndo * undo3 = CBNewBlockUndo();
+	CBTransaction * bad = newTestTransaction(coinbaseHash, 2, 2, script, NULL, (unsigned long long int []){1}, 1);
+	CBReleaseObject(block2->transactions[2]);
+	block2->transactions[2] = bad;
+	if (CBBlockConnect(block2, set, 2, undo3) || set->outputNum != 3 || undo3->spentNum) {
+		printf("CONNECT MISSING OUTPUT FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < 3; x++) {
+		if (! CBUnspentOutputSetGetOutput(set, coinbaseHash, x)) {
+			printf("CONNECT MISSING OUTPUT REVERT FAIL\n");
+			return 1;
+		}
+	}
+	CBReleaseObject(undo3);
+	// Disconnect the first block
+	if (! CBBlockDisconnect(block1, set, undo1) || set->outputNum) {
+		printf("DISCONNECT COINBASE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(undo1);
+	CBReleaseObject(block1);
+	CBReleaseObject(block2);
+	CBReleaseObject(set);
+	CBReleaseObject(script);
+	return 0;
+}
@@ -0,0 +1,242 @@
+//
+//  testCBBlockValidator.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBBlockValidator.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	CBScript * script = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1, CB_SCRIPT_OP_1}, 2);
+	// Validate the genesis block with and without threads
+	for (int threads = 0; threads < 3; threads += 2) {
+		CBBlockValidator * validator = CBNewBlockValidator(threads);
+		CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+		CBBlockUndo * undo = CBNewBlockUndo();
+		CBBlock * genesis = CBNewBlockGenesis();
+		CBBlockValidationResult res = CBValidateBlock(validator, genesis, set, 0, genesis->time, undo);
+		if (res != CB_BLOCK_VALIDATION_OK || set->outputNum != 1) {
+			printf("GENESIS VALIDATION FAIL %i WITH %i THREADS\n", res, threads);
+			return 1;
+		}
+		CBReleaseObject(undo);
+		undo = CBNewBlockUndo();
+		if (CBValidateBlock(validator, genesis, set, 0, genesis->time - CB_BLOCK_ALLOWED_TIME_DRIFT - 1, undo) != CB_BLOCK_VALIDATION_BAD_TIME) {
+			printf("GENESIS BAD TIME FAIL\n");
+			return 1;
+		}
+		// Connecting again fails as the coinbase output already exists.
+		if (CBValidateBlock(validator, genesis, set, 0, genesis->time, undo) != CB_BLOCK_VALIDATION_BAD_SPEND || set->outputNum != 1) {
+			printf("GENESIS CONNECT TWICE FAIL\n");
+			return 1;
+		}
+		CBReleaseObject(genesis);
+		CBReleaseObject(undo);
+		CBReleaseObject(set);
+		CBReleaseObject(validator);
+	}
+	// Test assume-valid with the genesis block as the trusted block
+	CBBlockValidator * validator = CBNewBlockValidator(0);
+	CBBlock * genesis = CBNewBlockGenesis();
+	unsigned char genesisHash[32];
+	memcpy(genesisHash, CBBlockGetHash(genesis), 32);
+	if (! CBBlockValidatorSetAssumeValid(validator, genesisHash, &genesis, 1, 0)) {
+		printf("SET ASSUME VALID FAIL\n");
+		return 1;
+	}
+	if (! CBBlockValidatorIsAssumedValid(validator, genesisHash, 0)
+		|| CBBlockValidatorIsAssumedValid(validator, genesisHash, 1)) {
+		printf("IS ASSUMED VALID HEIGHT FAIL\n");
+		return 1;
+	}
+	CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+	CBBlockUndo * undo = CBNewBlockUndo();
+	if (CBValidateBlock(validator, genesis, set, 0, genesis->time, undo) != CB_BLOCK_VALIDATION_OK || ! validator->assumedValid) {
+		printf("VALIDATE ASSUMED VALID FAIL\n");
+		return 1;
+	}
+	CBBlockDisconnect(genesis, set, undo);
+	// The genesis block is not assumed valid at another height.
+	if (CBValidateBlock(validator, genesis, set, 1, genesis->time, undo) != CB_BLOCK_VALIDATION_OK || validator->assumedValid) {
+		printf("VALIDATE NOT ASSUMED VALID FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(undo);
+	CBReleaseObject(set);
+	// A wrong trusted hash, headers which do not link and headers without proof of work are rejected.
+	genesisHash[0] ^= 1;
+	if (CBBlockValidatorSetAssumeValid(validator, genesisHash, &genesis, 1, 0) || validator->assumeValidNum) {
+		printf("SET ASSUME VALID WRONG HASH FAIL\n");
+		return 1;
+	}
+	genesisHash[0] ^= 1;
+	if (CBBlockValidatorSetAssumeValid(validator, genesisHash, (CBBlock *[]){genesis, genesis}, 2, 0)) {
+		printf("SET ASSUME VALID NOT LINKED FAIL\n");
+		return 1;
+	}
+	CBTransaction * coinbase = newTestTransaction(NULL, 0, 1, script, NULL, (unsigned long long int []){50 * CB_ONE_BITCOIN}, 1);
+	CBBlock * block = newTestBlock(&coinbase, 1, 0);
+	memcpy(CBByteArrayGetData(block->prevBlockHash), genesisHash, 32);
+	CBGetMessage(block)->serialised = false;
+	block->hashSet = false;
+	CBBlockSerialise(block, true, false);
+	if (CBBlockValidatorSetAssumeValid(validator, CBBlockGetHash(block), (CBBlock *[]){genesis, block}, 2, 0)) {
+		printf("SET ASSUME VALID BAD POW FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block);
+	CBReleaseObject(genesis);
+	CBReleaseObject(validator);
+	// Test stage 1 with no transactions
+	block = CBNewBlockGenesisHeader();
+	int failed;
+	if (CBValidateBlockContextFree(block, block->time, &failed) != CB_BLOCK_VALIDATION_NO_TRANSACTIONS) {
+		printf("NO TRANSACTIONS FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block);
+	// Test stage 2
+	CBTransaction * txs[3];
+	txs[0] = newTestTransaction(NULL, 0, 1, script, NULL, (unsigned long long int []){50 * CB_ONE_BITCOIN}, 1);
+	unsigned char prevHash[32];
+	memset(prevHash, 0x11, 32);
+	txs[1] = newTestTransaction(prevHash, 0, 1, script, NULL, (unsigned long long int []){10}, 1);
+	txs[2] = newTestTransaction(prevHash, 1, 1, script, NULL, (unsigned long long int []){10}, 1);
+	block = newTestBlock(txs, 3, 0);
+	if (CBValidateBlockMerkleRoot(block) != CB_BLOCK_VALIDATION_OK) {
+		printf("MERKLE ROOT OK FAIL\n");
+		return 1;
+	}
+	CBByteArraySetByte(block->merkleRoot, 0, CBByteArrayGetByte(block->merkleRoot, 0) ^ 1);
+	if (CBValidateBlockMerkleRoot(block) != CB_BLOCK_VALIDATION_BAD_MERKLE_ROOT) {
+		printf("BAD MERKLE ROOT FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block->transactions[2]);
+	block->transactions[2] = block->transactions[1];
+	CBRetainObject(block->transactions[1]);
+	if (CBValidateBlockMerkleRoot(block) != CB_BLOCK_VALIDATION_DUPLICATE_TRANSACTION) {
+		printf("DUPLICATE TRANSACTION FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block);
+	// Test stage 3 with a coinbase output at height 1
+	validator = CBNewBlockValidator(0);
+	set = CBNewUnspentOutputSet();
+	CBTransaction * prevCoinbase = newTestTransaction(NULL, 0, 1, script, NULL, (unsigned long long int []){50 * CB_ONE_BITCOIN}, 1);
+	unsigned char * coinbaseHash = CBTransactionGetHash(prevCoinbase);
+	CBUnspentOutputSetTakeOutput(set, CBNewUnspentOutput(coinbaseHash, 0, 50 * CB_ONE_BITCOIN, (unsigned char []){CB_SCRIPT_OP_1}, 1, 1, true));
+	struct{
+		unsigned int height;
+		unsigned long long int spend;
+		unsigned long long int coinbase;
+		CBBlockValidationResult res;
+	} cases[] = {
+		{101, 40 * CB_ONE_BITCOIN, 60 * CB_ONE_BITCOIN, CB_BLOCK_VALIDATION_OK},
+		{101, 40 * CB_ONE_BITCOIN, 60 * CB_ONE_BITCOIN + 1, CB_BLOCK_VALIDATION_BAD_COINBASE_VALUE},
+		{100, 40 * CB_ONE_BITCOIN, 45 * CB_ONE_BITCOIN, CB_BLOCK_VALIDATION_IMMATURE_COINBASE},
+		{101, 50 * CB_ONE_BITCOIN + 1, 45 * CB_ONE_BITCOIN, CB_BLOCK_VALIDATION_BAD_VALUE},
+	};
+	for (int x = 0; x < 4; x++) {
+		txs[0] = newTestTransaction(NULL, 0, 1, script, NULL, (unsigned long long int []){cases[x].coinbase}, 1);
+		txs[1] = newTestTransaction(coinbaseHash, 0, 1, script, NULL, (unsigned long long int []){cases[x].spend}, 1);
+		block = newTestBlock(txs, 2, 0);
+		CBBlockUndo * undo = CBNewBlockUndo();
+		CBBlockValidationResult res = CBValidateBlockSpends(validator, block, set, cases[x].height, undo);
+		if (res != cases[x].res) {
+			printf("SPENDS CASE %i FAIL %i != %i\n", x, res, cases[x].res);
+			return 1;
+		}
+		if (res == CB_BLOCK_VALIDATION_OK) {
+			if (set->outputNum != 2 || validator->inputNum != 1 || validator->inputs[0].spent->value != 50 * CB_ONE_BITCOIN) {
+				printf("SPENDS CASE %i CONNECT FAIL\n", x);
+				return 1;
+			}
+			CBBlockDisconnect(block, set, undo);
+		}else if (validator->failedTransaction != (res == CB_BLOCK_VALIDATION_BAD_COINBASE_VALUE ? 0 : 1)) {
+			printf("SPENDS CASE %i FAILED TRANSACTION FAIL\n", x);
+			return 1;
+		}
+		if (set->outputNum != 1 || ! CBUnspentOutputSetGetOutput(set, coinbaseHash, 0)) {
+			printf("SPENDS CASE %i SET FAIL\n", x);
+			return 1;
+		}
+		CBReleaseObject(undo);
+		CBReleaseObject(block);
+	}
+	CBReleaseObject(prevCoinbase);
+	CBReleaseObject(set);
+	CBReleaseObject(validator);
+	// Test stage 4
+	CBTransaction * tx = newTestTransaction(prevHash, 0, 1, script, NULL, (unsigned long long int []){10}, 1);
+	CBUnspentOutput * spent = CBNewUnspentOutput(prevHash, 0, 10, (unsigned char []){CB_SCRIPT_OP_1, CB_SCRIPT_OP_EQUAL}, 2, 1, false);
+	CBValidationInput input = {tx, 1, 0, spent};
+	if (! CBValidateInputScripts(&input, true)) {
+		printf("SCRIPT OK FAIL\n");
+		return 1;
+	}
+	spent->script[0] = CB_SCRIPT_OP_2;
+	if (CBValidateInputScripts(&input, true)) {
+		printf("SCRIPT BAD FAIL\n");
+		return 1;
+	}
+	free(spent);
+	// P2SH with the redeem script OP_1
+	CBScript * redeem = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1}, 1);
+	CBScript * p2sh = CBNewScriptP2SHOutput(redeem);
+	spent = CBNewUnspentOutput(prevHash, 0, 10, CBByteArrayGetData(p2sh), p2sh->length, 1, false);
+	input.spent = spent;
+	CBScript * inputScript = tx->inputs[0]->scriptObject;
+	CBByteArraySetBytes(inputScript, 0, (unsigned char []){0x01, CB_SCRIPT_OP_1}, 2);
+	if (! CBValidateInputScripts(&input, true)) {
+		printf("P2SH OK FAIL\n");
+		return 1;
+	}
+	CBByteArraySetBytes(inputScript, 0, (unsigned char []){CB_SCRIPT_OP_NOP, CB_SCRIPT_OP_1}, 2);
+	if (CBValidateInputScripts(&input, true)) {
+		printf("P2SH NOT PUSH ONLY FAIL\n");
+		return 1;
+	}
+	free(spent);
+	CBReleaseObject(p2sh);
+	// P2SH with the redeem script OP_0 only passes before the switch
+	CBByteArraySetByte(redeem, 0, CB_SCRIPT_OP_0);
+	p2sh = CBNewScriptP2SHOutput(redeem);
+	spent = CBNewUnspentOutput(prevHash, 0, 10, CBByteArrayGetData(p2sh), p2sh->length, 1, false);
+	input.spent = spent;
+	CBByteArraySetBytes(inputScript, 0, (unsigned char []){0x01, CB_SCRIPT_OP_0}, 2);
+	if (CBValidateInputScripts(&input, true)) {
+		printf("P2SH BAD REDEEM FAIL\n");
+		return 1;
+	}
+	if (! CBValidateInputScripts(&input, false)) {
+		printf("P2SH BEFORE SWITCH FAIL\n");
+		return 1;
+	}
+	free(spent);
+	CBReleaseObject(redeem);
+	CBReleaseObject(p2sh);
+	CBReleaseObject(tx);
+	CBReleaseObject(script);
+	return 0;
+}
@@ -0,0 +1,219 @@
+//
+//  testCBBloomFilter.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBBlockFilterData.h"
+#include "CBFilterAdd.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	// MurmurHash3 test vectors
+	struct{
+		uint32_t seed;
+		unsigned char data[4];
+		int length;
+		uint32_t result;
+	} vectors[8] = {
+		{0, {0}, 0, 0},
+		{0xFBA4C795, {0}, 0, 0x6a396f08},
+		{0, {0x00}, 1, 0x514E28B7},
+		{0xFBA4C795, {0x00}, 1, 0xea3f0b17},
+		{0, {0xff}, 1, 0xfd6cf10d},
+		{0, {0x00, 0x11}, 2, 0x16c6b7ab},
+		{0, {0x00, 0x11, 0x22}, 3, 0x8eb51c3d},
+		{0, {0x00, 0x11, 0x22, 0x33}, 4, 0xb4471bf8},
+	};
+	for (int x = 0; x < 8; x++)
+		if (CBMurmurHash3(vectors[x].seed, vectors[x].data, vectors[x].length) != vectors[x].result) {
+			printf("MURMUR HASH %i FAIL\n", x);
+			return 1;
+		}
+	// Filter test vectors
+	unsigned char elements[3][20] = {
+		{0x99,0x10,0x8a,0xd8,0xed,0x9b,0xb6,0x27,0x4d,0x39,0x80,0xba,0xb5,0xa8,0x5c,0x04,0x8f,0x09,0x50,0xc8},
+		{0xb5,0xa2,0xc7,0x86,0xd9,0xef,0x46,0x58,0x28,0x7c,0xed,0x59,0x14,0xb3,0x7a,0x1b,0x4a,0xa3,0x2e,0xee},
+		{0xb9,0x30,0x06,0x70,0xb4,0xc5,0x36,0x6e,0x95,0xb2,0x69,0x9e,0x8b,0x18,0xbc,0x75,0xe5,0xf7,0x29,0xc5},
+	};
+	unsigned char expected[2][13] = {
+		{0x03,0x61,0x4e,0x9b,0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01},
+		{0x03,0xce,0x42,0x99,0x05,0x00,0x00,0x00,0x01,0x00,0x00,0x80,0x01},
+	};
+	unsigned int tweaks[2] = {0, 2147483649U};
+	for (int x = 0; x < 2; x++) {
+		CBBloomFilter * filter = CBNewBloomFilter(3, 0.01, tweaks[x], CB_BLOOM_FILTER_UPDATE_ALL);
+		if (! filter->empty || CBBloomFilterContains(filter, elements[0], 20)) {
+			printf("FILTER %i EMPTY FAIL\n", x);
+			return 1;
+		}
+		for (int y = 0; y < 3; y++)
+			CBBloomFilterInsert(filter, elements[y], 20);
+		for (int y = 0; y < 3; y++)
+			if (! CBBloomFilterContains(filter, elements[y], 20)) {
+				printf("FILTER %i CONTAINS %i FAIL\n", x, y);
+				return 1;
+			}
+		elements[0][19] ^= 1;
+		if (CBBloomFilterContains(filter, elements[0], 20)) {
+			printf("FILTER %i NOT CONTAINS FAIL\n", x);
+			return 1;
+		}
+		elements[0][19] ^= 1;
+		CBBloomFilterPrepareBytes(filter);
+		if (CBBloomFilterSerialise(filter) != 13
+			|| memcmp(CBByteArrayGetData(CBGetMessage(filter)->bytes), expected[x], 13)) {
+			printf("FILTER %i SERIALISE FAIL\n", x);
+			return 1;
+		}
+		CBBloomFilter * filter2 = CBNewBloomFilterFromData(CBGetMessage(filter)->bytes);
+		if (CBBloomFilterDeserialise(filter2) != 13
+			|| filter2->hashFuncNum != 5 || filter2->tweak != tweaks[x]
+			|| filter2->update != CB_BLOOM_FILTER_UPDATE_ALL || filter2->empty || filter2->full
+			|| ! CBBloomFilterContains(filter2, elements[2], 20)) {
+			printf("FILTER %i DESERIALISE FAIL\n", x);
+			return 1;
+		}
+		CBReleaseObject(filter2);
+		CBReleaseObject(filter);
+	}
+	// A false positive rate of zero gives the filter for the minimum rate.
+	CBBloomFilter * zeroFilter = CBNewBloomFilter(10, 0, 0, CB_BLOOM_FILTER_UPDATE_ALL);
+	CBBloomFilter * minFilter = CBNewBloomFilter(10, CB_BLOOM_FILTER_MIN_FALSE_POSITIVE_RATE, 0, CB_BLOOM_FILTER_UPDATE_ALL);
+	if (zeroFilter->filter->length != minFilter->filter->length || zeroFilter->hashFuncNum != minFilter->hashFuncNum) {
+		printf("ZERO FALSE POSITIVE RATE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(minFilter);
+	CBReleaseObject(zeroFilter);
+	// Oversized filters are rejected.
+	CBByteArray * bytes = CBNewByteArrayOfSize(CB_BLOOM_FILTER_MAX_SIZE + 12);
+	CBByteArraySetVarInt(bytes, 0, CBVarIntFromUInt64(CB_BLOOM_FILTER_MAX_SIZE + 1));
+	CBBloomFilter * filter = CBNewBloomFilterFromData(bytes);
+	if (CBBloomFilterDeserialise(filter) != CB_DESERIALISE_ERROR) {
+		printf("FILTER SIZE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(filter);
+	CBReleaseObject(bytes);
+	// filteradd
+	CBByteArray * data = CBNewByteArrayWithDataCopy(elements[1], 20);
+	CBFilterAdd * filterAdd = CBNewFilterAdd(data);
+	CBReleaseObject(data);
+	CBFilterAddPrepareBytes(filterAdd);
+	if (CBFilterAddSerialise(filterAdd) != 21) {
+		printf("FILTERADD SERIALISE FAIL\n");
+		return 1;
+	}
+	CBFilterAdd * filterAdd2 = CBNewFilterAddFromData(CBGetMessage(filterAdd)->bytes);
+	if (CBFilterAddDeserialise(filterAdd2) != 21 || filterAdd2->data->length != 20
+		|| memcmp(CBByteArrayGetData(filterAdd2->data), elements[1], 20)) {
+		printf("FILTERADD DESERIALISE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(filterAdd2);
+	CBReleaseObject(filterAdd);
+	// Filtered blocks. The first transaction pays to the filtered key hash and the second spends it. The third is unrelated.
+	unsigned char prevHash[32];
+	memset(prevHash, 0x11, 32);
+	CBBlock * block = CBNewBlock();
+	block->version = 2;
+	block->prevBlockHash = CBNewByteArrayWithDataCopy(prevHash, 32);
+	block->time = 1400000000;
+	block->target = CB_MAX_TARGET;
+	block->nonce = 12;
+	block->transactionNum = 3;
+	block->transactions = malloc(sizeof(*block->transactions) * 3);
+	// The transactions pay to the key hashes 0xAA..., 0xBB... and 0xCC...
+	CBScript * inputScript = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1}, 1);
+	CBScript * keyHashScripts[3];
+	unsigned char keyHashScriptData[25] = {CB_SCRIPT_OP_DUP, CB_SCRIPT_OP_HASH160, 20};
+	keyHashScriptData[23] = CB_SCRIPT_OP_EQUALVERIFY;
+	keyHashScriptData[24] = CB_SCRIPT_OP_CHECKSIG;
+	for (int x = 0; x < 3; x++) {
+		memset(keyHashScriptData + 3, 0xAA + 0x11 * x, 20);
+		keyHashScripts[x] = CBNewScriptWithDataCopy(keyHashScriptData, 25);
+	}
+	unsigned long long int value = CB_ONE_BITCOIN;
+	block->transactions[0] = newTestTransaction(prevHash, 0, 1, inputScript, keyHashScripts, &value, 1);
+	block->transactions[1] = newTestTransaction(CBTransactionGetHash(block->transactions[0]), 0, 1, inputScript, keyHashScripts + 1, &value, 1);
+	memset(prevHash, 0x33, 32);
+	block->transactions[2] = newTestTransaction(prevHash, 0, 1, inputScript, keyHashScripts + 2, &value, 1);
+	CBReleaseObject(inputScript);
+	for (int x = 0; x < 3; x++)
+		CBReleaseObject(keyHashScripts[x]);
+	unsigned char * root = CBBlockCalculateMerkleRoot(block);
+	block->merkleRoot = CBNewByteArrayWithDataCopy(root, 32);
+	free(root);
+	CBBlockPrepareBytes(block, true);
+	CBBlockSerialise(block, true, false);
+	CBBlockFilterData * filterData = CBNewBlockFilterData(block);
+	filter = CBNewBloomFilter(10, 0.0001, 5, CB_BLOOM_FILTER_UPDATE_ALL);
+	unsigned char keyHash[20];
+	memset(keyHash, 0xAA, 20);
+	CBBloomFilterInsert(filter, keyHash, 20);
+	CBTransaction * matches[3];
+	int matchNum;
+	CBMerkleBlock * merkleBlock = CBBlockFilterDataGetMerkleBlock(filterData, filter, matches, &matchNum);
+	if (matchNum != 2 || matches[0] != block->transactions[0] || matches[1] != block->transactions[1]) {
+		printf("FILTERED BLOCK MATCHES FAIL\n");
+		return 1;
+	}
+	CBMerkleBlockPrepareBytes(merkleBlock);
+	int len = CBMerkleBlockSerialise(merkleBlock);
+	if (! len) {
+		printf("MERKLEBLOCK SERIALISE FAIL\n");
+		return 1;
+	}
+	CBMerkleBlock * merkleBlock2 = CBNewMerkleBlockFromData(CBGetMessage(merkleBlock)->bytes);
+	unsigned char hash[32] = {0};
+	if (CBMerkleBlockDeserialise(merkleBlock2) == len)
+		CBMerkleBlockCalculateHash(merkleBlock2, hash);
+	if (merkleBlock2->nonce != 12 || memcmp(hash, CBBlockGetHash(block), 32)) {
+		printf("MERKLEBLOCK DESERIALISE FAIL\n");
+		return 1;
+	}
+	unsigned char matchHashes[3 * 32];
+	int indexes[3];
+	if (! CBMerkleBlockVerify(merkleBlock2, matchHashes, indexes, &matchNum) || matchNum != 2
+		|| indexes[0] != 0 || indexes[1] != 1
+		|| memcmp(matchHashes + 32, CBTransactionGetHash(block->transactions[1]), 32)) {
+		printf("MERKLEBLOCK VERIFY FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(merkleBlock2);
+	CBReleaseObject(merkleBlock);
+	// Without updates the spend does not match
+	CBReleaseObject(filter);
+	filter = CBNewBloomFilter(10, 0.0001, 5, CB_BLOOM_FILTER_UPDATE_NONE);
+	CBBloomFilterInsert(filter, keyHash, 20);
+	if (! CBBlockFilterDataMatchTransaction(filterData, filter, 0)
+		|| CBBlockFilterDataMatchTransaction(filterData, filter, 1)
+		|| CBBlockFilterDataMatchTransaction(filterData, filter, 2)) {
+		printf("NO UPDATE MATCH FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(filter);
+	CBReleaseObject(filterData);
+	CBReleaseObject(block);
+	return 0;
+}
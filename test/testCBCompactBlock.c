@@ -0,0 +1,224 @@
+//
+//  testCBCompactBlock.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBPartialBlock.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+#define TX_NUM 200
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+CBMessage * roundTrip(CBMessage * message, CBMessage * (*newFromData)(CBByteArray *), int (*deserialise)(CBMessage *));
+CBMessage * roundTrip(CBMessage * message, CBMessage * (*newFromData)(CBByteArray *), int (*deserialise)(CBMessage *)){
+	CBByteArray * bytes = CBByteArrayCopy(message->bytes);
+	CBMessage * message2 = newFromData(bytes);
+	CBReleaseObject(bytes);
+	if (deserialise(message2) != message->bytes->length) {
+		CBReleaseObject(message2);
+		return NULL;
+	}
+	return message2;
+}
+
+int main(){
+	// SipHash-2-4 test vectors with the key 00 01 ... 0f
+	uint64_t k0 = 0x0706050403020100ULL, k1 = 0x0F0E0D0C0B0A0908ULL;
+	unsigned char data[15];
+	for (int x = 0; x < 15; x++)
+		data[x] = x;
+	if (CBSipHash(k0, k1, data, 0) != 0x726FDB47DD0E0E31ULL
+		|| CBSipHash(k0, k1, data, 1) != 0x74F839C593DC67FDULL
+		|| CBSipHash(k0, k1, data, 8) != 0x93F5F5799A932462ULL
+		|| CBSipHash(k0, k1, data, 15) != 0xA129CA6149BE45E5ULL) {
+		printf("SIPHASH FAIL\n");
+		return 1;
+	}
+	// Make a block where the first pool has every transaction and the second is missing every tenth transaction.
+	CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+	unsigned char prevHash[32];
+	memset(prevHash, 0x11, 32);
+	for (int x = 1; x < TX_NUM; x++)
+		CBUnspentOutputSetTakeOutput(set, CBNewUnspentOutput(prevHash, x, CB_ONE_BITCOIN, (unsigned char []){CB_SCRIPT_OP_1}, 1, 1, false));
+	CBMempool * pool = CBNewMempool(CB_MEMPOOL_DEFAULT_MAX_SIZE, CB_MEMPOOL_DEFAULT_MIN_FEE_RATE);
+	CBMempool * pool2 = CBNewMempool(CB_MEMPOOL_DEFAULT_MAX_SIZE, CB_MEMPOOL_DEFAULT_MIN_FEE_RATE);
+	CBBlock * block = CBNewBlock();
+	block->version = 2;
+	block->prevBlockHash = CBNewByteArrayWithDataCopy(prevHash, 32);
+	block->time = 1400000000;
+	block->target = CB_MAX_TARGET;
+	block->nonce = 7;
+	block->transactionNum = TX_NUM;
+	block->transactions = malloc(sizeof(*block->transactions) * TX_NUM);
+	// The inputs push data the size of a signature, made from the previous output index.
+	CBScript * inputScript = CBNewScriptOfSize(71);
+	CBByteArraySetByte(inputScript, 0, 70);
+	memset(CBByteArrayGetData(inputScript) + 1, 0xFF, 70);
+	CBScript * outputScript = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1}, 1);
+	unsigned long long int value = CBCalculateBlockReward(200);
+	block->transactions[0] = newTestTransaction(NULL, 0, 1, inputScript, &outputScript, &value, 1);
+	value = CB_ONE_BITCOIN - 10000;
+	int missingNum = 0;
+	for (int x = 1; x < TX_NUM; x++) {
+		memset(CBByteArrayGetData(inputScript) + 1, x, 70);
+		block->transactions[x] = newTestTransaction(prevHash, x, 1, inputScript, &outputScript, &value, 1);
+		if (CBMempoolAddTransaction(pool, block->transactions[x], set, 199, 0) != CB_MEMPOOL_OK
+			|| (x % 10 != 3 && CBMempoolAddTransaction(pool2, block->transactions[x], set, 199, 0) != CB_MEMPOOL_OK)) {
+			printf("ADD TO POOL FAIL\n");
+			return 1;
+		}
+		missingNum += x % 10 == 3;
+	}
+	unsigned char * root = CBBlockCalculateMerkleRoot(block);
+	block->merkleRoot = CBNewByteArrayWithDataCopy(root, 32);
+	free(root);
+	CBBlockPrepareBytes(block, true);
+	int blockSize = CBBlockSerialise(block, true, false);
+	// Make the compact block
+	CBCompactBlock * compactBlock = CBNewCompactBlock(block, 0x0123456789ABCDEFULL);
+	CBCompactBlockPrepareBytes(compactBlock);
+	int compactSize = CBCompactBlockSerialise(compactBlock);
+	if (! compactSize || compactBlock->shortIDNum != TX_NUM - 1 || compactBlock->prefilledNum != 1) {
+		printf("COMPACT BLOCK SERIALISE FAIL\n");
+		return 1;
+	}
+	printf("Block = %i bytes, compact block = %i bytes\n", blockSize, compactSize);
+	if (compactSize * 10 > blockSize) {
+		printf("COMPACT BLOCK SIZE FAIL\n");
+		return 1;
+	}
+	CBCompactBlock * compactBlock2 = (CBCompactBlock *)roundTrip(CBGetMessage(compactBlock), (CBMessage * (*)(CBByteArray *))CBNewCompactBlockFromData, (int (*)(CBMessage *))CBCompactBlockDeserialise);
+	if (! compactBlock2 || compactBlock2->shortIDNum != TX_NUM - 1 || compactBlock2->prefilledNum != 1
+		|| compactBlock2->prefilledIndexes[0] != 0 || compactBlock2->keys[0] != compactBlock->keys[0]
+		|| memcmp(compactBlock2->shortIDs, compactBlock->shortIDs, sizeof(*compactBlock->shortIDs) * (TX_NUM - 1))) {
+		printf("COMPACT BLOCK DESERIALISE FAIL\n");
+		return 1;
+	}
+	// Rebuild with every transaction in the pool
+	CBPartialBlock * partial = CBNewPartialBlock(compactBlock2);
+	if (CBPartialBlockFillFromMempool(partial, pool) != CB_PARTIAL_BLOCK_COMPLETE) {
+		printf("FILL COMPLETE FAIL\n");
+		return 1;
+	}
+	CBBlock * block2 = CBPartialBlockGetBlock(partial);
+	if (! block2 || memcmp(CBBlockGetHash(block2), CBBlockGetHash(block), 32)
+		|| CBGetMessage(block2)->bytes->length != blockSize
+		|| memcmp(CBByteArrayGetData(CBGetMessage(block2)->bytes), CBByteArrayGetData(CBGetMessage(block)->bytes), blockSize)) {
+		printf("REBUILD COMPLETE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block2);
+	// Nothing is requested when complete
+	CBGetBlockTxn * request = CBPartialBlockGetRequest(partial);
+	if (request->indexNum != 0) {
+		printf("EMPTY REQUEST FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(request);
+	CBReleaseObject(partial);
+	// Rebuild with the missing transactions requested
+	partial = CBNewPartialBlock(compactBlock2);
+	if (CBPartialBlockFillFromMempool(partial, pool2) != CB_PARTIAL_BLOCK_MISSING || partial->missingNum != missingNum) {
+		printf("FILL MISSING FAIL\n");
+		return 1;
+	}
+	if (CBPartialBlockGetBlock(partial)) {
+		printf("GET BLOCK WITH MISSING FAIL\n");
+		return 1;
+	}
+	request = CBPartialBlockGetRequest(partial);
+	if (request->indexNum != missingNum) {
+		printf("REQUEST NUM FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < missingNum; x++)
+		if (request->indexes[x] != x * 10 + 3) {
+			printf("REQUEST INDEX FAIL\n");
+			return 1;
+		}
+	CBGetBlockTxnPrepareBytes(request);
+	int requestSize = CBGetBlockTxnSerialise(request);
+	CBGetBlockTxn * request2 = (CBGetBlockTxn *)roundTrip(CBGetMessage(request), (CBMessage * (*)(CBByteArray *))CBNewGetBlockTxnFromData, (int (*)(CBMessage *))CBGetBlockTxnDeserialise);
+	if (! requestSize || ! request2 || request2->indexNum != missingNum || request2->indexes[missingNum - 1] != request->indexes[missingNum - 1]
+		|| memcmp(CBByteArrayGetData(request2->blockHash), CBBlockGetHash(block), 32)) {
+		printf("REQUEST SERIALISE FAIL\n");
+		return 1;
+	}
+	// The sender responds with the transactions
+	CBBlockTxn * blockTxn = CBNewBlockTxn(request2, block->transactions);
+	CBBlockTxnPrepareBytes(blockTxn);
+	int blockTxnSize = CBBlockTxnSerialise(blockTxn);
+	CBBlockTxn * blockTxn2 = (CBBlockTxn *)roundTrip(CBGetMessage(blockTxn), (CBMessage * (*)(CBByteArray *))CBNewBlockTxnFromData, (int (*)(CBMessage *))CBBlockTxnDeserialise);
+	if (! blockTxnSize || ! blockTxn2 || blockTxn2->transactionNum != missingNum) {
+		printf("BLOCKTXN SERIALISE FAIL\n");
+		return 1;
+	}
+	printf("With %i missing transactions, getblocktxn = %i bytes, blocktxn = %i bytes\n", missingNum, requestSize, blockTxnSize);
+	// A blocktxn message which does not match the missing transactions is invalid.
+	CBPartialBlock * partial2 = CBNewPartialBlock(compactBlock2);
+	if (CBPartialBlockFillFromBlockTxn(partial2, blockTxn2) != CB_PARTIAL_BLOCK_INVALID) {
+		printf("FILL INVALID FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(partial2);
+	if (CBPartialBlockFillFromBlockTxn(partial, blockTxn2) != CB_PARTIAL_BLOCK_COMPLETE) {
+		printf("FILL BLOCKTXN FAIL\n");
+		return 1;
+	}
+	block2 = CBPartialBlockGetBlock(partial);
+	if (! block2 || memcmp(CBBlockGetHash(block2), CBBlockGetHash(block), 32)) {
+		printf("REBUILD MISSING FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block2);
+	CBReleaseObject(partial);
+	CBReleaseObject(blockTxn2);
+	CBReleaseObject(blockTxn);
+	CBReleaseObject(request2);
+	CBReleaseObject(request);
+	// Repeated short IDs need the full block.
+	uint64_t shortID = compactBlock2->shortIDs[1];
+	compactBlock2->shortIDs[1] = compactBlock2->shortIDs[0];
+	partial = CBNewPartialBlock(compactBlock2);
+	if (CBPartialBlockFillFromMempool(partial, pool) != CB_PARTIAL_BLOCK_FULL_BLOCK) {
+		printf("REPEATED SHORT ID FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(partial);
+	// Short IDs matching the wrong transactions are detected by the merkle root.
+	compactBlock2->shortIDs[0] = shortID;
+	partial = CBNewPartialBlock(compactBlock2);
+	if (CBPartialBlockFillFromMempool(partial, pool) != CB_PARTIAL_BLOCK_COMPLETE || CBPartialBlockGetBlock(partial)) {
+		printf("WRONG MATCH FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(partial);
+	CBReleaseObject(compactBlock2);
+	CBReleaseObject(compactBlock);
+	CBReleaseObject(block);
+	CBReleaseObject(pool);
+	CBReleaseObject(pool2);
+	CBReleaseObject(set);
+	CBReleaseObject(inputScript);
+	CBReleaseObject(outputScript);
+	return 0;
+}
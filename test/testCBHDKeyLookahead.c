@@ -0,0 +1,132 @@
+//
+//  testCBHDKeyLookahead.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBHDKeyLookahead.h"
+#include "CBChecksumBytes.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+// Checks that the hash of a child derived on its own gives the child in the lookahead.
+bool checkChild(CBHDKeyLookahead * lookahead, CBHDKey * chainKey, CBHDKeyLookaheadChain * chain, unsigned int childNumber, bool present);
+bool checkChild(CBHDKeyLookahead * lookahead, CBHDKey * chainKey, CBHDKeyLookaheadChain * chain, unsigned int childNumber, bool present){
+	CBHDKey * child = CBNewHDKey(true);
+	CBHDKeyChildID childID = {false, childNumber};
+	CBHDKeyDeriveChild(chainKey, childID, child);
+	CBHDKeyLookaheadEntry * entry = CBHDKeyLookaheadFind(lookahead, CBHDKeyGetHash(child));
+	free(child);
+	if (! present)
+		return entry == NULL;
+	return entry && entry->chain == chain && entry->childNumber == childNumber;
+}
+
+int main(){
+	CBByteArray * masterString = CBNewByteArrayFromString("xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkVvvNKmPGJxWUtg6LnF5kejMRNNU3TGtRBeJgk33yuGBxrMPHi", true);
+	CBChecksumBytes * masterData = CBNewChecksumBytesFromString(masterString, false);
+	CBReleaseObject(masterString);
+	CBHDKey * master = CBNewHDKeyFromData(CBByteArrayGetData(CBGetByteArray(masterData)));
+	CBReleaseObject(masterData);
+	// The external and internal chains of the first account
+	CBHDKey * account = CBNewHDKey(true);
+	CBHDKeyChildID accountID = {true, 0};
+	CBHDKeyDeriveChild(master, accountID, account);
+	CBHDKey * chainKeys[2];
+	for (int x = 0; x < 2; x++) {
+		chainKeys[x] = CBNewHDKey(true);
+		CBHDKeyChildID chainID = {false, x};
+		CBHDKeyDeriveChild(account, chainID, chainKeys[x]);
+	}
+	for (int background = 0; background < 2; background++) {
+		CBHDKeyLookahead * lookahead = CBNewHDKeyLookahead(20, background);
+		CBHDKeyLookaheadChain * external = CBHDKeyLookaheadAddChain(lookahead, chainKeys[0], 0, 0);
+		CBHDKeyLookaheadChain * internal = CBHDKeyLookaheadAddChain(lookahead, chainKeys[1], 1, 5);
+		if (! external || ! internal || lookahead->entryNum != 45 || lookahead->hashes.num != 45) {
+			printf("ADD CHAIN FAIL\n");
+			return 1;
+		}
+		for (unsigned int x = 0; x < 26; x++)
+			if (! checkChild(lookahead, chainKeys[0], external, x, x < 20)
+				|| ! checkChild(lookahead, chainKeys[1], internal, x, x < 25)) {
+				printf("FIND CHILD %u FAIL\n", x);
+				return 1;
+			}
+		// Scripts paying the children
+		CBHDKey * child = CBNewHDKey(true);
+		CBHDKeyChildID childID = {false, 7};
+		CBHDKeyDeriveChild(chainKeys[0], childID, child);
+		CBScript * keyHash = CBNewScriptPubKeyHashOutput(CBHDKeyGetHash(child));
+		CBScript * pubKey = CBNewScriptPubKeyOutput(CBHDKeyGetPublicKey(child));
+		CBHDKeyLookaheadEntry * entry = CBHDKeyLookaheadFindScript(lookahead, keyHash);
+		if (! entry || entry->childNumber != 7 || CBHDKeyLookaheadFindScript(lookahead, pubKey) != entry) {
+			printf("FIND SCRIPT FAIL\n");
+			return 1;
+		}
+		CBByteArraySetByte(keyHash, 10, CBByteArrayGetByte(keyHash, 10) ^ 1);
+		if (CBHDKeyLookaheadFindScript(lookahead, keyHash)) {
+			printf("FIND OTHER SCRIPT FAIL\n");
+			return 1;
+		}
+		CBReleaseObject(keyHash);
+		CBReleaseObject(pubKey);
+		free(child);
+		// Using the 8th child extends the chain to 28 children.
+		if (! CBHDKeyLookaheadMarkUsed(lookahead, entry)) {
+			printf("MARK USED FAIL\n");
+			return 1;
+		}
+		CBHDKeyLookaheadWaitUntilExtended(lookahead);
+		if (external->used != 8 || external->derived != 28 || lookahead->hashes.num != 53
+			|| ! checkChild(lookahead, chainKeys[0], external, 27, true)
+			|| ! checkChild(lookahead, chainKeys[0], external, 28, false)) {
+			printf("EXTEND FAIL\n");
+			return 1;
+		}
+		// Using an earlier child changes nothing.
+		CBHDKeyLookaheadMarkUsed(lookahead, CBHDKeyLookaheadFind(lookahead, lookahead->chunks[0][2].hash));
+		CBHDKeyLookaheadWaitUntilExtended(lookahead);
+		if (external->used != 8 || external->derived != 28) {
+			printf("MARK EARLIER USED FAIL\n");
+			return 1;
+		}
+		// Use the last children one after another, further than a batch of derivations.
+		for (unsigned int x = 0; x < 300; x++) {
+			CBHDKeyLookaheadEntry * last = lookahead->chunks[(lookahead->entryNum - 1) / CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE] + (lookahead->entryNum - 1) % CB_HD_KEY_LOOKAHEAD_CHUNK_SIZE;
+			if (background)
+				CBHDKeyLookaheadWaitUntilExtended(lookahead);
+			CBHDKeyLookaheadMarkUsed(lookahead, last);
+		}
+		CBHDKeyLookaheadWaitUntilExtended(lookahead);
+		if (internal->used != 5 || internal->derived != 25 || external->derived != external->used + 20
+			|| lookahead->hashes.num != lookahead->entryNum || lookahead->entryNum != 25 + external->derived
+			|| ! checkChild(lookahead, chainKeys[0], external, external->derived - 1, true)
+			|| ! checkChild(lookahead, chainKeys[1], internal, 24, true)) {
+			printf("EXTEND MANY FAIL\n");
+			return 1;
+		}
+		CBReleaseObject(lookahead);
+	}
+	free(chainKeys[0]);
+	free(chainKeys[1]);
+	free(account);
+	free(master);
+	return 0;
+}
@@ -328,5 +328,158 @@ int main(){
 		}
 		free(key);
 	}
+	// Test batch derivation against single derivation
+	CBByteArray * masterString = CBNewByteArrayFromString(testVectors[0][0].privString, true);
+	CBChecksumBytes * masterData = CBNewChecksumBytesFromString(masterString, false);
+	CBReleaseObject(masterString);
+	CBHDKey * master = CBNewHDKeyFromData(CBByteArrayGetData(CBGetByteArray(masterData)));
+	CBReleaseObject(masterData);
+	CBHDKey * publicMaster = CBNewHDKey(false);
+	memcpy(publicMaster, master, sizeof(*publicMaster) + sizeof(CBPubKeyInfo));
+	publicMaster->versionBytes = CB_HD_KEY_VERSION_PROD_PUBLIC;
+	CBHDKey * children[300], * single = CBNewHDKey(true);
+	for (int x = 0; x < 300; x++)
+		children[x] = CBNewHDKey(true);
+	for (int x = 0; x < 6; x++) {
+		// Private and public parents, normal and hardened children, with and without threads
+		CBHDKey * parent = x % 3 == 2 ? publicMaster : master;
+		CBHDKeyChildID first = {x % 3 == 1, 1000 + x};
+		int num = first.priv ? 30 : 300, threads = x < 3 ? 1 : 3;
+		if (! CBHDKeyDeriveChildren(parent, first, num, children, threads)) {
+			printf("DERIVE CHILDREN %i FAIL\n", x);
+			return EXIT_FAILURE;
+		}
+		for (int y = 0; y < num; y++) {
+			CBHDKeyChildID childID = {first.priv, first.childNumber + y};
+			CBHDKeyDeriveChild(parent, childID, single);
+			// The serialisation is followed by space for the checksum.
+			unsigned char expected[CB_HD_KEY_STR_SIZE] = {0}, actual[CB_HD_KEY_STR_SIZE] = {0};
+			CBHDKeySerialise(single, expected);
+			CBHDKeySerialise(children[y], actual);
+			if (memcmp(expected, actual, CB_HD_KEY_STR_SIZE)
+				|| memcmp(CBHDKeyGetPublicKey(single), CBHDKeyGetPublicKey(children[y]), CB_PUBKEY_SIZE)) {
+				printf("DERIVE CHILDREN %i CHILD %i FAIL\n", x, y);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	CBHDKeyChildID hardened = {true, 0};
+	if (CBHDKeyDeriveChildren(publicMaster, hardened, 1, children, 1)) {
+		printf("DERIVE CHILDREN HARDENED FROM PUBLIC FAIL\n");
+		return EXIT_FAILURE;
+	}
+	for (int x = 0; x < 300; x++)
+		free(children[x]);
+	free(single);
+	free(master);
+	free(publicMaster);
+	// Test batch key stepping against single steps, across two batches of the precomputed multiples.
+	CBKeyPair * key = CBNewKeyPair(true), * stepped = CBNewKeyPair(true);
+	CBKeyPair * keys = malloc(sizeof(*keys) * 1100);
+	CBKeyPairGenerate(key);
+	memcpy(stepped, key, sizeof(*key));
+	CBKeyPairGetNextKeys(key, 1100, keys);
+	for (int x = 0; x < 1100; x++) {
+		CBKeyPairGetNext(stepped);
+		if (memcmp(stepped->privkey, keys[x].privkey, CB_PRIVKEY_SIZE)
+			|| memcmp(stepped->pubkey.key, keys[x].pubkey.key, CB_PUBKEY_SIZE)
+			|| ! keys[x].pubkey.hashSet
+			|| memcmp(CBKeyPairGetHash(stepped), keys[x].pubkey.hash, 20)) {
+			printf("NEXT KEYS %i FAIL\n", x);
+			return EXIT_FAILURE;
+		}
+	}
+	// Stepping from the generator doubles it, and stepping over the order gives the point at infinity and then the generator.
+	unsigned char privKeys[3][CB_PRIVKEY_SIZE] = {{0}}, pubKeys[5 * CB_PUBKEY_SIZE], expected[CB_PUBKEY_SIZE], zero[CB_PUBKEY_SIZE] = {0};
+	unsigned char order[32] = {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFE,0xBA,0xAE,0xDC,0xE6,0xAF,0x48,0xA0,0x3B,0xBF,0xD2,0x5E,0x8C,0xD0,0x36,0x41,0x41};
+	privKeys[0][31] = 1;
+	privKeys[1][31] = 2;
+	memcpy(privKeys[2], order, 32);
+	privKeys[2][31] -= 3;
+	CBKeyGetPublicKey(privKeys[0], key->pubkey.key);
+	CBKeyGetPublicKey(privKeys[1], expected);
+	if (! CBKeyGetNextPublicKeys(key->pubkey.key, 1, pubKeys) || memcmp(pubKeys, expected, CB_PUBKEY_SIZE)) {
+		printf("NEXT PUBLIC KEY FROM GENERATOR FAIL\n");
+		return EXIT_FAILURE;
+	}
+	CBKeyGetPublicKey(privKeys[2], key->pubkey.key);
+	CBKeyGetNextPublicKeys(key->pubkey.key, 5, pubKeys);
+	privKeys[2][31] += 2;
+	CBKeyGetPublicKey(privKeys[2], expected);
+	if (memcmp(pubKeys + CB_PUBKEY_SIZE, expected, CB_PUBKEY_SIZE)
+		|| memcmp(pubKeys + 2 * CB_PUBKEY_SIZE, zero, CB_PUBKEY_SIZE)) {
+		printf("NEXT PUBLIC KEYS OVER ORDER FAIL\n");
+		return EXIT_FAILURE;
+	}
+	CBKeyGetPublicKey(privKeys[1], expected);
+	if (memcmp(pubKeys + 4 * CB_PUBKEY_SIZE, expected, CB_PUBKEY_SIZE)) {
+		printf("NEXT PUBLIC KEYS AFTER ORDER FAIL\n");
+		return EXIT_FAILURE;
+	}
+	// RFC 6979 signatures for the private keys one and n - 1, with the lower s value.
+	unsigned char signature[72];
+	unsigned char expectedSigs[2][71] = {
+		{0x30,0x45,0x02,0x21,0x00,0x93,0x4b,0x1e,0xa1,0x0a,0x4b,0x3c,0x17,0x57,0xe2,0xb0,0xc0,0x17,0xd0,0xb6,0x14,0x3c,0xe3,0xc9,0xa7,0xe6,0xa4,0xa4,0x98,0x60,0xd7,0xa6,0xab,0x21,0x0e,0xe3,0xd8,0x02,0x20,0x24,0x42,0xce,0x9d,0x2b,0x91,0x60,0x64,0x10,0x80,0x14,0x78,0x3e,0x92,0x3e,0xc3,0x6b,0x49,0x74,0x3e,0x2f,0xfa,0x1c,0x44,0x96,0xf0,0x1a,0x51,0x2a,0xaf,0xd9,0xe5},
+		{0x30,0x45,0x02,0x21,0x00,0xfd,0x56,0x7d,0x12,0x1d,0xb6,0x6e,0x38,0x29,0x91,0x53,0x4a,0xda,0x77,0xa6,0xbd,0x31,0x06,0xf0,0xa1,0x09,0x8c,0x23,0x1e,0x47,0x99,0x34,0x47,0xcd,0x6a,0xf2,0xd0,0x02,0x20,0x6b,0x39,0xcd,0x0e,0xb1,0xbc,0x86,0x03,0xe1,0x59,0xef,0x5c,0x20,0xa5,0xc8,0xad,0x68,0x5a,0x45,0xb0,0x6c,0xe9,0xbe,0xbe,0xd3,0xf1,0x53,0xd1,0x0d,0x93,0xbe,0xd5},
+	};
+	CBSha256((unsigned char *)"Satoshi Nakamoto", 16, hash);
+	for (int x = 0; x < 2; x++)
+		if (CBKeySign(privKeys[x * 2], hash, signature) != 71 || memcmp(signature, expectedSigs[x], 71)) {
+			printf("RFC 6979 SIGNATURE %i FAIL\n", x);
+			return EXIT_FAILURE;
+		}
+	if (CBKeySign(order, hash, signature)) {
+		printf("SIGN WITH INVALID KEY FAIL\n");
+		return EXIT_FAILURE;
+	}
+	// Batch signatures match single signatures, verify, and have the lower s value.
+	int sigNum = 300;
+	unsigned char * sigKeys = malloc(sigNum * 32), * sigHashes = malloc(sigNum * 32), * signatures = malloc(sigNum * 72);
+	unsigned char ** keyPtrs = malloc(sigNum * sizeof(*keyPtrs)), ** hashPtrs = malloc(sigNum * sizeof(*hashPtrs)), ** sigPtrs = malloc(sigNum * sizeof(*sigPtrs));
+	int * sigLens = malloc(sigNum * sizeof(*sigLens));
+	for (int x = 0; x < sigNum; x++) {
+		for (int y = 0; y < 32; y++) {
+			sigKeys[x * 32 + y] = rand();
+			sigHashes[x * 32 + y] = rand();
+		}
+		keyPtrs[x] = sigKeys + x * 32;
+		hashPtrs[x] = sigHashes + x * 32;
+		sigPtrs[x] = signatures + x * 72;
+	}
+	// An invalid key in the batch
+	memset(keyPtrs[7], 0, 32);
+	CBKeySignBatch(keyPtrs, hashPtrs, sigNum, sigPtrs, sigLens);
+	for (int x = 0; x < sigNum; x++) {
+		if (x == 7) {
+			if (sigLens[x]) {
+				printf("BATCH SIGN WITH INVALID KEY FAIL\n");
+				return EXIT_FAILURE;
+			}
+			continue;
+		}
+		int len = CBKeySign(keyPtrs[x], hashPtrs[x], signature);
+		unsigned char pubKey[CB_PUBKEY_SIZE];
+		CBKeyGetPublicKey(keyPtrs[x], pubKey);
+		if (len != sigLens[x] || memcmp(signature, sigPtrs[x], len)
+			|| ! CBEcdsaVerify(signature, len, hashPtrs[x], pubKey, CB_PUBKEY_SIZE)) {
+			printf("BATCH SIGNATURE %i FAIL\n", x);
+			return EXIT_FAILURE;
+		}
+		// The first byte of s is after the r value.
+		if (signature[signature[3] + 6] & 0x80 || (signature[signature[3] + 5] == 33)) {
+			printf("LOW S %i FAIL\n", x);
+			return EXIT_FAILURE;
+		}
+	}
+	free(sigKeys);
+	free(sigHashes);
+	free(signatures);
+	free(keyPtrs);
+	free(hashPtrs);
+	free(sigPtrs);
+	free(sigLens);
+	free(keys);
+	free(key);
+	free(stepped);
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,82 @@
+//
+//  testCBHash160Map.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBHash160Map.h"
+#include <time.h>
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	unsigned int s = (unsigned int)time(NULL);
+	printf("Session = %u\n", s);
+	srand(s);
+	unsigned char hashes[3000][20];
+	int values[3000];
+	for (int x = 0; x < 3000; x++) {
+		for (int y = 0; y < 20; y++)
+			hashes[x][y] = rand();
+		// Make clusters by giving many keys the same slot.
+		if (x % 3 == 0)
+			memset(hashes[x], 0, 4);
+		hashes[x][19] = x;
+		hashes[x][18] = x >> 8;
+	}
+	CBHash160Map map;
+	CBInitHash160Map(&map, 0);
+	for (int x = 0; x < 3000; x++)
+		if (! CBHash160MapInsert(&map, hashes[x], values + x)) {
+			printf("INSERT %i FAIL\n", x);
+			return 1;
+		}
+	if (map.num != 3000 || map.capacity < 6000) {
+		printf("NUM FAIL\n");
+		return 1;
+	}
+	if (CBHash160MapInsert(&map, hashes[7], values + 8) || CBHash160MapGet(&map, hashes[7]) != values + 8) {
+		printf("REPLACE FAIL\n");
+		return 1;
+	}
+	CBHash160MapInsert(&map, hashes[7], values + 7);
+	for (int x = 0; x < 3000; x++)
+		if (CBHash160MapGet(&map, hashes[x]) != values + x) {
+			printf("GET %i FAIL\n", x);
+			return 1;
+		}
+	// Remove every other key
+	for (int x = 0; x < 3000; x += 2)
+		if (CBHash160MapRemove(&map, hashes[x]) != values + x) {
+			printf("REMOVE %i FAIL\n", x);
+			return 1;
+		}
+	if (map.num != 1500 || CBHash160MapRemove(&map, hashes[0])) {
+		printf("REMOVE NUM FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < 3000; x++)
+		if (CBHash160MapGet(&map, hashes[x]) != (x % 2 ? values + x : NULL)) {
+			printf("GET AFTER REMOVE %i FAIL\n", x);
+			return 1;
+		}
+	CBFreeHash160Map(&map);
+	return 0;
+}
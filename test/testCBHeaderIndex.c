@@ -0,0 +1,178 @@
+//
+//  testCBHeaderIndex.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBHeaderIndex.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+void loadHeaders(CBHeaderIndex * index, int num, unsigned int nonceStart);
+void loadHeaders(CBHeaderIndex * index, int num, unsigned int nonceStart){
+	unsigned char header[80];
+	memcpy(header, CBHeaderIndexGetTip(index)->header, 80);
+	for (int x = 0; x < num; x++) {
+		memcpy(header + 4, CBHeaderIndexGetTip(index)->hash, 32);
+		CBInt32ToArray(header, 76, nonceStart + x);
+		CBHeaderIndexLoadHeader(index, header);
+	}
+}
+
+int main(){
+	CBBlock * genesis = CBNewBlockGenesisHeader();
+	CBHeaderIndex * index = CBNewHeaderIndex(CBByteArrayGetData(CBGetMessage(genesis)->bytes), 0);
+	if (memcmp(CBHeaderIndexGetTip(index)->hash, CBBlockGetHash(genesis), 32)) {
+		printf("GENESIS HASH FAIL\n");
+		return 1;
+	}
+	loadHeaders(index, 4999, 1);
+	if (index->headerNum != 5000 || CBHeaderIndexGetTip(index)->height != 4999
+		|| CBHeaderIndexFind(index, CBHeaderIndexGetEntry(index, 2500)->hash)->height != 2500) {
+		printf("LOAD FAIL\n");
+		return 1;
+	}
+	CBUInt256 work, chainWork;
+	CBCalculateBlockWorkUInt256(&work, CB_MAX_TARGET);
+	CBUInt256FromUInt64(&chainWork, 5000);
+	CBUInt256EqualsMultiplicationByUInt256(&chainWork, &work);
+	if (CBUInt256CompareToUInt256(&CBHeaderIndexGetTip(index)->chainWork, &chainWork)) {
+		printf("CHAIN WORK FAIL\n");
+		return 1;
+	}
+	// Headers which do not link or have invalid proof of work are rejected.
+	unsigned char header[80];
+	memcpy(header, CBHeaderIndexGetTip(index)->header, 80);
+	if (CBHeaderIndexAddHeader(index, header)) {
+		printf("ADD NO LINK FAIL\n");
+		return 1;
+	}
+	memcpy(header + 4, CBHeaderIndexGetTip(index)->hash, 32);
+	if (CBHeaderIndexAddHeader(index, header)) {
+		printf("ADD POW FAIL\n");
+		return 1;
+	}
+	// Locator
+	CBChainDescriptor * locator = CBHeaderIndexGetLocator(index, 4999);
+	unsigned int heights[22] = {4999, 4998, 4997, 4996, 4995, 4994, 4993, 4992, 4991, 4990, 4988, 4984, 4976, 4960, 4928, 4864, 4736, 4480, 3968, 2944, 896, 0};
+	if (locator->hashNum != 22) {
+		printf("LOCATOR NUM FAIL\n");
+		return 1;
+	}
+	for (int x = 0; x < 22; x++)
+		if (memcmp(CBByteArrayGetData(locator->hashes[x]), CBHeaderIndexGetEntry(index, heights[x])->hash, 32)) {
+			printf("LOCATOR HASH %i FAIL\n", x);
+			return 1;
+		}
+	// getblocks
+	CBChainDescriptor * oldLocator = CBHeaderIndexGetLocator(index, 1000);
+	CBGetBlocks * request = CBNewGetBlocks(70001, oldLocator, NULL);
+	CBInventory * inv = CBHeaderIndexGetBlocksInventory(index, request);
+	if (! inv || CBInventoryDeserialise(inv) != 3 + 500 * 36 || inv->itemNum != 500
+		|| inv->itemFront->type != CB_INVENTORY_ITEM_BLOCK
+		|| memcmp(CBByteArrayGetData(inv->itemFront->hash), CBHeaderIndexGetEntry(index, 1001)->hash, 32)) {
+		printf("GETBLOCKS FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(inv);
+	CBReleaseObject(request);
+	CBByteArray * stopHash = CBNewByteArrayWithDataCopy(CBHeaderIndexGetEntry(index, 1200)->hash, 32);
+	request = CBNewGetBlocks(70001, oldLocator, stopHash);
+	inv = CBHeaderIndexGetBlocksInventory(index, request);
+	if (! inv || CBInventoryDeserialise(inv) != 1 + 200 * 36 || inv->itemNum != 200) {
+		printf("GETBLOCKS STOP FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(inv);
+	CBReleaseObject(request);
+	request = CBNewGetBlocks(70001, locator, NULL);
+	if (CBHeaderIndexGetBlocksInventory(index, request)) {
+		printf("GETBLOCKS AT TIP FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(request);
+	// getheaders
+	request = CBNewGetBlocks(70001, oldLocator, NULL);
+	CBBlockHeaders * headers = CBHeaderIndexGetHeaders(index, request);
+	CBBlockHeadersPrepareBytes(headers);
+	if (headers->headerNum != 2000 || CBBlockHeadersSerialise(headers, false) != 3 + 2000 * 82) {
+		printf("GETHEADERS FAIL\n");
+		return 1;
+	}
+	CBBlockHeaders * received = CBNewBlockHeadersFromData(CBGetMessage(headers)->bytes);
+	if (CBBlockHeadersDeserialiseFlat(received) != 3 + 2000 * 82
+		|| memcmp(CBBlockHeadersGetHeader(received, 0), CBHeaderIndexGetEntry(index, 1001)->header, 80)
+		|| memcmp(CBBlockHeadersGetHeader(received, 1999), CBHeaderIndexGetEntry(index, 3000)->header, 80)) {
+		printf("GETHEADERS DESERIALISE FAIL\n");
+		return 1;
+	}
+	// Known headers are skipped.
+	if (CBHeaderIndexAddHeaders(index, received) != 0 || index->headerNum != 5000) {
+		printf("ADD KNOWN HEADERS FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(received);
+	CBReleaseObject(headers);
+	CBReleaseObject(request);
+	// getheaders for the stop hash only
+	CBChainDescriptor * empty = CBNewChainDescriptor();
+	request = CBNewGetBlocks(70001, empty, stopHash);
+	headers = CBHeaderIndexGetHeaders(index, request);
+	if (headers->headerNum != 1 || memcmp(CBBlockHeadersGetHeader(headers, 0), CBHeaderIndexGetEntry(index, 1200)->header, 80)) {
+		printf("GETHEADERS STOP ONLY FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(headers);
+	CBReleaseObject(request);
+	CBReleaseObject(empty);
+	CBReleaseObject(stopHash);
+	// Switch to another chain after height 3500, so that the old locator finds the fork at 2944.
+	if (! CBHeaderIndexTruncate(index, 3500)) {
+		printf("TRUNCATE FAIL\n");
+		return 1;
+	}
+	loadHeaders(index, 100, 100000);
+	// Heights outside of the index are rejected.
+	unsigned int end = index->firstHeight + index->headerNum;
+	if (CBHeaderIndexGetEntry(index, end) || CBHeaderIndexGetLocator(index, end) || CBHeaderIndexTruncate(index, end)
+		|| (index->firstHeight && CBHeaderIndexGetEntry(index, index->firstHeight - 1))) {
+		printf("OUT OF RANGE FAIL\n");
+		return 1;
+	}
+	if (index->headerNum != 3601 || CBHeaderIndexFind(index, CBByteArrayGetData(locator->hashes[0]))) {
+		printf("TRUNCATE FAIL\n");
+		return 1;
+	}
+	CBUInt256FromUInt64(&chainWork, 3601);
+	CBUInt256EqualsMultiplicationByUInt256(&chainWork, &work);
+	if (CBUInt256CompareToUInt256(&CBHeaderIndexGetTip(index)->chainWork, &chainWork)) {
+		printf("TRUNCATE CHAIN WORK FAIL\n");
+		return 1;
+	}
+	if (CBHeaderIndexFindFork(index, locator)->height != 2944) {
+		printf("FIND FORK FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(oldLocator);
+	CBReleaseObject(locator);
+	CBReleaseObject(index);
+	CBReleaseObject(genesis);
+	return 0;
+}
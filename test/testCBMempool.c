@@ -0,0 +1,185 @@
+//
+//  testCBMempool.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBMempool.h"
+#include "testTransactions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	CBScript * script = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_1}, 1);
+	// Make an unspent output set with outputs of 1 bitcoin
+	CBUnspentOutputSet * set = CBNewUnspentOutputSet();
+	unsigned char prevHash[32];
+	memset(prevHash, 0x11, 32);
+	for (int x = 0; x < 4; x++)
+		CBUnspentOutputSetTakeOutput(set, CBNewUnspentOutput(prevHash, x, CB_ONE_BITCOIN, (unsigned char []){CB_SCRIPT_OP_1}, 1, 1, false));
+	CBUnspentOutputSetTakeOutput(set, CBNewUnspentOutput(prevHash, 4, CB_ONE_BITCOIN, (unsigned char []){CB_SCRIPT_OP_1}, 1, 150, true));
+	CBUnspentOutputSetTakeOutput(set, CBNewUnspentOutput(prevHash, 5, CB_ONE_BITCOIN, (unsigned char []){CB_SCRIPT_OP_0}, 1, 1, false));
+	CBMempool * pool = CBNewMempool(CB_MEMPOOL_DEFAULT_MAX_SIZE, CB_MEMPOOL_DEFAULT_MIN_FEE_RATE);
+	// Add a transaction and look it up
+	CBTransaction * txA = newTestTransaction(prevHash, 0, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 10000}, 1);
+	unsigned char * hashA = CBTransactionGetHash(txA);
+	if (CBMempoolAddTransaction(pool, txA, set, 200, 0) != CB_MEMPOOL_OK || pool->transactionNum != 1) {
+		printf("ADD FAIL\n");
+		return 1;
+	}
+	CBMempoolTransaction * entryA = CBMempoolGetTransaction(pool, hashA);
+	if (! entryA || entryA->fee != 10000 || entryA->size != CBGetMessage(txA)->bytes->length
+		|| CBMempoolGetSpender(pool, prevHash, 0) != entryA || CBMempoolGetSpender(pool, prevHash, 1)) {
+		printf("GET FAIL\n");
+		return 1;
+	}
+	CBTransaction * copy = CBMempoolTransactionGetTransaction(entryA);
+	if (memcmp(CBTransactionGetHash(copy), hashA, 32) || copy->outputs[0]->value != CB_ONE_BITCOIN - 10000) {
+		printf("GET TRANSACTION FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(copy);
+	if (CBMempoolAddTransaction(pool, txA, set, 200, 0) != CB_MEMPOOL_ALREADY_HAVE) {
+		printf("ALREADY HAVE FAIL\n");
+		return 1;
+	}
+	// Rejected transactions
+	struct{
+		unsigned int index;
+		unsigned long long int value;
+		CBMempoolResult res;
+	} rejects[] = {
+		{0, CB_ONE_BITCOIN - 20000, CB_MEMPOOL_CONFLICT},
+		{9, CB_ONE_BITCOIN - 20000, CB_MEMPOOL_MISSING_INPUTS},
+		{1, CB_ONE_BITCOIN + 1, CB_MEMPOOL_BAD_VALUE},
+		{1, CB_ONE_BITCOIN - 10, CB_MEMPOOL_LOW_FEE},
+		{4, CB_ONE_BITCOIN - 20000, CB_MEMPOOL_IMMATURE_COINBASE},
+		{5, CB_ONE_BITCOIN - 20000, CB_MEMPOOL_BAD_SCRIPT},
+	};
+	for (int x = 0; x < 6; x++) {
+		CBTransaction * tx = newTestTransaction(prevHash, rejects[x].index, 1, script, NULL, (unsigned long long int []){rejects[x].value}, 1);
+		CBMempoolResult res = CBMempoolAddTransaction(pool, tx, set, 200, 0);
+		if (res != rejects[x].res || pool->transactionNum != 1) {
+			printf("REJECT %i FAIL %i\n", x, res);
+			return 1;
+		}
+		CBReleaseObject(tx);
+	}
+	// Add a chain of descendants to A up to the limit
+	CBTransaction * chain[CB_MEMPOOL_MAX_DESCENDANTS];
+	chain[0] = txA;
+	for (int x = 1; x < CB_MEMPOOL_MAX_DESCENDANTS; x++) {
+		chain[x] = newTestTransaction(CBTransactionGetHash(chain[x-1]), 0, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 10000 * (x + 1)}, 1);
+		if (CBMempoolAddTransaction(pool, chain[x], set, 200, 0) != CB_MEMPOOL_OK) {
+			printf("ADD CHAIN %i FAIL\n", x);
+			return 1;
+		}
+	}
+	CBMempoolTransaction * last = CBMempoolGetTransaction(pool, CBTransactionGetHash(chain[CB_MEMPOOL_MAX_DESCENDANTS - 1]));
+	if (entryA->descendantNum != CB_MEMPOOL_MAX_DESCENDANTS || entryA->descendantFee != 10000ULL * CB_MEMPOOL_MAX_DESCENDANTS
+		|| last->ancestorNum != CB_MEMPOOL_MAX_ANCESTORS || last->ancestorSize != entryA->size * CB_MEMPOOL_MAX_ANCESTORS
+		|| last->parentNum != 1 || entryA->childNum != 1) {
+		printf("CHAIN TOTALS FAIL\n");
+		return 1;
+	}
+	CBTransaction * tooLong = newTestTransaction(CBTransactionGetHash(chain[CB_MEMPOOL_MAX_DESCENDANTS - 1]), 0, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 10000 * (CB_MEMPOOL_MAX_DESCENDANTS + 1)}, 1);
+	if (CBMempoolAddTransaction(pool, tooLong, set, 200, 0) != CB_MEMPOOL_TOO_LONG_CHAIN) {
+		printf("TOO LONG CHAIN FAIL\n");
+		return 1;
+	}
+	// The ancestor fee rate of the chain is ordered below a transaction with a higher fee.
+	CBTransaction * txB = newTestTransaction(prevHash, 1, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 50000}, 1);
+	if (CBMempoolAddTransaction(pool, txB, set, 200, 0) != CB_MEMPOOL_OK) {
+		printf("ADD B FAIL\n");
+		return 1;
+	}
+	CBMempoolTransaction * entryB = CBMempoolGetTransaction(pool, CBTransactionGetHash(txB));
+	CBPosition pos;
+	CBAssociativeArrayGetLast(&pool->ancestorScores, &pos);
+	if (pos.node->elements[pos.index] != entryB) {
+		printf("ANCESTOR SCORE ORDER FAIL\n");
+		return 1;
+	}
+	// Connect a block with A and a transaction conflicting with B.
+	CBTransaction * conflict = newTestTransaction(prevHash, 1, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 1}, 1);
+	CBBlock * block = CBNewBlock();
+	block->transactionNum = 3;
+	block->transactions = malloc(sizeof(*block->transactions) * 3);
+	block->transactions[0] = newTestTransaction(prevHash, 0xFFFFFFFF, 1, script, NULL, (unsigned long long int []){50 * CB_ONE_BITCOIN}, 1);
+	block->transactions[1] = txA;
+	block->transactions[2] = conflict;
+	CBRetainObject(txA);
+	CBMempoolRemoveBlockTransactions(pool, block);
+	if (CBMempoolGetTransaction(pool, hashA) || CBMempoolGetTransaction(pool, CBTransactionGetHash(txB))
+		|| CBMempoolGetSpender(pool, prevHash, 1) || pool->transactionNum != CB_MEMPOOL_MAX_DESCENDANTS - 1) {
+		printf("REMOVE BLOCK FAIL\n");
+		return 1;
+	}
+	entryA = CBMempoolGetTransaction(pool, CBTransactionGetHash(chain[1]));
+	if (entryA->parentNum || entryA->ancestorNum != 1 || entryA->descendantNum != CB_MEMPOOL_MAX_DESCENDANTS - 1
+		|| last->ancestorNum != CB_MEMPOOL_MAX_ANCESTORS - 1) {
+		printf("REMOVE BLOCK TOTALS FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block);
+	// The chain can be extended now that A is confirmed.
+	if (CBMempoolAddTransaction(pool, tooLong, set, 200, 0) != CB_MEMPOOL_OK) {
+		printf("ADD AFTER BLOCK FAIL\n");
+		return 1;
+	}
+	// Removing the middle of the chain removes the descendants
+	CBMempoolRemoveTransaction(pool, CBMempoolGetTransaction(pool, CBTransactionGetHash(chain[10])));
+	if (pool->transactionNum != 9 || entryA->descendantNum != 9 || pool->size != (unsigned long long int)entryA->size * 9) {
+		printf("REMOVE DESCENDANTS FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(pool);
+	// Evict the lowest fee rate package when full
+	pool = CBNewMempool(CBGetMessage(txA)->bytes->length * 2, CB_MEMPOOL_DEFAULT_MIN_FEE_RATE);
+	CBTransaction * fees[3];
+	unsigned long long int feeValues[3] = {20000, 10000, 30000};
+	for (int x = 0; x < 3; x++) {
+		fees[x] = newTestTransaction(prevHash, x + 1, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - feeValues[x]}, 1);
+		if (CBMempoolAddTransaction(pool, fees[x], set, 200, 0) != CB_MEMPOOL_OK) {
+			printf("ADD FOR EVICTION %i FAIL\n", x);
+			return 1;
+		}
+	}
+	if (pool->transactionNum != 2 || CBMempoolGetTransaction(pool, CBTransactionGetHash(fees[1]))) {
+		printf("EVICTION FAIL\n");
+		return 1;
+	}
+	CBTransaction * lowFee = newTestTransaction(prevHash, 0, 1, script, NULL, (unsigned long long int []){CB_ONE_BITCOIN - 5000}, 1);
+	if (CBMempoolAddTransaction(pool, lowFee, set, 200, 0) != CB_MEMPOOL_FULL || pool->transactionNum != 2) {
+		printf("FULL FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(lowFee);
+	for (int x = 0; x < 3; x++)
+		CBReleaseObject(fees[x]);
+	for (int x = 0; x < CB_MEMPOOL_MAX_DESCENDANTS; x++)
+		CBReleaseObject(chain[x]);
+	CBReleaseObject(tooLong);
+	CBReleaseObject(txB);
+	CBReleaseObject(pool);
+	CBReleaseObject(set);
+	CBReleaseObject(script);
+	return 0;
+}
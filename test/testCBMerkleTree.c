@@ -0,0 +1,129 @@
+//
+//  testCBMerkleTree.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBMerkleTree.h"
+#include "CBValidationFunctions.h"
+#include <stdarg.h>
+#include <time.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+bool checkRoot(CBMerkleTree * tree, unsigned char * hashes, int hashNum);
+bool checkRoot(CBMerkleTree * tree, unsigned char * hashes, int hashNum){
+	unsigned char * copy = malloc(hashNum * 32);
+	memcpy(copy, hashes, hashNum * 32);
+	CBCalculateMerkleRoot(copy, hashNum);
+	bool ok = tree->hashNum == hashNum && ! memcmp(CBMerkleTreeGetRoot(tree), copy, 32);
+	free(copy);
+	return ok;
+}
+
+int main(){
+	unsigned int s = (unsigned int)time(NULL);
+	printf("Session = %u\n", s);
+	srand(s);
+	unsigned char hashes[100 * 32];
+	for (int x = 0; x < 100 * 32; x++)
+		hashes[x] = rand();
+	CBMerkleTree tree;
+	CBInitMerkleTree(&tree);
+	if (CBMerkleTreeGetRoot(&tree)) {
+		printf("EMPTY ROOT FAIL\n");
+		return 1;
+	}
+	// Append one hash at a time, with the root matching at every size.
+	for (int x = 0; x < 100; x++) {
+		CBMerkleTreeAppend(&tree, hashes + x * 32);
+		if (! checkRoot(&tree, hashes, x + 1)) {
+			printf("APPEND %i FAIL\n", x);
+			return 1;
+		}
+	}
+	if (tree.levelNum != 8 || CBMerkleTreeGetLevelHashNum(&tree, 1) != 50 || CBMerkleTreeGetLevelHashNum(&tree, 2) != 25
+		|| CBMerkleTreeGetLevelHashNum(&tree, 3) != 13 || memcmp(CBMerkleTreeGetHash(&tree, 0, 99), hashes + 99 * 32, 32)) {
+		printf("LEVELS FAIL\n");
+		return 1;
+	}
+	// Update leaves including the first and last
+	int updates[4] = {0, 99, 98, 37};
+	for (int x = 0; x < 4; x++) {
+		for (int y = 0; y < 32; y++)
+			hashes[updates[x] * 32 + y] = rand();
+		CBMerkleTreeUpdate(&tree, updates[x], hashes + updates[x] * 32);
+		if (! checkRoot(&tree, hashes, 100)) {
+			printf("UPDATE %i FAIL\n", updates[x]);
+			return 1;
+		}
+	}
+	// Build in one go, for sizes smaller and larger than before.
+	for (int x = 1; x <= 100; x += 11) {
+		CBMerkleTreeSetHashes(&tree, hashes, x);
+		if (! checkRoot(&tree, hashes, x)) {
+			printf("SET HASHES %i FAIL\n", x);
+			return 1;
+		}
+		CBMerkleTreeUpdate(&tree, x - 1, hashes);
+		memcpy(hashes + (x - 1) * 32, hashes, 32);
+		if (! checkRoot(&tree, hashes, x)) {
+			printf("SET HASHES UPDATE %i FAIL\n", x);
+			return 1;
+		}
+	}
+	// Branches from the tree and from the hashes prove every leaf.
+	for (int x = 1; x <= 100; x += 9) {
+		CBMerkleTreeSetHashes(&tree, hashes, x);
+		unsigned char branch[7 * 32], branch2[7 * 32], root[32];
+		for (int y = 0; y < x; y++) {
+			int branchNum = CBMerkleTreeGetBranch(&tree, y, branch);
+			if (branchNum != tree.levelNum - 1 || CBCalculateMerkleBranch(hashes, x, y, branch2) != branchNum
+				|| memcmp(branch, branch2, branchNum * 32)) {
+				printf("BRANCH %i %i FAIL\n", x, y);
+				return 1;
+			}
+			CBMerkleBranchCalculateRoot(hashes + y * 32, branch, branchNum, y, root);
+			if (memcmp(root, CBMerkleTreeGetRoot(&tree), 32)) {
+				printf("BRANCH ROOT %i %i FAIL\n", x, y);
+				return 1;
+			}
+			if (branchNum) {
+				// The wrong index does not prove the hash unless the sibling is itself.
+				CBMerkleBranchCalculateRoot(hashes + y * 32, branch, branchNum, y ^ 1, root);
+				if (! memcmp(root, CBMerkleTreeGetRoot(&tree), 32) && (y ^ 1) < x) {
+					printf("BRANCH WRONG INDEX %i %i FAIL\n", x, y);
+					return 1;
+				}
+			}
+		}
+	}
+	CBMerkleTreeClear(&tree);
+	if (CBMerkleTreeGetRoot(&tree)) {
+		printf("CLEAR FAIL\n");
+		return 1;
+	}
+	CBMerkleTreeAppend(&tree, hashes);
+	if (! checkRoot(&tree, hashes, 1)) {
+		printf("APPEND AFTER CLEAR FAIL\n");
+		return 1;
+	}
+	CBDestroyMerkleTree(&tree);
+	return 0;
+}
@@ -0,0 +1,126 @@
+//
+//  testCBPartialMerkleTree.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBPartialMerkleTree.h"
+#include <stdarg.h>
+#include <time.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	unsigned int s = (unsigned int)time(NULL);
+	printf("Session = %u\n", s);
+	srand(s);
+	unsigned char hashes[300 * 32];
+	unsigned char matches[300 * 32];
+	int indexes[300];
+	bool matched[300];
+	for (int x = 0; x < 300 * 32; x++)
+		hashes[x] = rand();
+	int sizes[8] = {1, 2, 3, 7, 16, 17, 100, 300};
+	for (int x = 0; x < 8; x++) {
+		int num = sizes[x];
+		unsigned char root[32];
+		memcpy(matches, hashes, num * 32);
+		CBCalculateMerkleRoot(matches, num);
+		memcpy(root, matches, 32);
+		// Match nothing, everything and a random selection
+		for (int y = 0; y < 3; y++) {
+			int expectedNum = 0;
+			for (int z = 0; z < num; z++) {
+				matched[z] = y == 1 || (y == 2 && rand() % 8 == 0);
+				expectedNum += matched[z];
+			}
+			CBPartialMerkleTree tree;
+			CBInitPartialMerkleTree(&tree, hashes, num, matched);
+			// Serialise and deserialise
+			CBByteArray * bytes = CBNewByteArrayOfSize(CBPartialMerkleTreeCalculateLength(&tree));
+			if (CBPartialMerkleTreeSerialise(&tree, bytes, 0) != bytes->length) {
+				printf("SERIALISE %i %i FAIL\n", num, y);
+				return 1;
+			}
+			CBPartialMerkleTree tree2;
+			if (CBPartialMerkleTreeDeserialise(&tree2, bytes, 0) != bytes->length
+				|| tree2.transactionNum != num || tree2.hashNum != tree.hashNum) {
+				printf("DESERIALISE %i %i FAIL\n", num, y);
+				return 1;
+			}
+			int matchNum;
+			if (! CBPartialMerkleTreeVerify(&tree2, root, matches, indexes, &matchNum) || matchNum != expectedNum) {
+				printf("VERIFY %i %i FAIL\n", num, y);
+				return 1;
+			}
+			for (int z = 0, w = 0; z < num; z++)
+				if (matched[z]) {
+					if (indexes[w] != z || memcmp(matches + w * 32, hashes + z * 32, 32)) {
+						printf("MATCH %i %i %i FAIL\n", num, y, z);
+						return 1;
+					}
+					w++;
+				}
+			// A wrong root, a changed hash or a truncated tree does not verify.
+			root[0]++;
+			if (CBPartialMerkleTreeVerify(&tree2, root, matches, NULL, &matchNum)) {
+				printf("WRONG ROOT %i %i FAIL\n", num, y);
+				return 1;
+			}
+			root[0]--;
+			tree2.hashes[0] ^= 1;
+			if (CBPartialMerkleTreeVerify(&tree2, root, matches, NULL, &matchNum)) {
+				printf("CHANGED HASH %i %i FAIL\n", num, y);
+				return 1;
+			}
+			tree2.hashes[0] ^= 1;
+			tree2.hashNum--;
+			if (CBPartialMerkleTreeVerify(&tree2, root, matches, NULL, &matchNum)) {
+				printf("MISSING HASH %i %i FAIL\n", num, y);
+				return 1;
+			}
+			CBDestroyPartialMerkleTree(&tree2);
+			bytes->length--;
+			if (CBPartialMerkleTreeDeserialise(&tree2, bytes, 0)) {
+				printf("TRUNCATED %i %i FAIL\n", num, y);
+				return 1;
+			}
+			CBDestroyPartialMerkleTree(&tree2);
+			bytes->length++;
+			CBReleaseObject(bytes);
+			CBDestroyPartialMerkleTree(&tree);
+		}
+	}
+	// Duplicating the last transaction gives the same root and must be rejected.
+	memcpy(hashes + 32 * 3, hashes + 32 * 2, 32);
+	unsigned char root[32];
+	memcpy(matches, hashes, 3 * 32);
+	CBCalculateMerkleRoot(matches, 3);
+	memcpy(root, matches, 32);
+	bool all[4] = {true, true, true, true};
+	CBPartialMerkleTree tree;
+	CBInitPartialMerkleTree(&tree, hashes, 4, all);
+	int matchNum;
+	if (CBPartialMerkleTreeVerify(&tree, root, matches, NULL, &matchNum)) {
+		printf("DUPLICATE FAIL\n");
+		return 1;
+	}
+	CBDestroyPartialMerkleTree(&tree);
+	return 0;
+}
@@ -0,0 +1,160 @@
+//
+//  testCBRand.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <openssl/evp.h>
+#include "CBDependencies.h"
+
+void CBLogError(char * b, ...);
+void CBLogError(char * b, ...){
+	printf("%s\n", b);
+	exit(EXIT_FAILURE);
+}
+
+// Gets ChaCha20 output for a key with the counter and nonce starting at zero.
+bool chaCha20(unsigned char * key, unsigned char * output, int length);
+bool chaCha20(unsigned char * key, unsigned char * output, int length){
+	unsigned char iv[16] = {0};
+	EVP_CIPHER_CTX * ctx = EVP_CIPHER_CTX_new();
+	int outLength;
+	memset(output, 0, length);
+	bool ok = EVP_EncryptInit_ex(ctx, EVP_chacha20(), NULL, key, iv)
+		&& EVP_EncryptUpdate(ctx, output, &outLength, output, length);
+	EVP_CIPHER_CTX_free(ctx);
+	return ok;
+}
+
+int main(){
+	CBDepObject gen;
+	if (! CBNewSecureRandomGenerator(&gen)) {
+		printf("NEW FAIL\n");
+		return 1;
+	}
+	// A seeded generator gives ChaCha20 output after the 32 bytes which become the next key.
+	long long int seed = 0x0123456789ABCDEFLL;
+	unsigned char key[32] = {0}, stream[512], bytes[1000];
+	for (int x = 0; x < 8; x++)
+		key[x] = (unsigned char)(seed >> (x * 8));
+	if (! chaCha20(key, stream, 512)) {
+		printf("OPENSSL CHACHA20 FAIL\n");
+		return 1;
+	}
+	CBRandomSeed(gen, seed);
+	unsigned long long int integer = CBSecureRandomInteger(gen);
+	if (memcmp(&integer, stream + 32, 8)) {
+		printf("INTEGER KNOWN ANSWER FAIL\n");
+		return 1;
+	}
+	// Continue across the refill, which uses the new key.
+	if (! CBSecureRandomBytes(gen, bytes, 600) || memcmp(bytes, stream + 40, 472)) {
+		printf("BYTES KNOWN ANSWER FAIL\n");
+		return 1;
+	}
+	memcpy(key, stream, 32);
+	chaCha20(key, stream, 512);
+	if (memcmp(bytes + 472, stream + 32, 128)) {
+		printf("REFILL KNOWN ANSWER FAIL\n");
+		return 1;
+	}
+	// The same seed gives the same output, whatever the sizes of the requests.
+	unsigned char bytes2[1000];
+	CBRandomSeed(gen, 42);
+	CBSecureRandomBytes(gen, bytes, 1000);
+	CBRandomSeed(gen, 42);
+	for (int x = 0, length = 1; x < 1000; x += length, length = length * 3 % 97 + 1)
+		CBSecureRandomBytes(gen, bytes2 + x, x + length > 1000 ? 1000 - x : length);
+	if (memcmp(bytes, bytes2, 1000)) {
+		printf("SAME SEED FAIL\n");
+		return 1;
+	}
+	CBRandomSeed(gen, 43);
+	CBSecureRandomBytes(gen, bytes2, 1000);
+	if (! memcmp(bytes, bytes2, 32)) {
+		printf("DIFFERENT SEED FAIL\n");
+		return 1;
+	}
+	// Secure seeding
+	if (! CBSecureRandomSeed(gen)) {
+		printf("SECURE SEED FAIL\n");
+		return 1;
+	}
+	CBSecureRandomBytes(gen, bytes, 1000);
+	CBSecureRandomSeed(gen);
+	CBSecureRandomBytes(gen, bytes2, 1000);
+	if (! memcmp(bytes, bytes2, 32)) {
+		printf("SECURE SEED DIFFERENT FAIL\n");
+		return 1;
+	}
+	// Give enough output to seed again.
+	unsigned char * large = malloc(3000000);
+	if (! CBSecureRandomBytes(gen, large, 3000000)) {
+		printf("LARGE FAIL\n");
+		return 1;
+	}
+	free(large);
+	CBFreeSecureRandomGenerator(gen);
+	// The thread generator with odd lengths
+	memset(bytes, 0, 1000);
+	memset(bytes2, 0, 1000);
+	if (! CBGetRandomBytes(bytes, 333) || ! CBGetRandomBytes(bytes2, 333) || ! memcmp(bytes, bytes2, 333)) {
+		printf("THREAD BYTES FAIL\n");
+		return 1;
+	}
+	for (int x = 333; x < 1000; x++)
+		if (bytes[x] || bytes2[x]) {
+			printf("THREAD BYTES OVERRUN FAIL\n");
+			return 1;
+		}
+	int counts[256] = {0};
+	unsigned char * counted = malloc(256000);
+	CBGetRandomBytes(counted, 256000);
+	for (int x = 0; x < 256000; x++)
+		counts[counted[x]]++;
+	free(counted);
+	for (int x = 0; x < 256; x++)
+		// The expected count is 1000, with a standard deviation of about 32.
+		if (counts[x] < 800 || counts[x] > 1200) {
+			printf("DISTRIBUTION FAIL %i %i\n", x, counts[x]);
+			return 1;
+		}
+	if (! CBGet32RandomBytes(bytes)) {
+		printf("32 BYTES FAIL\n");
+		return 1;
+	}
+	// A forked child does not repeat the output of the parent.
+	int pipes[2];
+	if (pipe(pipes)) {
+		printf("PIPE FAIL\n");
+		return 1;
+	}
+	pid_t pid = fork();
+	if (pid == 0) {
+		CBGetRandomBytes(bytes, 32);
+		exit(write(pipes[1], bytes, 32) != 32);
+	}
+	CBGetRandomBytes(bytes, 32);
+	int status;
+	waitpid(pid, &status, 0);
+	if (read(pipes[0], bytes2, 32) != 32 || ! memcmp(bytes, bytes2, 32)) {
+		printf("FORK FAIL\n");
+		return 1;
+	}
+	close(pipes[0]);
+	close(pipes[1]);
+	return 0;
+}
@@ -30,6 +30,52 @@ void CBLogError(char * format, ...){
 	printf("\n");
 }
 
+#define SIGN_ALL_INPUTS 100
+
+CBKeyPair * signAllKeys[2];
+CBScript * signAllScripts[5]; // Pubkey hash and pubkey outputs for each key, then a 2 of 2 multisig output.
+
+CBTransactionSignScriptType signAllType(int input);
+CBTransactionSignScriptType signAllType(int input){
+	return input == 50 ? CB_TX_SIGN_SKIP : input % 3 + CB_TX_SIGN_PUBKEY;
+}
+CBSignType signAllSignType(int input);
+CBSignType signAllSignType(int input){
+	if (input == 1)
+		return CB_SIGHASH_SINGLE;
+	if (input == 2)
+		return CB_SIGHASH_NONE;
+	return input % 11 == 4 ? CB_SIGHASH_ALL | CB_SIGHASH_ANYONECANPAY : CB_SIGHASH_ALL;
+}
+CBScript * signAllScript(int input);
+CBScript * signAllScript(int input){
+	switch (signAllType(input)) {
+		case CB_TX_SIGN_PUBKEY_HASH:
+			return signAllScripts[input % 2];
+		case CB_TX_SIGN_PUBKEY:
+			return signAllScripts[2 + input % 2];
+		default:
+			return signAllScripts[4];
+	}
+}
+bool signAllGetKeys(void * foo, CBTransaction * tx, int input, CBTransactionSignInput * signInput);
+bool signAllGetKeys(void * foo, CBTransaction * tx, int input, CBTransactionSignInput * signInput){
+	UNUSED(foo);
+	UNUSED(tx);
+	signInput->type = signAllType(input);
+	if (signInput->type == CB_TX_SIGN_MULTISIG) {
+		signInput->keys[0] = signAllKeys[0];
+		signInput->keys[1] = signAllKeys[1];
+		signInput->keyNum = 2;
+	}else{
+		signInput->keys[0] = signAllKeys[input % 2];
+		signInput->keyNum = 1;
+	}
+	signInput->prevOutSubScript = signAllScript(input);
+	signInput->signType = signAllSignType(input);
+	return true;
+}
+
 int main(){
 	unsigned int s = (unsigned int)time(NULL);
 	s = 1337544566;
@@ -1434,6 +1480,100 @@ int main(){
 		return 1;
 	}
 	CBReleaseObject(script);
+	// Test CBTransactionSignAll against signing each input
+	signAllKeys[0] = keyPairs[0];
+	signAllKeys[1] = keyPairs[1];
+	for (int x = 0; x < 2; x++) {
+		signAllScripts[x] = CBNewScriptPubKeyHashOutput(CBKeyPairGetHash(keyPairs[x]));
+		signAllScripts[2 + x] = CBNewScriptPubKeyOutput(keyPairs[x]->pubkey.key);
+	}
+	signAllScripts[4] = CBNewScriptMultisigOutput((unsigned char *[2]){keyPairs[0]->pubkey.key, keyPairs[1]->pubkey.key}, 2, 2);
+	CBTransaction * txs[2];
+	for (int y = 0; y < 2; y++) {
+		txs[y] = CBNewTransaction(0, 1);
+		for (int x = 0; x < SIGN_ALL_INPUTS; x++) {
+			CBSha256((unsigned char *)&x, sizeof(x), hash);
+			prev = CBNewByteArrayWithDataCopy(hash, 32);
+			CBTransactionTakeInput(txs[y], CBNewTransactionInput(NULL, CB_TX_INPUT_FINAL, prev, x % 4));
+			CBReleaseObject(prev);
+		}
+		for (int x = 0; x < 3; x++)
+			CBTransactionTakeOutput(txs[y], CBNewTransactionOutput(1000 + x, signAllScripts[x]));
+	}
+	for (int x = 0; x < SIGN_ALL_INPUTS; x++) {
+		CBSignType signType = signAllSignType(x);
+		switch (signAllType(x)) {
+			case CB_TX_SIGN_PUBKEY:
+				CBTransactionSignPubKeyInput(txs[1], keyPairs[x % 2], signAllScript(x), x, signType);
+				break;
+			case CB_TX_SIGN_PUBKEY_HASH:
+				CBTransactionSignPubKeyHashInput(txs[1], keyPairs[x % 2], signAllScript(x), x, signType);
+				break;
+			case CB_TX_SIGN_MULTISIG:
+				CBTransactionSignMultisigInput(txs[1], keyPairs[0], signAllScript(x), x, signType);
+				CBTransactionSignMultisigInput(txs[1], keyPairs[1], signAllScript(x), x, signType);
+				break;
+			default:
+				// Skipped inputs keep their scripts.
+				for (int y = 0; y < 2; y++)
+					txs[y]->inputs[x]->scriptObject = CBNewScriptWithDataCopy((unsigned char []){CB_SCRIPT_OP_TRUE}, 1);
+		}
+	}
+	CBTransactionPrepareBytes(txs[1]);
+	CBTransactionSerialise(txs[1], true);
+	// The second time the transaction is already serialised and the scripts are replaced.
+	for (int y = 0; y < 2; y++) {
+		if (! CBTransactionSignAll(txs[0], signAllGetKeys, NULL, y + 1)) {
+			printf("CBTransactionSignAll FAIL\n");
+			return 1;
+		}
+		for (int x = 0; x < SIGN_ALL_INPUTS; x++)
+			if (CBByteArrayCompare(txs[0]->inputs[x]->scriptObject, txs[1]->inputs[x]->scriptObject) != CB_COMPARE_EQUAL) {
+				printf("CBTransactionSignAll SCRIPT %i FAIL\n", x);
+				return 1;
+			}
+		if (! y) {
+			CBTransactionPrepareBytes(txs[0]);
+			CBTransactionSerialise(txs[0], true);
+		}
+		if (CBByteArrayCompare(CBGetMessage(txs[0])->bytes, CBGetMessage(txs[1])->bytes) != CB_COMPARE_EQUAL) {
+			printf("CBTransactionSignAll SERIALISATION FAIL\n");
+			return 1;
+		}
+	}
+	for (int x = 0; x < SIGN_ALL_INPUTS; x++) {
+		if (signAllType(x) == CB_TX_SIGN_SKIP)
+			continue;
+		stack = CBNewEmptyScriptStack();
+		CBScriptExecute(txs[0]->inputs[x]->scriptObject, &stack, NULL, NULL, 0, false);
+		if (CBScriptExecute(signAllScript(x), &stack, CBTransactionGetInputHashForSignature, txs[0], x, false) != CB_SCRIPT_TRUE) {
+			printf("CBTransactionSignAll EXECUTION %i FAIL\n", x);
+			return 1;
+		}
+	}
+	// The compact encoding without a table of hashes gives the same transaction.
+	CBByteArray * compact = CBNewByteArrayOfSize(CBTransactionCalculateCompactLength(txs[1]));
+	if (CBTransactionCompactSerialise(txs[1], compact, 0, NULL) != compact->length) {
+		printf("COMPACT SERIALISE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(txs[0]);
+	txs[0] = CBNewTransaction(0, 0);
+	if (CBTransactionCompactDeserialise(txs[0], compact, 0, NULL) != compact->length) {
+		printf("COMPACT DESERIALISE FAIL\n");
+		return 1;
+	}
+	CBTransactionPrepareBytes(txs[0]);
+	CBTransactionSerialise(txs[0], true);
+	if (CBByteArrayCompare(CBGetMessage(txs[0])->bytes, CBGetMessage(txs[1])->bytes) != CB_COMPARE_EQUAL) {
+		printf("COMPACT ROUND TRIP FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(compact);
+	CBReleaseObject(txs[0]);
+	CBReleaseObject(txs[1]);
+	for (int x = 0; x < 5; x++)
+		CBReleaseObject(signAllScripts[x]);
 	// ??? Add standards tests
 	return 0;
 }
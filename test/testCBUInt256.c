@@ -0,0 +1,151 @@
+//
+//  testCBUInt256.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBValidationFunctions.h"
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+int main(){
+	// Compact targets
+	struct{
+		uint32_t compact;
+		bool valid;
+		uint64_t value;
+		uint32_t result;
+	} compacts[10] = {
+		{0x00123456, true, 0, 0},
+		{0x01003456, true, 0, 0},
+		{0x01123456, true, 0x12, 0x01120000},
+		{0x02123456, true, 0x1234, 0x02123400},
+		{0x03123456, true, 0x123456, 0x03123456},
+		{0x04123456, true, 0x12345600, 0x04123456},
+		{0x05009234, true, 0x92340000, 0x05009234},
+		{0x04923456, false, 0, 0},
+		{0xFF123456, false, 0, 0},
+		{0x23000001, false, 0, 0},
+	};
+	for (int x = 0; x < 10; x++) {
+		CBUInt256 a;
+		bool valid = CBUInt256FromCompact(&a, compacts[x].compact);
+		if (valid != compacts[x].valid
+			|| (valid && (a.limbs[0] != compacts[x].value || a.limbs[1] || a.limbs[2] || a.limbs[3]
+						  || CBUInt256ToCompact(&a) != compacts[x].result))) {
+			printf("COMPACT %i FAIL\n", x);
+			return 1;
+		}
+	}
+	CBUInt256 a, b, c, d;
+	if (! CBUInt256FromCompact(&a, 0x20123456) || a.limbs[3] != 0x1234560000000000ULL || a.limbs[2] || CBUInt256ToCompact(&a) != 0x20123456) {
+		printf("COMPACT HIGH FAIL\n");
+		return 1;
+	}
+	// Bytes
+	unsigned char bytes[32], bytes2[32];
+	for (int x = 0; x < 32; x++)
+		bytes[x] = x * 7 + 1;
+	CBUInt256FromBytes(&a, bytes);
+	CBUInt256ToBytes(&a, bytes2);
+	if (memcmp(bytes, bytes2, 32) || a.limbs[0] != 0x322B241D160F0801ULL || CBUInt256Bits(&a) != 256) {
+		printf("BYTES FAIL\n");
+		return 1;
+	}
+	// Addition and subtraction carry across limbs
+	a = (CBUInt256){{0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL, 0, 0}};
+	CBUInt256FromUInt64(&b, 1);
+	if (CBUInt256EqualsAdditionByUInt256(&a, &b) || a.limbs[0] || a.limbs[1] || a.limbs[2] != 1 || a.limbs[3]) {
+		printf("ADDITION FAIL\n");
+		return 1;
+	}
+	if (CBUInt256EqualsSubtractionByUInt256(&a, &b) || a.limbs[0] != 0xFFFFFFFFFFFFFFFFULL || a.limbs[1] != 0xFFFFFFFFFFFFFFFFULL || a.limbs[2]) {
+		printf("SUBTRACTION FAIL\n");
+		return 1;
+	}
+	CBUInt256FromUInt64(&c, 0);
+	if (! CBUInt256EqualsSubtractionByUInt256(&c, &b) || c.limbs[0] != 0xFFFFFFFFFFFFFFFFULL || c.limbs[3] != 0xFFFFFFFFFFFFFFFFULL) {
+		printf("SUBTRACTION UNDERFLOW FAIL\n");
+		return 1;
+	}
+	if (! CBUInt256EqualsAdditionByUInt256(&c, &b) || ! CBUInt256IsZero(&c)) {
+		printf("ADDITION OVERFLOW FAIL\n");
+		return 1;
+	}
+	// (2^128 - 1)^2 = 2^256 - 2^129 + 1
+	c = a;
+	if (CBUInt256EqualsMultiplicationByUInt256(&c, &a) || c.limbs[0] != 1 || c.limbs[1] != 0
+		|| c.limbs[2] != 0xFFFFFFFFFFFFFFFEULL || c.limbs[3] != 0xFFFFFFFFFFFFFFFFULL) {
+		printf("MULTIPLICATION FAIL\n");
+		return 1;
+	}
+	CBUInt256FromUInt64(&c, 1);
+	CBUInt256EqualsShiftLeft(&c, 128);
+	d = c;
+	if (! CBUInt256EqualsMultiplicationByUInt256(&c, &d) || ! CBUInt256IsZero(&c)) {
+		printf("MULTIPLICATION OVERFLOW FAIL\n");
+		return 1;
+	}
+	// Division, checked by multiplying back and adding the remainder.
+	uint32_t divisors[4][2] = {{0, 1209600}, {0x1D00FFFF, 0}, {0x1B0404CB, 0}, {0x10008F00, 0}};
+	for (int x = 0; x < 4; x++) {
+		CBUInt256FromBytes(&a, bytes);
+		if (divisors[x][0])
+			CBUInt256FromCompact(&b, divisors[x][0]);
+		else
+			CBUInt256FromUInt64(&b, divisors[x][1]);
+		c = a;
+		CBUInt256 rem;
+		if (! CBUInt256EqualsDivisionByUInt256(&c, &b, &rem) || CBUInt256CompareToUInt256(&rem, &b) != CB_COMPARE_LESS_THAN) {
+			printf("DIVISION %i FAIL\n", x);
+			return 1;
+		}
+		CBUInt256EqualsMultiplicationByUInt256(&c, &b);
+		CBUInt256EqualsAdditionByUInt256(&c, &rem);
+		if (CBUInt256CompareToUInt256(&c, &a)) {
+			printf("DIVISION %i CHECK FAIL\n", x);
+			return 1;
+		}
+	}
+	CBUInt256FromUInt64(&b, 0);
+	if (CBUInt256EqualsDivisionByUInt256(&a, &b, NULL)) {
+		printf("DIVISION BY ZERO FAIL\n");
+		return 1;
+	}
+	// Shifts
+	CBUInt256FromUInt64(&a, 0x8000000000000001ULL);
+	CBUInt256EqualsShiftLeft(&a, 65);
+	if (a.limbs[0] || a.limbs[1] != 2 || a.limbs[2] != 1 || CBUInt256Bits(&a) != 129) {
+		printf("SHIFT LEFT FAIL\n");
+		return 1;
+	}
+	CBUInt256EqualsShiftRight(&a, 66);
+	if (a.limbs[0] != 0x4000000000000000ULL || a.limbs[1] || a.limbs[2]) {
+		printf("SHIFT RIGHT FAIL\n");
+		return 1;
+	}
+	// Block work for the maximum target is 2^256 / (0xFFFF * 2^208)
+	CBCalculateBlockWorkUInt256(&a, CB_MAX_TARGET);
+	if (a.limbs[0] != 0x0100010001ULL || a.limbs[1]) {
+		printf("BLOCK WORK FAIL\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,202 @@
+//
+//  testCBVanitySearch.c
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+#include <stdio.h>
+#include "CBVanitySearch.h"
+#include <strings.h>
+#include <time.h>
+#include <stdarg.h>
+
+void CBLogError(char * format, ...);
+void CBLogError(char * format, ...){
+	va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+	printf("\n");
+}
+
+// Checks a hash against the search and the encoded address.
+bool checkHash(CBVanitySearch * search, unsigned char * hash);
+bool checkHash(CBVanitySearch * search, unsigned char * hash){
+	char address[CB_ADDRESS_STRING_SIZE];
+	CBAddressEncodeBatch(hash, search->prefix, 1, address);
+	size_t length = strlen(search->pattern);
+	bool match = search->caseInsensitive ? ! strncasecmp(address, search->pattern, length) : ! strncmp(address, search->pattern, length);
+	if (match && ! CBVanitySearchInRange(search, hash))
+		return false;
+	return CBVanitySearchCheckHash(search, hash, NULL) == match;
+}
+
+// Adds to or subtracts one from a hash.
+void stepHash(unsigned char * hash, bool up);
+void stepHash(unsigned char * hash, bool up){
+	for (int x = 19; x >= 0; x--)
+		if (up ? hash[x]++ != 0xFF : hash[x]-- != 0)
+			break;
+}
+
+int progressCalls = 0;
+bool onProgress(void * object, uint64_t tried, double rate);
+bool onProgress(void * object, uint64_t tried, double rate){
+	progressCalls++;
+	if (tried == 0 || rate < 0)
+		printf("PROGRESS VALUES FAIL\n");
+	return *(bool *)object;
+}
+
+int main(){
+	unsigned int s = (unsigned int)time(NULL);
+	printf("Session = %u\n", s);
+	srand(s);
+	// Patterns which cannot be searched for
+	if (CBNewVanitySearch("10", CB_PREFIX_PRODUCTION_ADDRESS, false)) {
+		printf("NOT BASE-58 FAIL\n");
+		return 1;
+	}
+	if (CBNewVanitySearch("1o0", CB_PREFIX_PRODUCTION_ADDRESS, true)) {
+		printf("NOT BASE-58 IGNORING CASE FAIL\n");
+		return 1;
+	}
+	if (CBNewVanitySearch("A", CB_PREFIX_PRODUCTION_ADDRESS, false)) {
+		printf("WRONG FIRST CHARACTER FAIL\n");
+		return 1;
+	}
+	if (CBNewVanitySearch("1zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz", CB_PREFIX_PRODUCTION_ADDRESS, false)) {
+		printf("TOO HIGH FAIL\n");
+		return 1;
+	}
+	if (CBNewVanitySearch("1abcdefghijkmnopqrstuvwxyz", CB_PREFIX_PRODUCTION_ADDRESS, true)) {
+		printf("TOO MANY SPELLINGS FAIL\n");
+		return 1;
+	}
+	// Only the lower case o is in the alphabet.
+	CBVanitySearch * search = CBNewVanitySearch("1O", CB_PREFIX_PRODUCTION_ADDRESS, true);
+	if (! search || search->rangeNum != 1) {
+		printf("ONE SPELLING IGNORING CASE FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(search);
+	// Compare the ranges with encoded addresses
+	struct{
+		char * pattern;
+		CBBase58Prefix prefix;
+		bool caseInsensitive;
+	} patterns[] = {
+		{"1", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"11", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"111", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"12", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"1A", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"1z", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"1Ab", CB_PREFIX_PRODUCTION_ADDRESS, false},
+		{"1ab", CB_PREFIX_PRODUCTION_ADDRESS, true},
+		{"11kx", CB_PREFIX_PRODUCTION_ADDRESS, true},
+		{"m", CB_PREFIX_TEST_ADDRESS, false},
+		{"n", CB_PREFIX_TEST_ADDRESS, false},
+		{"mz", CB_PREFIX_TEST_ADDRESS, true},
+		{"n2", CB_PREFIX_TEST_ADDRESS, false},
+	};
+	for (int x = 0; x < (int)(sizeof(patterns) / sizeof(*patterns)); x++) {
+		search = CBNewVanitySearch(patterns[x].pattern, patterns[x].prefix, patterns[x].caseInsensitive);
+		if (! search) {
+			printf("NEW %s FAIL\n", patterns[x].pattern);
+			return 1;
+		}
+		unsigned char hash[20];
+		for (int y = 0; y < 20000; y++) {
+			for (int z = 0; z < 20; z++)
+				hash[z] = rand();
+			// Give hashes leading zeros for the patterns with leading '1' characters.
+			for (int z = 0; z < y % 4; z++)
+				hash[z] = 0;
+			if (! checkHash(search, hash)) {
+				printf("RANDOM HASH %s FAIL\n", patterns[x].pattern);
+				return 1;
+			}
+		}
+		// Check around the ends of each range, where the hashes next to the ranges never match and the hashes inside always match.
+		for (int y = 0; y < search->rangeNum; y++) {
+			CBVanitySearchRange * range = search->ranges + y;
+			unsigned char * ends[2] = {range->lowHash, range->highHash};
+			// The hashes inside the ends are only certain to match when the range has more than two hashes.
+			memcpy(hash, range->lowHash, 20);
+			stepHash(hash, true);
+			stepHash(hash, true);
+			bool wide = memcmp(hash, range->highHash, 20) <= 0;
+			for (int z = 0; z < 2; z++) {
+				memcpy(hash, ends[z], 20);
+				if (! checkHash(search, hash)) {
+					printf("RANGE END %s FAIL\n", patterns[x].pattern);
+					return 1;
+				}
+				// Step outside unless the range reaches the lowest or highest hash.
+				stepHash(hash, z == 1);
+				bool wrapped = z ? memcmp(hash, ends[z], 20) < 0 : memcmp(hash, ends[z], 20) > 0;
+				if (! checkHash(search, hash) || (! wrapped && CBVanitySearchCheckHash(search, hash, NULL))) {
+					printf("OUTSIDE RANGE %s FAIL\n", patterns[x].pattern);
+					return 1;
+				}
+				memcpy(hash, ends[z], 20);
+				stepHash(hash, z == 0);
+				if (wide && ! CBVanitySearchCheckHash(search, hash, NULL)) {
+					printf("INSIDE RANGE %s FAIL\n", patterns[x].pattern);
+					return 1;
+				}
+			}
+		}
+		CBReleaseObject(search);
+	}
+	// Ignoring case makes matches more likely.
+	CBVanitySearch * caseSearch = CBNewVanitySearch("1ab", CB_PREFIX_PRODUCTION_ADDRESS, false);
+	CBVanitySearch * noCaseSearch = CBNewVanitySearch("1ab", CB_PREFIX_PRODUCTION_ADDRESS, true);
+	if (noCaseSearch->difficulty * 3 > caseSearch->difficulty || caseSearch->difficulty < 58 * 58) {
+		printf("DIFFICULTY FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(caseSearch);
+	CBReleaseObject(noCaseSearch);
+	// Search for a key pair
+	search = CBNewVanitySearch("1Ab", CB_PREFIX_PRODUCTION_ADDRESS, true);
+	CBKeyPair key;
+	char address[CB_ADDRESS_STRING_SIZE];
+	bool cont = true;
+	if (! CBVanitySearchFind(search, 2, onProgress, &cont, 0, &key, address)) {
+		printf("FIND FAIL\n");
+		return 1;
+	}
+	unsigned char pubKey[CB_PUBKEY_SIZE];
+	CBKeyGetPublicKey(key.privkey, pubKey);
+	char expected[CB_ADDRESS_STRING_SIZE];
+	CBAddressEncodeBatch(CBKeyPairGetHash(&key), CB_PREFIX_PRODUCTION_ADDRESS, 1, expected);
+	if (memcmp(pubKey, key.pubkey.key, CB_PUBKEY_SIZE) || strcmp(address, expected) || strncasecmp(address, "1ab", 3)) {
+		printf("FOUND KEY FAIL\n");
+		return 1;
+	}
+	if (search->tried == 0) {
+		printf("TRIED FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(search);
+	// Stop a search which would not end
+	search = CBNewVanitySearch("1AAAAAAAAAA", CB_PREFIX_PRODUCTION_ADDRESS, false);
+	cont = false;
+	progressCalls = 0;
+	if (CBVanitySearchFind(search, 2, onProgress, &cont, 0, &key, address) || progressCalls != 1) {
+		printf("STOP FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(search);
+	return 0;
+}
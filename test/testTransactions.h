@@ -0,0 +1,78 @@
+//
+//  testTransactions.h
+//  cbitcoin
+//
+//  Created by cbitcoin contributors on 18/10/2026.
+//  Copyright (c) 2012 Matthew Mitchell
+//
+//  This file is part of cbitcoin. It is subject to the license terms
+//  in the LICENSE file found in the top-level directory of this
+//  distribution and at http://www.cbitcoin.com/license.html. No part of
+//  cbitcoin, including this file, may be copied, modified, propagated,
+//  or distributed except according to the terms contained in the
+//  LICENSE file.
+
+/**
+ @file
+ @brief Makes transactions and blocks for the tests of block and transaction processing.
+ */
+
+#ifndef TESTTRANSACTIONSH
+#define TESTTRANSACTIONSH
+
+#include "CBBlock.h"
+
+/**
+ @brief Makes a new serialised transaction with a version of one and a lock time of zero.
+ @param prevHash The hash of the transaction with the outputs being spent, or NULL for a coinbase transaction, which spends the null hash with the index 0xFFFFFFFF.
+ @param prevIndex The index of the output spent by the first input. Each following input spends the next output.
+ @param inputNum The number of inputs.
+ @param inputScript The script of every input, which is copied.
+ @param outputScripts The script of each output, or NULL to use the copy of the input script for every output.
+ @param values The value of each output.
+ @param outputNum The number of outputs.
+ @returns The new CBTransaction.
+ */
+static CBTransaction * newTestTransaction(unsigned char * prevHash, unsigned int prevIndex, int inputNum, CBScript * inputScript, CBScript ** outputScripts, unsigned long long int * values, int outputNum){
+	CBTransaction * tx = CBNewTransaction(0, 1);
+	unsigned char nullHash[32] = {0};
+	CBByteArray * hash = CBNewByteArrayWithDataCopy(prevHash ? prevHash : nullHash, 32);
+	// Copy the script so that it references the data of this transaction only once serialised.
+	CBScript * script = CBNewScriptWithDataCopy(CBByteArrayGetData(inputScript), inputScript->length);
+	for (int x = 0; x < inputNum; x++)
+		CBTransactionTakeInput(tx, CBNewTransactionInput(script, CB_TX_INPUT_FINAL, hash, prevHash ? prevIndex + x : 0xFFFFFFFF));
+	for (int x = 0; x < outputNum; x++)
+		CBTransactionTakeOutput(tx, CBNewTransactionOutput(values[x], outputScripts ? outputScripts[x] : script));
+	CBReleaseObject(script);
+	CBReleaseObject(hash);
+	CBTransactionPrepareBytes(tx);
+	CBTransactionSerialise(tx, false);
+	return tx;
+}
+
+/**
+ @brief Makes a new serialised version one block with the null previous block hash and the maximum target.
+ @param txs The transactions of the block, which the block takes ownership of.
+ @param txNum The number of transactions.
+ @param nonce The nonce of the block, so that blocks with the same transactions can have different hashes.
+ @returns The new CBBlock.
+ */
+static CBBlock * newTestBlock(CBTransaction ** txs, int txNum, unsigned int nonce){
+	CBBlock * block = CBNewBlock();
+	block->version = 1;
+	block->prevBlockHash = CBNewByteArrayOfSize(32);
+	memset(CBByteArrayGetData(block->prevBlockHash), 0, 32);
+	block->merkleRoot = CBNewByteArrayOfSize(32);
+	block->time = 1231006505;
+	block->target = CB_MAX_TARGET;
+	block->nonce = nonce;
+	block->transactionNum = txNum;
+	block->transactions = malloc(sizeof(*block->transactions) * txNum);
+	memcpy(block->transactions, txs, sizeof(*block->transactions) * txNum);
+	CBBlockCalculateAndSetMerkleRoot(block);
+	CBBlockPrepareBytes(block, true);
+	CBBlockSerialise(block, true, false);
+	return block;
+}
+
+#endif
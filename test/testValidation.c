@@ -192,6 +192,69 @@ int main(){
 		return 1;
 	}
 	CBReleaseObject(tx);
+	// Test duplicate input detection with many inputs
+	tx = CBNewTransaction(0, 1);
+	script = CBNewScriptWithDataCopy((unsigned char [1]){CB_SCRIPT_OP_1}, 1);
+	hashData[31] = 1;
+	for (int x = 0; x < 3000; x++) {
+		hashData[0] = x;
+		hashData[1] = x >> 8;
+		hash = CBNewByteArrayWithDataCopy(hashData, 32);
+		CBTransactionTakeInput(tx, CBNewTransactionInput(script, CB_TX_INPUT_FINAL, hash, x % 3));
+		CBReleaseObject(hash);
+	}
+	CBTransactionTakeOutput(tx, CBNewTransactionOutput(50, script));
+	CBReleaseObject(script);
+	if (CBTransactionHasDuplicateInputs(tx) || ! CBTransactionValidateBasic(tx, false, &value)) {
+		printf("DUPLICATE INPUTS NONE FAIL\n");
+		return 1;
+	}
+	// Make the last input spend the same output as the first
+	CBByteArraySetBytes(tx->inputs[2999]->prevOut.hash, 0, (unsigned char []){0, 0}, 2);
+	tx->inputs[2999]->prevOut.index = 0;
+	if (! CBTransactionHasDuplicateInputs(tx) || CBTransactionValidateBasic(tx, false, &value)) {
+		printf("DUPLICATE INPUTS FAIL\n");
+		return 1;
+	}
+	// Same hash but a different index is not a duplicate
+	tx->inputs[2999]->prevOut.index = 1;
+	if (CBTransactionHasDuplicateInputs(tx)) {
+		printf("DUPLICATE INPUTS DIFFERENT INDEX FAIL\n");
+		return 1;
+	}
+	// Test double spend detection across a block
+	CBBlock * block = CBNewBlock();
+	block->transactionNum = 4;
+	block->transactions = malloc(sizeof(*block->transactions) * 4);
+	for (int x = 0; x < 4; x++) {
+		block->transactions[x] = CBNewTransaction(0, 1);
+		script = CBNewScriptWithDataCopy((unsigned char [2]){0x01, 0x00}, 2);
+		memset(hashData, x, 32);
+		hash = CBNewByteArrayWithDataCopy(hashData, 32);
+		CBTransactionTakeInput(block->transactions[x], CBNewTransactionInput(script, CB_TX_INPUT_FINAL, hash, x ? 0 : 0xFFFFFFFF));
+		CBReleaseObject(hash);
+		CBReleaseObject(script);
+	}
+	if (CBTransactionsFindDoubleSpend(block->transactions, block->transactionNum) != -1) {
+		printf("BLOCK DOUBLE SPEND NONE FAIL\n");
+		return 1;
+	}
+	// The coinbase input is ignored
+	block->transactions[1]->inputs[0]->prevOut.index = 0xFFFFFFFF;
+	CBByteArraySetBytes(block->transactions[1]->inputs[0]->prevOut.hash, 0, (unsigned char [32]){0}, 32);
+	if (CBTransactionsFindDoubleSpend(block->transactions, block->transactionNum) != -1) {
+		printf("BLOCK DOUBLE SPEND COINBASE FAIL\n");
+		return 1;
+	}
+	// The third and fourth transactions spend the same output
+	CBByteArraySetBytes(block->transactions[3]->inputs[0]->prevOut.hash, 0, CBByteArrayGetData(block->transactions[2]->inputs[0]->prevOut.hash), 32);
+	if (CBTransactionsFindDoubleSpend(block->transactions, block->transactionNum) != 3) {
+		printf("BLOCK DOUBLE SPEND FAIL\n");
+		return 1;
+	}
+	CBReleaseObject(block);
+	memset(hashData, 0, 32);
+	CBReleaseObject(tx);
 	// Test merkle root calculation from block 100, 004
 	unsigned char hashes[192] = {
 		0x2b, 0xa9, 0x74, 0xce, 0xdd, 0x1d, 0xb4, 0x7c, 0x60, 0xce, 0xb1, 0x91, 0x04, 0xd7, 0x0c, 0xaf, 0xd8, 0x8f, 0xa5, 0x41, 0x10, 0x1b, 0xc5, 0x3d, 0x41, 0xe5, 0x3f, 0x93, 0x23, 0xd4, 0x7e, 0xab